@@ -0,0 +1,515 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+   Route the allocations of both the library and the hand-written arrays
+   through a wrapper that keeps track of the reallocations, and of the bytes
+   that they had to copy whenever the block could not be grown in place.
+*/
+
+#define ZR_REALLOC zrBenchReallocate
+#define ZR_FREE zrBenchFree
+
+static void *
+zrBenchReallocate(void *pMemory, size_t size);
+
+static void
+zrBenchFree(void *pMemory);
+
+#define ZR_DEFINE_IMPLEMENTATION
+#include <zero/dynamicarray.h>
+#include <zero/timer.h>
+
+#define ZR_BENCH_ALLOCATION_HEADER_SIZE 16
+#define ZR_BENCH_REPETITION_COUNT 3
+#define ZR_BENCH_LINEAR_COUNT ((size_t)1 << 20)
+#define ZR_BENCH_QUADRATIC_COUNT ((size_t)1 << 13)
+#define ZR_BENCH_SEED 0x9E3779B97F4A7C15ull
+
+typedef struct ZrBenchCounters {
+    ZrUint64 reallocCount;
+    ZrUint64 bytesCopied;
+} ZrBenchCounters;
+
+typedef struct ZrBenchResult {
+    ZrUint64 duration;
+    ZrUint64 reallocCount;
+    ZrUint64 bytesCopied;
+    ZrUint64 bytesMoved;
+} ZrBenchResult;
+
+typedef enum ZrBenchOperation {
+    ZR_BENCH_OPERATION_PUSH_BACK = 0,
+    ZR_BENCH_OPERATION_PUSH_BACK_RESERVED = 1,
+    ZR_BENCH_OPERATION_PUSH_FRONT = 2,
+    ZR_BENCH_OPERATION_INSERT_RANDOM = 3,
+    ZR_BENCH_OPERATION_TRIM_BACK = 4,
+    ZR_BENCH_OPERATION_TRIM_FRONT = 5,
+    ZR_BENCH_OPERATION_TRIM_RANDOM = 6,
+    ZR_BENCH_OPERATION_COUNT = 7
+} ZrBenchOperation;
+
+typedef enum ZrStatus (*ZrBenchRunFunction)(ZrBenchResult *pResult,
+                                            ZrBenchOperation operation,
+                                            size_t count,
+                                            size_t growth);
+
+typedef struct ZrBenchCase {
+    const char *pImplementation;
+    size_t elementSize;
+    size_t growth;
+    ZrBenchRunFunction pfnRun;
+} ZrBenchCase;
+
+static const char *zrBenchOperationNames[] = {
+    "push_back",
+    "push_back_reserved",
+    "push_front",
+    "insert_random",
+    "trim_back",
+    "trim_front",
+    "trim_random",
+};
+
+static ZrBenchCounters zrBenchCounters;
+
+static void *
+zrBenchReallocate(void *pMemory, size_t size)
+{
+    unsigned char *pBlock;
+    size_t previousAddress;
+    size_t previousSize;
+
+    if (pMemory == NULL) {
+        pBlock = (unsigned char *)malloc(ZR_BENCH_ALLOCATION_HEADER_SIZE
+                                         + size);
+        if (pBlock == NULL) {
+            return NULL;
+        }
+
+        memcpy(pBlock, &size, sizeof size);
+        return &pBlock[ZR_BENCH_ALLOCATION_HEADER_SIZE];
+    }
+
+    pBlock = (unsigned char *)pMemory - ZR_BENCH_ALLOCATION_HEADER_SIZE;
+    memcpy(&previousSize, pBlock, sizeof previousSize);
+    previousAddress = (size_t)pBlock;
+
+    pBlock = (unsigned char *)realloc(pBlock,
+                                      ZR_BENCH_ALLOCATION_HEADER_SIZE + size);
+    if (pBlock == NULL) {
+        return NULL;
+    }
+
+    ++zrBenchCounters.reallocCount;
+    if ((size_t)pBlock != previousAddress) {
+        zrBenchCounters.bytesCopied += previousSize < size ? previousSize
+                                                           : size;
+    }
+
+    memcpy(pBlock, &size, sizeof size);
+    return &pBlock[ZR_BENCH_ALLOCATION_HEADER_SIZE];
+}
+
+static void
+zrBenchFree(void *pMemory)
+{
+    if (pMemory == NULL) {
+        return;
+    }
+
+    free((unsigned char *)pMemory - ZR_BENCH_ALLOCATION_HEADER_SIZE);
+}
+
+static size_t
+zrBenchGetRandom(ZrUint64 *pState, size_t bound)
+{
+    ZrUint64 x;
+
+    assert(pState != NULL);
+    assert(bound > 0);
+
+    x = *pState;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pState = x;
+    return (size_t)(x % (ZrUint64)bound);
+}
+
+static ZrUint64
+zrBenchGetPeakResidentSetSize(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    return (ZrUint64)usage.ru_maxrss;
+#else
+    return (ZrUint64)usage.ru_maxrss * 1024ull;
+#endif
+}
+
+/*
+   Each implementation exposes the same set of adapters, with positions that
+   are always within the bounds of the array, so that a single runner can
+   drive all of them.
+*/
+
+#define ZR_BENCH_MAKE_ZERO_ARRAY(name, type)                                   \
+    ZR_MAKE_DYNAMIC_ARRAY(name, type)                                          \
+                                                                               \
+    static enum ZrStatus zrBenchCreate##name(type **ppArray, size_t growth)    \
+    {                                                                          \
+        (void)growth;                                                          \
+        return zrCreate##name(ppArray, 0);                                     \
+    }                                                                          \
+                                                                               \
+    static void zrBenchDestroy##name(type **ppArray)                           \
+    {                                                                          \
+        zrDestroy##name(*ppArray);                                             \
+    }                                                                          \
+                                                                               \
+    static enum ZrStatus zrBenchReserve##name(type **ppArray, size_t capacity) \
+    {                                                                          \
+        return zrReserve##name(ppArray, (ZrSize)capacity);                     \
+    }                                                                          \
+                                                                               \
+    static enum ZrStatus zrBenchPush##name(                                    \
+        type **ppArray, size_t position, type value)                           \
+    {                                                                          \
+        return zrPush##name(ppArray, (ZrSize)position, value);                 \
+    }                                                                          \
+                                                                               \
+    static void zrBenchTrim##name(type **ppArray, size_t position)             \
+    {                                                                          \
+        zrTrim##name(*ppArray, (ZrSize)position, 1);                           \
+    }
+
+#define ZR_BENCH_MAKE_MANUAL_ARRAY(name, type)                                 \
+    typedef struct ZrBenchArray##name {                                        \
+        type *pData;                                                           \
+        size_t size;                                                           \
+        size_t capacity;                                                       \
+        size_t growth;                                                         \
+    } ZrBenchArray##name;                                                      \
+                                                                               \
+    static enum ZrStatus zrBenchCreate##name(ZrBenchArray##name *pArray,       \
+                                             size_t growth)                    \
+    {                                                                          \
+        pArray->pData = NULL;                                                  \
+        pArray->size = 0;                                                      \
+        pArray->capacity = 0;                                                  \
+        pArray->growth = growth;                                               \
+        return ZR_SUCCESS;                                                     \
+    }                                                                          \
+                                                                               \
+    static void zrBenchDestroy##name(ZrBenchArray##name *pArray)               \
+    {                                                                          \
+        zrBenchFree(pArray->pData);                                            \
+    }                                                                          \
+                                                                               \
+    static enum ZrStatus zrBenchReserve##name(ZrBenchArray##name *pArray,      \
+                                              size_t capacity)                 \
+    {                                                                          \
+        type *pData;                                                           \
+                                                                               \
+        if (capacity <= pArray->capacity) {                                    \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        pData = (type *)zrBenchReallocate(pArray->pData,                       \
+                                          sizeof(type) * capacity);            \
+        if (pData == NULL) {                                                   \
+            return ZR_ERROR_ALLOCATION;                                        \
+        }                                                                      \
+                                                                               \
+        pArray->pData = pData;                                                 \
+        pArray->capacity = capacity;                                           \
+        return ZR_SUCCESS;                                                     \
+    }                                                                          \
+                                                                               \
+    static enum ZrStatus zrBenchPush##name(                                    \
+        ZrBenchArray##name *pArray, size_t position, type value)               \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        if (pArray->size == pArray->capacity) {                                \
+            status = zrBenchReserve##name(                                     \
+                pArray, pArray->capacity * pArray->growth / 100 + 1);          \
+            if (status != ZR_SUCCESS) {                                        \
+                return status;                                                 \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        memmove(&pArray->pData[position + 1],                                  \
+                &pArray->pData[position],                                      \
+                sizeof(type) * (pArray->size - position));                     \
+        pArray->pData[position] = value;                                       \
+        ++pArray->size;                                                        \
+        return ZR_SUCCESS;                                                     \
+    }                                                                          \
+                                                                               \
+    static void zrBenchTrim##name(ZrBenchArray##name *pArray, size_t position) \
+    {                                                                          \
+        memmove(&pArray->pData[position],                                      \
+                &pArray->pData[position + 1],                                  \
+                sizeof(type) * (pArray->size - position - 1));                 \
+        --pArray->size;                                                        \
+    }
+
+#define ZR_BENCH_MAKE_RUNNER(name, array, type)                                \
+    static enum ZrStatus zrBenchRun##name(ZrBenchResult *pResult,              \
+                                          ZrBenchOperation operation,          \
+                                          size_t count,                        \
+                                          size_t growth)                       \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        array handle;                                                          \
+        type value;                                                            \
+        ZrUint64 state;                                                        \
+        ZrUint64 start;                                                        \
+        ZrUint64 end;                                                          \
+        size_t position;                                                       \
+        size_t i;                                                              \
+                                                                               \
+        assert(pResult != NULL);                                               \
+                                                                               \
+        memset(&value, 0, sizeof value);                                       \
+        memset(pResult, 0, sizeof *pResult);                                   \
+        state = ZR_BENCH_SEED;                                                 \
+                                                                               \
+        status = zrBenchCreate##name(&handle, growth);                         \
+        if (status != ZR_SUCCESS) {                                            \
+            goto exit;                                                         \
+        }                                                                      \
+                                                                               \
+        if (operation >= ZR_BENCH_OPERATION_TRIM_BACK) {                       \
+            for (i = 0; i < count; ++i) {                                      \
+                value.data[0] = (ZrUint32)i;                                   \
+                status = zrBenchPush##name(&handle, i, value);                 \
+                if (status != ZR_SUCCESS) {                                    \
+                    goto handle_cleanup;                                       \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        memset(&zrBenchCounters, 0, sizeof zrBenchCounters);                   \
+        status = zrGetRealTime(&start);                                        \
+        if (status != ZR_SUCCESS) {                                            \
+            goto handle_cleanup;                                               \
+        }                                                                      \
+                                                                               \
+        switch (operation) {                                                   \
+            case ZR_BENCH_OPERATION_PUSH_BACK_RESERVED:                        \
+                status = zrBenchReserve##name(&handle, count);                 \
+                if (status != ZR_SUCCESS) {                                    \
+                    goto handle_cleanup;                                       \
+                }                                                              \
+                /* Fall through. */                                            \
+            case ZR_BENCH_OPERATION_PUSH_BACK:                                 \
+                for (i = 0; i < count; ++i) {                                  \
+                    value.data[0] = (ZrUint32)i;                               \
+                    status = zrBenchPush##name(&handle, i, value);             \
+                    if (status != ZR_SUCCESS) {                                \
+                        goto handle_cleanup;                                   \
+                    }                                                          \
+                }                                                              \
+                break;                                                         \
+            case ZR_BENCH_OPERATION_PUSH_FRONT:                                \
+            case ZR_BENCH_OPERATION_INSERT_RANDOM:                             \
+                for (i = 0; i < count; ++i) {                                  \
+                    position                                                   \
+                        = operation == ZR_BENCH_OPERATION_PUSH_FRONT           \
+                              ? 0                                              \
+                              : zrBenchGetRandom(&state, i + 1);               \
+                    value.data[0] = (ZrUint32)i;                               \
+                    status = zrBenchPush##name(&handle, position, value);      \
+                    if (status != ZR_SUCCESS) {                                \
+                        goto handle_cleanup;                                   \
+                    }                                                          \
+                                                                               \
+                    pResult->bytesMoved += sizeof(type) * (i - position);      \
+                }                                                              \
+                break;                                                         \
+            case ZR_BENCH_OPERATION_TRIM_BACK:                                 \
+            case ZR_BENCH_OPERATION_TRIM_FRONT:                                \
+            case ZR_BENCH_OPERATION_TRIM_RANDOM:                               \
+                for (i = count; i > 0; --i) {                                  \
+                    if (operation == ZR_BENCH_OPERATION_TRIM_BACK) {           \
+                        position = i - 1;                                      \
+                    } else if (operation == ZR_BENCH_OPERATION_TRIM_FRONT) {   \
+                        position = 0;                                          \
+                    } else {                                                   \
+                        position = zrBenchGetRandom(&state, i);                \
+                    }                                                          \
+                                                                               \
+                    zrBenchTrim##name(&handle, position);                      \
+                    pResult->bytesMoved += sizeof(type) * (i - position - 1);  \
+                }                                                              \
+                break;                                                         \
+            case ZR_BENCH_OPERATION_COUNT:                                     \
+            default:                                                           \
+                assert(0);                                                     \
+        }                                                                      \
+                                                                               \
+        status = zrGetRealTime(&end);                                          \
+        if (status != ZR_SUCCESS) {                                            \
+            goto handle_cleanup;                                               \
+        }                                                                      \
+                                                                               \
+        pResult->duration = end - start;                                       \
+        pResult->reallocCount = zrBenchCounters.reallocCount;                  \
+        pResult->bytesCopied = zrBenchCounters.bytesCopied;                    \
+                                                                               \
+    handle_cleanup:                                                            \
+        zrBenchDestroy##name(&handle);                                         \
+                                                                               \
+    exit:                                                                      \
+        return status;                                                         \
+    }
+
+#define ZR_BENCH_MAKE_ELEMENT(size)                                            \
+    typedef struct ZrBenchElement##size {                                      \
+        ZrUint32 data[size / 4];                                               \
+    } ZrBenchElement##size;                                                    \
+                                                                               \
+    ZR_BENCH_MAKE_ZERO_ARRAY(Zero##size, ZrBenchElement##size)                 \
+    ZR_BENCH_MAKE_RUNNER(Zero##size, ZrBenchElement##size *,                   \
+                         ZrBenchElement##size)                                 \
+    ZR_BENCH_MAKE_MANUAL_ARRAY(Manual##size, ZrBenchElement##size)             \
+    ZR_BENCH_MAKE_RUNNER(Manual##size, ZrBenchArrayManual##size,               \
+                         ZrBenchElement##size)
+
+ZR_BENCH_MAKE_ELEMENT(4)
+ZR_BENCH_MAKE_ELEMENT(16)
+ZR_BENCH_MAKE_ELEMENT(64)
+
+/*
+   The growth is expressed in percents. The library grows its capacity by
+   a fixed factor of 1.5, which the hand-written arrays are compared against
+   with both the same factor and the factor of 2 commonly used elsewhere.
+*/
+
+static const ZrBenchCase zrBenchCases[] = {
+    {"zero", 4, 150, zrBenchRunZero4},
+    {"manual", 4, 150, zrBenchRunManual4},
+    {"manual", 4, 200, zrBenchRunManual4},
+    {"zero", 16, 150, zrBenchRunZero16},
+    {"manual", 16, 150, zrBenchRunManual16},
+    {"manual", 16, 200, zrBenchRunManual16},
+    {"zero", 64, 150, zrBenchRunZero64},
+    {"manual", 64, 150, zrBenchRunManual64},
+    {"manual", 64, 200, zrBenchRunManual64},
+};
+
+static int
+zrBenchRunCase(const ZrBenchCase *pCase, ZrBenchOperation operation)
+{
+    ZrBenchResult result;
+    ZrUint64 bestDuration;
+    size_t count;
+    size_t i;
+
+    assert(pCase != NULL);
+
+    count = operation == ZR_BENCH_OPERATION_PUSH_FRONT
+                    || operation == ZR_BENCH_OPERATION_INSERT_RANDOM
+                    || operation == ZR_BENCH_OPERATION_TRIM_FRONT
+                    || operation == ZR_BENCH_OPERATION_TRIM_RANDOM
+                ? ZR_BENCH_QUADRATIC_COUNT
+                : ZR_BENCH_LINEAR_COUNT;
+
+    bestDuration = (ZrUint64)-1;
+    for (i = 0; i < ZR_BENCH_REPETITION_COUNT; ++i) {
+        if (pCase->pfnRun(&result, operation, count, pCase->growth)
+            != ZR_SUCCESS) {
+            fprintf(stderr,
+                    "could not run the benchmark '%s' for '%s'\n",
+                    zrBenchOperationNames[operation],
+                    pCase->pImplementation);
+            return 1;
+        }
+
+        if (result.duration < bestDuration) {
+            bestDuration = result.duration;
+        }
+    }
+
+    printf("  {\"operation\": \"%s\", \"implementation\": \"%s\", "
+           "\"elementSize\": %lu, \"growthFactor\": %.2f, \"count\": %lu, "
+           "\"nsPerOp\": %.3f, \"reallocCount\": %llu, "
+           "\"bytesCopied\": %llu, \"bytesMoved\": %llu, "
+           "\"peakRss\": %llu}",
+           zrBenchOperationNames[operation],
+           pCase->pImplementation,
+           (unsigned long)pCase->elementSize,
+           (double)pCase->growth / 100.0,
+           (unsigned long)count,
+           (double)bestDuration / (double)count,
+           (unsigned long long)result.reallocCount,
+           (unsigned long long)result.bytesCopied,
+           (unsigned long long)result.bytesMoved,
+           (unsigned long long)zrBenchGetPeakResidentSetSize());
+    return 0;
+}
+
+int
+main(void)
+{
+    int out;
+    int status;
+    pid_t pid;
+    size_t operation;
+    size_t i;
+
+    out = 0;
+
+    printf("[\n");
+    for (operation = 0; operation < ZR_BENCH_OPERATION_COUNT; ++operation) {
+        for (i = 0; i < sizeof zrBenchCases / sizeof zrBenchCases[0]; ++i) {
+            if (operation > 0 || i > 0) {
+                printf(",\n");
+            }
+
+            /* Isolate each case in its own process to measure its peak RSS. */
+            fflush(stdout);
+            pid = fork();
+            if (pid < 0) {
+                fprintf(stderr, "could not fork the process\n");
+                out = 1;
+                goto exit;
+            }
+
+            if (pid == 0) {
+                status = zrBenchRunCase(&zrBenchCases[i],
+                                        (ZrBenchOperation)operation);
+                fflush(stdout);
+                _exit(status);
+            }
+
+            if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)
+                || WEXITSTATUS(status) != 0) {
+                out = 1;
+            }
+        }
+    }
+
+    printf("\n]\n");
+
+exit:
+    return out;
+}
@@ -0,0 +1,398 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#define ZR_DEFINE_IMPLEMENTATION
+#include <zero/allocator.h>
+#include <zero/logger.h>
+#include <zero/timer.h>
+
+#define ZR_BENCH_REPETITION_COUNT 3
+#define ZR_BENCH_LINE_COUNT ((size_t)1 << 18)
+#define ZR_BENCH_MAX_THREAD_COUNT 64
+#define ZR_BENCH_PIPE_BUFFER_SIZE 65536
+
+typedef void (*ZrBenchLogFunction)(enum ZrLogLevel level,
+                                   const char *pFile,
+                                   int line,
+                                   const char *pFormat,
+                                   ...);
+
+typedef enum ZrBenchMode {
+    ZR_BENCH_MODE_SYNC = 0,
+    ZR_BENCH_MODE_ASYNC = 1,
+    ZR_BENCH_MODE_DEFERRED = 2
+} ZrBenchMode;
+
+typedef struct ZrBenchCase {
+    const char *pImplementation;
+    const char *pMode;
+    ZrBenchLogFunction pfnLog;
+    ZrBenchMode mode;
+} ZrBenchCase;
+
+typedef enum ZrBenchSinkType {
+    ZR_BENCH_SINK_TYPE_NULL = 0,
+    ZR_BENCH_SINK_TYPE_FILE = 1,
+    ZR_BENCH_SINK_TYPE_PIPE = 2
+} ZrBenchSinkType;
+
+typedef struct ZrBenchSink {
+    const char *pName;
+    ZrBenchSinkType type;
+} ZrBenchSink;
+
+typedef struct ZrBenchThread {
+    pthread_t thread;
+    ZrBenchLogFunction pfnLog;
+    size_t index;
+    size_t lineCount;
+    ZrUint64 *pLatencies;
+    int status;
+} ZrBenchThread;
+
+typedef struct ZrBenchResult {
+    ZrUint64 duration;
+    ZrUint64 p50;
+    ZrUint64 p99;
+    ZrUint64 p999;
+} ZrBenchResult;
+
+static const size_t zrBenchThreadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+static const ZrBenchSink zrBenchSinks[] = {
+    {"null", ZR_BENCH_SINK_TYPE_NULL},
+    {"file", ZR_BENCH_SINK_TYPE_FILE},
+    {"pipe", ZR_BENCH_SINK_TYPE_PIPE},
+};
+
+/*
+   The implementation that the logger had before writing each record with
+   a single system call, which emits the prefix and the message through two
+   separate stdio calls.
+*/
+static void
+zrBenchLogStdio(enum ZrLogLevel level,
+                const char *pFile,
+                int line,
+                const char *pFormat,
+                ...)
+{
+    va_list args;
+
+    (void)level;
+
+    va_start(args, pFormat);
+    fprintf(stderr, "%s:%d: %s%s%s: ", pFile, line, "", "info", "");
+    vfprintf(stderr, pFormat, args);
+    va_end(args);
+}
+
+static const ZrBenchCase zrBenchCases[] = {
+    {"zero", "sync", zrLog, ZR_BENCH_MODE_SYNC},
+    {"zero", "async", zrLog, ZR_BENCH_MODE_ASYNC},
+    {"zero", "deferred", zrLog, ZR_BENCH_MODE_DEFERRED},
+    {"stdio", "sync", zrBenchLogStdio, ZR_BENCH_MODE_SYNC},
+};
+
+static void *
+zrBenchDrainPipe(void *pArg)
+{
+    char buffer[ZR_BENCH_PIPE_BUFFER_SIZE];
+    int fd;
+
+    fd = *(int *)pArg;
+    while (read(fd, buffer, sizeof buffer) > 0) {
+    }
+
+    return NULL;
+}
+
+static void *
+zrBenchRunThread(void *pArg)
+{
+    ZrBenchThread *pThread;
+    ZrUint64 start;
+    ZrUint64 end;
+    size_t i;
+
+    pThread = (ZrBenchThread *)pArg;
+    start = 0;
+    end = 0;
+    for (i = 0; i < pThread->lineCount; ++i) {
+        if (pThread->pLatencies != NULL
+            && zrGetRealTime(&start) != ZR_SUCCESS) {
+            pThread->status = 1;
+            return NULL;
+        }
+
+        pThread->pfnLog(ZR_LOG_LEVEL_INFO,
+                        __FILE__,
+                        __LINE__,
+                        "thread %lu wrote line %lu with value %f\n",
+                        (unsigned long)pThread->index,
+                        (unsigned long)i,
+                        (double)i * 0.5);
+
+        if (pThread->pLatencies != NULL) {
+            if (zrGetRealTime(&end) != ZR_SUCCESS) {
+                pThread->status = 1;
+                return NULL;
+            }
+
+            pThread->pLatencies[i] = end - start;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+   Run the given case, either without any instrumentation to measure the
+   throughput, or while timing each call on its own to measure the latencies.
+   In the asynchronous modes, the measured duration includes stopping the
+   background thread, so that every record has been written out.
+*/
+static int
+zrBenchRunCase(ZrUint64 *pDuration,
+               ZrUint64 *pLatencies,
+               const ZrBenchCase *pCase,
+               size_t threadCount)
+{
+    ZrBenchThread threads[ZR_BENCH_MAX_THREAD_COUNT];
+    struct ZrAsyncLoggerOptions options;
+    ZrUint64 start;
+    ZrUint64 end;
+    size_t lineCount;
+    size_t i;
+    int status;
+
+    assert(pDuration != NULL);
+    assert(pCase != NULL);
+    assert(threadCount <= ZR_BENCH_MAX_THREAD_COUNT);
+
+    if (zrGetRealTime(&start) != ZR_SUCCESS) {
+        return 1;
+    }
+
+    if (pCase->mode != ZR_BENCH_MODE_SYNC) {
+        memset(&options, 0, sizeof options);
+        options.deferFormatting = pCase->mode == ZR_BENCH_MODE_DEFERRED;
+        if (zrLoggerStartAsync(&options) != ZR_SUCCESS) {
+            return 1;
+        }
+    }
+
+    lineCount = ZR_BENCH_LINE_COUNT / threadCount;
+    for (i = 0; i < threadCount; ++i) {
+        threads[i].pfnLog = pCase->pfnLog;
+        threads[i].index = i;
+        threads[i].lineCount = lineCount;
+        threads[i].pLatencies
+            = pLatencies != NULL ? &pLatencies[i * lineCount] : NULL;
+        threads[i].status = 0;
+        if (pthread_create(
+                &threads[i].thread, NULL, zrBenchRunThread, &threads[i])
+            != 0) {
+            threadCount = i;
+            break;
+        }
+    }
+
+    status = 0;
+    for (i = 0; i < threadCount; ++i) {
+        pthread_join(threads[i].thread, NULL);
+        status |= threads[i].status;
+    }
+
+    if (pCase->mode != ZR_BENCH_MODE_SYNC) {
+        zrLoggerStopAsync();
+    }
+
+    if (status || zrGetRealTime(&end) != ZR_SUCCESS) {
+        return 1;
+    }
+
+    *pDuration = end - start;
+    return 0;
+}
+
+static int
+zrBenchCompareLatencies(const void *pA, const void *pB)
+{
+    ZrUint64 a;
+    ZrUint64 b;
+
+    a = *(const ZrUint64 *)pA;
+    b = *(const ZrUint64 *)pB;
+    return (a > b) - (a < b);
+}
+
+static int
+zrBenchMeasure(ZrBenchResult *pResult,
+               ZrUint64 *pLatencies,
+               const ZrBenchCase *pCase,
+               size_t threadCount)
+{
+    ZrUint64 duration;
+    size_t count;
+    size_t i;
+
+    assert(pResult != NULL);
+    assert(pLatencies != NULL);
+
+    pResult->duration = (ZrUint64)-1;
+    for (i = 0; i < ZR_BENCH_REPETITION_COUNT; ++i) {
+        if (zrBenchRunCase(&duration, NULL, pCase, threadCount)) {
+            return 1;
+        }
+
+        if (duration < pResult->duration) {
+            pResult->duration = duration;
+        }
+    }
+
+    if (zrBenchRunCase(&duration, pLatencies, pCase, threadCount)) {
+        return 1;
+    }
+
+    count = ZR_BENCH_LINE_COUNT / threadCount * threadCount;
+    qsort(pLatencies, count, sizeof *pLatencies, zrBenchCompareLatencies);
+    pResult->p50 = pLatencies[count * 500 / 1000];
+    pResult->p99 = pLatencies[count * 990 / 1000];
+    pResult->p999 = pLatencies[count * 999 / 1000];
+    return 0;
+}
+
+/* Redirect the standard error stream, where the records go, to the sink. */
+static int
+zrBenchOpenSink(int *pPipe, const ZrBenchSink *pSink, const char *pPath)
+{
+    int fd;
+
+    switch (pSink->type) {
+        case ZR_BENCH_SINK_TYPE_NULL:
+            fd = open("/dev/null", O_WRONLY);
+            break;
+        case ZR_BENCH_SINK_TYPE_FILE:
+            fd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            break;
+        case ZR_BENCH_SINK_TYPE_PIPE:
+            fd = pPipe[1];
+            break;
+        default:
+            assert(0);
+            return 1;
+    }
+
+    if (fd < 0 || dup2(fd, STDERR_FILENO) < 0) {
+        fprintf(stdout, "could not open the '%s' sink\n", pSink->pName);
+        return 1;
+    }
+
+    if (pSink->type != ZR_BENCH_SINK_TYPE_PIPE) {
+        close(fd);
+    }
+
+    return 0;
+}
+
+/* Measure every case and thread count against the given sink. */
+static int
+zrBenchRunSink(int *pFirst,
+               ZrUint64 *pLatencies,
+               const ZrBenchSink *pSink)
+{
+    ZrBenchResult result;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < sizeof zrBenchThreadCounts / sizeof zrBenchThreadCounts[0];
+         ++i) {
+        for (j = 0; j < sizeof zrBenchCases / sizeof zrBenchCases[0]; ++j) {
+            if (zrBenchMeasure(&result,
+                               pLatencies,
+                               &zrBenchCases[j],
+                               zrBenchThreadCounts[i])) {
+                return 1;
+            }
+
+            printf("%s  {\"implementation\": \"%s\", \"mode\": \"%s\", "
+                   "\"sink\": \"%s\", \"threadCount\": %lu, "
+                   "\"lineCount\": %lu, \"linesPerSecond\": %.0f, "
+                   "\"p50Ns\": %lu, \"p99Ns\": %lu, \"p999Ns\": %lu}",
+                   *pFirst ? "" : ",\n",
+                   zrBenchCases[j].pImplementation,
+                   zrBenchCases[j].pMode,
+                   pSink->pName,
+                   (unsigned long)zrBenchThreadCounts[i],
+                   (unsigned long)ZR_BENCH_LINE_COUNT,
+                   (double)ZR_BENCH_LINE_COUNT * 1e9 / (double)result.duration,
+                   (unsigned long)result.p50,
+                   (unsigned long)result.p99,
+                   (unsigned long)result.p999);
+            fflush(stdout);
+            *pFirst = 0;
+        }
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *pPath;
+    ZrUint64 *pLatencies;
+    pthread_t drainThread;
+    int pipeFds[2];
+    int status;
+    int first;
+    size_t i;
+
+    /* The file sink writes to the given path, removed once done. */
+    pPath = argc > 1 ? argv[1] : "bench-logger.log";
+
+    pLatencies = (ZrUint64 *)malloc(ZR_BENCH_LINE_COUNT * sizeof *pLatencies);
+    if (pLatencies == NULL) {
+        fprintf(stdout, "could not allocate the latencies\n");
+        return 1;
+    }
+
+    if (pipe(pipeFds) != 0
+        || pthread_create(&drainThread, NULL, zrBenchDrainPipe, &pipeFds[0])
+               != 0) {
+        fprintf(stdout, "could not create the pipe\n");
+        free(pLatencies);
+        return 1;
+    }
+
+    status = 0;
+    first = 1;
+    printf("[\n");
+    for (i = 0; i < sizeof zrBenchSinks / sizeof zrBenchSinks[0] && !status;
+         ++i) {
+        status = zrBenchOpenSink(pipeFds, &zrBenchSinks[i], pPath)
+                 || zrBenchRunSink(&first, pLatencies, &zrBenchSinks[i]);
+    }
+
+    printf("\n]\n");
+
+    /* Closing every write end of the pipe lets the drain thread finish. */
+    close(STDERR_FILENO);
+    close(pipeFds[1]);
+    pthread_join(drainThread, NULL);
+    close(pipeFds[0]);
+    remove(pPath);
+    free(pLatencies);
+    return status;
+}
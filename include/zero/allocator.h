@@ -324,135 +324,507 @@ enum ZrLogLevel {
 #define ZRP_LOGGER_LOG_STYLING 0
 #endif
 
-#if ZRP_LOGGER_LOG_STYLING
-enum ZrpLoggerStyle {
-    ZRP_LOGGER_STYLE_RESET = 0,
-    ZRP_LOGGER_STYLE_BLACK = 1,
-    ZRP_LOGGER_STYLE_RED = 2,
-    ZRP_LOGGER_STYLE_GREEN = 3,
-    ZRP_LOGGER_STYLE_YELLOW = 4,
-    ZRP_LOGGER_STYLE_BLUE = 5,
-    ZRP_LOGGER_STYLE_MAGENTA = 6,
-    ZRP_LOGGER_STYLE_CYAN = 7,
-    ZRP_LOGGER_STYLE_BRIGHT_BLACK = 8,
-    ZRP_LOGGER_STYLE_BRIGHT_RED = 9,
-    ZRP_LOGGER_STYLE_BRIGHT_GREEN = 10,
-    ZRP_LOGGER_STYLE_BRIGHT_YELLOW = 11,
-    ZRP_LOGGER_STYLE_BRIGHT_BLUE = 12,
-    ZRP_LOGGER_STYLE_BRIGHT_MAGENTA = 13,
-    ZRP_LOGGER_STYLE_BRIGHT_CYAN = 14
+#if defined(ZR_ENABLE_LOG_TIMESTAMPS)
+#define ZRP_LOGGER_LOG_TIMESTAMPS 1
+#else
+#define ZRP_LOGGER_LOG_TIMESTAMPS 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_THREAD_IDS)
+#define ZRP_LOGGER_LOG_THREAD_IDS 1
+#else
+#define ZRP_LOGGER_LOG_THREAD_IDS 0
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_LOGGER_USE_CLOCK_GETTIME
+#else
+#include <sys/time.h>
+#endif
+#if defined(ZRP_PLATFORM_LINUX)
+#include <unistd.h>
+#if defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE)
+#include <sys/syscall.h>
+#if defined(SYS_gettid)
+#define ZRP_LOGGER_USE_GETTID
+#endif
+#endif
+#endif
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(va_copy) && defined(__va_copy)
+#define va_copy __va_copy
+#endif
+
+/*
+   `vsnprintf()` only appeared with C99 and C++11, C89 builds write the prefix
+   and the message of each record with separate calls instead.
+*/
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)                 \
+    || (defined(__cplusplus) && __cplusplus >= 201103L)                        \
+    || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)                \
+    || (defined(__GNUC__) && !defined(__STRICT_ANSI__))                        \
+    || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define ZRP_LOGGER_USE_VSNPRINTF
+#endif
+
+#if defined(_MSC_VER)
+#define ZRP_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define ZRP_LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Size of `YYYY-MM-DDTHH:MM:SS`. */
+#define ZRP_LOGGER_DATE_TIME_SIZE 19
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.mmmZ `. */
+#define ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 6)
+
+/* Records fitting into this size are written with a single call. */
+#define ZRP_LOGGER_LINE_BUFFER_SIZE 512
+
+struct ZrpLoggerLabel {
+    const char *pString;
+    size_t size;
 };
+
+#define ZRP_LOGGER_MAKE_LABEL(string)                                          \
+    {                                                                          \
+        string, sizeof string - 1                                              \
+    }
+
+/*
+   The level part of the prefixes, including the ANSI style codes when
+   styling, indexed by level.
+*/
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel zrpLoggerLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("error: "),
+       ZRP_LOGGER_MAKE_LABEL("warning: "),
+       ZRP_LOGGER_MAKE_LABEL("info: "),
+       ZRP_LOGGER_MAKE_LABEL("trace: "),
+       ZRP_LOGGER_MAKE_LABEL("debug: ")};
+
+#if ZRP_LOGGER_LOG_STYLING
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel
+    zrpLoggerStyledLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("\x1b[1;31merror\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;33mwarning\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;32minfo\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;36mtrace\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;35mdebug\x1b[0m: ")};
+
+/*
+   Whether the standard error stream is a terminal, detected on the first
+   record rather than on each one, or -1 if not detected yet. Concurrent
+   detections store the same value.
+*/
+static int zrpLoggerStderrStyled = -1;
 #endif /* ZRP_LOGGER_LOG_STYLING */
 
-static void
-zrpLoggerGetLogLevelName(const char **ppName, enum ZrLogLevel level)
+ZRP_MAYBE_UNUSED static int
+zrpLoggerIsStderrStyled(void)
 {
-    ZR_ASSERT(ppName != NULL);
-
-    switch (level) {
-        case ZR_LOG_LEVEL_ERROR:
-            *ppName = "error";
-            return;
-        case ZR_LOG_LEVEL_WARNING:
-            *ppName = "warning";
-            return;
-        case ZR_LOG_LEVEL_INFO:
-            *ppName = "info";
-            return;
-        case ZR_LOG_LEVEL_TRACE:
-            *ppName = "trace";
-            return;
-        case ZR_LOG_LEVEL_DEBUG:
-            *ppName = "debug";
-            return;
-        default:
-            ZR_ASSERT(0);
+#if ZRP_LOGGER_LOG_STYLING
+    int styled;
+
+#if defined(__GNUC__)
+    styled = __atomic_load_n(&zrpLoggerStderrStyled, __ATOMIC_RELAXED);
+#else
+    styled = *(volatile int *)&zrpLoggerStderrStyled;
+#endif
+    if (styled < 0) {
+        styled = isatty(STDERR_FILENO) ? 1 : 0;
+#if defined(__GNUC__)
+        __atomic_store_n(&zrpLoggerStderrStyled, styled, __ATOMIC_RELAXED);
+#else
+        *(volatile int *)&zrpLoggerStderrStyled = styled;
+#endif
     }
+
+    return styled;
+#else
+    return 0;
+#endif /* ZRP_LOGGER_LOG_STYLING */
 }
 
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel *
+zrpLoggerGetLevelLabel(int styled, enum ZrLogLevel level)
+{
+    ZR_ASSERT((int)level >= (int)ZR_LOG_LEVEL_ERROR
+              && (int)level <= (int)ZR_LOG_LEVEL_DEBUG);
+
 #if ZRP_LOGGER_LOG_STYLING
-static void
-zrpLoggerGetLogLevelStyle(enum ZrpLoggerStyle *pStyle, enum ZrLogLevel level)
+    if (styled) {
+        return &zrpLoggerStyledLevelLabels[level];
+    }
+#else
+    (void)styled;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+    return &zrpLoggerLevelLabels[level];
+}
+
+/* Copy data at the given offset, as much as the buffer can hold. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerCopy(char *pBuffer,
+              size_t size,
+              size_t *pOffset,
+              const char *pData,
+              size_t dataSize)
 {
-    ZR_ASSERT(pStyle != NULL);
-
-    switch (level) {
-        case ZR_LOG_LEVEL_ERROR:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_RED;
-            return;
-        case ZR_LOG_LEVEL_WARNING:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_YELLOW;
-            return;
-        case ZR_LOG_LEVEL_INFO:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_GREEN;
-            return;
-        case ZR_LOG_LEVEL_TRACE:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_CYAN;
-            return;
-        case ZR_LOG_LEVEL_DEBUG:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_MAGENTA;
-            return;
-        default:
-            ZR_ASSERT(0);
-    };
+    size_t copySize;
+
+    if (*pOffset < size) {
+        copySize = size - *pOffset;
+        if (copySize > dataSize) {
+            copySize = dataSize;
+        }
+
+        memcpy(&pBuffer[*pOffset], pData, copySize);
+    }
+
+    *pOffset += dataSize;
 }
 
-static void
-zrpLoggerGetStyleAnsiCode(const char **ppCode, enum ZrpLoggerStyle style)
+/*
+   Where and when a record was logged, captured by the logging thread since
+   the formatting may happen on another one. The fields are only set when
+   the prefixes include them.
+*/
+struct ZrpLoggerOrigin {
+    ZrUint64 time;
+    unsigned long threadId;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteDigits(char *pBuffer, ZrUint64 value, size_t count)
 {
-    ZR_ASSERT(ppCode != NULL);
-
-    switch (style) {
-        case ZRP_LOGGER_STYLE_RESET:
-            *ppCode = "\x1b[0m";
-            return;
-        case ZRP_LOGGER_STYLE_BLACK:
-            *ppCode = "\x1b[30m";
-            return;
-        case ZRP_LOGGER_STYLE_RED:
-            *ppCode = "\x1b[31m";
-            return;
-        case ZRP_LOGGER_STYLE_GREEN:
-            *ppCode = "\x1b[32m";
-            return;
-        case ZRP_LOGGER_STYLE_YELLOW:
-            *ppCode = "\x1b[33m";
-            return;
-        case ZRP_LOGGER_STYLE_BLUE:
-            *ppCode = "\x1b[34m";
-            return;
-        case ZRP_LOGGER_STYLE_MAGENTA:
-            *ppCode = "\x1b[35m";
-            return;
-        case ZRP_LOGGER_STYLE_CYAN:
-            *ppCode = "\x1b[36m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_BLACK:
-            *ppCode = "\x1b[1;30m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_RED:
-            *ppCode = "\x1b[1;31m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_GREEN:
-            *ppCode = "\x1b[1;32m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_YELLOW:
-            *ppCode = "\x1b[1;33m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_BLUE:
-            *ppCode = "\x1b[1;34m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_MAGENTA:
-            *ppCode = "\x1b[1;35m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_CYAN:
-            *ppCode = "\x1b[1;36m";
-            return;
-        default:
-            ZR_ASSERT(0);
+    while (count-- > 0) {
+        pBuffer[count] = (char)('0' + value % 10);
+        value /= 10;
     }
 }
-#endif /* ZRP_LOGGER_LOG_STYLING */
+
+/*
+   Time in milliseconds since the epoch, read from a coarse clock when there
+   is one since a tick per millisecond or so is enough for prefixes.
+*/
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpLoggerGetCoarseTime(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    FILETIME time;
+
+    /* Intervals of 100 nanoseconds since 1601-01-01. */
+    GetSystemTimeAsFileTime(&time);
+    return ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+            - 116444736000000000ull)
+           / 10000;
+#elif defined(ZRP_LOGGER_USE_CLOCK_GETTIME)
+    struct timespec time;
+
+#if defined(CLOCK_REALTIME_COARSE)
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &time) != 0) {
+        return 0;
+    }
+#else
+    if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+        return 0;
+    }
+#endif
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+#elif defined(ZRP_PLATFORM_UNIX)
+    struct timeval time;
+
+    if (gettimeofday(&time, NULL) != 0) {
+        return 0;
+    }
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_usec / 1000;
+#else
+    return 0;
+#endif
+}
+
+/*
+   Format the UTC date and time of a number of seconds since the epoch as
+   `YYYY-MM-DDTHH:MM:SS`, which is cached per thread since it only changes
+   once per second.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatDateTime(char *pBuffer, ZrUint64 seconds)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedSeconds;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedDateTime[ZRP_LOGGER_DATE_TIME_SIZE];
+#endif
+    ZrUint64 days;
+    ZrUint64 era;
+    ZrUint64 dayOfEra;
+    ZrUint64 yearOfEra;
+    ZrUint64 dayOfYear;
+    ZrUint64 shiftedMonth;
+    ZrUint64 month;
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    if (seconds + 1 == cachedSeconds) {
+        memcpy(pBuffer, cachedDateTime, ZRP_LOGGER_DATE_TIME_SIZE);
+        return;
+    }
+#endif
+
+    /* Civil date from the days since 1970-01-01, in eras of 400 years. */
+    days = seconds / 86400 + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                 - dayOfEra / 146096)
+                / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+
+    zrpLoggerWriteDigits(
+        &pBuffer[0], yearOfEra + era * 400 + (month <= 2 ? 1 : 0), 4);
+    pBuffer[4] = '-';
+    zrpLoggerWriteDigits(&pBuffer[5], month, 2);
+    pBuffer[7] = '-';
+    zrpLoggerWriteDigits(
+        &pBuffer[8], dayOfYear - (153 * shiftedMonth + 2) / 5 + 1, 2);
+    pBuffer[10] = 'T';
+    zrpLoggerWriteDigits(&pBuffer[11], seconds % 86400 / 3600, 2);
+    pBuffer[13] = ':';
+    zrpLoggerWriteDigits(&pBuffer[14], seconds % 3600 / 60, 2);
+    pBuffer[16] = ':';
+    zrpLoggerWriteDigits(&pBuffer[17], seconds % 60, 2);
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    /* Offset by one to not match the zero-initialized cache. */
+    cachedSeconds = seconds + 1;
+    memcpy(cachedDateTime, pBuffer, ZRP_LOGGER_DATE_TIME_SIZE);
+#endif
+}
+
+/*
+   Format a time in milliseconds since the epoch as it appears in prefixes,
+   reusing the previous result of the thread while the coarse clock doesn't
+   tick, which is common at high logging rates.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatPrefixTimestamp(char *pBuffer, ZrUint64 time)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedTime;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedTimestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+
+    if (time + 1 == cachedTime) {
+        memcpy(pBuffer, cachedTimestamp, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+        return;
+    }
+#endif
+
+    zrpLoggerFormatDateTime(pBuffer, time / 1000);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time % 1000, 3);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 4] = 'Z';
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 5] = ' ';
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    cachedTime = time + 1;
+    memcpy(cachedTimestamp, pBuffer, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+#endif
+}
+
+/*
+   Identifier of the calling thread, as known by the system when it can be
+   retrieved, or otherwise as assigned in the order the threads first ask
+   for it. On Linux, `syscall()` is only declared with `_DEFAULT_SOURCE` or
+   `_GNU_SOURCE`, so strict C99 builds get the latter.
+*/
+ZRP_MAYBE_UNUSED static unsigned long
+zrpLoggerGetThreadId(void)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL unsigned long threadId;
+
+    if (threadId != 0) {
+        return threadId;
+    }
+#else
+    unsigned long threadId;
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    threadId = (unsigned long)GetCurrentThreadId();
+#elif defined(ZRP_LOGGER_USE_GETTID)
+    threadId = (unsigned long)syscall(SYS_gettid);
+#else
+    {
+        static unsigned long threadCount;
+
+#if defined(__GNUC__)
+        threadId = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+#else
+        threadId = ++threadCount;
+#endif
+    }
+#endif
+
+    return threadId;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerGetOrigin(struct ZrpLoggerOrigin *pOrigin)
+{
+    ZR_ASSERT(pOrigin != NULL);
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    pOrigin->time = zrpLoggerGetCoarseTime();
+#else
+    pOrigin->time = 0;
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    pOrigin->threadId = zrpLoggerGetThreadId();
+#else
+    pOrigin->threadId = 0;
+#endif
+}
+
+/*
+   Format the prefix of a record into the given buffer, truncating it if
+   needed, and return the size that it requires, not counting the terminating
+   null character.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatPrefix(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line)
+{
+    const struct ZrpLoggerLabel *pLabel;
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    char timestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+#endif
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    char threadId[24];
+    size_t threadIdOffset;
+    unsigned long threadIdValue;
+#endif
+    char digits[16];
+    size_t digitCount;
+    size_t offset;
+    unsigned int value;
+
+    ZR_ASSERT(pBuffer != NULL || size == 0);
+    ZR_ASSERT(pOrigin != NULL);
+    ZR_ASSERT(pFile != NULL);
+
+    (void)pOrigin;
+    offset = 0;
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    zrpLoggerFormatPrefixTimestamp(timestamp, pOrigin->time);
+    zrpLoggerCopy(pBuffer, size, &offset, timestamp, sizeof timestamp);
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    threadIdValue = pOrigin->threadId;
+    threadIdOffset = sizeof threadId;
+    threadId[--threadIdOffset] = ' ';
+    threadId[--threadIdOffset] = ']';
+    do {
+        threadId[--threadIdOffset] = (char)('0' + threadIdValue % 10);
+        threadIdValue /= 10;
+    } while (threadIdValue > 0);
+
+    threadId[--threadIdOffset] = '[';
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &threadId[threadIdOffset],
+                  sizeof threadId - threadIdOffset);
+#endif
+
+    value = line < 0 ? 0u - (unsigned int)line : (unsigned int)line;
+    digitCount = sizeof digits;
+    do {
+        digits[--digitCount] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (line < 0) {
+        digits[--digitCount] = '-';
+    }
+
+    pLabel = zrpLoggerGetLevelLabel(styled, level);
+
+    zrpLoggerCopy(pBuffer, size, &offset, pFile, strlen(pFile));
+    zrpLoggerCopy(pBuffer, size, &offset, ":", 1);
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &digits[digitCount],
+                  sizeof digits - digitCount);
+    zrpLoggerCopy(pBuffer, size, &offset, ": ", 2);
+    zrpLoggerCopy(pBuffer, size, &offset, pLabel->pString, pLabel->size);
+
+    if (size > 0) {
+        pBuffer[offset < size ? offset : size - 1] = '\0';
+    }
+
+    return offset;
+}
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+/* Same as `zrpLoggerFormatPrefix()` but for a whole record. */
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatVaList(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    size_t prefixSize;
+    int messageSize;
+
+    ZR_ASSERT(pFormat != NULL);
+
+    prefixSize = zrpLoggerFormatPrefix(
+        pBuffer, size, styled, level, pOrigin, pFile, line);
+    if (prefixSize < size) {
+        messageSize = vsnprintf(
+            &pBuffer[prefixSize], size - prefixSize, pFormat, args);
+    } else {
+        messageSize = vsnprintf(NULL, 0, pFormat, args);
+    }
+
+    if (messageSize < 0) {
+        return prefixSize;
+    }
+
+    return prefixSize + (size_t)messageSize;
+}
+#endif /* ZRP_LOGGER_USE_VSNPRINTF */
 
 ZRP_MAYBE_UNUSED static void
 zrpLoggerLogVaList(enum ZrLogLevel level,
@@ -461,37 +833,55 @@ zrpLoggerLogVaList(enum ZrLogLevel level,
                    const char *pFormat,
                    va_list args)
 {
-    const char *pLevelName;
-    const char *pLevelStyleStart;
-    const char *pLevelStyleEnd;
+    char buffer[ZRP_LOGGER_LINE_BUFFER_SIZE];
+    struct ZrpLoggerOrigin origin;
+    const struct ZrpLoggerLabel *pLabel;
+    size_t size;
+    int styled;
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_list argsCopy;
+#endif
 
     ZR_ASSERT(pFile != NULL);
     ZR_ASSERT(pFormat != NULL);
 
-    zrpLoggerGetLogLevelName(&pLevelName, level);
-
-#if ZRP_LOGGER_LOG_STYLING
-    if (isatty(fileno(stderr))) {
-        enum ZrpLoggerStyle levelStyle;
+    styled = zrpLoggerIsStderrStyled();
+    zrpLoggerGetOrigin(&origin);
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_copy(argsCopy, args);
+    size = zrpLoggerFormatVaList(buffer,
+                                 sizeof buffer,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+        va_end(argsCopy);
+        return;
+    }
+#endif
 
-        zrpLoggerGetLogLevelStyle(&levelStyle, level);
-        zrpLoggerGetStyleAnsiCode(&pLevelStyleStart, levelStyle);
-        zrpLoggerGetStyleAnsiCode(&pLevelStyleEnd, ZRP_LOGGER_STYLE_RESET);
+    /* Too large for the buffer, write the prefix and message apart. */
+    size = zrpLoggerFormatPrefix(
+        buffer, sizeof buffer, styled, level, &origin, pFile, line);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
     } else {
-        pLevelStyleStart = pLevelStyleEnd = "";
+        pLabel = zrpLoggerGetLevelLabel(styled, level);
+        fprintf(stderr, "%s:%d: %s", pFile, line, pLabel->pString);
     }
-#else
-    pLevelStyleStart = pLevelStyleEnd = "";
-#endif /* ZRP_LOGGER_LOG_STYLING */
 
-    fprintf(stderr,
-            "%s:%d: %s%s%s: ",
-            pFile,
-            line,
-            pLevelStyleStart,
-            pLevelName,
-            pLevelStyleEnd);
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    vfprintf(stderr, pFormat, argsCopy);
+    va_end(argsCopy);
+#else
     vfprintf(stderr, pFormat, args);
+#endif
 }
 
 ZRP_MAYBE_UNUSED static void
@@ -0,0 +1,1635 @@
+/*
+   The MIT License (MIT)
+
+   Copyright (c) 2018 Christopher Crouzet
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+   THE SOFTWARE.
+*/
+
+#ifndef ZERO_HASHMAP_H
+#define ZERO_HASHMAP_H
+
+#define ZR_HASHMAP_MAJOR_VERSION 0
+#define ZR_HASHMAP_MINOR_VERSION 1
+#define ZR_HASHMAP_PATCH_VERSION 0
+
+#ifndef ZRP_ARCH_DEFINED
+#define ZRP_ARCH_DEFINED
+#if defined(__x86_64__) || defined(_M_X64)
+#define ZRP_ARCH_X86_64
+#elif defined(__i386) || defined(_M_IX86)
+#define ZRP_ARCH_X86_32
+#elif defined(__itanium__) || defined(_M_IA64)
+#define ZRP_ARCH_ITANIUM_64
+#elif defined(__powerpc64__) || defined(__ppc64__)
+#define ZRP_ARCH_POWERPC_64
+#elif defined(__powerpc__) || defined(__ppc__)
+#define ZRP_ARCH_POWERPC_32
+#elif defined(__aarch64__)
+#define ZRP_ARCH_ARM_64
+#elif defined(__arm__)
+#define ZRP_ARCH_ARM_32
+#endif
+#endif /* ZRP_ARCH_DEFINED */
+
+/*
+   The environment macro represents whether the code is to be generated for a
+   32-bit or 64-bit target platform. Some CPUs, such as the x86-64 processors,
+   allow running code in 32-bit mode if compiled using the -m32 or -mx32
+   compiler switches, in which case `ZR_ENVIRONMENT` is set to 32.
+*/
+#ifndef ZR_ENVIRONMENT
+#if (!defined(ZRP_ARCH_X86_64) || defined(__ILP32__))                          \
+    && !defined(ZRP_ARCH_ITANIUM_64) && !defined(ZRP_ARCH_POWERPC_64)          \
+    && !defined(ZRP_ARCH_ARM_64)
+#define ZR_ENVIRONMENT 32
+#else
+#define ZR_ENVIRONMENT 64
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_environment_value
+    [ZR_ENVIRONMENT == 32 || ZR_ENVIRONMENT == 64 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZR_ENVIRONMENT */
+
+#ifndef ZRP_PLATFORM_DEFINED
+#define ZRP_PLATFORM_DEFINED
+#if defined(_WIN32)
+#define ZRP_PLATFORM_WINDOWS
+#elif defined(__unix__) || defined(__APPLE__)
+#define ZRP_PLATFORM_UNIX
+#if defined(__APPLE__)
+#define ZRP_PLATFORM_DARWIN
+#if TARGET_OS_IPHONE == 1
+#define ZRP_PLATFORM_IOS
+#elif TARGET_OS_MAC == 1
+#define ZRP_PLATFORM_MACOS
+#endif
+#elif defined(__linux__)
+#define ZRP_PLATFORM_LINUX
+#endif
+#endif
+#endif /* ZRP_PLATFORM_DEFINED */
+
+#ifndef ZRP_FIXED_TYPES_DEFINED
+#define ZRP_FIXED_TYPES_DEFINED
+#ifdef ZR_USE_STD_FIXED_TYPES
+#include <stdint.h>
+typedef int8_t ZrInt8;
+typedef uint8_t ZrUint8;
+typedef int16_t ZrInt16;
+typedef uint16_t ZrUint16;
+typedef int32_t ZrInt32;
+typedef uint32_t ZrUint32;
+typedef int64_t ZrInt64;
+typedef uint64_t ZrUint64;
+#else
+/*
+   The focus here is on the common data models, that is ILP32 (most recent
+   32-bit systems), LP64 (Unix-like systems), and LLP64 (Windows). All of these
+   models have the `char` type set to 8 bits, `short` to 16 bits, `int` to
+   32 bits, and `long long` to 64 bits.
+*/
+#ifdef ZR_INT8
+typedef ZR_INT8 ZrInt8;
+#else
+typedef char ZrInt8;
+#endif
+#ifdef ZR_UINT8
+typedef ZR_UINT8 ZrUint8;
+#else
+typedef unsigned char ZrUint8;
+#endif
+#ifdef ZR_INT16
+typedef ZR_INT16 ZrInt16;
+#else
+typedef short ZrInt16;
+#endif
+#ifdef ZR_UINT16
+typedef ZR_UINT16 ZrUint16;
+#else
+typedef unsigned short ZrUint16;
+#endif
+#ifdef ZR_INT32
+typedef ZR_INT32 ZrInt32;
+#else
+typedef int ZrInt32;
+#endif
+#ifdef ZR_UINT32
+typedef ZR_UINT32 ZrUint32;
+#else
+typedef unsigned int ZrUint32;
+#endif
+#ifdef ZR_INT64
+typedef ZR_INT64 ZrInt64;
+#else
+typedef long long ZrInt64;
+#endif
+#ifdef ZR_UINT64
+typedef ZR_UINT64 ZrUint64;
+#else
+typedef unsigned long long ZrUint64;
+#endif
+#endif /* ZR_USE_STD_FIXED_TYPES */
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_int8_type[sizeof(ZrInt8) == 1 ? 1 : -1];
+typedef char zrp_invalid_uint8_type[sizeof(ZrUint8) == 1 ? 1 : -1];
+typedef char zrp_invalid_int16_type[sizeof(ZrInt16) == 2 ? 1 : -1];
+typedef char zrp_invalid_uint16_type[sizeof(ZrUint16) == 2 ? 1 : -1];
+typedef char zrp_invalid_int32_type[sizeof(ZrInt32) == 4 ? 1 : -1];
+typedef char zrp_invalid_uint32_type[sizeof(ZrUint32) == 4 ? 1 : -1];
+typedef char zrp_invalid_int64_type[sizeof(ZrInt64) == 8 ? 1 : -1];
+typedef char zrp_invalid_uint64_type[sizeof(ZrUint64) == 8 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_FIXED_TYPES_DEFINED */
+
+#ifndef ZRP_BASIC_TYPES_DEFINED
+#define ZRP_BASIC_TYPES_DEFINED
+#ifdef ZR_USE_STD_BASIC_TYPES
+#include <stddef.h>
+typedef size_t ZrSize;
+#else
+/*
+   The C standard provides no guarantees about the size of the type `size_t`,
+   and some exotic platforms will in fact provide original values, but this
+   should cover most of the use cases.
+*/
+#ifdef ZR_SIZE_TYPE
+typedef ZR_SIZE_TYPE ZrSize;
+#elif ZR_ENVIRONMENT == 32
+typedef ZrUint32 ZrSize;
+#else
+typedef ZrUint64 ZrSize;
+#endif
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char
+    zrp_invalid_size_type[sizeof(ZrSize) == sizeof sizeof(void *) ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_BASIC_TYPES_DEFINED */
+
+#ifndef ZRP_STATUS_DEFINED
+#define ZRP_STATUS_DEFINED
+enum ZrStatus {
+    ZR_SUCCESS = 0,
+    ZR_ERROR = -1,
+    ZR_ERROR_ALLOCATION = -2,
+    ZR_ERROR_MAX_SIZE_EXCEEDED = -3
+};
+#endif /* ZRP_STATUS_DEFINED */
+
+#if defined(ZR_HASHMAP_SPECIFY_INTERNAL_LINKAGE)                               \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_HASHMAP_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_HASHMAP_LINKAGE extern "C"
+#else
+#define ZRP_HASHMAP_LINKAGE extern
+#endif
+
+struct ZrHashMap;
+
+#define ZRP_HASHMAP_DECLARE_CREATE_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrCreate##name(struct ZrHashMap **ppMap, \
+                                                     ZrSize size)
+
+#define ZRP_HASHMAP_DECLARE_DESTROY_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE void zrDestroy##name(struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_GET_SIZE_FUNCTION(name, key, value)                \
+    ZRP_HASHMAP_LINKAGE void zrGet##name##Size(ZrSize *pSize,                  \
+                                               const struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_GET_CAPACITY_FUNCTION(name, key, value)            \
+    ZRP_HASHMAP_LINKAGE void zrGet##name##Capacity(                            \
+        ZrSize *pCapacity, const struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_RESERVE_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrReserve##name(struct ZrHashMap *pMap,  \
+                                                      ZrSize size)
+
+#define ZRP_HASHMAP_DECLARE_CLEAR_FUNCTION(name, key, value)                   \
+    ZRP_HASHMAP_LINKAGE void zrClear##name(struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_INSERT_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrInsert##name(                          \
+        struct ZrHashMap *pMap, key k, value v)
+
+#define ZRP_HASHMAP_DECLARE_FIND_FUNCTION(name, key, value)                    \
+    ZRP_HASHMAP_LINKAGE void zrFind##name(                                     \
+        value **ppValue, const struct ZrHashMap *pMap, key k)
+
+#define ZRP_HASHMAP_DECLARE_REMOVE_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE void zrRemove##name(struct ZrHashMap *pMap, key k)
+
+#define ZRP_HASHMAP_DECLARE_ITERATE_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE int zrIterate##name(ZrSize *pPosition,                 \
+                                            const key **ppKey,                 \
+                                            value **ppValue,                   \
+                                            const struct ZrHashMap *pMap)
+
+/*
+   Hash maps are open-addressing tables storing one control byte per slot,
+   holding 7 bits of the hash for the occupied slots, that are compared
+   a group at a time, using SSE2 when available, before looking at any key.
+
+   The hash function is called as `hashFn(const key *)` and returns an
+   integer, while the equality function is called as
+   `eqFn(const key *, const key *)` and returns a non-zero value if the keys
+   are equal.
+
+   Iterating starts with a position set to 0 and returns 0 when there are no
+   elements left. Removing elements while iterating is allowed but inserting
+   is not, and pointers to values are invalidated by any insertion.
+*/
+#define ZR_MAKE_HASH_MAP(name, key, value, hashFn, eqFn)                       \
+    ZRP_HASHMAP_DECLARE_CREATE_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_DESTROY_FUNCTION(name, key, value);                    \
+    ZRP_HASHMAP_DECLARE_GET_SIZE_FUNCTION(name, key, value);                   \
+    ZRP_HASHMAP_DECLARE_GET_CAPACITY_FUNCTION(name, key, value);               \
+    ZRP_HASHMAP_DECLARE_RESERVE_FUNCTION(name, key, value);                    \
+    ZRP_HASHMAP_DECLARE_CLEAR_FUNCTION(name, key, value);                      \
+    ZRP_HASHMAP_DECLARE_INSERT_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_FIND_FUNCTION(name, key, value);                       \
+    ZRP_HASHMAP_DECLARE_REMOVE_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_ITERATE_FUNCTION(name, key, value);
+
+#endif /* ZERO_HASHMAP_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_HASHMAP_IMPLEMENTATION_DEFINED
+#define ZRP_HASHMAP_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "allocator.h"
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+#ifndef ZRP_UNUSED_DEFINED
+#define ZRP_UNUSED_DEFINED
+#ifdef __GNUC__
+#define ZRP_MAYBE_UNUSED __attribute__((unused))
+#else
+#define ZRP_MAYBE_UNUSED
+#endif
+#endif /* ZRP_UNUSED_DEFINED */
+
+#ifndef ZRP_LOGGING_DEFINED
+#define ZRP_LOGGING_DEFINED
+
+#if defined(ZR_SET_LOGGING_LEVEL_DEBUG)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#elif defined(ZR_SET_LOGGING_LEVEL_TRACE)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_TRACE
+#elif defined(ZR_SET_LOGGING_LEVEL_INFO)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_INFO
+#elif defined(ZR_SET_LOGGING_LEVEL_WARNING)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#elif defined(ZR_SET_LOGGING_LEVEL_ERROR)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_ERROR
+#elif defined(ZR_ENABLE_DEBUGGING)                                             \
+    || (!defined(ZR_DISABLE_DEBUGGING)                                         \
+        && (defined(DEBUG) || !defined(NDEBUG)))
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#else
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#endif
+
+#ifdef ZR_DISABLE_LOGGING
+#define ZRP_LOGGING 0
+#else
+#define ZRP_LOGGING 1
+#endif /* ZR_DISABLE_LOGGING */
+
+#ifndef ZR_LOG
+#define ZR_LOG(level, ...)                                                     \
+    do {                                                                       \
+        if (ZRP_LOGGING && level <= ZRP_LOGGING_LEVEL) {                       \
+            zrpLoggerLog(level, __FILE__, __LINE__, __VA_ARGS__);              \
+        }                                                                      \
+    } while (0)
+#endif /* ZR_LOG */
+
+#define ZRP_LOG_DEBUG(...) ZR_LOG(ZR_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define ZRP_LOG_TRACE(...) ZR_LOG(ZR_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#define ZRP_LOG_INFO(...) ZR_LOG(ZR_LOG_LEVEL_INFO, __VA_ARGS__)
+
+#define ZRP_LOG_WARNING(...) ZR_LOG(ZR_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+#define ZRP_LOG_ERROR(...) ZR_LOG(ZR_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif /* ZRP_LOGGING_DEFINED */
+
+#ifndef ZRP_LOGLEVEL_DEFINED
+#define ZRP_LOGLEVEL_DEFINED
+
+enum ZrLogLevel {
+    ZR_LOG_LEVEL_ERROR = 0,
+    ZR_LOG_LEVEL_WARNING = 1,
+    ZR_LOG_LEVEL_INFO = 2,
+    ZR_LOG_LEVEL_TRACE = 3,
+    ZR_LOG_LEVEL_DEBUG = 4
+};
+
+#endif /* ZRP_LOGLEVEL_DEFINED */
+
+#ifndef ZRP_LOGGER_DEFINED
+#define ZRP_LOGGER_DEFINED
+
+#if !defined(ZR_DISABLE_LOG_STYLING) && defined(ZRP_PLATFORM_UNIX)             \
+    && defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 1
+#include <unistd.h>
+#define ZRP_LOGGER_LOG_STYLING 1
+#else
+#define ZRP_LOGGER_LOG_STYLING 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_TIMESTAMPS)
+#define ZRP_LOGGER_LOG_TIMESTAMPS 1
+#else
+#define ZRP_LOGGER_LOG_TIMESTAMPS 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_THREAD_IDS)
+#define ZRP_LOGGER_LOG_THREAD_IDS 1
+#else
+#define ZRP_LOGGER_LOG_THREAD_IDS 0
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_LOGGER_USE_CLOCK_GETTIME
+#else
+#include <sys/time.h>
+#endif
+#if defined(ZRP_PLATFORM_LINUX)
+#include <unistd.h>
+#if defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE)
+#include <sys/syscall.h>
+#if defined(SYS_gettid)
+#define ZRP_LOGGER_USE_GETTID
+#endif
+#endif
+#endif
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(va_copy) && defined(__va_copy)
+#define va_copy __va_copy
+#endif
+
+/*
+   `vsnprintf()` only appeared with C99 and C++11, C89 builds write the prefix
+   and the message of each record with separate calls instead.
+*/
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)                 \
+    || (defined(__cplusplus) && __cplusplus >= 201103L)                        \
+    || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)                \
+    || (defined(__GNUC__) && !defined(__STRICT_ANSI__))                        \
+    || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define ZRP_LOGGER_USE_VSNPRINTF
+#endif
+
+#if defined(_MSC_VER)
+#define ZRP_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define ZRP_LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Size of `YYYY-MM-DDTHH:MM:SS`. */
+#define ZRP_LOGGER_DATE_TIME_SIZE 19
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.mmmZ `. */
+#define ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 6)
+
+/* Records fitting into this size are written with a single call. */
+#define ZRP_LOGGER_LINE_BUFFER_SIZE 512
+
+struct ZrpLoggerLabel {
+    const char *pString;
+    size_t size;
+};
+
+#define ZRP_LOGGER_MAKE_LABEL(string)                                          \
+    {                                                                          \
+        string, sizeof string - 1                                              \
+    }
+
+/*
+   The level part of the prefixes, including the ANSI style codes when
+   styling, indexed by level.
+*/
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel zrpLoggerLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("error: "),
+       ZRP_LOGGER_MAKE_LABEL("warning: "),
+       ZRP_LOGGER_MAKE_LABEL("info: "),
+       ZRP_LOGGER_MAKE_LABEL("trace: "),
+       ZRP_LOGGER_MAKE_LABEL("debug: ")};
+
+#if ZRP_LOGGER_LOG_STYLING
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel
+    zrpLoggerStyledLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("\x1b[1;31merror\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;33mwarning\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;32minfo\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;36mtrace\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;35mdebug\x1b[0m: ")};
+
+/*
+   Whether the standard error stream is a terminal, detected on the first
+   record rather than on each one, or -1 if not detected yet. Concurrent
+   detections store the same value.
+*/
+static int zrpLoggerStderrStyled = -1;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+ZRP_MAYBE_UNUSED static int
+zrpLoggerIsStderrStyled(void)
+{
+#if ZRP_LOGGER_LOG_STYLING
+    int styled;
+
+#if defined(__GNUC__)
+    styled = __atomic_load_n(&zrpLoggerStderrStyled, __ATOMIC_RELAXED);
+#else
+    styled = *(volatile int *)&zrpLoggerStderrStyled;
+#endif
+    if (styled < 0) {
+        styled = isatty(STDERR_FILENO) ? 1 : 0;
+#if defined(__GNUC__)
+        __atomic_store_n(&zrpLoggerStderrStyled, styled, __ATOMIC_RELAXED);
+#else
+        *(volatile int *)&zrpLoggerStderrStyled = styled;
+#endif
+    }
+
+    return styled;
+#else
+    return 0;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+}
+
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel *
+zrpLoggerGetLevelLabel(int styled, enum ZrLogLevel level)
+{
+    ZR_ASSERT((int)level >= (int)ZR_LOG_LEVEL_ERROR
+              && (int)level <= (int)ZR_LOG_LEVEL_DEBUG);
+
+#if ZRP_LOGGER_LOG_STYLING
+    if (styled) {
+        return &zrpLoggerStyledLevelLabels[level];
+    }
+#else
+    (void)styled;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+    return &zrpLoggerLevelLabels[level];
+}
+
+/* Copy data at the given offset, as much as the buffer can hold. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerCopy(char *pBuffer,
+              size_t size,
+              size_t *pOffset,
+              const char *pData,
+              size_t dataSize)
+{
+    size_t copySize;
+
+    if (*pOffset < size) {
+        copySize = size - *pOffset;
+        if (copySize > dataSize) {
+            copySize = dataSize;
+        }
+
+        memcpy(&pBuffer[*pOffset], pData, copySize);
+    }
+
+    *pOffset += dataSize;
+}
+
+/*
+   Where and when a record was logged, captured by the logging thread since
+   the formatting may happen on another one. The fields are only set when
+   the prefixes include them.
+*/
+struct ZrpLoggerOrigin {
+    ZrUint64 time;
+    unsigned long threadId;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteDigits(char *pBuffer, ZrUint64 value, size_t count)
+{
+    while (count-- > 0) {
+        pBuffer[count] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/*
+   Time in milliseconds since the epoch, read from a coarse clock when there
+   is one since a tick per millisecond or so is enough for prefixes.
+*/
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpLoggerGetCoarseTime(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    FILETIME time;
+
+    /* Intervals of 100 nanoseconds since 1601-01-01. */
+    GetSystemTimeAsFileTime(&time);
+    return ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+            - 116444736000000000ull)
+           / 10000;
+#elif defined(ZRP_LOGGER_USE_CLOCK_GETTIME)
+    struct timespec time;
+
+#if defined(CLOCK_REALTIME_COARSE)
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &time) != 0) {
+        return 0;
+    }
+#else
+    if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+        return 0;
+    }
+#endif
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+#elif defined(ZRP_PLATFORM_UNIX)
+    struct timeval time;
+
+    if (gettimeofday(&time, NULL) != 0) {
+        return 0;
+    }
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_usec / 1000;
+#else
+    return 0;
+#endif
+}
+
+/*
+   Format the UTC date and time of a number of seconds since the epoch as
+   `YYYY-MM-DDTHH:MM:SS`, which is cached per thread since it only changes
+   once per second.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatDateTime(char *pBuffer, ZrUint64 seconds)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedSeconds;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedDateTime[ZRP_LOGGER_DATE_TIME_SIZE];
+#endif
+    ZrUint64 days;
+    ZrUint64 era;
+    ZrUint64 dayOfEra;
+    ZrUint64 yearOfEra;
+    ZrUint64 dayOfYear;
+    ZrUint64 shiftedMonth;
+    ZrUint64 month;
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    if (seconds + 1 == cachedSeconds) {
+        memcpy(pBuffer, cachedDateTime, ZRP_LOGGER_DATE_TIME_SIZE);
+        return;
+    }
+#endif
+
+    /* Civil date from the days since 1970-01-01, in eras of 400 years. */
+    days = seconds / 86400 + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                 - dayOfEra / 146096)
+                / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+
+    zrpLoggerWriteDigits(
+        &pBuffer[0], yearOfEra + era * 400 + (month <= 2 ? 1 : 0), 4);
+    pBuffer[4] = '-';
+    zrpLoggerWriteDigits(&pBuffer[5], month, 2);
+    pBuffer[7] = '-';
+    zrpLoggerWriteDigits(
+        &pBuffer[8], dayOfYear - (153 * shiftedMonth + 2) / 5 + 1, 2);
+    pBuffer[10] = 'T';
+    zrpLoggerWriteDigits(&pBuffer[11], seconds % 86400 / 3600, 2);
+    pBuffer[13] = ':';
+    zrpLoggerWriteDigits(&pBuffer[14], seconds % 3600 / 60, 2);
+    pBuffer[16] = ':';
+    zrpLoggerWriteDigits(&pBuffer[17], seconds % 60, 2);
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    /* Offset by one to not match the zero-initialized cache. */
+    cachedSeconds = seconds + 1;
+    memcpy(cachedDateTime, pBuffer, ZRP_LOGGER_DATE_TIME_SIZE);
+#endif
+}
+
+/*
+   Format a time in milliseconds since the epoch as it appears in prefixes,
+   reusing the previous result of the thread while the coarse clock doesn't
+   tick, which is common at high logging rates.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatPrefixTimestamp(char *pBuffer, ZrUint64 time)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedTime;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedTimestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+
+    if (time + 1 == cachedTime) {
+        memcpy(pBuffer, cachedTimestamp, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+        return;
+    }
+#endif
+
+    zrpLoggerFormatDateTime(pBuffer, time / 1000);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time % 1000, 3);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 4] = 'Z';
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 5] = ' ';
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    cachedTime = time + 1;
+    memcpy(cachedTimestamp, pBuffer, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+#endif
+}
+
+/*
+   Identifier of the calling thread, as known by the system when it can be
+   retrieved, or otherwise as assigned in the order the threads first ask
+   for it. On Linux, `syscall()` is only declared with `_DEFAULT_SOURCE` or
+   `_GNU_SOURCE`, so strict C99 builds get the latter.
+*/
+ZRP_MAYBE_UNUSED static unsigned long
+zrpLoggerGetThreadId(void)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL unsigned long threadId;
+
+    if (threadId != 0) {
+        return threadId;
+    }
+#else
+    unsigned long threadId;
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    threadId = (unsigned long)GetCurrentThreadId();
+#elif defined(ZRP_LOGGER_USE_GETTID)
+    threadId = (unsigned long)syscall(SYS_gettid);
+#else
+    {
+        static unsigned long threadCount;
+
+#if defined(__GNUC__)
+        threadId = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+#else
+        threadId = ++threadCount;
+#endif
+    }
+#endif
+
+    return threadId;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerGetOrigin(struct ZrpLoggerOrigin *pOrigin)
+{
+    ZR_ASSERT(pOrigin != NULL);
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    pOrigin->time = zrpLoggerGetCoarseTime();
+#else
+    pOrigin->time = 0;
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    pOrigin->threadId = zrpLoggerGetThreadId();
+#else
+    pOrigin->threadId = 0;
+#endif
+}
+
+/*
+   Format the prefix of a record into the given buffer, truncating it if
+   needed, and return the size that it requires, not counting the terminating
+   null character.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatPrefix(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line)
+{
+    const struct ZrpLoggerLabel *pLabel;
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    char timestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+#endif
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    char threadId[24];
+    size_t threadIdOffset;
+    unsigned long threadIdValue;
+#endif
+    char digits[16];
+    size_t digitCount;
+    size_t offset;
+    unsigned int value;
+
+    ZR_ASSERT(pBuffer != NULL || size == 0);
+    ZR_ASSERT(pOrigin != NULL);
+    ZR_ASSERT(pFile != NULL);
+
+    (void)pOrigin;
+    offset = 0;
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    zrpLoggerFormatPrefixTimestamp(timestamp, pOrigin->time);
+    zrpLoggerCopy(pBuffer, size, &offset, timestamp, sizeof timestamp);
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    threadIdValue = pOrigin->threadId;
+    threadIdOffset = sizeof threadId;
+    threadId[--threadIdOffset] = ' ';
+    threadId[--threadIdOffset] = ']';
+    do {
+        threadId[--threadIdOffset] = (char)('0' + threadIdValue % 10);
+        threadIdValue /= 10;
+    } while (threadIdValue > 0);
+
+    threadId[--threadIdOffset] = '[';
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &threadId[threadIdOffset],
+                  sizeof threadId - threadIdOffset);
+#endif
+
+    value = line < 0 ? 0u - (unsigned int)line : (unsigned int)line;
+    digitCount = sizeof digits;
+    do {
+        digits[--digitCount] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (line < 0) {
+        digits[--digitCount] = '-';
+    }
+
+    pLabel = zrpLoggerGetLevelLabel(styled, level);
+
+    zrpLoggerCopy(pBuffer, size, &offset, pFile, strlen(pFile));
+    zrpLoggerCopy(pBuffer, size, &offset, ":", 1);
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &digits[digitCount],
+                  sizeof digits - digitCount);
+    zrpLoggerCopy(pBuffer, size, &offset, ": ", 2);
+    zrpLoggerCopy(pBuffer, size, &offset, pLabel->pString, pLabel->size);
+
+    if (size > 0) {
+        pBuffer[offset < size ? offset : size - 1] = '\0';
+    }
+
+    return offset;
+}
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+/* Same as `zrpLoggerFormatPrefix()` but for a whole record. */
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatVaList(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    size_t prefixSize;
+    int messageSize;
+
+    ZR_ASSERT(pFormat != NULL);
+
+    prefixSize = zrpLoggerFormatPrefix(
+        pBuffer, size, styled, level, pOrigin, pFile, line);
+    if (prefixSize < size) {
+        messageSize = vsnprintf(
+            &pBuffer[prefixSize], size - prefixSize, pFormat, args);
+    } else {
+        messageSize = vsnprintf(NULL, 0, pFormat, args);
+    }
+
+    if (messageSize < 0) {
+        return prefixSize;
+    }
+
+    return prefixSize + (size_t)messageSize;
+}
+#endif /* ZRP_LOGGER_USE_VSNPRINTF */
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLogVaList(enum ZrLogLevel level,
+                   const char *pFile,
+                   int line,
+                   const char *pFormat,
+                   va_list args)
+{
+    char buffer[ZRP_LOGGER_LINE_BUFFER_SIZE];
+    struct ZrpLoggerOrigin origin;
+    const struct ZrpLoggerLabel *pLabel;
+    size_t size;
+    int styled;
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_list argsCopy;
+#endif
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    styled = zrpLoggerIsStderrStyled();
+    zrpLoggerGetOrigin(&origin);
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_copy(argsCopy, args);
+    size = zrpLoggerFormatVaList(buffer,
+                                 sizeof buffer,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+        va_end(argsCopy);
+        return;
+    }
+#endif
+
+    /* Too large for the buffer, write the prefix and message apart. */
+    size = zrpLoggerFormatPrefix(
+        buffer, sizeof buffer, styled, level, &origin, pFile, line);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+    } else {
+        pLabel = zrpLoggerGetLevelLabel(styled, level);
+        fprintf(stderr, "%s:%d: %s", pFile, line, pLabel->pString);
+    }
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    vfprintf(stderr, pFormat, argsCopy);
+    va_end(argsCopy);
+#else
+    vfprintf(stderr, pFormat, args);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLog(enum ZrLogLevel level,
+             const char *pFile,
+             int line,
+             const char *pFormat,
+             ...)
+{
+    va_list args;
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    va_start(args, pFormat);
+    zrpLoggerLogVaList(level, pFile, line, pFormat, args);
+    va_end(args);
+}
+
+#endif /* ZRP_LOGGER_DEFINED */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)                  \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZRP_HASHMAP_USE_SSE2 1
+#else
+#define ZRP_HASHMAP_USE_SSE2 0
+#endif
+
+/*
+   The control bytes are laid out at the beginning of a cache line aligned
+   block, followed by the slots.
+
+     block
+      /
+     +----------+--------+---------+-------+
+     | controls | clones | padding | slots |
+     +----------+--------+---------+-------+
+      \                             \
+       0                           offset
+
+   The first `group width - 1` control bytes are cloned past the end so that
+   a group can be loaded starting from any slot without wrapping around.
+
+   An empty control byte has only its sign bit set, a deleted one has all of
+   its bits set except the lowest one, and a full one has its sign bit
+   cleared with the 7 remaining bits taken from the hash.
+*/
+
+/*
+   Matching a group returns a mask with one bit per slot, found at the
+   position `(slot << shift) + offset`.
+*/
+
+#if ZRP_HASHMAP_USE_SSE2
+#define ZRP_HASHMAP_GROUP_WIDTH 16
+#define ZRP_HASHMAP_MASK_SHIFT 0
+#define ZRP_HASHMAP_MASK_OFFSET 0
+#else
+#define ZRP_HASHMAP_GROUP_WIDTH 8
+#define ZRP_HASHMAP_MASK_SHIFT 3
+#define ZRP_HASHMAP_MASK_OFFSET 7
+#endif
+
+#define ZRP_HASHMAP_CONTROL_EMPTY 0x80
+#define ZRP_HASHMAP_CONTROL_DELETED 0xFE
+#define ZRP_HASHMAP_MIN_CAPACITY 16
+
+#define ZRP_HASHMAP_GET_H1(hash) ((size_t)((hash) >> 7))
+#define ZRP_HASHMAP_GET_H2(hash) ((unsigned char)((hash)&0x7F))
+#define ZRP_HASHMAP_IS_FULL(control) ((control) < 0x80)
+
+#define ZRP_HASHMAP_GET_SLOT(pMap, index)                                      \
+    ((void *)&(pMap)->pSlots[(index) * (pMap)->slotSize])
+
+struct ZrHashMap {
+    unsigned char *pControls;
+    unsigned char *pSlots;
+    size_t capacity;
+    size_t size;
+    size_t growthLeft;
+    size_t slotSize;
+};
+
+#if ZRP_HASHMAP_USE_SSE2
+typedef __m128i ZrpHashMapGroup;
+#else
+typedef ZrUint64 ZrpHashMapGroup;
+#endif
+
+typedef ZrUint64 (*ZrpHashMapHashSlotFunction)(const void *pSlot);
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMix(ZrUint64 hash)
+{
+    /* Spread weak hashes, such as the identity, across all bits. */
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetTrailingZeroCount(ZrUint64 mask)
+{
+    ZR_ASSERT(mask != 0);
+
+#if defined(__GNUC__)
+    return (size_t)__builtin_ctzll(mask);
+#else
+    {
+        size_t out;
+
+        out = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++out;
+        }
+
+        return out;
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetLeadingZeroCount(ZrUint64 mask)
+{
+    size_t out;
+
+    /* Count within the group width rather than the full integer. */
+    out = 0;
+    while (out < ZRP_HASHMAP_GROUP_WIDTH
+           && !(mask
+                & ((ZrUint64)1 << (((ZRP_HASHMAP_GROUP_WIDTH - 1 - out)
+                                    << ZRP_HASHMAP_MASK_SHIFT)
+                                   + ZRP_HASHMAP_MASK_OFFSET)))) {
+        ++out;
+    }
+
+    return out;
+}
+
+ZRP_MAYBE_UNUSED static ZrpHashMapGroup
+zrpHashMapLoadGroup(const unsigned char *pControls)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return _mm_loadu_si128((const __m128i *)(const void *)pControls);
+#else
+    ZrUint64 out;
+    size_t i;
+
+    /* Assemble in little-endian order so that bytes map to the same bits. */
+    out = 0;
+    for (i = 0; i < ZRP_HASHMAP_GROUP_WIDTH; ++i) {
+        out |= (ZrUint64)pControls[i] << (i * 8);
+    }
+
+    return out;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatch(ZrpHashMapGroup group, unsigned char h2)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char)h2), group));
+#else
+    /* Might report false positives, which the key comparison discards. */
+    ZrUint64 x;
+
+    x = group ^ (0x0101010101010101ull * h2);
+    return (x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatchEmpty(ZrpHashMapGroup group)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(_mm_cmpeq_epi8(
+        _mm_set1_epi8((char)ZRP_HASHMAP_CONTROL_EMPTY), group));
+#else
+    return group & (~group << 6) & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatchEmptyOrDeleted(ZrpHashMapGroup group)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(-1), group));
+#else
+    return group & (~group << 7) & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetMaxSize(size_t capacity)
+{
+    /* Keep the load factor at or below 7/8. */
+    return capacity - capacity / 8;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetCapacityForSize(size_t size)
+{
+    size_t capacity;
+
+    capacity = ZRP_HASHMAP_MIN_CAPACITY;
+    while (zrpHashMapGetMaxSize(capacity) < size) {
+        if (capacity > (size_t)-1 / 2) {
+            return 0;
+        }
+
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetSlotsOffset(size_t capacity)
+{
+    return (capacity + ZRP_HASHMAP_GROUP_WIDTH - 1 + ZR_CACHE_LINE_SIZE - 1)
+           / ZR_CACHE_LINE_SIZE * ZR_CACHE_LINE_SIZE;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapResetControls(struct ZrHashMap *pMap)
+{
+    memset(pMap->pControls,
+           ZRP_HASHMAP_CONTROL_EMPTY,
+           pMap->capacity + ZRP_HASHMAP_GROUP_WIDTH - 1);
+    pMap->size = 0;
+    pMap->growthLeft = zrpHashMapGetMaxSize(pMap->capacity);
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapAllocate(struct ZrHashMap *pMap, size_t capacity, size_t slotSize)
+{
+    size_t offset;
+    unsigned char *pBlock;
+
+    ZR_ASSERT(pMap != NULL);
+    ZR_ASSERT(capacity >= ZRP_HASHMAP_MIN_CAPACITY);
+    ZR_ASSERT((capacity & (capacity - 1)) == 0);
+
+    offset = zrpHashMapGetSlotsOffset(capacity);
+    if (capacity > ((size_t)-1 - offset) / slotSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    pBlock = (unsigned char *)zrAllocateAligned(
+        (ZrSize)(offset + capacity * slotSize), ZR_CACHE_LINE_SIZE);
+    if (pBlock == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the table\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pMap->pControls = pBlock;
+    pMap->pSlots = &pBlock[offset];
+    pMap->capacity = capacity;
+    pMap->slotSize = slotSize;
+    zrpHashMapResetControls(pMap);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapSetControl(struct ZrHashMap *pMap,
+                     size_t index,
+                     unsigned char control)
+{
+    pMap->pControls[index] = control;
+    if (index < ZRP_HASHMAP_GROUP_WIDTH - 1) {
+        pMap->pControls[pMap->capacity + index] = control;
+    }
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapFindFreeSlot(const struct ZrHashMap *pMap, ZrUint64 hash)
+{
+    size_t position;
+    size_t step;
+    ZrUint64 mask;
+
+    position = ZRP_HASHMAP_GET_H1(hash) & (pMap->capacity - 1);
+    step = 0;
+    for (;;) {
+        mask = zrpHashMapMatchEmptyOrDeleted(
+            zrpHashMapLoadGroup(&pMap->pControls[position]));
+        if (mask != 0) {
+            return (position
+                    + (zrpHashMapGetTrailingZeroCount(mask)
+                       >> ZRP_HASHMAP_MASK_SHIFT))
+                   & (pMap->capacity - 1);
+        }
+
+        step += ZRP_HASHMAP_GROUP_WIDTH;
+        position = (position + step) & (pMap->capacity - 1);
+    }
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapResize(struct ZrHashMap *pMap,
+                 size_t capacity,
+                 ZrpHashMapHashSlotFunction pfnHashSlot)
+{
+    enum ZrStatus status;
+    struct ZrHashMap previous;
+    size_t i;
+    size_t index;
+    ZrUint64 hash;
+
+    ZR_ASSERT(pMap != NULL);
+    ZR_ASSERT(zrpHashMapGetMaxSize(capacity) >= pMap->size);
+
+    previous = *pMap;
+    status = zrpHashMapAllocate(pMap, capacity, previous.slotSize);
+    if (status != ZR_SUCCESS) {
+        *pMap = previous;
+        return status;
+    }
+
+    for (i = 0; i < previous.capacity; ++i) {
+        if (!ZRP_HASHMAP_IS_FULL(previous.pControls[i])) {
+            continue;
+        }
+
+        hash = zrpHashMapMix(
+            pfnHashSlot(ZRP_HASHMAP_GET_SLOT(&previous, i)));
+        index = zrpHashMapFindFreeSlot(pMap, hash);
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_GET_H2(hash));
+        memcpy(ZRP_HASHMAP_GET_SLOT(pMap, index),
+               ZRP_HASHMAP_GET_SLOT(&previous, i),
+               pMap->slotSize);
+    }
+
+    pMap->size = previous.size;
+    pMap->growthLeft -= previous.size;
+    zrFreeAligned(previous.pControls);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapPrepareInsert(size_t *pIndex,
+                        struct ZrHashMap *pMap,
+                        ZrUint64 hash,
+                        ZrpHashMapHashSlotFunction pfnHashSlot)
+{
+    enum ZrStatus status;
+    size_t capacity;
+
+    *pIndex = zrpHashMapFindFreeSlot(pMap, hash);
+    if (pMap->growthLeft == 0
+        && pMap->pControls[*pIndex] == ZRP_HASHMAP_CONTROL_EMPTY) {
+        /*
+           Purge the deleted slots if they account for a large enough share
+           of the table, or grow it otherwise.
+        */
+        capacity = pMap->capacity;
+        if (pMap->size + 1 > zrpHashMapGetMaxSize(capacity) / 2) {
+            if (capacity > (size_t)-1 / 2) {
+                ZRP_LOG_TRACE("the requested capacity is too large\n");
+                return ZR_ERROR_MAX_SIZE_EXCEEDED;
+            }
+
+            capacity *= 2;
+        }
+
+        status = zrpHashMapResize(pMap, capacity, pfnHashSlot);
+        if (status != ZR_SUCCESS) {
+            return status;
+        }
+
+        *pIndex = zrpHashMapFindFreeSlot(pMap, hash);
+    }
+
+    if (pMap->pControls[*pIndex] == ZRP_HASHMAP_CONTROL_EMPTY) {
+        --pMap->growthLeft;
+    }
+
+    zrpHashMapSetControl(pMap, *pIndex, ZRP_HASHMAP_GET_H2(hash));
+    ++pMap->size;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapRemoveAt(struct ZrHashMap *pMap, size_t index)
+{
+    size_t previous;
+    size_t emptyBefore;
+    size_t emptyAfter;
+
+    ZR_ASSERT(ZRP_HASHMAP_IS_FULL(pMap->pControls[index]));
+
+    /*
+       A slot can be marked as empty again if no group that could have been
+       probed through it was ever full, that is if no window of group width
+       slots containing it is free of empty slots.
+    */
+    previous = (index - ZRP_HASHMAP_GROUP_WIDTH) & (pMap->capacity - 1);
+    emptyBefore = zrpHashMapGetLeadingZeroCount(zrpHashMapMatchEmpty(
+        zrpHashMapLoadGroup(&pMap->pControls[previous])));
+    emptyAfter = zrpHashMapMatchEmpty(
+        zrpHashMapLoadGroup(&pMap->pControls[index]));
+    emptyAfter = emptyAfter == 0
+                     ? ZRP_HASHMAP_GROUP_WIDTH
+                     : zrpHashMapGetTrailingZeroCount(emptyAfter)
+                           >> ZRP_HASHMAP_MASK_SHIFT;
+
+    --pMap->size;
+    if (emptyBefore + emptyAfter < ZRP_HASHMAP_GROUP_WIDTH) {
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_CONTROL_EMPTY);
+        ++pMap->growthLeft;
+    } else {
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_CONTROL_DELETED);
+    }
+}
+
+#define ZRP_HASHMAP_DEFINE_SLOT(name, key, value, hashFn)                      \
+    struct ZrpHashMap##name##Slot {                                            \
+        key k;                                                                 \
+        value v;                                                               \
+    };                                                                         \
+                                                                               \
+    ZRP_MAYBE_UNUSED static ZrUint64 zrpHash##name##Slot(const void *pSlot)    \
+    {                                                                          \
+        return (ZrUint64)hashFn(                                               \
+            &((const struct ZrpHashMap##name##Slot *)pSlot)->k);               \
+    }
+
+#define ZRP_HASHMAP_DEFINE_FIND_INDEX_FUNCTION(name, key, value, eqFn)         \
+    ZRP_MAYBE_UNUSED static int zrpFind##name##Index(                          \
+        size_t *pIndex,                                                        \
+        const struct ZrHashMap *pMap,                                          \
+        const key *pKey,                                                       \
+        ZrUint64 hash)                                                         \
+    {                                                                          \
+        const struct ZrpHashMap##name##Slot *pSlots;                           \
+        ZrpHashMapGroup group;                                                 \
+        ZrUint64 mask;                                                         \
+        size_t position;                                                       \
+        size_t step;                                                           \
+                                                                               \
+        pSlots = (const struct ZrpHashMap##name##Slot *)pMap->pSlots;          \
+        position = ZRP_HASHMAP_GET_H1(hash) & (pMap->capacity - 1);            \
+        step = 0;                                                              \
+        for (;;) {                                                             \
+            group = zrpHashMapLoadGroup(&pMap->pControls[position]);           \
+            mask = zrpHashMapMatch(group, ZRP_HASHMAP_GET_H2(hash));           \
+            while (mask != 0) {                                                \
+                *pIndex = (position                                            \
+                           + (zrpHashMapGetTrailingZeroCount(mask)             \
+                              >> ZRP_HASHMAP_MASK_SHIFT))                      \
+                          & (pMap->capacity - 1);                              \
+                if (eqFn(&pSlots[*pIndex].k, pKey)) {                          \
+                    return 1;                                                  \
+                }                                                              \
+                                                                               \
+                mask &= mask - 1;                                              \
+            }                                                                  \
+                                                                               \
+            if (zrpHashMapMatchEmpty(group) != 0) {                            \
+                return 0;                                                      \
+            }                                                                  \
+                                                                               \
+            step += ZRP_HASHMAP_GROUP_WIDTH;                                   \
+            position = (position + step) & (pMap->capacity - 1);               \
+        }                                                                      \
+    }
+
+#define ZRP_HASHMAP_DEFINE_CREATE_FUNCTION(name, key, value)                   \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrCreate##name(         \
+        struct ZrHashMap **ppMap, ZrSize size)                                 \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrHashMap *pMap;                                                \
+        size_t capacity;                                                       \
+                                                                               \
+        ZR_ASSERT(ppMap != NULL);                                              \
+                                                                               \
+        capacity = zrpHashMapGetCapacityForSize((size_t)size);                 \
+        if (capacity == 0) {                                                   \
+            ZRP_LOG_ERROR("the requested size is too large (requested size: "  \
+                          "%zu)\n",                                            \
+                          (size_t)size);                                       \
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;                                 \
+        }                                                                      \
+                                                                               \
+        pMap = (struct ZrHashMap *)zrAllocate((ZrSize)sizeof *pMap);           \
+        if (pMap == NULL) {                                                    \
+            ZRP_LOG_ERROR("failed to allocate the hash map\n");                \
+            return ZR_ERROR_ALLOCATION;                                        \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapAllocate(                                           \
+            pMap, capacity, sizeof(struct ZrpHashMap##name##Slot));            \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create a hash map with key type "         \
+                          "‘" #key "’ and value type ‘" #value "’ "            \
+                          "(requested size: %zu)\n",                           \
+                          (size_t)size);                                       \
+            zrFree(pMap);                                                      \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        *ppMap = pMap;                                                         \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_DESTROY_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrDestroy##name(                 \
+        struct ZrHashMap *pMap)                                                \
+    {                                                                          \
+        if (pMap == NULL) {                                                    \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+        zrFreeAligned(pMap->pControls);                                        \
+        zrFree(pMap);                                                          \
+    }
+
+#define ZRP_HASHMAP_DEFINE_GET_SIZE_FUNCTION(name, key, value)                 \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrGet##name##Size(               \
+        ZrSize *pSize, const struct ZrHashMap *pMap)                           \
+    {                                                                          \
+        ZR_ASSERT(pSize != NULL);                                              \
+        ZR_ASSERT(pMap != NULL);                                               \
+                                                                               \
+        *pSize = (ZrSize)pMap->size;                                           \
+    }
+
+#define ZRP_HASHMAP_DEFINE_GET_CAPACITY_FUNCTION(name, key, value)             \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrGet##name##Capacity(           \
+        ZrSize *pCapacity, const struct ZrHashMap *pMap)                       \
+    {                                                                          \
+        ZR_ASSERT(pCapacity != NULL);                                          \
+        ZR_ASSERT(pMap != NULL);                                               \
+                                                                               \
+        *pCapacity = (ZrSize)zrpHashMapGetMaxSize(pMap->capacity);             \
+    }
+
+#define ZRP_HASHMAP_DEFINE_RESERVE_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrReserve##name(        \
+        struct ZrHashMap *pMap, ZrSize size)                                   \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        size_t capacity;                                                       \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if ((size_t)size <= pMap->size + pMap->growthLeft) {                   \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        capacity = zrpHashMapGetCapacityForSize((size_t)size);                 \
+        if (capacity == 0) {                                                   \
+            ZRP_LOG_ERROR("the requested size is too large (requested size: "  \
+                          "%zu)\n",                                            \
+                          (size_t)size);                                       \
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;                                 \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapResize(pMap, capacity, zrpHash##name##Slot);        \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
+                          "hash map (requested size: %zu)\n",                  \
+                          (size_t)size);                                       \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_CLEAR_FUNCTION(name, key, value)                    \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrClear##name(                   \
+        struct ZrHashMap *pMap)                                                \
+    {                                                                          \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        zrpHashMapResetControls(pMap);                                         \
+    }
+
+#define ZRP_HASHMAP_DEFINE_INSERT_FUNCTION(name, key, value, hashFn)           \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrInsert##name(         \
+        struct ZrHashMap *pMap, key k, value v)                                \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrpHashMap##name##Slot *pSlot;                                  \
+        ZrUint64 hash;                                                         \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        hash = zrpHashMapMix((ZrUint64)hashFn(&k));                            \
+        if (zrpFind##name##Index(&index, pMap, &k, hash)) {                    \
+            ((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index].v = v;      \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapPrepareInsert(                                      \
+            &index, pMap, hash, zrpHash##name##Slot);                          \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to insert into the hash map with key type "  \
+                          "‘" #key "’ and value type ‘" #value "’\n");         \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        pSlot = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index];       \
+        pSlot->k = k;                                                          \
+        pSlot->v = v;                                                          \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_FIND_FUNCTION(name, key, value, hashFn)             \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrFind##name(                    \
+        value **ppValue, const struct ZrHashMap *pMap, key k)                  \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(ppValue != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if (!zrpFind##name##Index(                                             \
+                &index, pMap, &k, zrpHashMapMix((ZrUint64)hashFn(&k)))) {      \
+            *ppValue = NULL;                                                   \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        *ppValue = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index].v;  \
+    }
+
+#define ZRP_HASHMAP_DEFINE_REMOVE_FUNCTION(name, key, value, hashFn)           \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrRemove##name(                  \
+        struct ZrHashMap *pMap, key k)                                         \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if (zrpFind##name##Index(                                              \
+                &index, pMap, &k, zrpHashMapMix((ZrUint64)hashFn(&k)))) {      \
+            zrpHashMapRemoveAt(pMap, index);                                   \
+        }                                                                      \
+    }
+
+#define ZRP_HASHMAP_DEFINE_ITERATE_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE int zrIterate##name(                  \
+        ZrSize *pPosition,                                                     \
+        const key **ppKey,                                                     \
+        value **ppValue,                                                       \
+        const struct ZrHashMap *pMap)                                          \
+    {                                                                          \
+        struct ZrpHashMap##name##Slot *pSlot;                                  \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pPosition != NULL);                                          \
+        ZR_ASSERT(ppKey != NULL);                                              \
+        ZR_ASSERT(ppValue != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        for (i = (size_t)*pPosition; i < pMap->capacity; ++i) {                \
+            if (ZRP_HASHMAP_IS_FULL(pMap->pControls[i])) {                     \
+                pSlot = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[i];   \
+                *pPosition = (ZrSize)(i + 1);                                  \
+                *ppKey = &pSlot->k;                                            \
+                *ppValue = &pSlot->v;                                          \
+                return 1;                                                      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        *pPosition = (ZrSize)pMap->capacity;                                   \
+        return 0;                                                              \
+    }
+
+#undef ZR_MAKE_HASH_MAP
+#define ZR_MAKE_HASH_MAP(name, key, value, hashFn, eqFn)                       \
+    ZRP_HASHMAP_DEFINE_SLOT(name, key, value, hashFn)                          \
+    ZRP_HASHMAP_DEFINE_FIND_INDEX_FUNCTION(name, key, value, eqFn)             \
+    ZRP_HASHMAP_DEFINE_CREATE_FUNCTION(name, key, value)                       \
+    ZRP_HASHMAP_DEFINE_DESTROY_FUNCTION(name, key, value)                      \
+    ZRP_HASHMAP_DEFINE_GET_SIZE_FUNCTION(name, key, value)                     \
+    ZRP_HASHMAP_DEFINE_GET_CAPACITY_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_DEFINE_RESERVE_FUNCTION(name, key, value)                      \
+    ZRP_HASHMAP_DEFINE_CLEAR_FUNCTION(name, key, value)                        \
+    ZRP_HASHMAP_DEFINE_INSERT_FUNCTION(name, key, value, hashFn)               \
+    ZRP_HASHMAP_DEFINE_FIND_FUNCTION(name, key, value, hashFn)                 \
+    ZRP_HASHMAP_DEFINE_REMOVE_FUNCTION(name, key, value, hashFn)               \
+    ZRP_HASHMAP_DEFINE_ITERATE_FUNCTION(name, key, value)
+
+#endif /* ZRP_HASHMAP_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
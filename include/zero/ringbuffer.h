@@ -0,0 +1,1626 @@
+/*
+   The MIT License (MIT)
+
+   Copyright (c) 2018 Christopher Crouzet
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+   THE SOFTWARE.
+*/
+
+#ifndef ZERO_RINGBUFFER_H
+#define ZERO_RINGBUFFER_H
+
+#define ZR_RINGBUFFER_MAJOR_VERSION 0
+#define ZR_RINGBUFFER_MINOR_VERSION 1
+#define ZR_RINGBUFFER_PATCH_VERSION 0
+
+#ifndef ZRP_ARCH_DEFINED
+#define ZRP_ARCH_DEFINED
+#if defined(__x86_64__) || defined(_M_X64)
+#define ZRP_ARCH_X86_64
+#elif defined(__i386) || defined(_M_IX86)
+#define ZRP_ARCH_X86_32
+#elif defined(__itanium__) || defined(_M_IA64)
+#define ZRP_ARCH_ITANIUM_64
+#elif defined(__powerpc64__) || defined(__ppc64__)
+#define ZRP_ARCH_POWERPC_64
+#elif defined(__powerpc__) || defined(__ppc__)
+#define ZRP_ARCH_POWERPC_32
+#elif defined(__aarch64__)
+#define ZRP_ARCH_ARM_64
+#elif defined(__arm__)
+#define ZRP_ARCH_ARM_32
+#endif
+#endif /* ZRP_ARCH_DEFINED */
+
+/*
+   The environment macro represents whether the code is to be generated for a
+   32-bit or 64-bit target platform. Some CPUs, such as the x86-64 processors,
+   allow running code in 32-bit mode if compiled using the -m32 or -mx32
+   compiler switches, in which case `ZR_ENVIRONMENT` is set to 32.
+*/
+#ifndef ZR_ENVIRONMENT
+#if (!defined(ZRP_ARCH_X86_64) || defined(__ILP32__))                          \
+    && !defined(ZRP_ARCH_ITANIUM_64) && !defined(ZRP_ARCH_POWERPC_64)          \
+    && !defined(ZRP_ARCH_ARM_64)
+#define ZR_ENVIRONMENT 32
+#else
+#define ZR_ENVIRONMENT 64
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_environment_value
+    [ZR_ENVIRONMENT == 32 || ZR_ENVIRONMENT == 64 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZR_ENVIRONMENT */
+
+#ifndef ZRP_PLATFORM_DEFINED
+#define ZRP_PLATFORM_DEFINED
+#if defined(_WIN32)
+#define ZRP_PLATFORM_WINDOWS
+#elif defined(__unix__) || defined(__APPLE__)
+#define ZRP_PLATFORM_UNIX
+#if defined(__APPLE__)
+#define ZRP_PLATFORM_DARWIN
+#if TARGET_OS_IPHONE == 1
+#define ZRP_PLATFORM_IOS
+#elif TARGET_OS_MAC == 1
+#define ZRP_PLATFORM_MACOS
+#endif
+#elif defined(__linux__)
+#define ZRP_PLATFORM_LINUX
+#endif
+#endif
+#endif /* ZRP_PLATFORM_DEFINED */
+
+#ifndef ZRP_FIXED_TYPES_DEFINED
+#define ZRP_FIXED_TYPES_DEFINED
+#ifdef ZR_USE_STD_FIXED_TYPES
+#include <stdint.h>
+typedef int8_t ZrInt8;
+typedef uint8_t ZrUint8;
+typedef int16_t ZrInt16;
+typedef uint16_t ZrUint16;
+typedef int32_t ZrInt32;
+typedef uint32_t ZrUint32;
+typedef int64_t ZrInt64;
+typedef uint64_t ZrUint64;
+#else
+/*
+   The focus here is on the common data models, that is ILP32 (most recent
+   32-bit systems), LP64 (Unix-like systems), and LLP64 (Windows). All of these
+   models have the `char` type set to 8 bits, `short` to 16 bits, `int` to
+   32 bits, and `long long` to 64 bits.
+*/
+#ifdef ZR_INT8
+typedef ZR_INT8 ZrInt8;
+#else
+typedef char ZrInt8;
+#endif
+#ifdef ZR_UINT8
+typedef ZR_UINT8 ZrUint8;
+#else
+typedef unsigned char ZrUint8;
+#endif
+#ifdef ZR_INT16
+typedef ZR_INT16 ZrInt16;
+#else
+typedef short ZrInt16;
+#endif
+#ifdef ZR_UINT16
+typedef ZR_UINT16 ZrUint16;
+#else
+typedef unsigned short ZrUint16;
+#endif
+#ifdef ZR_INT32
+typedef ZR_INT32 ZrInt32;
+#else
+typedef int ZrInt32;
+#endif
+#ifdef ZR_UINT32
+typedef ZR_UINT32 ZrUint32;
+#else
+typedef unsigned int ZrUint32;
+#endif
+#ifdef ZR_INT64
+typedef ZR_INT64 ZrInt64;
+#else
+typedef long long ZrInt64;
+#endif
+#ifdef ZR_UINT64
+typedef ZR_UINT64 ZrUint64;
+#else
+typedef unsigned long long ZrUint64;
+#endif
+#endif /* ZR_USE_STD_FIXED_TYPES */
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_int8_type[sizeof(ZrInt8) == 1 ? 1 : -1];
+typedef char zrp_invalid_uint8_type[sizeof(ZrUint8) == 1 ? 1 : -1];
+typedef char zrp_invalid_int16_type[sizeof(ZrInt16) == 2 ? 1 : -1];
+typedef char zrp_invalid_uint16_type[sizeof(ZrUint16) == 2 ? 1 : -1];
+typedef char zrp_invalid_int32_type[sizeof(ZrInt32) == 4 ? 1 : -1];
+typedef char zrp_invalid_uint32_type[sizeof(ZrUint32) == 4 ? 1 : -1];
+typedef char zrp_invalid_int64_type[sizeof(ZrInt64) == 8 ? 1 : -1];
+typedef char zrp_invalid_uint64_type[sizeof(ZrUint64) == 8 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_FIXED_TYPES_DEFINED */
+
+#ifndef ZRP_BASIC_TYPES_DEFINED
+#define ZRP_BASIC_TYPES_DEFINED
+#ifdef ZR_USE_STD_BASIC_TYPES
+#include <stddef.h>
+typedef size_t ZrSize;
+#else
+/*
+   The C standard provides no guarantees about the size of the type `size_t`,
+   and some exotic platforms will in fact provide original values, but this
+   should cover most of the use cases.
+*/
+#ifdef ZR_SIZE_TYPE
+typedef ZR_SIZE_TYPE ZrSize;
+#elif ZR_ENVIRONMENT == 32
+typedef ZrUint32 ZrSize;
+#else
+typedef ZrUint64 ZrSize;
+#endif
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char
+    zrp_invalid_size_type[sizeof(ZrSize) == sizeof sizeof(void *) ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_BASIC_TYPES_DEFINED */
+
+#ifndef ZRP_STATUS_DEFINED
+#define ZRP_STATUS_DEFINED
+enum ZrStatus {
+    ZR_SUCCESS = 0,
+    ZR_ERROR = -1,
+    ZR_ERROR_ALLOCATION = -2,
+    ZR_ERROR_MAX_SIZE_EXCEEDED = -3
+};
+#endif /* ZRP_STATUS_DEFINED */
+
+#if defined(ZR_RINGBUFFER_SPECIFY_INTERNAL_LINKAGE)                            \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_RINGBUFFER_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_RINGBUFFER_LINKAGE extern "C"
+#else
+#define ZRP_RINGBUFFER_LINKAGE extern
+#endif
+
+struct ZrSpscRingBuffer;
+struct ZrMpmcRingBuffer;
+
+#define ZRP_RINGBUFFER_DECLARE_CREATE_FUNCTION(name, type, buffer)             \
+    ZRP_RINGBUFFER_LINKAGE enum ZrStatus zrCreate##name(                       \
+        struct buffer **ppBuffer, ZrSize capacity)
+
+#define ZRP_RINGBUFFER_DECLARE_DESTROY_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE void zrDestroy##name(struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_GET_CAPACITY_FUNCTION(name, type, buffer)       \
+    ZRP_RINGBUFFER_LINKAGE void zrGet##name##Capacity(                         \
+        ZrSize *pCapacity, const struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_ENQUEUE_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE int zrEnqueue##name(struct buffer *pBuffer,         \
+                                               type value)
+
+#define ZRP_RINGBUFFER_DECLARE_DEQUEUE_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE int zrDequeue##name(type *pValue,                   \
+                                               struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_ENQUEUE_BATCH_FUNCTION(name, type, buffer)      \
+    ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(                        \
+        ZrSize *pCount,                                                        \
+        struct buffer *pBuffer,                                                \
+        ZrSize size,                                                           \
+        const type *pValues)
+
+#define ZRP_RINGBUFFER_DECLARE_DEQUEUE_BATCH_FUNCTION(name, type, buffer)      \
+    ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(                        \
+        ZrSize *pCount, type *pValues, struct buffer *pBuffer, ZrSize size)
+
+#define ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, buffer)                   \
+    ZRP_RINGBUFFER_DECLARE_CREATE_FUNCTION(name, type, buffer);                \
+    ZRP_RINGBUFFER_DECLARE_DESTROY_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_GET_CAPACITY_FUNCTION(name, type, buffer);          \
+    ZRP_RINGBUFFER_DECLARE_ENQUEUE_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_DEQUEUE_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_ENQUEUE_BATCH_FUNCTION(name, type, buffer);         \
+    ZRP_RINGBUFFER_DECLARE_DEQUEUE_BATCH_FUNCTION(name, type, buffer);
+
+/*
+   Ring buffers are bounded lock-free queues, with their capacity rounded up
+   to the next power of two. The SPSC variant supports a single producer
+   thread and a single consumer thread, while the MPMC variant supports any
+   number of both.
+
+   Enqueuing returns 0 when the buffer is full, and dequeuing returns 0 when
+   it is empty. The batch variants transfer as many elements as possible, up
+   to the given size, using a single atomic operation to publish or claim all
+   of them, and return the number of elements transferred.
+*/
+#define ZR_MAKE_SPSC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, ZrSpscRingBuffer)
+
+#define ZR_MAKE_MPMC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, ZrMpmcRingBuffer)
+
+#endif /* ZERO_RINGBUFFER_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED
+#define ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "allocator.h"
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+#ifndef ZRP_UNUSED_DEFINED
+#define ZRP_UNUSED_DEFINED
+#ifdef __GNUC__
+#define ZRP_MAYBE_UNUSED __attribute__((unused))
+#else
+#define ZRP_MAYBE_UNUSED
+#endif
+#endif /* ZRP_UNUSED_DEFINED */
+
+#ifndef ZRP_LOGGING_DEFINED
+#define ZRP_LOGGING_DEFINED
+
+#if defined(ZR_SET_LOGGING_LEVEL_DEBUG)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#elif defined(ZR_SET_LOGGING_LEVEL_TRACE)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_TRACE
+#elif defined(ZR_SET_LOGGING_LEVEL_INFO)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_INFO
+#elif defined(ZR_SET_LOGGING_LEVEL_WARNING)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#elif defined(ZR_SET_LOGGING_LEVEL_ERROR)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_ERROR
+#elif defined(ZR_ENABLE_DEBUGGING)                                             \
+    || (!defined(ZR_DISABLE_DEBUGGING)                                         \
+        && (defined(DEBUG) || !defined(NDEBUG)))
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#else
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#endif
+
+#ifdef ZR_DISABLE_LOGGING
+#define ZRP_LOGGING 0
+#else
+#define ZRP_LOGGING 1
+#endif /* ZR_DISABLE_LOGGING */
+
+#ifndef ZR_LOG
+#define ZR_LOG(level, ...)                                                     \
+    do {                                                                       \
+        if (ZRP_LOGGING && level <= ZRP_LOGGING_LEVEL) {                       \
+            zrpLoggerLog(level, __FILE__, __LINE__, __VA_ARGS__);              \
+        }                                                                      \
+    } while (0)
+#endif /* ZR_LOG */
+
+#define ZRP_LOG_DEBUG(...) ZR_LOG(ZR_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define ZRP_LOG_TRACE(...) ZR_LOG(ZR_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#define ZRP_LOG_INFO(...) ZR_LOG(ZR_LOG_LEVEL_INFO, __VA_ARGS__)
+
+#define ZRP_LOG_WARNING(...) ZR_LOG(ZR_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+#define ZRP_LOG_ERROR(...) ZR_LOG(ZR_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif /* ZRP_LOGGING_DEFINED */
+
+#ifndef ZRP_LOGLEVEL_DEFINED
+#define ZRP_LOGLEVEL_DEFINED
+
+enum ZrLogLevel {
+    ZR_LOG_LEVEL_ERROR = 0,
+    ZR_LOG_LEVEL_WARNING = 1,
+    ZR_LOG_LEVEL_INFO = 2,
+    ZR_LOG_LEVEL_TRACE = 3,
+    ZR_LOG_LEVEL_DEBUG = 4
+};
+
+#endif /* ZRP_LOGLEVEL_DEFINED */
+
+#ifndef ZRP_LOGGER_DEFINED
+#define ZRP_LOGGER_DEFINED
+
+#if !defined(ZR_DISABLE_LOG_STYLING) && defined(ZRP_PLATFORM_UNIX)             \
+    && defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 1
+#include <unistd.h>
+#define ZRP_LOGGER_LOG_STYLING 1
+#else
+#define ZRP_LOGGER_LOG_STYLING 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_TIMESTAMPS)
+#define ZRP_LOGGER_LOG_TIMESTAMPS 1
+#else
+#define ZRP_LOGGER_LOG_TIMESTAMPS 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_THREAD_IDS)
+#define ZRP_LOGGER_LOG_THREAD_IDS 1
+#else
+#define ZRP_LOGGER_LOG_THREAD_IDS 0
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_LOGGER_USE_CLOCK_GETTIME
+#else
+#include <sys/time.h>
+#endif
+#if defined(ZRP_PLATFORM_LINUX)
+#include <unistd.h>
+#if defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE)
+#include <sys/syscall.h>
+#if defined(SYS_gettid)
+#define ZRP_LOGGER_USE_GETTID
+#endif
+#endif
+#endif
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(va_copy) && defined(__va_copy)
+#define va_copy __va_copy
+#endif
+
+/*
+   `vsnprintf()` only appeared with C99 and C++11, C89 builds write the prefix
+   and the message of each record with separate calls instead.
+*/
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)                 \
+    || (defined(__cplusplus) && __cplusplus >= 201103L)                        \
+    || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)                \
+    || (defined(__GNUC__) && !defined(__STRICT_ANSI__))                        \
+    || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define ZRP_LOGGER_USE_VSNPRINTF
+#endif
+
+#if defined(_MSC_VER)
+#define ZRP_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define ZRP_LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Size of `YYYY-MM-DDTHH:MM:SS`. */
+#define ZRP_LOGGER_DATE_TIME_SIZE 19
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.mmmZ `. */
+#define ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 6)
+
+/* Records fitting into this size are written with a single call. */
+#define ZRP_LOGGER_LINE_BUFFER_SIZE 512
+
+struct ZrpLoggerLabel {
+    const char *pString;
+    size_t size;
+};
+
+#define ZRP_LOGGER_MAKE_LABEL(string)                                          \
+    {                                                                          \
+        string, sizeof string - 1                                              \
+    }
+
+/*
+   The level part of the prefixes, including the ANSI style codes when
+   styling, indexed by level.
+*/
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel zrpLoggerLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("error: "),
+       ZRP_LOGGER_MAKE_LABEL("warning: "),
+       ZRP_LOGGER_MAKE_LABEL("info: "),
+       ZRP_LOGGER_MAKE_LABEL("trace: "),
+       ZRP_LOGGER_MAKE_LABEL("debug: ")};
+
+#if ZRP_LOGGER_LOG_STYLING
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel
+    zrpLoggerStyledLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("\x1b[1;31merror\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;33mwarning\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;32minfo\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;36mtrace\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;35mdebug\x1b[0m: ")};
+
+/*
+   Whether the standard error stream is a terminal, detected on the first
+   record rather than on each one, or -1 if not detected yet. Concurrent
+   detections store the same value.
+*/
+static int zrpLoggerStderrStyled = -1;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+ZRP_MAYBE_UNUSED static int
+zrpLoggerIsStderrStyled(void)
+{
+#if ZRP_LOGGER_LOG_STYLING
+    int styled;
+
+#if defined(__GNUC__)
+    styled = __atomic_load_n(&zrpLoggerStderrStyled, __ATOMIC_RELAXED);
+#else
+    styled = *(volatile int *)&zrpLoggerStderrStyled;
+#endif
+    if (styled < 0) {
+        styled = isatty(STDERR_FILENO) ? 1 : 0;
+#if defined(__GNUC__)
+        __atomic_store_n(&zrpLoggerStderrStyled, styled, __ATOMIC_RELAXED);
+#else
+        *(volatile int *)&zrpLoggerStderrStyled = styled;
+#endif
+    }
+
+    return styled;
+#else
+    return 0;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+}
+
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel *
+zrpLoggerGetLevelLabel(int styled, enum ZrLogLevel level)
+{
+    ZR_ASSERT((int)level >= (int)ZR_LOG_LEVEL_ERROR
+              && (int)level <= (int)ZR_LOG_LEVEL_DEBUG);
+
+#if ZRP_LOGGER_LOG_STYLING
+    if (styled) {
+        return &zrpLoggerStyledLevelLabels[level];
+    }
+#else
+    (void)styled;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+    return &zrpLoggerLevelLabels[level];
+}
+
+/* Copy data at the given offset, as much as the buffer can hold. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerCopy(char *pBuffer,
+              size_t size,
+              size_t *pOffset,
+              const char *pData,
+              size_t dataSize)
+{
+    size_t copySize;
+
+    if (*pOffset < size) {
+        copySize = size - *pOffset;
+        if (copySize > dataSize) {
+            copySize = dataSize;
+        }
+
+        memcpy(&pBuffer[*pOffset], pData, copySize);
+    }
+
+    *pOffset += dataSize;
+}
+
+/*
+   Where and when a record was logged, captured by the logging thread since
+   the formatting may happen on another one. The fields are only set when
+   the prefixes include them.
+*/
+struct ZrpLoggerOrigin {
+    ZrUint64 time;
+    unsigned long threadId;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteDigits(char *pBuffer, ZrUint64 value, size_t count)
+{
+    while (count-- > 0) {
+        pBuffer[count] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/*
+   Time in milliseconds since the epoch, read from a coarse clock when there
+   is one since a tick per millisecond or so is enough for prefixes.
+*/
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpLoggerGetCoarseTime(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    FILETIME time;
+
+    /* Intervals of 100 nanoseconds since 1601-01-01. */
+    GetSystemTimeAsFileTime(&time);
+    return ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+            - 116444736000000000ull)
+           / 10000;
+#elif defined(ZRP_LOGGER_USE_CLOCK_GETTIME)
+    struct timespec time;
+
+#if defined(CLOCK_REALTIME_COARSE)
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &time) != 0) {
+        return 0;
+    }
+#else
+    if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+        return 0;
+    }
+#endif
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+#elif defined(ZRP_PLATFORM_UNIX)
+    struct timeval time;
+
+    if (gettimeofday(&time, NULL) != 0) {
+        return 0;
+    }
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_usec / 1000;
+#else
+    return 0;
+#endif
+}
+
+/*
+   Format the UTC date and time of a number of seconds since the epoch as
+   `YYYY-MM-DDTHH:MM:SS`, which is cached per thread since it only changes
+   once per second.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatDateTime(char *pBuffer, ZrUint64 seconds)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedSeconds;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedDateTime[ZRP_LOGGER_DATE_TIME_SIZE];
+#endif
+    ZrUint64 days;
+    ZrUint64 era;
+    ZrUint64 dayOfEra;
+    ZrUint64 yearOfEra;
+    ZrUint64 dayOfYear;
+    ZrUint64 shiftedMonth;
+    ZrUint64 month;
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    if (seconds + 1 == cachedSeconds) {
+        memcpy(pBuffer, cachedDateTime, ZRP_LOGGER_DATE_TIME_SIZE);
+        return;
+    }
+#endif
+
+    /* Civil date from the days since 1970-01-01, in eras of 400 years. */
+    days = seconds / 86400 + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                 - dayOfEra / 146096)
+                / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+
+    zrpLoggerWriteDigits(
+        &pBuffer[0], yearOfEra + era * 400 + (month <= 2 ? 1 : 0), 4);
+    pBuffer[4] = '-';
+    zrpLoggerWriteDigits(&pBuffer[5], month, 2);
+    pBuffer[7] = '-';
+    zrpLoggerWriteDigits(
+        &pBuffer[8], dayOfYear - (153 * shiftedMonth + 2) / 5 + 1, 2);
+    pBuffer[10] = 'T';
+    zrpLoggerWriteDigits(&pBuffer[11], seconds % 86400 / 3600, 2);
+    pBuffer[13] = ':';
+    zrpLoggerWriteDigits(&pBuffer[14], seconds % 3600 / 60, 2);
+    pBuffer[16] = ':';
+    zrpLoggerWriteDigits(&pBuffer[17], seconds % 60, 2);
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    /* Offset by one to not match the zero-initialized cache. */
+    cachedSeconds = seconds + 1;
+    memcpy(cachedDateTime, pBuffer, ZRP_LOGGER_DATE_TIME_SIZE);
+#endif
+}
+
+/*
+   Format a time in milliseconds since the epoch as it appears in prefixes,
+   reusing the previous result of the thread while the coarse clock doesn't
+   tick, which is common at high logging rates.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatPrefixTimestamp(char *pBuffer, ZrUint64 time)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedTime;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedTimestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+
+    if (time + 1 == cachedTime) {
+        memcpy(pBuffer, cachedTimestamp, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+        return;
+    }
+#endif
+
+    zrpLoggerFormatDateTime(pBuffer, time / 1000);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time % 1000, 3);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 4] = 'Z';
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 5] = ' ';
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    cachedTime = time + 1;
+    memcpy(cachedTimestamp, pBuffer, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+#endif
+}
+
+/*
+   Identifier of the calling thread, as known by the system when it can be
+   retrieved, or otherwise as assigned in the order the threads first ask
+   for it. On Linux, `syscall()` is only declared with `_DEFAULT_SOURCE` or
+   `_GNU_SOURCE`, so strict C99 builds get the latter.
+*/
+ZRP_MAYBE_UNUSED static unsigned long
+zrpLoggerGetThreadId(void)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL unsigned long threadId;
+
+    if (threadId != 0) {
+        return threadId;
+    }
+#else
+    unsigned long threadId;
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    threadId = (unsigned long)GetCurrentThreadId();
+#elif defined(ZRP_LOGGER_USE_GETTID)
+    threadId = (unsigned long)syscall(SYS_gettid);
+#else
+    {
+        static unsigned long threadCount;
+
+#if defined(__GNUC__)
+        threadId = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+#else
+        threadId = ++threadCount;
+#endif
+    }
+#endif
+
+    return threadId;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerGetOrigin(struct ZrpLoggerOrigin *pOrigin)
+{
+    ZR_ASSERT(pOrigin != NULL);
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    pOrigin->time = zrpLoggerGetCoarseTime();
+#else
+    pOrigin->time = 0;
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    pOrigin->threadId = zrpLoggerGetThreadId();
+#else
+    pOrigin->threadId = 0;
+#endif
+}
+
+/*
+   Format the prefix of a record into the given buffer, truncating it if
+   needed, and return the size that it requires, not counting the terminating
+   null character.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatPrefix(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line)
+{
+    const struct ZrpLoggerLabel *pLabel;
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    char timestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+#endif
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    char threadId[24];
+    size_t threadIdOffset;
+    unsigned long threadIdValue;
+#endif
+    char digits[16];
+    size_t digitCount;
+    size_t offset;
+    unsigned int value;
+
+    ZR_ASSERT(pBuffer != NULL || size == 0);
+    ZR_ASSERT(pOrigin != NULL);
+    ZR_ASSERT(pFile != NULL);
+
+    (void)pOrigin;
+    offset = 0;
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    zrpLoggerFormatPrefixTimestamp(timestamp, pOrigin->time);
+    zrpLoggerCopy(pBuffer, size, &offset, timestamp, sizeof timestamp);
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    threadIdValue = pOrigin->threadId;
+    threadIdOffset = sizeof threadId;
+    threadId[--threadIdOffset] = ' ';
+    threadId[--threadIdOffset] = ']';
+    do {
+        threadId[--threadIdOffset] = (char)('0' + threadIdValue % 10);
+        threadIdValue /= 10;
+    } while (threadIdValue > 0);
+
+    threadId[--threadIdOffset] = '[';
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &threadId[threadIdOffset],
+                  sizeof threadId - threadIdOffset);
+#endif
+
+    value = line < 0 ? 0u - (unsigned int)line : (unsigned int)line;
+    digitCount = sizeof digits;
+    do {
+        digits[--digitCount] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (line < 0) {
+        digits[--digitCount] = '-';
+    }
+
+    pLabel = zrpLoggerGetLevelLabel(styled, level);
+
+    zrpLoggerCopy(pBuffer, size, &offset, pFile, strlen(pFile));
+    zrpLoggerCopy(pBuffer, size, &offset, ":", 1);
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &digits[digitCount],
+                  sizeof digits - digitCount);
+    zrpLoggerCopy(pBuffer, size, &offset, ": ", 2);
+    zrpLoggerCopy(pBuffer, size, &offset, pLabel->pString, pLabel->size);
+
+    if (size > 0) {
+        pBuffer[offset < size ? offset : size - 1] = '\0';
+    }
+
+    return offset;
+}
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+/* Same as `zrpLoggerFormatPrefix()` but for a whole record. */
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatVaList(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    size_t prefixSize;
+    int messageSize;
+
+    ZR_ASSERT(pFormat != NULL);
+
+    prefixSize = zrpLoggerFormatPrefix(
+        pBuffer, size, styled, level, pOrigin, pFile, line);
+    if (prefixSize < size) {
+        messageSize = vsnprintf(
+            &pBuffer[prefixSize], size - prefixSize, pFormat, args);
+    } else {
+        messageSize = vsnprintf(NULL, 0, pFormat, args);
+    }
+
+    if (messageSize < 0) {
+        return prefixSize;
+    }
+
+    return prefixSize + (size_t)messageSize;
+}
+#endif /* ZRP_LOGGER_USE_VSNPRINTF */
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLogVaList(enum ZrLogLevel level,
+                   const char *pFile,
+                   int line,
+                   const char *pFormat,
+                   va_list args)
+{
+    char buffer[ZRP_LOGGER_LINE_BUFFER_SIZE];
+    struct ZrpLoggerOrigin origin;
+    const struct ZrpLoggerLabel *pLabel;
+    size_t size;
+    int styled;
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_list argsCopy;
+#endif
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    styled = zrpLoggerIsStderrStyled();
+    zrpLoggerGetOrigin(&origin);
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_copy(argsCopy, args);
+    size = zrpLoggerFormatVaList(buffer,
+                                 sizeof buffer,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+        va_end(argsCopy);
+        return;
+    }
+#endif
+
+    /* Too large for the buffer, write the prefix and message apart. */
+    size = zrpLoggerFormatPrefix(
+        buffer, sizeof buffer, styled, level, &origin, pFile, line);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+    } else {
+        pLabel = zrpLoggerGetLevelLabel(styled, level);
+        fprintf(stderr, "%s:%d: %s", pFile, line, pLabel->pString);
+    }
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    vfprintf(stderr, pFormat, argsCopy);
+    va_end(argsCopy);
+#else
+    vfprintf(stderr, pFormat, args);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLog(enum ZrLogLevel level,
+             const char *pFile,
+             int line,
+             const char *pFormat,
+             ...)
+{
+    va_list args;
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    va_start(args, pFormat);
+    zrpLoggerLogVaList(level, pFile, line, pFormat, args);
+    va_end(args);
+}
+
+#endif /* ZRP_LOGGER_DEFINED */
+
+#ifndef ZRP_ATOMICS_DEFINED
+#define ZRP_ATOMICS_DEFINED
+
+/*
+   C89 doesn't provide any atomic operation, so the few ones needed are
+   implemented on top of the compiler intrinsics. On MSVC, the plain volatile
+   accesses are only ordered by the compiler barrier on x86 since it is
+   a strongly-ordered architecture, other architectures need a full fence.
+*/
+
+#if defined(__GNUC__)
+#define ZRP_ATOMICS_GNUC
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define ZRP_ATOMICS_MSVC
+#if defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32)
+#define ZRP_ATOMICS_FENCE() _ReadWriteBarrier()
+#else
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define ZRP_ATOMICS_FENCE() MemoryBarrier()
+#endif
+#else
+typedef char zrp_atomics_unsupported_compiler[-1];
+#endif
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeRelaxed(const volatile size_t *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeAcquire(const volatile size_t *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    size_t value;
+
+    value = *pValue;
+    ZRP_ATOMICS_FENCE();
+    return value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelaxed(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelease(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicFetchAddSize(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_add(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedExchangeAdd64((volatile __int64 *)pValue,
+                                             (__int64)value);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedExchangeAdd((volatile long *)pValue,
+                                           (long)value);
+#endif
+}
+
+/* May fail spuriously, callers are expected to retry in a loop. */
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangeSizeRelaxed(volatile size_t *pValue,
+                                    size_t expected,
+                                    size_t desired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(
+        pValue, &expected, desired, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedCompareExchange64((volatile __int64 *)pValue,
+                                                 (__int64)desired,
+                                                 (__int64)expected)
+           == expected;
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedCompareExchange(
+               (volatile long *)pValue, (long)desired, (long)expected)
+           == expected;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicLoadIntRelaxed(const volatile int *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreIntRelaxed(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchOrInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_or(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedOr((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchAndInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_and(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedAnd((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void *
+zrpAtomicLoadPointerAcquire(void *const volatile *ppValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(ppValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    void *pValue;
+
+    pValue = *ppValue;
+    ZRP_ATOMICS_FENCE();
+    return pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStorePointerRelease(void *volatile *ppValue, void *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(ppValue, pValue, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *ppValue = pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangePointer(void *volatile *ppValue,
+                                void *pExpected,
+                                void *pDesired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(ppValue,
+                                       &pExpected,
+                                       pDesired,
+                                       0,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return _InterlockedCompareExchangePointer(ppValue, pDesired, pExpected)
+           == pExpected;
+#endif
+}
+
+/* Hint to the CPU that the calling thread is busy-waiting. */
+ZRP_MAYBE_UNUSED static void
+zrpAtomicPause(void)
+{
+#if defined(ZRP_ATOMICS_GNUC)                                                  \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    __builtin_ia32_pause();
+#elif defined(ZRP_ATOMICS_GNUC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __asm__ __volatile__("yield");
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    _mm_pause();
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __yield();
+#endif
+}
+
+#endif /* ZRP_ATOMICS_DEFINED */
+
+#define ZRP_RINGBUFFER_ALIGN(size)                                             \
+    (((size) + ZR_CACHE_LINE_SIZE - 1) / ZR_CACHE_LINE_SIZE                    \
+     * ZR_CACHE_LINE_SIZE)
+
+#define ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(name, type, buffer, prefix)      \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE enum ZrStatus zrCreate##name(      \
+        struct buffer **ppBuffer, ZrSize capacity)                             \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(ppBuffer != NULL);                                           \
+                                                                               \
+        status = prefix##Create(ppBuffer, (size_t)capacity, sizeof(type));     \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create the ring buffer of type "          \
+                          "‘" #type "’ (requested capacity: %zu)\n",           \
+                          (size_t)capacity);                                   \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDestroy##name(              \
+        struct buffer *pBuffer)                                                \
+    {                                                                          \
+        if (pBuffer == NULL) {                                                 \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        zrFreeAligned(pBuffer);                                                \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, buffer)        \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrGet##name##Capacity(        \
+        ZrSize *pCapacity, const struct buffer *pBuffer)                       \
+    {                                                                          \
+        ZR_ASSERT(pCapacity != NULL);                                          \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+                                                                               \
+        *pCapacity = (ZrSize)(pBuffer->mask + 1);                              \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE int zrEnqueue##name(               \
+        struct buffer *pBuffer, type value)                                    \
+    {                                                                          \
+        ZrSize count;                                                          \
+                                                                               \
+        zrEnqueue##name##Batch(&count, pBuffer, 1, &value);                    \
+        return count != 0;                                                     \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE int zrDequeue##name(               \
+        type *pValue, struct buffer *pBuffer)                                  \
+    {                                                                          \
+        ZrSize count;                                                          \
+                                                                               \
+        zrDequeue##name##Batch(&count, pValue, pBuffer, 1);                    \
+        return count != 0;                                                     \
+    }
+
+/*
+   The SPSC variant keeps the positions of the consumer and of the producer
+   on separate cache lines, each next to a cached copy of the other position
+   so that the shared one only needs to be loaded again when the cached copy
+   says that the buffer looks full, or empty. Positions increase forever and
+   wrap around the range of `size_t`.
+*/
+
+struct ZrSpscRingBuffer {
+    unsigned char *pElements;
+    size_t mask;
+    size_t elementSize;
+    unsigned char sharedPadding[ZR_CACHE_LINE_SIZE - 3 * sizeof(size_t)];
+    volatile size_t head;
+    size_t cachedTail;
+    unsigned char headPadding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+    volatile size_t tail;
+    size_t cachedHead;
+    unsigned char tailPadding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpRingBufferGetCapacity(size_t *pCapacity,
+                         size_t capacity,
+                         size_t elementSize,
+                         size_t offset)
+{
+    size_t out;
+
+    ZR_ASSERT(pCapacity != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    out = 2;
+    while (out < capacity) {
+        if (out > (size_t)-1 / 2) {
+            ZRP_LOG_TRACE("the requested capacity is too large\n");
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;
+        }
+
+        out *= 2;
+    }
+
+    if (out > ((size_t)-1 - offset) / elementSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    *pCapacity = out;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpSpscRingBufferCreate(struct ZrSpscRingBuffer **ppBuffer,
+                        size_t capacity,
+                        size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrSpscRingBuffer *pBuffer;
+    size_t offset;
+
+    ZR_ASSERT(ppBuffer != NULL);
+
+    offset = ZRP_RINGBUFFER_ALIGN(sizeof *pBuffer);
+    status = zrpRingBufferGetCapacity(&capacity, capacity, elementSize, offset);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    pBuffer = (struct ZrSpscRingBuffer *)zrAllocateAligned(
+        (ZrSize)(offset + capacity * elementSize), ZR_CACHE_LINE_SIZE);
+    if (pBuffer == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the ring buffer\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pBuffer->pElements = (unsigned char *)pBuffer + offset;
+    pBuffer->mask = capacity - 1;
+    pBuffer->elementSize = elementSize;
+    pBuffer->head = 0;
+    pBuffer->cachedTail = 0;
+    pBuffer->tail = 0;
+    pBuffer->cachedHead = 0;
+
+    *ppBuffer = pBuffer;
+    return ZR_SUCCESS;
+}
+
+/* Number of elements, up to `size`, that the producer can write. */
+ZRP_MAYBE_UNUSED static size_t
+zrpSpscRingBufferAcquireWrite(size_t *pPosition,
+                              struct ZrSpscRingBuffer *pBuffer,
+                              size_t size)
+{
+    size_t available;
+
+    *pPosition = zrpAtomicLoadSizeRelaxed(&pBuffer->tail);
+    available = pBuffer->mask + 1 - (*pPosition - pBuffer->cachedHead);
+    if (available < size) {
+        pBuffer->cachedHead = zrpAtomicLoadSizeAcquire(&pBuffer->head);
+        available = pBuffer->mask + 1 - (*pPosition - pBuffer->cachedHead);
+    }
+
+    return available < size ? available : size;
+}
+
+/* Number of elements, up to `size`, that the consumer can read. */
+ZRP_MAYBE_UNUSED static size_t
+zrpSpscRingBufferAcquireRead(size_t *pPosition,
+                             struct ZrSpscRingBuffer *pBuffer,
+                             size_t size)
+{
+    size_t available;
+
+    *pPosition = zrpAtomicLoadSizeRelaxed(&pBuffer->head);
+    available = pBuffer->cachedTail - *pPosition;
+    if (available < size) {
+        pBuffer->cachedTail = zrpAtomicLoadSizeAcquire(&pBuffer->tail);
+        available = pBuffer->cachedTail - *pPosition;
+    }
+
+    return available < size ? available : size;
+}
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_SPSC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        struct ZrSpscRingBuffer *pBuffer,                                      \
+        ZrSize size,                                                           \
+        const type *pValues)                                                   \
+    {                                                                          \
+        type *pElements;                                                       \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+                                                                               \
+        count = zrpSpscRingBufferAcquireWrite(                                 \
+            &position, pBuffer, (size_t)size);                                 \
+        pElements = (type *)(void *)pBuffer->pElements;                        \
+        for (i = 0; i < count; ++i) {                                          \
+            pElements[(position + i) & pBuffer->mask] = pValues[i];            \
+        }                                                                      \
+                                                                               \
+        if (count > 0) {                                                       \
+            zrpAtomicStoreSizeRelease(&pBuffer->tail, position + count);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_SPSC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        type *pValues,                                                         \
+        struct ZrSpscRingBuffer *pBuffer,                                      \
+        ZrSize size)                                                           \
+    {                                                                          \
+        const type *pElements;                                                 \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+                                                                               \
+        count = zrpSpscRingBufferAcquireRead(                                  \
+            &position, pBuffer, (size_t)size);                                 \
+        pElements = (const type *)(const void *)pBuffer->pElements;            \
+        for (i = 0; i < count; ++i) {                                          \
+            pValues[i] = pElements[(position + i) & pBuffer->mask];            \
+        }                                                                      \
+                                                                               \
+        if (count > 0) {                                                       \
+            zrpAtomicStoreSizeRelease(&pBuffer->head, position + count);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+/*
+   The MPMC variant follows Dmitry Vyukov's bounded queue, where each element
+   is paired with a sequence number telling whether it is ready to be written
+   for a given position, when equal to that position, or ready to be read,
+   when equal to that position plus one. Producers and consumers claim their
+   positions by moving their respective counter forward with a single
+   compare-and-swap, covering as many consecutive elements as are found ready.
+
+   The sequence numbers are stored apart from the elements to allow for any
+   element type without having to worry about alignment.
+*/
+
+struct ZrMpmcRingBuffer {
+    volatile size_t *pSequences;
+    unsigned char *pElements;
+    size_t mask;
+    size_t elementSize;
+    unsigned char sharedPadding[ZR_CACHE_LINE_SIZE - 4 * sizeof(size_t)];
+    volatile size_t enqueuePosition;
+    unsigned char enqueuePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+    volatile size_t dequeuePosition;
+    unsigned char dequeuePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+};
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpMpmcRingBufferCreate(struct ZrMpmcRingBuffer **ppBuffer,
+                        size_t capacity,
+                        size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrMpmcRingBuffer *pBuffer;
+    size_t sequencesOffset;
+    size_t elementsOffset;
+    size_t i;
+
+    ZR_ASSERT(ppBuffer != NULL);
+
+    sequencesOffset = ZRP_RINGBUFFER_ALIGN(sizeof *pBuffer);
+    status = zrpRingBufferGetCapacity(
+        &capacity, capacity, elementSize + sizeof(size_t), sequencesOffset);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    elementsOffset = ZRP_RINGBUFFER_ALIGN(sequencesOffset
+                                          + capacity * sizeof(size_t));
+    if (elementsOffset < sequencesOffset
+        || capacity > ((size_t)-1 - elementsOffset) / elementSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    pBuffer = (struct ZrMpmcRingBuffer *)zrAllocateAligned(
+        (ZrSize)(elementsOffset + capacity * elementSize), ZR_CACHE_LINE_SIZE);
+    if (pBuffer == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the ring buffer\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pBuffer->pSequences
+        = (volatile size_t *)(void *)((unsigned char *)pBuffer
+                                      + sequencesOffset);
+    pBuffer->pElements = (unsigned char *)pBuffer + elementsOffset;
+    pBuffer->mask = capacity - 1;
+    pBuffer->elementSize = elementSize;
+    pBuffer->enqueuePosition = 0;
+    pBuffer->dequeuePosition = 0;
+    for (i = 0; i < capacity; ++i) {
+        pBuffer->pSequences[i] = i;
+    }
+
+    *ppBuffer = pBuffer;
+    return ZR_SUCCESS;
+}
+
+/*
+   Claim up to `size` consecutive positions from the given counter, for which
+   the sequence numbers are equal to the position plus the given offset.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpMpmcRingBufferClaim(size_t *pPosition,
+                       struct ZrMpmcRingBuffer *pBuffer,
+                       volatile size_t *pCounter,
+                       size_t offset,
+                       size_t size)
+{
+    size_t position;
+    size_t sequence;
+    size_t count;
+
+    ZR_ASSERT(size > 0);
+
+    position = zrpAtomicLoadSizeRelaxed(pCounter);
+    for (;;) {
+        sequence = zrpAtomicLoadSizeAcquire(
+            &pBuffer->pSequences[position & pBuffer->mask]);
+        if (sequence != position + offset) {
+            /*
+               A sequence number lagging behind means that the buffer is full,
+               or empty, otherwise another thread already claimed the
+               position.
+            */
+            if ((ptrdiff_t)(sequence - (position + offset)) < 0) {
+                return 0;
+            }
+
+            position = zrpAtomicLoadSizeRelaxed(pCounter);
+            continue;
+        }
+
+        count = 1;
+        while (count < size
+               && zrpAtomicLoadSizeAcquire(
+                      &pBuffer->pSequences[(position + count) & pBuffer->mask])
+                      == position + count + offset) {
+            ++count;
+        }
+
+        if (zrpAtomicCompareExchangeSizeRelaxed(
+                pCounter, position, position + count)) {
+            *pPosition = position;
+            return count;
+        }
+
+        position = zrpAtomicLoadSizeRelaxed(pCounter);
+    }
+}
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_MPMC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        struct ZrMpmcRingBuffer *pBuffer,                                      \
+        ZrSize size,                                                           \
+        const type *pValues)                                                   \
+    {                                                                          \
+        type *pElements;                                                       \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t index;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+                                                                               \
+        count = size == 0 ? 0                                                  \
+                          : zrpMpmcRingBufferClaim(&position,                  \
+                                                   pBuffer,                    \
+                                                   &pBuffer->enqueuePosition,  \
+                                                   0,                          \
+                                                   (size_t)size);              \
+        pElements = (type *)(void *)pBuffer->pElements;                        \
+        for (i = 0; i < count; ++i) {                                          \
+            index = (position + i) & pBuffer->mask;                            \
+            pElements[index] = pValues[i];                                     \
+            zrpAtomicStoreSizeRelease(&pBuffer->pSequences[index],             \
+                                      position + i + 1);                       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_MPMC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        type *pValues,                                                         \
+        struct ZrMpmcRingBuffer *pBuffer,                                      \
+        ZrSize size)                                                           \
+    {                                                                          \
+        const type *pElements;                                                 \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t index;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+                                                                               \
+        count = size == 0 ? 0                                                  \
+                          : zrpMpmcRingBufferClaim(&position,                  \
+                                                   pBuffer,                    \
+                                                   &pBuffer->dequeuePosition,  \
+                                                   1,                          \
+                                                   (size_t)size);              \
+        pElements = (const type *)(const void *)pBuffer->pElements;            \
+        for (i = 0; i < count; ++i) {                                          \
+            index = (position + i) & pBuffer->mask;                            \
+            pValues[i] = pElements[index];                                     \
+            zrpAtomicStoreSizeRelease(&pBuffer->pSequences[index],             \
+                                      position + i + pBuffer->mask + 1);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#undef ZR_MAKE_SPSC_RING_BUFFER
+#define ZR_MAKE_SPSC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(                                     \
+        name, type, ZrSpscRingBuffer, zrpSpscRingBuffer)                       \
+    ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, ZrSpscRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, ZrSpscRingBuffer)  \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_SPSC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_SPSC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, ZrSpscRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, ZrSpscRingBuffer)
+
+#undef ZR_MAKE_MPMC_RING_BUFFER
+#define ZR_MAKE_MPMC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(                                     \
+        name, type, ZrMpmcRingBuffer, zrpMpmcRingBuffer)                       \
+    ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, ZrMpmcRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, ZrMpmcRingBuffer)  \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_MPMC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_MPMC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, ZrMpmcRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, ZrMpmcRingBuffer)
+
+#endif /* ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
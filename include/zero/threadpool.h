@@ -0,0 +1,2206 @@
+/*
+   The MIT License (MIT)
+
+   Copyright (c) 2018 Christopher Crouzet
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+   THE SOFTWARE.
+*/
+
+#ifndef ZERO_THREADPOOL_H
+#define ZERO_THREADPOOL_H
+
+#define ZR_THREADPOOL_MAJOR_VERSION 0
+#define ZR_THREADPOOL_MINOR_VERSION 1
+#define ZR_THREADPOOL_PATCH_VERSION 0
+
+#ifndef ZRP_ARCH_DEFINED
+#define ZRP_ARCH_DEFINED
+#if defined(__x86_64__) || defined(_M_X64)
+#define ZRP_ARCH_X86_64
+#elif defined(__i386) || defined(_M_IX86)
+#define ZRP_ARCH_X86_32
+#elif defined(__itanium__) || defined(_M_IA64)
+#define ZRP_ARCH_ITANIUM_64
+#elif defined(__powerpc64__) || defined(__ppc64__)
+#define ZRP_ARCH_POWERPC_64
+#elif defined(__powerpc__) || defined(__ppc__)
+#define ZRP_ARCH_POWERPC_32
+#elif defined(__aarch64__)
+#define ZRP_ARCH_ARM_64
+#elif defined(__arm__)
+#define ZRP_ARCH_ARM_32
+#endif
+#endif /* ZRP_ARCH_DEFINED */
+
+/*
+   The environment macro represents whether the code is to be generated for a
+   32-bit or 64-bit target platform. Some CPUs, such as the x86-64 processors,
+   allow running code in 32-bit mode if compiled using the -m32 or -mx32
+   compiler switches, in which case `ZR_ENVIRONMENT` is set to 32.
+*/
+#ifndef ZR_ENVIRONMENT
+#if (!defined(ZRP_ARCH_X86_64) || defined(__ILP32__))                          \
+    && !defined(ZRP_ARCH_ITANIUM_64) && !defined(ZRP_ARCH_POWERPC_64)          \
+    && !defined(ZRP_ARCH_ARM_64)
+#define ZR_ENVIRONMENT 32
+#else
+#define ZR_ENVIRONMENT 64
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_environment_value
+    [ZR_ENVIRONMENT == 32 || ZR_ENVIRONMENT == 64 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZR_ENVIRONMENT */
+
+#ifndef ZRP_PLATFORM_DEFINED
+#define ZRP_PLATFORM_DEFINED
+#if defined(_WIN32)
+#define ZRP_PLATFORM_WINDOWS
+#elif defined(__unix__) || defined(__APPLE__)
+#define ZRP_PLATFORM_UNIX
+#if defined(__APPLE__)
+#define ZRP_PLATFORM_DARWIN
+#if TARGET_OS_IPHONE == 1
+#define ZRP_PLATFORM_IOS
+#elif TARGET_OS_MAC == 1
+#define ZRP_PLATFORM_MACOS
+#endif
+#elif defined(__linux__)
+#define ZRP_PLATFORM_LINUX
+#endif
+#endif
+#endif /* ZRP_PLATFORM_DEFINED */
+
+#ifndef ZRP_FIXED_TYPES_DEFINED
+#define ZRP_FIXED_TYPES_DEFINED
+#ifdef ZR_USE_STD_FIXED_TYPES
+#include <stdint.h>
+typedef int8_t ZrInt8;
+typedef uint8_t ZrUint8;
+typedef int16_t ZrInt16;
+typedef uint16_t ZrUint16;
+typedef int32_t ZrInt32;
+typedef uint32_t ZrUint32;
+typedef int64_t ZrInt64;
+typedef uint64_t ZrUint64;
+#else
+/*
+   The focus here is on the common data models, that is ILP32 (most recent
+   32-bit systems), LP64 (Unix-like systems), and LLP64 (Windows). All of these
+   models have the `char` type set to 8 bits, `short` to 16 bits, `int` to
+   32 bits, and `long long` to 64 bits.
+*/
+#ifdef ZR_INT8
+typedef ZR_INT8 ZrInt8;
+#else
+typedef char ZrInt8;
+#endif
+#ifdef ZR_UINT8
+typedef ZR_UINT8 ZrUint8;
+#else
+typedef unsigned char ZrUint8;
+#endif
+#ifdef ZR_INT16
+typedef ZR_INT16 ZrInt16;
+#else
+typedef short ZrInt16;
+#endif
+#ifdef ZR_UINT16
+typedef ZR_UINT16 ZrUint16;
+#else
+typedef unsigned short ZrUint16;
+#endif
+#ifdef ZR_INT32
+typedef ZR_INT32 ZrInt32;
+#else
+typedef int ZrInt32;
+#endif
+#ifdef ZR_UINT32
+typedef ZR_UINT32 ZrUint32;
+#else
+typedef unsigned int ZrUint32;
+#endif
+#ifdef ZR_INT64
+typedef ZR_INT64 ZrInt64;
+#else
+typedef long long ZrInt64;
+#endif
+#ifdef ZR_UINT64
+typedef ZR_UINT64 ZrUint64;
+#else
+typedef unsigned long long ZrUint64;
+#endif
+#endif /* ZR_USE_STD_FIXED_TYPES */
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char zrp_invalid_int8_type[sizeof(ZrInt8) == 1 ? 1 : -1];
+typedef char zrp_invalid_uint8_type[sizeof(ZrUint8) == 1 ? 1 : -1];
+typedef char zrp_invalid_int16_type[sizeof(ZrInt16) == 2 ? 1 : -1];
+typedef char zrp_invalid_uint16_type[sizeof(ZrUint16) == 2 ? 1 : -1];
+typedef char zrp_invalid_int32_type[sizeof(ZrInt32) == 4 ? 1 : -1];
+typedef char zrp_invalid_uint32_type[sizeof(ZrUint32) == 4 ? 1 : -1];
+typedef char zrp_invalid_int64_type[sizeof(ZrInt64) == 8 ? 1 : -1];
+typedef char zrp_invalid_uint64_type[sizeof(ZrUint64) == 8 ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_FIXED_TYPES_DEFINED */
+
+#ifndef ZRP_BASIC_TYPES_DEFINED
+#define ZRP_BASIC_TYPES_DEFINED
+#ifdef ZR_USE_STD_BASIC_TYPES
+#include <stddef.h>
+typedef size_t ZrSize;
+#else
+/*
+   The C standard provides no guarantees about the size of the type `size_t`,
+   and some exotic platforms will in fact provide original values, but this
+   should cover most of the use cases.
+*/
+#ifdef ZR_SIZE_TYPE
+typedef ZR_SIZE_TYPE ZrSize;
+#elif ZR_ENVIRONMENT == 32
+typedef ZrUint32 ZrSize;
+#else
+typedef ZrUint64 ZrSize;
+#endif
+#endif
+#ifdef ZR_DEFINE_IMPLEMENTATION
+typedef char
+    zrp_invalid_size_type[sizeof(ZrSize) == sizeof sizeof(void *) ? 1 : -1];
+#endif /* ZR_DEFINE_IMPLEMENTATION */
+#endif /* ZRP_BASIC_TYPES_DEFINED */
+
+#ifndef ZRP_STATUS_DEFINED
+#define ZRP_STATUS_DEFINED
+enum ZrStatus {
+    ZR_SUCCESS = 0,
+    ZR_ERROR = -1,
+    ZR_ERROR_ALLOCATION = -2,
+    ZR_ERROR_MAX_SIZE_EXCEEDED = -3
+};
+#endif /* ZRP_STATUS_DEFINED */
+
+#if defined(ZR_THREADPOOL_SPECIFY_INTERNAL_LINKAGE)                            \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_THREADPOOL_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_THREADPOOL_LINKAGE extern "C"
+#else
+#define ZRP_THREADPOOL_LINKAGE extern
+#endif
+
+struct ZrThreadPool;
+
+struct ZrParallelChunkTiming {
+    ZrSize begin;
+    ZrSize end;
+    ZrSize thread;
+    ZrUint64 start;
+    ZrUint64 duration;
+};
+
+typedef void (*ZrParallelForFunction)(void *pData,
+                                      ZrSize chunk,
+                                      ZrSize begin,
+                                      ZrSize end);
+
+ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrCreateThreadPool(struct ZrThreadPool **ppPool, ZrSize threadCount);
+
+ZRP_THREADPOOL_LINKAGE void
+zrDestroyThreadPool(struct ZrThreadPool *pPool);
+
+ZRP_THREADPOOL_LINKAGE void
+zrGetThreadPoolThreadCount(ZrSize *pThreadCount,
+                           const struct ZrThreadPool *pPool);
+
+/*
+   The chunks split the elements of the array at the given address, which may
+   be NULL if unknown, so that the threads writing to different chunks don't
+   share cache lines.
+*/
+ZRP_THREADPOOL_LINKAGE void
+zrGetParallelChunkCount(ZrSize *pChunkCount,
+                        const struct ZrThreadPool *pPool,
+                        const void *pArray,
+                        ZrSize size,
+                        ZrSize elementSize);
+
+/*
+   A pool runs a single job at a time, which the calling thread takes part in
+   until all the chunks are processed. The parallel functions must thus not be
+   called concurrently on the same pool, nor from within their callbacks.
+*/
+ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrParallelFor(struct ZrThreadPool *pPool,
+              const void *pArray,
+              ZrSize size,
+              ZrSize elementSize,
+              ZrParallelForFunction pfnFunction,
+              void *pData,
+              struct ZrParallelChunkTiming *pTimings);
+
+#define ZRP_THREADPOOL_DECLARE_FOR_EACH_FUNCTION(name, type)                   \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelForEach##name(              \
+        struct ZrThreadPool *pPool,                                            \
+        type *pArray,                                                          \
+        ZrSize size,                                                           \
+        void (*pfnFunction)(type * pElement, void *pData),                     \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZRP_THREADPOOL_DECLARE_TRANSFORM_FUNCTION(name, type)                  \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelTransform##name(            \
+        struct ZrThreadPool *pPool,                                            \
+        type *pOutput,                                                         \
+        const type *pInput,                                                    \
+        ZrSize size,                                                           \
+        void (*pfnFunction)(type * pOutput, const type *pInput, void *pData),  \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZRP_THREADPOOL_DECLARE_REDUCE_FUNCTION(name, type)                     \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelReduce##name(               \
+        struct ZrThreadPool *pPool,                                            \
+        type *pResult,                                                         \
+        const type *pArray,                                                    \
+        ZrSize size,                                                           \
+        type initialValue,                                                     \
+        type (*pfnFunction)(type accumulator, type value, void *pData),        \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZR_MAKE_PARALLEL_ALGORITHMS(name, type)                                \
+    ZRP_THREADPOOL_DECLARE_FOR_EACH_FUNCTION(name, type);                      \
+    ZRP_THREADPOOL_DECLARE_TRANSFORM_FUNCTION(name, type);                     \
+    ZRP_THREADPOOL_DECLARE_REDUCE_FUNCTION(name, type);
+
+#endif /* ZERO_THREADPOOL_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_THREADPOOL_IMPLEMENTATION_DEFINED
+#define ZRP_THREADPOOL_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_MALLOC
+#include <stdlib.h>
+#define ZR_MALLOC malloc
+#endif /* ZR_MALLOC */
+
+#ifndef ZR_FREE
+#include <stdlib.h>
+#define ZR_FREE free
+#endif /* ZR_FREE */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+#ifndef ZRP_UNUSED_DEFINED
+#define ZRP_UNUSED_DEFINED
+#ifdef __GNUC__
+#define ZRP_MAYBE_UNUSED __attribute__((unused))
+#else
+#define ZRP_MAYBE_UNUSED
+#endif
+#endif /* ZRP_UNUSED_DEFINED */
+
+#ifndef ZRP_LOGGING_DEFINED
+#define ZRP_LOGGING_DEFINED
+
+#if defined(ZR_SET_LOGGING_LEVEL_DEBUG)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#elif defined(ZR_SET_LOGGING_LEVEL_TRACE)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_TRACE
+#elif defined(ZR_SET_LOGGING_LEVEL_INFO)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_INFO
+#elif defined(ZR_SET_LOGGING_LEVEL_WARNING)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#elif defined(ZR_SET_LOGGING_LEVEL_ERROR)
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_ERROR
+#elif defined(ZR_ENABLE_DEBUGGING)                                             \
+    || (!defined(ZR_DISABLE_DEBUGGING)                                         \
+        && (defined(DEBUG) || !defined(NDEBUG)))
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_DEBUG
+#else
+#define ZRP_LOGGING_LEVEL ZR_LOG_LEVEL_WARNING
+#endif
+
+#ifdef ZR_DISABLE_LOGGING
+#define ZRP_LOGGING 0
+#else
+#define ZRP_LOGGING 1
+#endif /* ZR_DISABLE_LOGGING */
+
+#ifndef ZR_LOG
+#define ZR_LOG(level, ...)                                                     \
+    do {                                                                       \
+        if (ZRP_LOGGING && level <= ZRP_LOGGING_LEVEL) {                       \
+            zrpLoggerLog(level, __FILE__, __LINE__, __VA_ARGS__);              \
+        }                                                                      \
+    } while (0)
+#endif /* ZR_LOG */
+
+#define ZRP_LOG_DEBUG(...) ZR_LOG(ZR_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define ZRP_LOG_TRACE(...) ZR_LOG(ZR_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#define ZRP_LOG_INFO(...) ZR_LOG(ZR_LOG_LEVEL_INFO, __VA_ARGS__)
+
+#define ZRP_LOG_WARNING(...) ZR_LOG(ZR_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+#define ZRP_LOG_ERROR(...) ZR_LOG(ZR_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif /* ZRP_LOGGING_DEFINED */
+
+#ifndef ZRP_LOGLEVEL_DEFINED
+#define ZRP_LOGLEVEL_DEFINED
+
+enum ZrLogLevel {
+    ZR_LOG_LEVEL_ERROR = 0,
+    ZR_LOG_LEVEL_WARNING = 1,
+    ZR_LOG_LEVEL_INFO = 2,
+    ZR_LOG_LEVEL_TRACE = 3,
+    ZR_LOG_LEVEL_DEBUG = 4
+};
+
+#endif /* ZRP_LOGLEVEL_DEFINED */
+
+#ifndef ZRP_LOGGER_DEFINED
+#define ZRP_LOGGER_DEFINED
+
+#if !defined(ZR_DISABLE_LOG_STYLING) && defined(ZRP_PLATFORM_UNIX)             \
+    && defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 1
+#include <unistd.h>
+#define ZRP_LOGGER_LOG_STYLING 1
+#else
+#define ZRP_LOGGER_LOG_STYLING 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_TIMESTAMPS)
+#define ZRP_LOGGER_LOG_TIMESTAMPS 1
+#else
+#define ZRP_LOGGER_LOG_TIMESTAMPS 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_THREAD_IDS)
+#define ZRP_LOGGER_LOG_THREAD_IDS 1
+#else
+#define ZRP_LOGGER_LOG_THREAD_IDS 0
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_LOGGER_USE_CLOCK_GETTIME
+#else
+#include <sys/time.h>
+#endif
+#if defined(ZRP_PLATFORM_LINUX)
+#include <unistd.h>
+#if defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE)
+#include <sys/syscall.h>
+#if defined(SYS_gettid)
+#define ZRP_LOGGER_USE_GETTID
+#endif
+#endif
+#endif
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(va_copy) && defined(__va_copy)
+#define va_copy __va_copy
+#endif
+
+/*
+   `vsnprintf()` only appeared with C99 and C++11, C89 builds write the prefix
+   and the message of each record with separate calls instead.
+*/
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)                 \
+    || (defined(__cplusplus) && __cplusplus >= 201103L)                        \
+    || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)                \
+    || (defined(__GNUC__) && !defined(__STRICT_ANSI__))                        \
+    || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define ZRP_LOGGER_USE_VSNPRINTF
+#endif
+
+#if defined(_MSC_VER)
+#define ZRP_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define ZRP_LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Size of `YYYY-MM-DDTHH:MM:SS`. */
+#define ZRP_LOGGER_DATE_TIME_SIZE 19
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.mmmZ `. */
+#define ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 6)
+
+/* Records fitting into this size are written with a single call. */
+#define ZRP_LOGGER_LINE_BUFFER_SIZE 512
+
+struct ZrpLoggerLabel {
+    const char *pString;
+    size_t size;
+};
+
+#define ZRP_LOGGER_MAKE_LABEL(string)                                          \
+    {                                                                          \
+        string, sizeof string - 1                                              \
+    }
+
+/*
+   The level part of the prefixes, including the ANSI style codes when
+   styling, indexed by level.
+*/
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel zrpLoggerLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("error: "),
+       ZRP_LOGGER_MAKE_LABEL("warning: "),
+       ZRP_LOGGER_MAKE_LABEL("info: "),
+       ZRP_LOGGER_MAKE_LABEL("trace: "),
+       ZRP_LOGGER_MAKE_LABEL("debug: ")};
+
+#if ZRP_LOGGER_LOG_STYLING
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel
+    zrpLoggerStyledLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("\x1b[1;31merror\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;33mwarning\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;32minfo\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;36mtrace\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;35mdebug\x1b[0m: ")};
+
+/*
+   Whether the standard error stream is a terminal, detected on the first
+   record rather than on each one, or -1 if not detected yet. Concurrent
+   detections store the same value.
+*/
+static int zrpLoggerStderrStyled = -1;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+ZRP_MAYBE_UNUSED static int
+zrpLoggerIsStderrStyled(void)
+{
+#if ZRP_LOGGER_LOG_STYLING
+    int styled;
+
+#if defined(__GNUC__)
+    styled = __atomic_load_n(&zrpLoggerStderrStyled, __ATOMIC_RELAXED);
+#else
+    styled = *(volatile int *)&zrpLoggerStderrStyled;
+#endif
+    if (styled < 0) {
+        styled = isatty(STDERR_FILENO) ? 1 : 0;
+#if defined(__GNUC__)
+        __atomic_store_n(&zrpLoggerStderrStyled, styled, __ATOMIC_RELAXED);
+#else
+        *(volatile int *)&zrpLoggerStderrStyled = styled;
+#endif
+    }
+
+    return styled;
+#else
+    return 0;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+}
+
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel *
+zrpLoggerGetLevelLabel(int styled, enum ZrLogLevel level)
+{
+    ZR_ASSERT((int)level >= (int)ZR_LOG_LEVEL_ERROR
+              && (int)level <= (int)ZR_LOG_LEVEL_DEBUG);
+
+#if ZRP_LOGGER_LOG_STYLING
+    if (styled) {
+        return &zrpLoggerStyledLevelLabels[level];
+    }
+#else
+    (void)styled;
+#endif /* ZRP_LOGGER_LOG_STYLING */
+
+    return &zrpLoggerLevelLabels[level];
+}
+
+/* Copy data at the given offset, as much as the buffer can hold. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerCopy(char *pBuffer,
+              size_t size,
+              size_t *pOffset,
+              const char *pData,
+              size_t dataSize)
+{
+    size_t copySize;
+
+    if (*pOffset < size) {
+        copySize = size - *pOffset;
+        if (copySize > dataSize) {
+            copySize = dataSize;
+        }
+
+        memcpy(&pBuffer[*pOffset], pData, copySize);
+    }
+
+    *pOffset += dataSize;
+}
+
+/*
+   Where and when a record was logged, captured by the logging thread since
+   the formatting may happen on another one. The fields are only set when
+   the prefixes include them.
+*/
+struct ZrpLoggerOrigin {
+    ZrUint64 time;
+    unsigned long threadId;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteDigits(char *pBuffer, ZrUint64 value, size_t count)
+{
+    while (count-- > 0) {
+        pBuffer[count] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/*
+   Time in milliseconds since the epoch, read from a coarse clock when there
+   is one since a tick per millisecond or so is enough for prefixes.
+*/
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpLoggerGetCoarseTime(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    FILETIME time;
+
+    /* Intervals of 100 nanoseconds since 1601-01-01. */
+    GetSystemTimeAsFileTime(&time);
+    return ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+            - 116444736000000000ull)
+           / 10000;
+#elif defined(ZRP_LOGGER_USE_CLOCK_GETTIME)
+    struct timespec time;
+
+#if defined(CLOCK_REALTIME_COARSE)
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &time) != 0) {
+        return 0;
+    }
+#else
+    if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+        return 0;
+    }
+#endif
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+#elif defined(ZRP_PLATFORM_UNIX)
+    struct timeval time;
+
+    if (gettimeofday(&time, NULL) != 0) {
+        return 0;
+    }
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_usec / 1000;
+#else
+    return 0;
+#endif
+}
+
+/*
+   Format the UTC date and time of a number of seconds since the epoch as
+   `YYYY-MM-DDTHH:MM:SS`, which is cached per thread since it only changes
+   once per second.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatDateTime(char *pBuffer, ZrUint64 seconds)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedSeconds;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedDateTime[ZRP_LOGGER_DATE_TIME_SIZE];
+#endif
+    ZrUint64 days;
+    ZrUint64 era;
+    ZrUint64 dayOfEra;
+    ZrUint64 yearOfEra;
+    ZrUint64 dayOfYear;
+    ZrUint64 shiftedMonth;
+    ZrUint64 month;
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    if (seconds + 1 == cachedSeconds) {
+        memcpy(pBuffer, cachedDateTime, ZRP_LOGGER_DATE_TIME_SIZE);
+        return;
+    }
+#endif
+
+    /* Civil date from the days since 1970-01-01, in eras of 400 years. */
+    days = seconds / 86400 + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                 - dayOfEra / 146096)
+                / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+
+    zrpLoggerWriteDigits(
+        &pBuffer[0], yearOfEra + era * 400 + (month <= 2 ? 1 : 0), 4);
+    pBuffer[4] = '-';
+    zrpLoggerWriteDigits(&pBuffer[5], month, 2);
+    pBuffer[7] = '-';
+    zrpLoggerWriteDigits(
+        &pBuffer[8], dayOfYear - (153 * shiftedMonth + 2) / 5 + 1, 2);
+    pBuffer[10] = 'T';
+    zrpLoggerWriteDigits(&pBuffer[11], seconds % 86400 / 3600, 2);
+    pBuffer[13] = ':';
+    zrpLoggerWriteDigits(&pBuffer[14], seconds % 3600 / 60, 2);
+    pBuffer[16] = ':';
+    zrpLoggerWriteDigits(&pBuffer[17], seconds % 60, 2);
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    /* Offset by one to not match the zero-initialized cache. */
+    cachedSeconds = seconds + 1;
+    memcpy(cachedDateTime, pBuffer, ZRP_LOGGER_DATE_TIME_SIZE);
+#endif
+}
+
+/*
+   Format a time in milliseconds since the epoch as it appears in prefixes,
+   reusing the previous result of the thread while the coarse clock doesn't
+   tick, which is common at high logging rates.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatPrefixTimestamp(char *pBuffer, ZrUint64 time)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedTime;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedTimestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+
+    if (time + 1 == cachedTime) {
+        memcpy(pBuffer, cachedTimestamp, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+        return;
+    }
+#endif
+
+    zrpLoggerFormatDateTime(pBuffer, time / 1000);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time % 1000, 3);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 4] = 'Z';
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 5] = ' ';
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    cachedTime = time + 1;
+    memcpy(cachedTimestamp, pBuffer, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+#endif
+}
+
+/*
+   Identifier of the calling thread, as known by the system when it can be
+   retrieved, or otherwise as assigned in the order the threads first ask
+   for it. On Linux, `syscall()` is only declared with `_DEFAULT_SOURCE` or
+   `_GNU_SOURCE`, so strict C99 builds get the latter.
+*/
+ZRP_MAYBE_UNUSED static unsigned long
+zrpLoggerGetThreadId(void)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL unsigned long threadId;
+
+    if (threadId != 0) {
+        return threadId;
+    }
+#else
+    unsigned long threadId;
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    threadId = (unsigned long)GetCurrentThreadId();
+#elif defined(ZRP_LOGGER_USE_GETTID)
+    threadId = (unsigned long)syscall(SYS_gettid);
+#else
+    {
+        static unsigned long threadCount;
+
+#if defined(__GNUC__)
+        threadId = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+#else
+        threadId = ++threadCount;
+#endif
+    }
+#endif
+
+    return threadId;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerGetOrigin(struct ZrpLoggerOrigin *pOrigin)
+{
+    ZR_ASSERT(pOrigin != NULL);
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    pOrigin->time = zrpLoggerGetCoarseTime();
+#else
+    pOrigin->time = 0;
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    pOrigin->threadId = zrpLoggerGetThreadId();
+#else
+    pOrigin->threadId = 0;
+#endif
+}
+
+/*
+   Format the prefix of a record into the given buffer, truncating it if
+   needed, and return the size that it requires, not counting the terminating
+   null character.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatPrefix(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line)
+{
+    const struct ZrpLoggerLabel *pLabel;
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    char timestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+#endif
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    char threadId[24];
+    size_t threadIdOffset;
+    unsigned long threadIdValue;
+#endif
+    char digits[16];
+    size_t digitCount;
+    size_t offset;
+    unsigned int value;
+
+    ZR_ASSERT(pBuffer != NULL || size == 0);
+    ZR_ASSERT(pOrigin != NULL);
+    ZR_ASSERT(pFile != NULL);
+
+    (void)pOrigin;
+    offset = 0;
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    zrpLoggerFormatPrefixTimestamp(timestamp, pOrigin->time);
+    zrpLoggerCopy(pBuffer, size, &offset, timestamp, sizeof timestamp);
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    threadIdValue = pOrigin->threadId;
+    threadIdOffset = sizeof threadId;
+    threadId[--threadIdOffset] = ' ';
+    threadId[--threadIdOffset] = ']';
+    do {
+        threadId[--threadIdOffset] = (char)('0' + threadIdValue % 10);
+        threadIdValue /= 10;
+    } while (threadIdValue > 0);
+
+    threadId[--threadIdOffset] = '[';
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &threadId[threadIdOffset],
+                  sizeof threadId - threadIdOffset);
+#endif
+
+    value = line < 0 ? 0u - (unsigned int)line : (unsigned int)line;
+    digitCount = sizeof digits;
+    do {
+        digits[--digitCount] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (line < 0) {
+        digits[--digitCount] = '-';
+    }
+
+    pLabel = zrpLoggerGetLevelLabel(styled, level);
+
+    zrpLoggerCopy(pBuffer, size, &offset, pFile, strlen(pFile));
+    zrpLoggerCopy(pBuffer, size, &offset, ":", 1);
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &digits[digitCount],
+                  sizeof digits - digitCount);
+    zrpLoggerCopy(pBuffer, size, &offset, ": ", 2);
+    zrpLoggerCopy(pBuffer, size, &offset, pLabel->pString, pLabel->size);
+
+    if (size > 0) {
+        pBuffer[offset < size ? offset : size - 1] = '\0';
+    }
+
+    return offset;
+}
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+/* Same as `zrpLoggerFormatPrefix()` but for a whole record. */
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatVaList(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    size_t prefixSize;
+    int messageSize;
+
+    ZR_ASSERT(pFormat != NULL);
+
+    prefixSize = zrpLoggerFormatPrefix(
+        pBuffer, size, styled, level, pOrigin, pFile, line);
+    if (prefixSize < size) {
+        messageSize = vsnprintf(
+            &pBuffer[prefixSize], size - prefixSize, pFormat, args);
+    } else {
+        messageSize = vsnprintf(NULL, 0, pFormat, args);
+    }
+
+    if (messageSize < 0) {
+        return prefixSize;
+    }
+
+    return prefixSize + (size_t)messageSize;
+}
+#endif /* ZRP_LOGGER_USE_VSNPRINTF */
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLogVaList(enum ZrLogLevel level,
+                   const char *pFile,
+                   int line,
+                   const char *pFormat,
+                   va_list args)
+{
+    char buffer[ZRP_LOGGER_LINE_BUFFER_SIZE];
+    struct ZrpLoggerOrigin origin;
+    const struct ZrpLoggerLabel *pLabel;
+    size_t size;
+    int styled;
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_list argsCopy;
+#endif
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    styled = zrpLoggerIsStderrStyled();
+    zrpLoggerGetOrigin(&origin);
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_copy(argsCopy, args);
+    size = zrpLoggerFormatVaList(buffer,
+                                 sizeof buffer,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+        va_end(argsCopy);
+        return;
+    }
+#endif
+
+    /* Too large for the buffer, write the prefix and message apart. */
+    size = zrpLoggerFormatPrefix(
+        buffer, sizeof buffer, styled, level, &origin, pFile, line);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+    } else {
+        pLabel = zrpLoggerGetLevelLabel(styled, level);
+        fprintf(stderr, "%s:%d: %s", pFile, line, pLabel->pString);
+    }
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    vfprintf(stderr, pFormat, argsCopy);
+    va_end(argsCopy);
+#else
+    vfprintf(stderr, pFormat, args);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLog(enum ZrLogLevel level,
+             const char *pFile,
+             int line,
+             const char *pFormat,
+             ...)
+{
+    va_list args;
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    va_start(args, pFormat);
+    zrpLoggerLogVaList(level, pFile, line, pFormat, args);
+    va_end(args);
+}
+
+#endif /* ZRP_LOGGER_DEFINED */
+
+#ifndef ZRP_ATOMICS_DEFINED
+#define ZRP_ATOMICS_DEFINED
+
+/*
+   C89 doesn't provide any atomic operation, so the few ones needed are
+   implemented on top of the compiler intrinsics. On MSVC, the plain volatile
+   accesses are only ordered by the compiler barrier on x86 since it is
+   a strongly-ordered architecture, other architectures need a full fence.
+*/
+
+#if defined(__GNUC__)
+#define ZRP_ATOMICS_GNUC
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define ZRP_ATOMICS_MSVC
+#if defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32)
+#define ZRP_ATOMICS_FENCE() _ReadWriteBarrier()
+#else
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define ZRP_ATOMICS_FENCE() MemoryBarrier()
+#endif
+#else
+typedef char zrp_atomics_unsupported_compiler[-1];
+#endif
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeRelaxed(const volatile size_t *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeAcquire(const volatile size_t *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    size_t value;
+
+    value = *pValue;
+    ZRP_ATOMICS_FENCE();
+    return value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelaxed(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelease(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicFetchAddSize(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_add(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedExchangeAdd64((volatile __int64 *)pValue,
+                                             (__int64)value);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedExchangeAdd((volatile long *)pValue,
+                                           (long)value);
+#endif
+}
+
+/* May fail spuriously, callers are expected to retry in a loop. */
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangeSizeRelaxed(volatile size_t *pValue,
+                                    size_t expected,
+                                    size_t desired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(
+        pValue, &expected, desired, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedCompareExchange64((volatile __int64 *)pValue,
+                                                 (__int64)desired,
+                                                 (__int64)expected)
+           == expected;
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedCompareExchange(
+               (volatile long *)pValue, (long)desired, (long)expected)
+           == expected;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicLoadIntRelaxed(const volatile int *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreIntRelaxed(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchOrInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_or(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedOr((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchAndInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_and(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedAnd((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void *
+zrpAtomicLoadPointerAcquire(void *const volatile *ppValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(ppValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    void *pValue;
+
+    pValue = *ppValue;
+    ZRP_ATOMICS_FENCE();
+    return pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStorePointerRelease(void *volatile *ppValue, void *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(ppValue, pValue, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *ppValue = pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangePointer(void *volatile *ppValue,
+                                void *pExpected,
+                                void *pDesired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(ppValue,
+                                       &pExpected,
+                                       pDesired,
+                                       0,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return _InterlockedCompareExchangePointer(ppValue, pDesired, pExpected)
+           == pExpected;
+#endif
+}
+
+/* Hint to the CPU that the calling thread is busy-waiting. */
+ZRP_MAYBE_UNUSED static void
+zrpAtomicPause(void)
+{
+#if defined(ZRP_ATOMICS_GNUC)                                                  \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    __builtin_ia32_pause();
+#elif defined(ZRP_ATOMICS_GNUC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __asm__ __volatile__("yield");
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    _mm_pause();
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __yield();
+#endif
+}
+
+#endif /* ZRP_ATOMICS_DEFINED */
+
+#ifndef ZRP_THREADS_DEFINED
+#define ZRP_THREADS_DEFINED
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define ZRP_THREAD_RETURN_TYPE DWORD
+#define ZRP_THREAD_CALL WINAPI
+#define ZRP_THREAD_RETURN_VALUE 0
+typedef HANDLE ZrpThread;
+typedef CRITICAL_SECTION ZrpMutex;
+typedef CONDITION_VARIABLE ZrpCondition;
+#elif defined(ZRP_PLATFORM_UNIX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define ZRP_THREAD_RETURN_TYPE void *
+#define ZRP_THREAD_CALL
+#define ZRP_THREAD_RETURN_VALUE NULL
+typedef pthread_t ZrpThread;
+typedef pthread_mutex_t ZrpMutex;
+typedef pthread_cond_t ZrpCondition;
+#else
+typedef char zrp_threads_unsupported_platform[-1];
+#endif
+
+typedef ZRP_THREAD_RETURN_TYPE(ZRP_THREAD_CALL *ZrpThreadFunction)(void *);
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpThreadCreate(ZrpThread *pThread, ZrpThreadFunction pfnFunction, void *pArg)
+{
+    ZR_ASSERT(pThread != NULL);
+    ZR_ASSERT(pfnFunction != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    *pThread = CreateThread(NULL, 0, pfnFunction, pArg, 0, NULL);
+    if (*pThread == NULL) {
+        ZRP_LOG_ERROR("failed to create a thread\n");
+        return ZR_ERROR;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_create(pThread, NULL, pfnFunction, pArg) != 0) {
+        ZRP_LOG_ERROR("failed to create a thread\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpThreadJoin(ZrpThread thread)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_join(thread, NULL);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpThreadYield(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SwitchToThread();
+#elif defined(ZRP_PLATFORM_UNIX)
+    sched_yield();
+#endif
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpMutexCreate(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    InitializeCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_mutex_init(pMutex, NULL) != 0) {
+        ZRP_LOG_ERROR("failed to create a mutex\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexDestroy(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    DeleteCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_destroy(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexLock(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    EnterCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_lock(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexUnlock(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    LeaveCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_unlock(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpConditionCreate(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    InitializeConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_cond_init(pCondition, NULL) != 0) {
+        ZRP_LOG_ERROR("failed to create a condition variable\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionDestroy(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_destroy(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionWait(ZrpCondition *pCondition, ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pCondition != NULL);
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SleepConditionVariableCS(pCondition, pMutex, INFINITE);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_wait(pCondition, pMutex);
+#endif
+}
+
+/* Spurious wake-ups are possible, as with `zrpConditionWait()`. */
+ZRP_MAYBE_UNUSED static void
+zrpConditionTimedWait(ZrpCondition *pCondition,
+                      ZrpMutex *pMutex,
+                      ZrUint32 milliseconds)
+{
+    ZR_ASSERT(pCondition != NULL);
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SleepConditionVariableCS(pCondition, pMutex, (DWORD)milliseconds);
+#elif defined(ZRP_PLATFORM_UNIX)
+    {
+        struct timeval now;
+        struct timespec deadline;
+        long nanoseconds;
+
+        gettimeofday(&now, NULL);
+        nanoseconds = (long)now.tv_usec * 1000L
+                      + (long)(milliseconds % 1000) * 1000000L;
+        deadline.tv_sec = now.tv_sec + (time_t)(milliseconds / 1000)
+                          + (time_t)(nanoseconds / 1000000000L);
+        deadline.tv_nsec = nanoseconds % 1000000000L;
+        pthread_cond_timedwait(pCondition, pMutex, &deadline);
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionSignal(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WakeConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_signal(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionBroadcast(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WakeAllConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_broadcast(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpGetProcessorCount(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (size_t)info.dwNumberOfProcessors;
+#elif defined(ZRP_PLATFORM_UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    long count;
+
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#else
+    return 1;
+#endif
+}
+
+#endif /* ZRP_THREADS_DEFINED */
+
+#ifndef ZRP_CLOCK_DEFINED
+#define ZRP_CLOCK_DEFINED
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_DARWIN)
+#include <mach/mach_time.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_CLOCK_USE_CLOCK_GETTIME
+#if defined(CLOCK_MONOTONIC_RAW)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC_RAW
+#elif defined(CLOCK_MONOTONIC)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC
+#else
+#define ZRP_CLOCK_ID CLOCK_REALTIME
+#endif
+#else
+#include <sys/time.h>
+#endif
+#else
+typedef char zrp_clock_unsupported_platform[-1];
+#endif
+
+/*
+    In some cases, tick values are casted to 64-bit floating-points in order
+    to prevent (unlikely) integer overflows during some arithmetic operations.
+    This effectively reducse the precision of the ticks having a value greater
+    than 2^53, which corresponds to approximatively 104 days.
+*/
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpClockGetRealTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    {
+        static double timeToNano;
+        LARGE_INTEGER time;
+
+        if (timeToNano == 0.0) {
+            LARGE_INTEGER frequency;
+
+            if (!QueryPerformanceFrequency(&frequency)) {
+                ZRP_LOG_ERROR("failed to retrieve the time's frequency\n");
+                return ZR_ERROR;
+            }
+
+            timeToNano = 1000000000.0 / frequency.QuadPart;
+        }
+
+        if (!QueryPerformanceCounter(&time)) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = time.QuadPart * timeToNano;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_DARWIN)
+    /*
+       Since Darwin 5.2, `clock_gettime()` can return high resolution times
+       with the `CLOCK_UPTIME_RAW` clock but it internally only calls
+       `mach_absolute_time()` with the overhead of converting the result into
+       the `timespec` format.
+    */
+    {
+        static double timeToNano;
+
+        if (timeToNano == 0.0) {
+            mach_timebase_info_data_t info;
+
+            if (mach_timebase_info(&info) != KERN_SUCCESS) {
+                ZRP_LOG_ERROR("failed to retrieve the current time\n");
+                return ZR_ERROR;
+            }
+
+            timeToNano = (double)info.numer / info.denom;
+        }
+
+        *pTime = mach_absolute_time() * timeToNano;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    {
+        struct timespec time;
+
+        if (clock_gettime(ZRP_CLOCK_ID, &time) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
+        return ZR_SUCCESS;
+    }
+#else
+    {
+        struct timeval time;
+
+        if (gettimeofday(&time, NULL) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull
+                 + (ZrUint64)time.tv_usec * 1000ull;
+        return ZR_SUCCESS;
+    }
+#endif
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+#endif /* ZRP_CLOCK_DEFINED */
+
+/*
+   Each participating thread is assigned an even range of chunks to start
+   with. Enough chunks are created for every thread to get several of them so
+   that, once a thread runs out of chunks in its own range, it can steal the
+   remaining ones from the ranges of the other threads. Chunks are sized to
+   a multiple of the cache line size and the first one is extended up to the
+   first line boundary of the array to prevent threads from sharing lines
+   when writing to contiguous elements.
+*/
+
+#define ZRP_THREADPOOL_CHUNKS_PER_THREAD 4
+#define ZRP_THREADPOOL_MIN_CHUNK_BYTE_SIZE 4096
+
+typedef char zrp_threadpool_invalid_cache_line_size
+    [ZR_CACHE_LINE_SIZE >= 2 * sizeof(size_t) ? 1 : -1];
+
+struct ZrpThreadPoolRange {
+    volatile size_t next;
+    size_t end;
+    unsigned char padding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
+
+struct ZrpThreadPoolJob {
+    ZrParallelForFunction pfnFunction;
+    void *pData;
+    size_t size;
+    size_t chunkSize;
+    size_t offset;
+    struct ZrParallelChunkTiming *pTimings;
+};
+
+struct ZrpThreadPoolWorker {
+    struct ZrThreadPool *pPool;
+    size_t index;
+    ZrpThread thread;
+};
+
+struct ZrThreadPool {
+    ZrpMutex mutex;
+    ZrpCondition startCondition;
+    ZrpCondition endCondition;
+    size_t generation;
+    size_t pendingWorkerCount;
+    int quit;
+    struct ZrpThreadPoolJob job;
+    struct ZrpThreadPoolRange *pRanges;
+    struct ZrpThreadPoolWorker *pWorkers;
+    size_t workerCount;
+};
+
+static size_t
+zrpThreadPoolGetGreatestCommonDivisor(size_t a, size_t b)
+{
+    size_t remainder;
+
+    while (b != 0) {
+        remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+/*
+   Retrieve the number of elements per chunk, the number of elements that
+   the first chunk has in excess to end on a cache line boundary, and the
+   resulting number of chunks.
+*/
+static void
+zrpThreadPoolGetChunks(size_t *pChunkSize,
+                       size_t *pOffset,
+                       size_t *pChunkCount,
+                       size_t participantCount,
+                       const void *pArray,
+                       size_t size,
+                       size_t elementSize)
+{
+    size_t granularity;
+    size_t chunkCount;
+    size_t minChunkSize;
+    size_t misalignment;
+    size_t i;
+
+    ZR_ASSERT(pChunkSize != NULL);
+    ZR_ASSERT(pOffset != NULL);
+    ZR_ASSERT(pChunkCount != NULL);
+    ZR_ASSERT(participantCount > 0);
+    ZR_ASSERT(elementSize > 0);
+
+    /* Smallest number of elements spanning a whole number of cache lines. */
+    granularity = ZR_CACHE_LINE_SIZE
+                  / zrpThreadPoolGetGreatestCommonDivisor(ZR_CACHE_LINE_SIZE,
+                                                          elementSize);
+
+    chunkCount = participantCount * ZRP_THREADPOOL_CHUNKS_PER_THREAD;
+    *pChunkSize = size / chunkCount + (size % chunkCount != 0);
+
+    minChunkSize = ZRP_THREADPOOL_MIN_CHUNK_BYTE_SIZE / elementSize;
+    if (*pChunkSize < minChunkSize) {
+        *pChunkSize = minChunkSize;
+    }
+
+    *pChunkSize = (*pChunkSize + granularity - 1) / granularity * granularity;
+
+    /*
+       Find the first element starting a cache line, if any does since the
+       elements might be less aligned than the cache line size requires.
+    */
+    *pOffset = 0;
+    misalignment = (size_t)((uintptr_t)pArray % ZR_CACHE_LINE_SIZE);
+    if (misalignment != 0) {
+        for (i = 1; i < granularity; ++i) {
+            if ((misalignment + i * elementSize) % ZR_CACHE_LINE_SIZE == 0) {
+                *pOffset = i;
+                break;
+            }
+        }
+    }
+
+    if (size <= *pChunkSize + *pOffset) {
+        *pChunkCount = 1;
+    } else {
+        size -= *pChunkSize + *pOffset;
+        *pChunkCount = 1 + size / *pChunkSize + (size % *pChunkSize != 0);
+    }
+}
+
+static void
+zrpThreadPoolRunChunk(struct ZrThreadPool *pPool,
+                      size_t participant,
+                      size_t chunk)
+{
+    const struct ZrpThreadPoolJob *pJob;
+    size_t begin;
+    size_t end;
+
+    pJob = &pPool->job;
+
+    begin = chunk == 0 ? 0 : chunk * pJob->chunkSize + pJob->offset;
+    end = (chunk + 1) * pJob->chunkSize + pJob->offset;
+    if (end > pJob->size) {
+        end = pJob->size;
+    }
+
+    if (pJob->pTimings == NULL) {
+        pJob->pfnFunction(
+            pJob->pData, (ZrSize)chunk, (ZrSize)begin, (ZrSize)end);
+    } else {
+        struct ZrParallelChunkTiming *pTiming;
+        ZrUint64 start;
+        ZrUint64 stop;
+
+        if (zrpClockGetRealTime(&start) != ZR_SUCCESS) {
+            start = 0;
+        }
+
+        pJob->pfnFunction(
+            pJob->pData, (ZrSize)chunk, (ZrSize)begin, (ZrSize)end);
+
+        if (zrpClockGetRealTime(&stop) != ZR_SUCCESS || stop < start) {
+            stop = start;
+        }
+
+        pTiming = &pJob->pTimings[chunk];
+        pTiming->begin = (ZrSize)begin;
+        pTiming->end = (ZrSize)end;
+        pTiming->thread = (ZrSize)participant;
+        pTiming->start = start;
+        pTiming->duration = stop - start;
+    }
+}
+
+static void
+zrpThreadPoolRunJob(struct ZrThreadPool *pPool, size_t participant)
+{
+    size_t participantCount;
+    size_t i;
+
+    participantCount = pPool->workerCount + 1;
+
+    /* Start with the own range and then steal from the others. */
+    for (i = 0; i < participantCount; ++i) {
+        struct ZrpThreadPoolRange *pRange;
+        size_t chunk;
+
+        pRange = &pPool->pRanges[(participant + i) % participantCount];
+        while (zrpAtomicLoadSizeRelaxed(&pRange->next) < pRange->end) {
+            chunk = zrpAtomicFetchAddSize(&pRange->next, 1);
+            if (chunk >= pRange->end) {
+                break;
+            }
+
+            zrpThreadPoolRunChunk(pPool, participant, chunk);
+        }
+    }
+}
+
+static ZRP_THREAD_RETURN_TYPE ZRP_THREAD_CALL
+zrpThreadPoolRunWorker(void *pArg)
+{
+    struct ZrpThreadPoolWorker *pWorker;
+    struct ZrThreadPool *pPool;
+    size_t generation;
+
+    pWorker = (struct ZrpThreadPoolWorker *)pArg;
+    pPool = pWorker->pPool;
+    generation = 0;
+
+    for (;;) {
+        zrpMutexLock(&pPool->mutex);
+        while (pPool->generation == generation && !pPool->quit) {
+            zrpConditionWait(&pPool->startCondition, &pPool->mutex);
+        }
+
+        if (pPool->quit) {
+            zrpMutexUnlock(&pPool->mutex);
+            break;
+        }
+
+        generation = pPool->generation;
+        zrpMutexUnlock(&pPool->mutex);
+
+        zrpThreadPoolRunJob(pPool, pWorker->index);
+
+        zrpMutexLock(&pPool->mutex);
+        if (--pPool->pendingWorkerCount == 0) {
+            zrpConditionSignal(&pPool->endCondition);
+        }
+
+        zrpMutexUnlock(&pPool->mutex);
+    }
+
+    return ZRP_THREAD_RETURN_VALUE;
+}
+
+static void
+zrpThreadPoolStopWorkers(struct ZrThreadPool *pPool, size_t workerCount)
+{
+    size_t i;
+
+    zrpMutexLock(&pPool->mutex);
+    pPool->quit = 1;
+    zrpConditionBroadcast(&pPool->startCondition);
+    zrpMutexUnlock(&pPool->mutex);
+
+    for (i = 0; i < workerCount; ++i) {
+        zrpThreadJoin(pPool->pWorkers[i].thread);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrCreateThreadPool(struct ZrThreadPool **ppPool, ZrSize threadCount)
+{
+    enum ZrStatus status;
+    struct ZrThreadPool *pPool;
+    size_t i;
+
+    ZR_ASSERT(ppPool != NULL);
+
+    if (threadCount == 0) {
+        /* The calling thread also takes part in the work. */
+        threadCount = (ZrSize)zrpGetProcessorCount() - 1;
+    }
+
+    pPool = (struct ZrThreadPool *)ZR_MALLOC(sizeof *pPool);
+    if (pPool == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the thread pool\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto exit;
+    }
+
+    pPool->generation = 0;
+    pPool->pendingWorkerCount = 0;
+    pPool->quit = 0;
+    pPool->workerCount = 0;
+
+    pPool->pRanges = (struct ZrpThreadPoolRange *)ZR_MALLOC(
+        sizeof *pPool->pRanges * ((size_t)threadCount + 1));
+    if (pPool->pRanges == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the chunk ranges\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto pool_undo;
+    }
+
+    if (threadCount == 0) {
+        pPool->pWorkers = NULL;
+    } else {
+        pPool->pWorkers = (struct ZrpThreadPoolWorker *)ZR_MALLOC(
+            sizeof *pPool->pWorkers * (size_t)threadCount);
+        if (pPool->pWorkers == NULL) {
+            ZRP_LOG_ERROR("failed to allocate the workers\n");
+            status = ZR_ERROR_ALLOCATION;
+            goto ranges_undo;
+        }
+    }
+
+    status = zrpMutexCreate(&pPool->mutex);
+    if (status != ZR_SUCCESS) {
+        goto workers_undo;
+    }
+
+    status = zrpConditionCreate(&pPool->startCondition);
+    if (status != ZR_SUCCESS) {
+        goto mutex_undo;
+    }
+
+    status = zrpConditionCreate(&pPool->endCondition);
+    if (status != ZR_SUCCESS) {
+        goto start_condition_undo;
+    }
+
+    for (i = 0; i < (size_t)threadCount; ++i) {
+        pPool->pWorkers[i].pPool = pPool;
+        pPool->pWorkers[i].index = i + 1;
+        status = zrpThreadCreate(&pPool->pWorkers[i].thread,
+                                 zrpThreadPoolRunWorker,
+                                 &pPool->pWorkers[i]);
+        if (status != ZR_SUCCESS) {
+            ZRP_LOG_ERROR("failed to create the worker threads\n");
+            goto threads_undo;
+        }
+
+        ++pPool->workerCount;
+    }
+
+    *ppPool = pPool;
+    return ZR_SUCCESS;
+
+threads_undo:
+    zrpThreadPoolStopWorkers(pPool, pPool->workerCount);
+    zrpConditionDestroy(&pPool->endCondition);
+
+start_condition_undo:
+    zrpConditionDestroy(&pPool->startCondition);
+
+mutex_undo:
+    zrpMutexDestroy(&pPool->mutex);
+
+workers_undo:
+    ZR_FREE(pPool->pWorkers);
+
+ranges_undo:
+    ZR_FREE(pPool->pRanges);
+
+pool_undo:
+    ZR_FREE(pPool);
+
+exit:
+    return status;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrDestroyThreadPool(struct ZrThreadPool *pPool)
+{
+    if (pPool == NULL) {
+        return;
+    }
+
+    zrpThreadPoolStopWorkers(pPool, pPool->workerCount);
+    zrpConditionDestroy(&pPool->endCondition);
+    zrpConditionDestroy(&pPool->startCondition);
+    zrpMutexDestroy(&pPool->mutex);
+    ZR_FREE(pPool->pWorkers);
+    ZR_FREE(pPool->pRanges);
+    ZR_FREE(pPool);
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrGetThreadPoolThreadCount(ZrSize *pThreadCount,
+                           const struct ZrThreadPool *pPool)
+{
+    ZR_ASSERT(pThreadCount != NULL);
+    ZR_ASSERT(pPool != NULL);
+
+    *pThreadCount = (ZrSize)pPool->workerCount;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrGetParallelChunkCount(ZrSize *pChunkCount,
+                        const struct ZrThreadPool *pPool,
+                        const void *pArray,
+                        ZrSize size,
+                        ZrSize elementSize)
+{
+    size_t chunkSize;
+    size_t offset;
+    size_t chunkCount;
+
+    ZR_ASSERT(pChunkCount != NULL);
+    ZR_ASSERT(pPool != NULL);
+
+    zrpThreadPoolGetChunks(&chunkSize,
+                           &offset,
+                           &chunkCount,
+                           pPool->workerCount + 1,
+                           pArray,
+                           (size_t)size,
+                           (size_t)elementSize);
+    *pChunkCount = (ZrSize)chunkCount;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrParallelFor(struct ZrThreadPool *pPool,
+              const void *pArray,
+              ZrSize size,
+              ZrSize elementSize,
+              ZrParallelForFunction pfnFunction,
+              void *pData,
+              struct ZrParallelChunkTiming *pTimings)
+{
+    size_t participantCount;
+    size_t chunkCount;
+    size_t i;
+
+    ZR_ASSERT(pPool != NULL);
+    ZR_ASSERT(pfnFunction != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (size == 0) {
+        return ZR_SUCCESS;
+    }
+
+    participantCount = pPool->workerCount + 1;
+
+    pPool->job.pfnFunction = pfnFunction;
+    pPool->job.pData = pData;
+    pPool->job.size = (size_t)size;
+    pPool->job.pTimings = pTimings;
+    zrpThreadPoolGetChunks(&pPool->job.chunkSize,
+                           &pPool->job.offset,
+                           &chunkCount,
+                           participantCount,
+                           pArray,
+                           (size_t)size,
+                           (size_t)elementSize);
+
+    for (i = 0; i < participantCount; ++i) {
+        zrpAtomicStoreSizeRelaxed(&pPool->pRanges[i].next,
+                                  chunkCount * i / participantCount);
+        pPool->pRanges[i].end = chunkCount * (i + 1) / participantCount;
+    }
+
+    if (pPool->workerCount == 0 || chunkCount == 1) {
+        for (i = 0; i < chunkCount; ++i) {
+            zrpThreadPoolRunChunk(pPool, 0, i);
+        }
+
+        return ZR_SUCCESS;
+    }
+
+    zrpMutexLock(&pPool->mutex);
+    ZR_ASSERT(pPool->pendingWorkerCount == 0);
+    pPool->pendingWorkerCount = pPool->workerCount;
+    ++pPool->generation;
+    zrpConditionBroadcast(&pPool->startCondition);
+    zrpMutexUnlock(&pPool->mutex);
+
+    zrpThreadPoolRunJob(pPool, 0);
+
+    zrpMutexLock(&pPool->mutex);
+    while (pPool->pendingWorkerCount != 0) {
+        zrpConditionWait(&pPool->endCondition, &pPool->mutex);
+    }
+
+    zrpMutexUnlock(&pPool->mutex);
+    return ZR_SUCCESS;
+}
+
+#define ZRP_THREADPOOL_DEFINE_FOR_EACH_FUNCTION(name, type)                    \
+    struct ZrpParallelForEach##name##Context {                                 \
+        type *pArray;                                                          \
+        void (*pfnFunction)(type *, void *);                                   \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelForEach##name##Chunk(                               \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelForEach##name##Context *pContext;              \
+        size_t i;                                                              \
+                                                                               \
+        (void)chunk;                                                           \
+        pContext = (const struct ZrpParallelForEach##name##Context *)pData;    \
+        for (i = (size_t)begin; i < (size_t)end; ++i) {                        \
+            pContext->pfnFunction(&pContext->pArray[i], pContext->pData);      \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelForEach##name(                                               \
+            struct ZrThreadPool *pPool,                                        \
+            type *pArray,                                                      \
+            ZrSize size,                                                       \
+            void (*pfnFunction)(type * pElement, void *pData),                 \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        struct ZrpParallelForEach##name##Context context;                      \
+                                                                               \
+        ZR_ASSERT(pArray != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        context.pArray = pArray;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        return zrParallelFor(pPool,                                            \
+                             pArray,                                           \
+                             size,                                             \
+                             (ZrSize)sizeof(type),                             \
+                             zrpParallelForEach##name##Chunk,                  \
+                             &context,                                         \
+                             pTimings);                                        \
+    }
+
+#define ZRP_THREADPOOL_DEFINE_TRANSFORM_FUNCTION(name, type)                   \
+    struct ZrpParallelTransform##name##Context {                               \
+        type *pOutput;                                                         \
+        const type *pInput;                                                    \
+        void (*pfnFunction)(type *, const type *, void *);                     \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelTransform##name##Chunk(                             \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelTransform##name##Context *pContext;            \
+        size_t i;                                                              \
+                                                                               \
+        (void)chunk;                                                           \
+        pContext = (const struct ZrpParallelTransform##name##Context *)pData;  \
+        for (i = (size_t)begin; i < (size_t)end; ++i) {                        \
+            pContext->pfnFunction(&pContext->pOutput[i],                       \
+                                  &pContext->pInput[i],                        \
+                                  pContext->pData);                            \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelTransform##name(                                             \
+            struct ZrThreadPool *pPool,                                        \
+            type *pOutput,                                                     \
+            const type *pInput,                                                \
+            ZrSize size,                                                       \
+            void (*pfnFunction)(                                               \
+                type * pOutput, const type *pInput, void *pData),              \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        struct ZrpParallelTransform##name##Context context;                    \
+                                                                               \
+        ZR_ASSERT(pOutput != NULL || size == 0);                               \
+        ZR_ASSERT(pInput != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        context.pOutput = pOutput;                                             \
+        context.pInput = pInput;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        return zrParallelFor(pPool,                                            \
+                             pOutput,                                          \
+                             size,                                             \
+                             (ZrSize)sizeof(type),                             \
+                             zrpParallelTransform##name##Chunk,                \
+                             &context,                                         \
+                             pTimings);                                        \
+    }
+
+#define ZRP_THREADPOOL_DEFINE_REDUCE_FUNCTION(name, type)                      \
+    struct ZrpParallelReduce##name##Context {                                  \
+        const type *pArray;                                                    \
+        type *pPartials;                                                       \
+        type (*pfnFunction)(type, type, void *);                               \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelReduce##name##Chunk(                                \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelReduce##name##Context *pContext;               \
+        type accumulator;                                                      \
+        size_t i;                                                              \
+                                                                               \
+        pContext = (const struct ZrpParallelReduce##name##Context *)pData;     \
+        accumulator = pContext->pArray[begin];                                 \
+        for (i = (size_t)begin + 1; i < (size_t)end; ++i) {                    \
+            accumulator = pContext->pfnFunction(                               \
+                accumulator, pContext->pArray[i], pContext->pData);            \
+        }                                                                      \
+                                                                               \
+        pContext->pPartials[chunk] = accumulator;                              \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelReduce##name(                                                \
+            struct ZrThreadPool *pPool,                                        \
+            type *pResult,                                                     \
+            const type *pArray,                                                \
+            ZrSize size,                                                       \
+            type initialValue,                                                 \
+            type (*pfnFunction)(type accumulator, type value, void *pData),    \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrpParallelReduce##name##Context context;                       \
+        ZrSize chunkCount;                                                     \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pResult != NULL);                                            \
+        ZR_ASSERT(pArray != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        *pResult = initialValue;                                               \
+        if (size == 0) {                                                       \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        zrGetParallelChunkCount(                                               \
+            &chunkCount, pPool, pArray, size, (ZrSize)sizeof(type));           \
+                                                                               \
+        context.pArray = pArray;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        context.pPartials                                                      \
+            = (type *)ZR_MALLOC(sizeof(type) * (size_t)chunkCount);            \
+        if (context.pPartials == NULL) {                                       \
+            ZRP_LOG_ERROR("failed to allocate the partial results\n");         \
+            return ZR_ERROR_ALLOCATION;                                        \
+        }                                                                      \
+                                                                               \
+        status = zrParallelFor(pPool,                                          \
+                               pArray,                                         \
+                               size,                                           \
+                               (ZrSize)sizeof(type),                           \
+                               zrpParallelReduce##name##Chunk,                 \
+                               &context,                                       \
+                               pTimings);                                      \
+        if (status == ZR_SUCCESS) {                                            \
+            for (i = 0; i < (size_t)chunkCount; ++i) {                         \
+                *pResult                                                       \
+                    = pfnFunction(*pResult, context.pPartials[i], pData);      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        ZR_FREE(context.pPartials);                                            \
+        return status;                                                         \
+    }
+
+#undef ZR_MAKE_PARALLEL_ALGORITHMS
+#define ZR_MAKE_PARALLEL_ALGORITHMS(name, type)                                \
+    ZRP_THREADPOOL_DEFINE_FOR_EACH_FUNCTION(name, type)                        \
+    ZRP_THREADPOOL_DEFINE_TRANSFORM_FUNCTION(name, type)                       \
+    ZRP_THREADPOOL_DEFINE_REDUCE_FUNCTION(name, type)
+
+#endif /* ZRP_THREADPOOL_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
@@ -210,12 +210,118 @@ struct ZrCpuTimes {
     ZrUint64 system;
 };
 
+/*
+   - times: CPU times spent in user and kernel modes.
+   - voluntaryContextSwitches: count of times that the CPU was yielded, for
+     example to wait for a resource.
+   - involuntaryContextSwitches: count of times that the scheduler preempted
+     the CPU, for example to run a thread with a higher priority.
+   - minorPageFaults: count of page faults serviced without any I/O.
+   - majorPageFaults: count of page faults requiring an I/O.
+   - maxResidentSetSize: peak resident memory in bytes. On Linux, it always
+     refers to the whole process.
+*/
+struct ZrResourceUsage {
+    struct ZrCpuTimes times;
+    ZrUint64 voluntaryContextSwitches;
+    ZrUint64 involuntaryContextSwitches;
+    ZrUint64 minorPageFaults;
+    ZrUint64 majorPageFaults;
+    ZrUint64 maxResidentSetSize;
+};
+
+/*
+   Clocks that `zrGetRealTime()` can read from. The raw monotonic clock isn't
+   adjusted by NTP, the monotonic clock is, the coarse monotonic clock is
+   cheaper but only advances at each scheduler tick, and the boot time clock
+   also counts the time spent suspended.
+
+   Without `clock_gettime()`, only `ZR_CLOCK_MONOTONIC_RAW` is available and
+   it refers to the high-resolution clock of the platform. When the raw
+   clock doesn't exist, it falls back to the monotonic clock.
+*/
+enum ZrClock {
+    ZR_CLOCK_MONOTONIC_RAW = 0,
+    ZR_CLOCK_MONOTONIC = 1,
+    ZR_CLOCK_MONOTONIC_COARSE = 2,
+    ZR_CLOCK_BOOTTIME = 3
+};
+
+/*
+   - clock: clock being used.
+   - resolution: measured resolution in nanoseconds, that is the largest of
+     the resolution reported by the system and of the smallest step observed
+     between two consecutive reads.
+   - cost: measured cost in nanoseconds of reading the clock.
+*/
+struct ZrClockInfo {
+    enum ZrClock clock;
+    ZrUint64 resolution;
+    ZrUint64 cost;
+};
+
 ZRP_TIMER_LINKAGE enum ZrStatus
 zrGetRealTime(ZrUint64 *pTime);
 
+/*
+   Unless set at compile time with one of the `ZR_SET_TIMER_CLOCK_*` macros,
+   the first call to any of the clock functions probes the available clocks
+   and selects the cheapest one having a resolution of at most
+   `ZR_TIMER_MAX_CLOCK_RESOLUTION` nanoseconds (default: 1000).
+
+   Each clock is only probed once. Setting or selecting the clock can happen
+   while other threads call `zrGetRealTime()` or `zrGetClockInfo()`, but then
+   times read from different clocks must not be compared with each other.
+   Setting the clock returns `ZR_ERROR` if it isn't available, and selecting
+   it does so if no clock is fine enough, in which case the clock in use
+   doesn't change.
+*/
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrSetClock(enum ZrClock clock);
+
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrSelectClock(ZrUint64 maxResolution);
+
+ZRP_TIMER_LINKAGE void
+zrGetClockInfo(struct ZrClockInfo *pInfo);
+
 ZRP_TIMER_LINKAGE enum ZrStatus
 zrGetCpuTimes(struct ZrCpuTimes *pTimes);
 
+/*
+   Outside of Linux and without `RUSAGE_THREAD`, the CPU times of the calling
+   thread can still be retrieved from `CLOCK_THREAD_CPUTIME_ID`, which doesn't
+   distinguish between the user and kernel modes, so the total is then
+   reported as user time.
+*/
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadCpuTimes(struct ZrCpuTimes *pTimes);
+
+/* Resource usages are only available on Unix platforms. */
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetResourceUsage(struct ZrResourceUsage *pUsage);
+
+/* Only available on Linux and on the platforms defining `RUSAGE_THREAD`. */
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadResourceUsage(struct ZrResourceUsage *pUsage);
+
+/*
+   Ticks are read directly from the counter of the CPU when it runs at
+   a constant rate, that is the invariant timestamp counter on x86 and the
+   virtual counter on ARM64, and from the same clock as `zrGetRealTime()`
+   otherwise. They are only meaningful relative to each other and need to be
+   converted to get a duration.
+
+   The first call to either function checks for the counter and, on x86,
+   calibrates its rate against `zrGetRealTime()`, which takes about 10
+   milliseconds.
+*/
+ZRP_TIMER_LINKAGE ZrUint64
+zrGetTicks(void);
+
+ZRP_TIMER_LINKAGE ZrUint64
+zrTicksToNanoseconds(ZrUint64 ticks);
+
 #endif /* ZERO_TIMER_H */
 
 #ifdef ZR_DEFINE_IMPLEMENTATION
@@ -312,136 +418,508 @@ enum ZrLogLevel {
 #define ZRP_LOGGER_LOG_STYLING 0
 #endif
 
-#if ZRP_LOGGER_LOG_STYLING
-enum ZrpLoggerStyle {
-    ZRP_LOGGER_STYLE_RESET = 0,
-    ZRP_LOGGER_STYLE_BLACK = 1,
-    ZRP_LOGGER_STYLE_RED = 2,
-    ZRP_LOGGER_STYLE_GREEN = 3,
-    ZRP_LOGGER_STYLE_YELLOW = 4,
-    ZRP_LOGGER_STYLE_BLUE = 5,
-    ZRP_LOGGER_STYLE_MAGENTA = 6,
-    ZRP_LOGGER_STYLE_CYAN = 7,
-    ZRP_LOGGER_STYLE_BRIGHT_BLACK = 8,
-    ZRP_LOGGER_STYLE_BRIGHT_RED = 9,
-    ZRP_LOGGER_STYLE_BRIGHT_GREEN = 10,
-    ZRP_LOGGER_STYLE_BRIGHT_YELLOW = 11,
-    ZRP_LOGGER_STYLE_BRIGHT_BLUE = 12,
-    ZRP_LOGGER_STYLE_BRIGHT_MAGENTA = 13,
-    ZRP_LOGGER_STYLE_BRIGHT_CYAN = 14
+#if defined(ZR_ENABLE_LOG_TIMESTAMPS)
+#define ZRP_LOGGER_LOG_TIMESTAMPS 1
+#else
+#define ZRP_LOGGER_LOG_TIMESTAMPS 0
+#endif
+
+#if defined(ZR_ENABLE_LOG_THREAD_IDS)
+#define ZRP_LOGGER_LOG_THREAD_IDS 1
+#else
+#define ZRP_LOGGER_LOG_THREAD_IDS 0
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_LOGGER_USE_CLOCK_GETTIME
+#else
+#include <sys/time.h>
+#endif
+#if defined(ZRP_PLATFORM_LINUX)
+#include <unistd.h>
+#if defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE)
+#include <sys/syscall.h>
+#if defined(SYS_gettid)
+#define ZRP_LOGGER_USE_GETTID
+#endif
+#endif
+#endif
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(va_copy) && defined(__va_copy)
+#define va_copy __va_copy
+#endif
+
+/*
+   `vsnprintf()` only appeared with C99 and C++11, C89 builds write the prefix
+   and the message of each record with separate calls instead.
+*/
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)                 \
+    || (defined(__cplusplus) && __cplusplus >= 201103L)                        \
+    || (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L)                \
+    || (defined(__GNUC__) && !defined(__STRICT_ANSI__))                        \
+    || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define ZRP_LOGGER_USE_VSNPRINTF
+#endif
+
+#if defined(_MSC_VER)
+#define ZRP_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define ZRP_LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Size of `YYYY-MM-DDTHH:MM:SS`. */
+#define ZRP_LOGGER_DATE_TIME_SIZE 19
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.mmmZ `. */
+#define ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 6)
+
+/* Records fitting into this size are written with a single call. */
+#define ZRP_LOGGER_LINE_BUFFER_SIZE 512
+
+struct ZrpLoggerLabel {
+    const char *pString;
+    size_t size;
 };
+
+#define ZRP_LOGGER_MAKE_LABEL(string)                                          \
+    {                                                                          \
+        string, sizeof string - 1                                              \
+    }
+
+/*
+   The level part of the prefixes, including the ANSI style codes when
+   styling, indexed by level.
+*/
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel zrpLoggerLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("error: "),
+       ZRP_LOGGER_MAKE_LABEL("warning: "),
+       ZRP_LOGGER_MAKE_LABEL("info: "),
+       ZRP_LOGGER_MAKE_LABEL("trace: "),
+       ZRP_LOGGER_MAKE_LABEL("debug: ")};
+
+#if ZRP_LOGGER_LOG_STYLING
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel
+    zrpLoggerStyledLevelLabels[]
+    = {ZRP_LOGGER_MAKE_LABEL("\x1b[1;31merror\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;33mwarning\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;32minfo\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;36mtrace\x1b[0m: "),
+       ZRP_LOGGER_MAKE_LABEL("\x1b[1;35mdebug\x1b[0m: ")};
+
+/*
+   Whether the standard error stream is a terminal, detected on the first
+   record rather than on each one, or -1 if not detected yet. Concurrent
+   detections store the same value.
+*/
+static int zrpLoggerStderrStyled = -1;
 #endif /* ZRP_LOGGER_LOG_STYLING */
 
-static void
-zrpLoggerGetLogLevelName(const char **ppName, enum ZrLogLevel level)
-{
-    ZR_ASSERT(ppName != NULL);
-
-    switch (level) {
-        case ZR_LOG_LEVEL_ERROR:
-            *ppName = "error";
-            return;
-        case ZR_LOG_LEVEL_WARNING:
-            *ppName = "warning";
-            return;
-        case ZR_LOG_LEVEL_INFO:
-            *ppName = "info";
-            return;
-        case ZR_LOG_LEVEL_TRACE:
-            *ppName = "trace";
-            return;
-        case ZR_LOG_LEVEL_DEBUG:
-            *ppName = "debug";
-            return;
-        default:
-            ZR_ASSERT(0);
+ZRP_MAYBE_UNUSED static int
+zrpLoggerIsStderrStyled(void)
+{
+#if ZRP_LOGGER_LOG_STYLING
+    int styled;
+
+#if defined(__GNUC__)
+    styled = __atomic_load_n(&zrpLoggerStderrStyled, __ATOMIC_RELAXED);
+#else
+    styled = *(volatile int *)&zrpLoggerStderrStyled;
+#endif
+    if (styled < 0) {
+        styled = isatty(STDERR_FILENO) ? 1 : 0;
+#if defined(__GNUC__)
+        __atomic_store_n(&zrpLoggerStderrStyled, styled, __ATOMIC_RELAXED);
+#else
+        *(volatile int *)&zrpLoggerStderrStyled = styled;
+#endif
     }
+
+    return styled;
+#else
+    return 0;
+#endif /* ZRP_LOGGER_LOG_STYLING */
 }
 
+ZRP_MAYBE_UNUSED static const struct ZrpLoggerLabel *
+zrpLoggerGetLevelLabel(int styled, enum ZrLogLevel level)
+{
+    ZR_ASSERT((int)level >= (int)ZR_LOG_LEVEL_ERROR
+              && (int)level <= (int)ZR_LOG_LEVEL_DEBUG);
+
 #if ZRP_LOGGER_LOG_STYLING
-static void
-zrpLoggerGetLogLevelStyle(enum ZrpLoggerStyle *pStyle, enum ZrLogLevel level)
-{
-    ZR_ASSERT(pStyle != NULL);
-
-    switch (level) {
-        case ZR_LOG_LEVEL_ERROR:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_RED;
-            return;
-        case ZR_LOG_LEVEL_WARNING:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_YELLOW;
-            return;
-        case ZR_LOG_LEVEL_INFO:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_GREEN;
-            return;
-        case ZR_LOG_LEVEL_TRACE:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_CYAN;
-            return;
-        case ZR_LOG_LEVEL_DEBUG:
-            *pStyle = ZRP_LOGGER_STYLE_BRIGHT_MAGENTA;
-            return;
-        default:
-            ZR_ASSERT(0);
-    };
-}
-
-static void
-zrpLoggerGetStyleAnsiCode(const char **ppCode, enum ZrpLoggerStyle style)
-{
-    ZR_ASSERT(ppCode != NULL);
-
-    switch (style) {
-        case ZRP_LOGGER_STYLE_RESET:
-            *ppCode = "\x1b[0m";
-            return;
-        case ZRP_LOGGER_STYLE_BLACK:
-            *ppCode = "\x1b[30m";
-            return;
-        case ZRP_LOGGER_STYLE_RED:
-            *ppCode = "\x1b[31m";
-            return;
-        case ZRP_LOGGER_STYLE_GREEN:
-            *ppCode = "\x1b[32m";
-            return;
-        case ZRP_LOGGER_STYLE_YELLOW:
-            *ppCode = "\x1b[33m";
-            return;
-        case ZRP_LOGGER_STYLE_BLUE:
-            *ppCode = "\x1b[34m";
-            return;
-        case ZRP_LOGGER_STYLE_MAGENTA:
-            *ppCode = "\x1b[35m";
-            return;
-        case ZRP_LOGGER_STYLE_CYAN:
-            *ppCode = "\x1b[36m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_BLACK:
-            *ppCode = "\x1b[1;30m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_RED:
-            *ppCode = "\x1b[1;31m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_GREEN:
-            *ppCode = "\x1b[1;32m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_YELLOW:
-            *ppCode = "\x1b[1;33m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_BLUE:
-            *ppCode = "\x1b[1;34m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_MAGENTA:
-            *ppCode = "\x1b[1;35m";
-            return;
-        case ZRP_LOGGER_STYLE_BRIGHT_CYAN:
-            *ppCode = "\x1b[1;36m";
-            return;
-        default:
-            ZR_ASSERT(0);
+    if (styled) {
+        return &zrpLoggerStyledLevelLabels[level];
     }
-}
+#else
+    (void)styled;
 #endif /* ZRP_LOGGER_LOG_STYLING */
 
+    return &zrpLoggerLevelLabels[level];
+}
+
+/* Copy data at the given offset, as much as the buffer can hold. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerCopy(char *pBuffer,
+              size_t size,
+              size_t *pOffset,
+              const char *pData,
+              size_t dataSize)
+{
+    size_t copySize;
+
+    if (*pOffset < size) {
+        copySize = size - *pOffset;
+        if (copySize > dataSize) {
+            copySize = dataSize;
+        }
+
+        memcpy(&pBuffer[*pOffset], pData, copySize);
+    }
+
+    *pOffset += dataSize;
+}
+
+/*
+   Where and when a record was logged, captured by the logging thread since
+   the formatting may happen on another one. The fields are only set when
+   the prefixes include them.
+*/
+struct ZrpLoggerOrigin {
+    ZrUint64 time;
+    unsigned long threadId;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteDigits(char *pBuffer, ZrUint64 value, size_t count)
+{
+    while (count-- > 0) {
+        pBuffer[count] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/*
+   Time in milliseconds since the epoch, read from a coarse clock when there
+   is one since a tick per millisecond or so is enough for prefixes.
+*/
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpLoggerGetCoarseTime(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    FILETIME time;
+
+    /* Intervals of 100 nanoseconds since 1601-01-01. */
+    GetSystemTimeAsFileTime(&time);
+    return ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+            - 116444736000000000ull)
+           / 10000;
+#elif defined(ZRP_LOGGER_USE_CLOCK_GETTIME)
+    struct timespec time;
+
+#if defined(CLOCK_REALTIME_COARSE)
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &time) != 0) {
+        return 0;
+    }
+#else
+    if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+        return 0;
+    }
+#endif
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+#elif defined(ZRP_PLATFORM_UNIX)
+    struct timeval time;
+
+    if (gettimeofday(&time, NULL) != 0) {
+        return 0;
+    }
+
+    return (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_usec / 1000;
+#else
+    return 0;
+#endif
+}
+
+/*
+   Format the UTC date and time of a number of seconds since the epoch as
+   `YYYY-MM-DDTHH:MM:SS`, which is cached per thread since it only changes
+   once per second.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatDateTime(char *pBuffer, ZrUint64 seconds)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedSeconds;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedDateTime[ZRP_LOGGER_DATE_TIME_SIZE];
+#endif
+    ZrUint64 days;
+    ZrUint64 era;
+    ZrUint64 dayOfEra;
+    ZrUint64 yearOfEra;
+    ZrUint64 dayOfYear;
+    ZrUint64 shiftedMonth;
+    ZrUint64 month;
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    if (seconds + 1 == cachedSeconds) {
+        memcpy(pBuffer, cachedDateTime, ZRP_LOGGER_DATE_TIME_SIZE);
+        return;
+    }
+#endif
+
+    /* Civil date from the days since 1970-01-01, in eras of 400 years. */
+    days = seconds / 86400 + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                 - dayOfEra / 146096)
+                / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+
+    zrpLoggerWriteDigits(
+        &pBuffer[0], yearOfEra + era * 400 + (month <= 2 ? 1 : 0), 4);
+    pBuffer[4] = '-';
+    zrpLoggerWriteDigits(&pBuffer[5], month, 2);
+    pBuffer[7] = '-';
+    zrpLoggerWriteDigits(
+        &pBuffer[8], dayOfYear - (153 * shiftedMonth + 2) / 5 + 1, 2);
+    pBuffer[10] = 'T';
+    zrpLoggerWriteDigits(&pBuffer[11], seconds % 86400 / 3600, 2);
+    pBuffer[13] = ':';
+    zrpLoggerWriteDigits(&pBuffer[14], seconds % 3600 / 60, 2);
+    pBuffer[16] = ':';
+    zrpLoggerWriteDigits(&pBuffer[17], seconds % 60, 2);
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    /* Offset by one to not match the zero-initialized cache. */
+    cachedSeconds = seconds + 1;
+    memcpy(cachedDateTime, pBuffer, ZRP_LOGGER_DATE_TIME_SIZE);
+#endif
+}
+
+/*
+   Format a time in milliseconds since the epoch as it appears in prefixes,
+   reusing the previous result of the thread while the coarse clock doesn't
+   tick, which is common at high logging rates.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatPrefixTimestamp(char *pBuffer, ZrUint64 time)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL ZrUint64 cachedTime;
+    static ZRP_LOGGER_THREAD_LOCAL char
+        cachedTimestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+
+    if (time + 1 == cachedTime) {
+        memcpy(pBuffer, cachedTimestamp, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+        return;
+    }
+#endif
+
+    zrpLoggerFormatDateTime(pBuffer, time / 1000);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time % 1000, 3);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 4] = 'Z';
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 5] = ' ';
+
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    cachedTime = time + 1;
+    memcpy(cachedTimestamp, pBuffer, ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE);
+#endif
+}
+
+/*
+   Identifier of the calling thread, as known by the system when it can be
+   retrieved, or otherwise as assigned in the order the threads first ask
+   for it. On Linux, `syscall()` is only declared with `_DEFAULT_SOURCE` or
+   `_GNU_SOURCE`, so strict C99 builds get the latter.
+*/
+ZRP_MAYBE_UNUSED static unsigned long
+zrpLoggerGetThreadId(void)
+{
+#if defined(ZRP_LOGGER_THREAD_LOCAL)
+    static ZRP_LOGGER_THREAD_LOCAL unsigned long threadId;
+
+    if (threadId != 0) {
+        return threadId;
+    }
+#else
+    unsigned long threadId;
+#endif
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    threadId = (unsigned long)GetCurrentThreadId();
+#elif defined(ZRP_LOGGER_USE_GETTID)
+    threadId = (unsigned long)syscall(SYS_gettid);
+#else
+    {
+        static unsigned long threadCount;
+
+#if defined(__GNUC__)
+        threadId = __atomic_add_fetch(&threadCount, 1, __ATOMIC_RELAXED);
+#else
+        threadId = ++threadCount;
+#endif
+    }
+#endif
+
+    return threadId;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerGetOrigin(struct ZrpLoggerOrigin *pOrigin)
+{
+    ZR_ASSERT(pOrigin != NULL);
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    pOrigin->time = zrpLoggerGetCoarseTime();
+#else
+    pOrigin->time = 0;
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    pOrigin->threadId = zrpLoggerGetThreadId();
+#else
+    pOrigin->threadId = 0;
+#endif
+}
+
+/*
+   Format the prefix of a record into the given buffer, truncating it if
+   needed, and return the size that it requires, not counting the terminating
+   null character.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatPrefix(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line)
+{
+    const struct ZrpLoggerLabel *pLabel;
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    char timestamp[ZRP_LOGGER_PREFIX_TIMESTAMP_SIZE];
+#endif
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    char threadId[24];
+    size_t threadIdOffset;
+    unsigned long threadIdValue;
+#endif
+    char digits[16];
+    size_t digitCount;
+    size_t offset;
+    unsigned int value;
+
+    ZR_ASSERT(pBuffer != NULL || size == 0);
+    ZR_ASSERT(pOrigin != NULL);
+    ZR_ASSERT(pFile != NULL);
+
+    (void)pOrigin;
+    offset = 0;
+
+#if ZRP_LOGGER_LOG_TIMESTAMPS
+    zrpLoggerFormatPrefixTimestamp(timestamp, pOrigin->time);
+    zrpLoggerCopy(pBuffer, size, &offset, timestamp, sizeof timestamp);
+#endif
+
+#if ZRP_LOGGER_LOG_THREAD_IDS
+    threadIdValue = pOrigin->threadId;
+    threadIdOffset = sizeof threadId;
+    threadId[--threadIdOffset] = ' ';
+    threadId[--threadIdOffset] = ']';
+    do {
+        threadId[--threadIdOffset] = (char)('0' + threadIdValue % 10);
+        threadIdValue /= 10;
+    } while (threadIdValue > 0);
+
+    threadId[--threadIdOffset] = '[';
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &threadId[threadIdOffset],
+                  sizeof threadId - threadIdOffset);
+#endif
+
+    value = line < 0 ? 0u - (unsigned int)line : (unsigned int)line;
+    digitCount = sizeof digits;
+    do {
+        digits[--digitCount] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (line < 0) {
+        digits[--digitCount] = '-';
+    }
+
+    pLabel = zrpLoggerGetLevelLabel(styled, level);
+
+    zrpLoggerCopy(pBuffer, size, &offset, pFile, strlen(pFile));
+    zrpLoggerCopy(pBuffer, size, &offset, ":", 1);
+    zrpLoggerCopy(pBuffer,
+                  size,
+                  &offset,
+                  &digits[digitCount],
+                  sizeof digits - digitCount);
+    zrpLoggerCopy(pBuffer, size, &offset, ": ", 2);
+    zrpLoggerCopy(pBuffer, size, &offset, pLabel->pString, pLabel->size);
+
+    if (size > 0) {
+        pBuffer[offset < size ? offset : size - 1] = '\0';
+    }
+
+    return offset;
+}
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+/* Same as `zrpLoggerFormatPrefix()` but for a whole record. */
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatVaList(char *pBuffer,
+                      size_t size,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const struct ZrpLoggerOrigin *pOrigin,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    size_t prefixSize;
+    int messageSize;
+
+    ZR_ASSERT(pFormat != NULL);
+
+    prefixSize = zrpLoggerFormatPrefix(
+        pBuffer, size, styled, level, pOrigin, pFile, line);
+    if (prefixSize < size) {
+        messageSize = vsnprintf(
+            &pBuffer[prefixSize], size - prefixSize, pFormat, args);
+    } else {
+        messageSize = vsnprintf(NULL, 0, pFormat, args);
+    }
+
+    if (messageSize < 0) {
+        return prefixSize;
+    }
+
+    return prefixSize + (size_t)messageSize;
+}
+#endif /* ZRP_LOGGER_USE_VSNPRINTF */
+
 ZRP_MAYBE_UNUSED static void
 zrpLoggerLogVaList(enum ZrLogLevel level,
                    const char *pFile,
@@ -449,37 +927,55 @@ zrpLoggerLogVaList(enum ZrLogLevel level,
                    const char *pFormat,
                    va_list args)
 {
-    const char *pLevelName;
-    const char *pLevelStyleStart;
-    const char *pLevelStyleEnd;
+    char buffer[ZRP_LOGGER_LINE_BUFFER_SIZE];
+    struct ZrpLoggerOrigin origin;
+    const struct ZrpLoggerLabel *pLabel;
+    size_t size;
+    int styled;
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_list argsCopy;
+#endif
 
     ZR_ASSERT(pFile != NULL);
     ZR_ASSERT(pFormat != NULL);
 
-    zrpLoggerGetLogLevelName(&pLevelName, level);
-
-#if ZRP_LOGGER_LOG_STYLING
-    if (isatty(fileno(stderr))) {
-        enum ZrpLoggerStyle levelStyle;
+    styled = zrpLoggerIsStderrStyled();
+    zrpLoggerGetOrigin(&origin);
+
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    va_copy(argsCopy, args);
+    size = zrpLoggerFormatVaList(buffer,
+                                 sizeof buffer,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
+        va_end(argsCopy);
+        return;
+    }
+#endif
 
-        zrpLoggerGetLogLevelStyle(&levelStyle, level);
-        zrpLoggerGetStyleAnsiCode(&pLevelStyleStart, levelStyle);
-        zrpLoggerGetStyleAnsiCode(&pLevelStyleEnd, ZRP_LOGGER_STYLE_RESET);
+    /* Too large for the buffer, write the prefix and message apart. */
+    size = zrpLoggerFormatPrefix(
+        buffer, sizeof buffer, styled, level, &origin, pFile, line);
+    if (size < sizeof buffer) {
+        fwrite(buffer, 1, size, stderr);
     } else {
-        pLevelStyleStart = pLevelStyleEnd = "";
+        pLabel = zrpLoggerGetLevelLabel(styled, level);
+        fprintf(stderr, "%s:%d: %s", pFile, line, pLabel->pString);
     }
-#else
-    pLevelStyleStart = pLevelStyleEnd = "";
-#endif /* ZRP_LOGGER_LOG_STYLING */
 
-    fprintf(stderr,
-            "%s:%d: %s%s%s: ",
-            pFile,
-            line,
-            pLevelStyleStart,
-            pLevelName,
-            pLevelStyleEnd);
+#if defined(ZRP_LOGGER_USE_VSNPRINTF)
+    vfprintf(stderr, pFormat, argsCopy);
+    va_end(argsCopy);
+#else
     vfprintf(stderr, pFormat, args);
+#endif
 }
 
 ZRP_MAYBE_UNUSED static void
@@ -501,42 +997,253 @@ zrpLoggerLog(enum ZrLogLevel level,
 
 #endif /* ZRP_LOGGER_DEFINED */
 
-#if defined(ZRP_PLATFORM_WINDOWS)
+#ifndef ZRP_ATOMICS_DEFINED
+#define ZRP_ATOMICS_DEFINED
+
+/*
+   C89 doesn't provide any atomic operation, so the few ones needed are
+   implemented on top of the compiler intrinsics. On MSVC, the plain volatile
+   accesses are only ordered by the compiler barrier on x86 since it is
+   a strongly-ordered architecture, other architectures need a full fence.
+*/
+
+#if defined(__GNUC__)
+#define ZRP_ATOMICS_GNUC
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define ZRP_ATOMICS_MSVC
+#if defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32)
+#define ZRP_ATOMICS_FENCE() _ReadWriteBarrier()
+#else
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
-#elif defined(ZRP_PLATFORM_DARWIN)
-#include <mach/mach_time.h>
-#include <sys/resource.h>
-#elif defined(ZRP_PLATFORM_UNIX)
-#include <sys/resource.h>
-#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
-#include <time.h>
-#define ZRP_TIMER_USE_CLOCK_GETTIME
-#if defined(CLOCK_MONOTONIC_RAW)
-#define ZRP_TIMER_CLOCK_ID CLOCK_MONOTONIC_RAW
-#elif defined(CLOCK_MONOTONIC)
-#define ZRP_TIMER_CLOCK_ID CLOCK_MONOTONIC
-#else
-#define ZRP_TIMER_CLOCK_ID CLOCK_REALTIME
-#endif
-#else
-#include <sys/time.h>
+#define ZRP_ATOMICS_FENCE() MemoryBarrier()
 #endif
 #else
-typedef char zrp_timer_unsupported_platform[-1];
+typedef char zrp_atomics_unsupported_compiler[-1];
 #endif
 
-/*
-    In some cases, tick values are casted to 64-bit floating-points in order
-    to prevent (unlikely) integer overflows during some arithmetic operations.
-    This effectively reducse the precision of the ticks having a value greater
-    than 2^53, which corresponds to approximatively 104 days.
-*/
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeRelaxed(const volatile size_t *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
 
-ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
-zrGetRealTime(ZrUint64 *pTime)
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicLoadSizeAcquire(const volatile size_t *pValue)
 {
-    ZR_ASSERT(pTime != NULL);
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    size_t value;
+
+    value = *pValue;
+    ZRP_ATOMICS_FENCE();
+    return value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelaxed(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreSizeRelease(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpAtomicFetchAddSize(volatile size_t *pValue, size_t value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_add(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedExchangeAdd64((volatile __int64 *)pValue,
+                                             (__int64)value);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedExchangeAdd((volatile long *)pValue,
+                                           (long)value);
+#endif
+}
+
+/* May fail spuriously, callers are expected to retry in a loop. */
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangeSizeRelaxed(volatile size_t *pValue,
+                                    size_t expected,
+                                    size_t desired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(
+        pValue, &expected, desired, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC) && ZR_ENVIRONMENT == 64
+    return (size_t)_InterlockedCompareExchange64((volatile __int64 *)pValue,
+                                                 (__int64)desired,
+                                                 (__int64)expected)
+           == expected;
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (size_t)_InterlockedCompareExchange(
+               (volatile long *)pValue, (long)desired, (long)expected)
+           == expected;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicLoadIntRelaxed(const volatile int *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(pValue, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return *pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStoreIntRelaxed(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(pValue, value, __ATOMIC_RELAXED);
+#elif defined(ZRP_ATOMICS_MSVC)
+    *pValue = value;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchOrInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_or(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedOr((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicFetchAndInt(volatile int *pValue, int value)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_fetch_and(pValue, value, __ATOMIC_ACQ_REL);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return (int)_InterlockedAnd((volatile long *)pValue, (long)value);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void *
+zrpAtomicLoadPointerAcquire(void *const volatile *ppValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_load_n(ppValue, __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    void *pValue;
+
+    pValue = *ppValue;
+    ZRP_ATOMICS_FENCE();
+    return pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAtomicStorePointerRelease(void *volatile *ppValue, void *pValue)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    __atomic_store_n(ppValue, pValue, __ATOMIC_RELEASE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    ZRP_ATOMICS_FENCE();
+    *ppValue = pValue;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAtomicCompareExchangePointer(void *volatile *ppValue,
+                                void *pExpected,
+                                void *pDesired)
+{
+#if defined(ZRP_ATOMICS_GNUC)
+    return __atomic_compare_exchange_n(ppValue,
+                                       &pExpected,
+                                       pDesired,
+                                       0,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+#elif defined(ZRP_ATOMICS_MSVC)
+    return _InterlockedCompareExchangePointer(ppValue, pDesired, pExpected)
+           == pExpected;
+#endif
+}
+
+/* Hint to the CPU that the calling thread is busy-waiting. */
+ZRP_MAYBE_UNUSED static void
+zrpAtomicPause(void)
+{
+#if defined(ZRP_ATOMICS_GNUC)                                                  \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    __builtin_ia32_pause();
+#elif defined(ZRP_ATOMICS_GNUC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __asm__ __volatile__("yield");
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+    _mm_pause();
+#elif defined(ZRP_ATOMICS_MSVC)                                                \
+    && (defined(ZRP_ARCH_ARM_64) || defined(ZRP_ARCH_ARM_32))
+    __yield();
+#endif
+}
+
+#endif /* ZRP_ATOMICS_DEFINED */
+
+#ifndef ZRP_CLOCK_DEFINED
+#define ZRP_CLOCK_DEFINED
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_DARWIN)
+#include <mach/mach_time.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_CLOCK_USE_CLOCK_GETTIME
+#if defined(CLOCK_MONOTONIC_RAW)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC_RAW
+#elif defined(CLOCK_MONOTONIC)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC
+#else
+#define ZRP_CLOCK_ID CLOCK_REALTIME
+#endif
+#else
+#include <sys/time.h>
+#endif
+#else
+typedef char zrp_clock_unsupported_platform[-1];
+#endif
+
+/*
+    In some cases, tick values are casted to 64-bit floating-points in order
+    to prevent (unlikely) integer overflows during some arithmetic operations.
+    This effectively reducse the precision of the ticks having a value greater
+    than 2^53, which corresponds to approximatively 104 days.
+*/
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpClockGetRealTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
 
 #if defined(ZRP_PLATFORM_WINDOWS)
     {
@@ -551,7 +1258,7 @@ zrGetRealTime(ZrUint64 *pTime)
                 return ZR_ERROR;
             }
 
-            timeToNano = (double)ZR_TIMER_TICKS_PER_SECOND / frequency.QuadPart;
+            timeToNano = 1000000000.0 / frequency.QuadPart;
         }
 
         if (!QueryPerformanceCounter(&time)) {
@@ -587,11 +1294,11 @@ zrGetRealTime(ZrUint64 *pTime)
         return ZR_SUCCESS;
     }
 #elif defined(ZRP_PLATFORM_UNIX)
-#if defined(ZRP_TIMER_USE_CLOCK_GETTIME)
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
     {
         struct timespec time;
 
-        if (clock_gettime(ZRP_TIMER_CLOCK_ID, &time) != 0) {
+        if (clock_gettime(ZRP_CLOCK_ID, &time) != 0) {
             ZRP_LOG_ERROR("failed to retrieve the current time\n");
             return ZR_ERROR;
         }
@@ -619,6 +1326,492 @@ zrGetRealTime(ZrUint64 *pTime)
     return ZR_ERROR;
 }
 
+#endif /* ZRP_CLOCK_DEFINED */
+
+#if defined(ZRP_PLATFORM_DARWIN)
+#include <mach/mach.h>
+#endif
+
+#if defined(ZRP_PLATFORM_UNIX)
+#include <sys/resource.h>
+#endif
+
+/*
+   Linux only exposes `RUSAGE_THREAD` with `_GNU_SOURCE`, but its value is
+   part of the system call ABI.
+*/
+#if defined(RUSAGE_THREAD)
+#define ZRP_TIMER_RUSAGE_THREAD RUSAGE_THREAD
+#elif defined(ZRP_PLATFORM_LINUX)
+#define ZRP_TIMER_RUSAGE_THREAD 1
+#endif
+
+#if defined(__GNUC__)                                                          \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+#include <cpuid.h>
+#define ZRP_TIMER_USE_TSC
+#elif defined(_MSC_VER)                                                        \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+#include <intrin.h>
+#define ZRP_TIMER_USE_TSC
+#elif defined(__GNUC__) && defined(ZRP_ARCH_ARM_64)
+#define ZRP_TIMER_USE_CNTVCT
+#endif
+
+#ifndef ZR_TIMER_MAX_CLOCK_RESOLUTION
+#define ZR_TIMER_MAX_CLOCK_RESOLUTION 1000
+#endif /* ZR_TIMER_MAX_CLOCK_RESOLUTION */
+
+#if defined(ZR_SET_TIMER_CLOCK_MONOTONIC_RAW)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC_RAW
+#elif defined(ZR_SET_TIMER_CLOCK_MONOTONIC)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC
+#elif defined(ZR_SET_TIMER_CLOCK_MONOTONIC_COARSE)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC_COARSE
+#elif defined(ZR_SET_TIMER_CLOCK_BOOTTIME)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_BOOTTIME
+#endif
+
+#define ZRP_TIMER_STATE_UNINITIALIZED 0
+#define ZRP_TIMER_STATE_INITIALIZING 1
+#define ZRP_TIMER_STATE_INITIALIZED 2
+
+#define ZRP_TIMER_CLOCK_COUNT 4
+#define ZRP_TIMER_PROBE_SAMPLE_COUNT 256
+
+#define ZRP_TIMER_CALIBRATION_DURATION 10000000ull
+
+static volatile size_t zrpTimerClockState;
+static volatile size_t zrpTimerClock;
+
+static volatile size_t zrpTimerClockInfoStates[ZRP_TIMER_CLOCK_COUNT];
+static struct ZrClockInfo zrpTimerClockInfos[ZRP_TIMER_CLOCK_COUNT];
+static int zrpTimerClockAvailabilities[ZRP_TIMER_CLOCK_COUNT];
+
+static volatile size_t zrpTimerTicksState;
+static int zrpTimerUseCounter;
+static ZrUint64 zrpTimerTicksPerSecond;
+
+/*
+   Return whether the calling thread is the one to initialize the given
+   state, after waiting for another thread to be done with it otherwise.
+*/
+ZRP_MAYBE_UNUSED static int
+zrpTimerBeginInitialization(volatile size_t *pState)
+{
+    /* The exchange may fail spuriously, so retry until someone claims it. */
+    while (zrpAtomicLoadSizeRelaxed(pState) == ZRP_TIMER_STATE_UNINITIALIZED) {
+        if (zrpAtomicCompareExchangeSizeRelaxed(pState,
+                                                ZRP_TIMER_STATE_UNINITIALIZED,
+                                                ZRP_TIMER_STATE_INITIALIZING)) {
+            return 1;
+        }
+    }
+
+    while (zrpAtomicLoadSizeAcquire(pState) != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpAtomicPause();
+    }
+
+    return 0;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerEndInitialization(volatile size_t *pState)
+{
+    zrpAtomicStoreSizeRelease(pState, ZRP_TIMER_STATE_INITIALIZED);
+}
+
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+ZRP_MAYBE_UNUSED static int
+zrpTimerGetClockId(clockid_t *pId, enum ZrClock clock)
+{
+    switch (clock) {
+        case ZR_CLOCK_MONOTONIC_RAW:
+            *pId = ZRP_CLOCK_ID;
+            return 1;
+#if defined(CLOCK_MONOTONIC)
+        case ZR_CLOCK_MONOTONIC:
+            *pId = CLOCK_MONOTONIC;
+            return 1;
+#endif
+#if defined(CLOCK_MONOTONIC_COARSE)
+        case ZR_CLOCK_MONOTONIC_COARSE:
+            *pId = CLOCK_MONOTONIC_COARSE;
+            return 1;
+#endif
+#if defined(CLOCK_BOOTTIME)
+        case ZR_CLOCK_BOOTTIME:
+            *pId = CLOCK_BOOTTIME;
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+#endif
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpTimerReadClock(ZrUint64 *pTime, enum ZrClock clock)
+{
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    clockid_t id;
+    struct timespec time;
+
+    if (!zrpTimerGetClockId(&id, clock) || clock_gettime(id, &time) != 0) {
+        ZRP_LOG_ERROR("failed to retrieve the current time\n");
+        return ZR_ERROR;
+    }
+
+    *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
+    return ZR_SUCCESS;
+#else
+    (void)clock;
+
+    return zrpClockGetRealTime(pTime);
+#endif
+}
+
+/* Measure the resolution and the cost of a clock, if available. */
+ZRP_MAYBE_UNUSED static int
+zrpTimerProbeClock(struct ZrClockInfo *pInfo, enum ZrClock clock)
+{
+    ZrUint64 start;
+    ZrUint64 end;
+    ZrUint64 previous;
+    ZrUint64 time;
+    ZrUint64 step;
+    size_t i;
+
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    clockid_t id;
+    struct timespec resolution;
+    struct timespec now;
+
+    /* Some clocks are known to the headers but not to the running kernel. */
+    if (!zrpTimerGetClockId(&id, clock) || clock_getres(id, &resolution) != 0
+        || clock_gettime(id, &now) != 0) {
+        return 0;
+    }
+
+    pInfo->resolution = (ZrUint64)resolution.tv_sec * 1000000000ull
+                        + (ZrUint64)resolution.tv_nsec;
+#else
+    if (clock != ZR_CLOCK_MONOTONIC_RAW) {
+        return 0;
+    }
+
+    pInfo->resolution = 1;
+#endif
+
+    pInfo->clock = clock;
+    if (zrpClockGetRealTime(&start) != ZR_SUCCESS
+        || zrpTimerReadClock(&previous, clock) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    step = 0;
+    for (i = 0; i < ZRP_TIMER_PROBE_SAMPLE_COUNT; ++i) {
+        if (zrpTimerReadClock(&time, clock) != ZR_SUCCESS) {
+            return 0;
+        }
+
+        if (time > previous && (step == 0 || time - previous < step)) {
+            step = time - previous;
+        }
+
+        previous = time;
+    }
+
+    if (zrpClockGetRealTime(&end) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    if (step > pInfo->resolution) {
+        pInfo->resolution = step;
+    }
+
+    pInfo->cost = (end - start) / ZRP_TIMER_PROBE_SAMPLE_COUNT;
+    return 1;
+}
+
+/*
+   Retrieve the info of a clock and return whether it is available. Each clock
+   is only probed once so that its info never changes after being published,
+   allowing it to be read while other threads set or select the clock.
+*/
+ZRP_MAYBE_UNUSED static int
+zrpTimerGetClockInfo(const struct ZrClockInfo **ppInfo, enum ZrClock clock)
+{
+    size_t i;
+
+    ZR_ASSERT((int)clock >= 0 && (int)clock < ZRP_TIMER_CLOCK_COUNT);
+
+    i = (size_t)clock;
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerClockInfoStates[i])
+            != ZRP_TIMER_STATE_INITIALIZED
+        && zrpTimerBeginInitialization(&zrpTimerClockInfoStates[i])) {
+        zrpTimerClockAvailabilities[i]
+            = zrpTimerProbeClock(&zrpTimerClockInfos[i], clock);
+        if (!zrpTimerClockAvailabilities[i]) {
+            zrpTimerClockInfos[i].clock = clock;
+            zrpTimerClockInfos[i].resolution = 0;
+            zrpTimerClockInfos[i].cost = 0;
+        }
+
+        zrpTimerEndInitialization(&zrpTimerClockInfoStates[i]);
+    }
+
+    *ppInfo = &zrpTimerClockInfos[i];
+    return zrpTimerClockAvailabilities[i];
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpTimerSelectClock(ZrUint64 maxResolution)
+{
+    const struct ZrClockInfo *pInfo;
+    const struct ZrClockInfo *pBestInfo;
+    int i;
+
+    pBestInfo = NULL;
+    for (i = 0; i < ZRP_TIMER_CLOCK_COUNT; ++i) {
+        if (zrpTimerGetClockInfo(&pInfo, (enum ZrClock)i)
+            && pInfo->resolution <= maxResolution
+            && (pBestInfo == NULL || pInfo->cost < pBestInfo->cost)) {
+            pBestInfo = pInfo;
+        }
+    }
+
+    if (pBestInfo == NULL) {
+        return ZR_ERROR;
+    }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)pBestInfo->clock);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerInitializeClock(void)
+{
+#if defined(ZRP_TIMER_CLOCK)
+    const struct ZrClockInfo *pInfo;
+#endif
+
+    if (!zrpTimerBeginInitialization(&zrpTimerClockState)) {
+        return;
+    }
+
+#if defined(ZRP_TIMER_CLOCK)
+    if (!zrpTimerGetClockInfo(&pInfo, ZRP_TIMER_CLOCK)) {
+        ZRP_LOG_ERROR("the clock set at compile time isn't available\n");
+    }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)ZRP_TIMER_CLOCK);
+#else
+    if (zrpTimerSelectClock(ZR_TIMER_MAX_CLOCK_RESOLUTION) != ZR_SUCCESS) {
+        zrpAtomicStoreSizeRelaxed(&zrpTimerClock,
+                                  (size_t)ZR_CLOCK_MONOTONIC_RAW);
+    }
+#endif
+
+    zrpTimerEndInitialization(&zrpTimerClockState);
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpTimerReadCounter(void)
+{
+#if defined(ZRP_TIMER_USE_TSC) && defined(__GNUC__)
+    return (ZrUint64)__builtin_ia32_rdtsc();
+#elif defined(ZRP_TIMER_USE_TSC)
+    return (ZrUint64)__rdtsc();
+#elif defined(ZRP_TIMER_USE_CNTVCT)
+    ZrUint64 counter;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(counter));
+    return counter;
+#else
+    return 0;
+#endif
+}
+
+/* Return the rate of the counter, or 0 if it can't be relied upon. */
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpTimerGetCounterFrequency(void)
+{
+#if defined(ZRP_TIMER_USE_TSC)
+    ZrUint64 startTime;
+    ZrUint64 time;
+    ZrUint64 startTicks;
+    ZrUint64 ticks;
+
+    /* Without an invariant TSC, its rate follows the frequency scaling. */
+    {
+#if defined(__GNUC__)
+        unsigned int registers[4];
+
+        if (!__get_cpuid(0x80000000u,
+                         &registers[0],
+                         &registers[1],
+                         &registers[2],
+                         &registers[3])
+            || registers[0] < 0x80000007u
+            || !__get_cpuid(0x80000007u,
+                            &registers[0],
+                            &registers[1],
+                            &registers[2],
+                            &registers[3])
+            || !(registers[3] & 0x100u)) {
+            return 0;
+        }
+#else
+        int registers[4];
+
+        __cpuid(registers, (int)0x80000000u);
+        if ((unsigned int)registers[0] < 0x80000007u) {
+            return 0;
+        }
+
+        __cpuid(registers, (int)0x80000007u);
+        if (!((unsigned int)registers[3] & 0x100u)) {
+            return 0;
+        }
+#endif
+    }
+
+    if (zrpClockGetRealTime(&startTime) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    startTicks = zrpTimerReadCounter();
+    do {
+        if (zrpClockGetRealTime(&time) != ZR_SUCCESS) {
+            return 0;
+        }
+    } while (time - startTime < ZRP_TIMER_CALIBRATION_DURATION);
+
+    ticks = zrpTimerReadCounter();
+    if (ticks <= startTicks) {
+        return 0;
+    }
+
+    return (ZrUint64)((double)(ticks - startTicks) * 1000000000.0
+                          / (double)(time - startTime)
+                      + 0.5);
+#elif defined(ZRP_TIMER_USE_CNTVCT)
+    ZrUint64 frequency;
+
+    /* The generic timer reports its own frequency. */
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency;
+#else
+    return 0;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerInitializeTicks(void)
+{
+    ZrUint64 frequency;
+
+    if (!zrpTimerBeginInitialization(&zrpTimerTicksState)) {
+        return;
+    }
+
+    frequency = zrpTimerGetCounterFrequency();
+    if (frequency > 0) {
+        zrpTimerUseCounter = 1;
+        zrpTimerTicksPerSecond = frequency;
+    } else {
+        zrpTimerUseCounter = 0;
+        zrpTimerTicksPerSecond = ZR_TIMER_TICKS_PER_SECOND;
+    }
+
+    zrpTimerEndInitialization(&zrpTimerTicksState);
+}
+
+#if defined(ZRP_PLATFORM_UNIX)
+ZRP_MAYBE_UNUSED static void
+zrpTimerGetUsageCpuTimes(struct ZrCpuTimes *pTimes, const struct rusage *pUsage)
+{
+    pTimes->user = (ZrUint64)pUsage->ru_utime.tv_sec * 1000000000ull
+                   + (ZrUint64)pUsage->ru_utime.tv_usec * 1000ull;
+    pTimes->system = (ZrUint64)pUsage->ru_stime.tv_sec * 1000000000ull
+                     + (ZrUint64)pUsage->ru_stime.tv_usec * 1000ull;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerGetUsage(struct ZrResourceUsage *pUsage, const struct rusage *pSource)
+{
+    zrpTimerGetUsageCpuTimes(&pUsage->times, pSource);
+    pUsage->voluntaryContextSwitches = (ZrUint64)pSource->ru_nvcsw;
+    pUsage->involuntaryContextSwitches = (ZrUint64)pSource->ru_nivcsw;
+    pUsage->minorPageFaults = (ZrUint64)pSource->ru_minflt;
+    pUsage->majorPageFaults = (ZrUint64)pSource->ru_majflt;
+
+    /* Darwin reports the peak resident set size in bytes, others in KiB. */
+#if defined(ZRP_PLATFORM_DARWIN)
+    pUsage->maxResidentSetSize = (ZrUint64)pSource->ru_maxrss;
+#else
+    pUsage->maxResidentSetSize = (ZrUint64)pSource->ru_maxrss * 1024ull;
+#endif
+}
+#endif
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetRealTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerClockState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeClock();
+    }
+
+    return zrpTimerReadClock(
+        pTime, (enum ZrClock)zrpAtomicLoadSizeRelaxed(&zrpTimerClock));
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrSetClock(enum ZrClock clock)
+{
+    const struct ZrClockInfo *pInfo;
+
+    zrpTimerInitializeClock();
+    if ((int)clock < 0 || (int)clock >= ZRP_TIMER_CLOCK_COUNT
+        || !zrpTimerGetClockInfo(&pInfo, clock)) {
+        ZRP_LOG_ERROR("the clock %d isn't available\n", (int)clock);
+        return ZR_ERROR;
+    }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)clock);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrSelectClock(ZrUint64 maxResolution)
+{
+    zrpTimerInitializeClock();
+    if (zrpTimerSelectClock(maxResolution) != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("no clock has a resolution of %lu nanoseconds\n",
+                      (unsigned long)maxResolution);
+        return ZR_ERROR;
+    }
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE void
+zrGetClockInfo(struct ZrClockInfo *pInfo)
+{
+    const struct ZrClockInfo *pClockInfo;
+
+    ZR_ASSERT(pInfo != NULL);
+
+    zrpTimerInitializeClock();
+    zrpTimerGetClockInfo(
+        &pClockInfo, (enum ZrClock)zrpAtomicLoadSizeRelaxed(&zrpTimerClock));
+    *pInfo = *pClockInfo;
+}
+
 ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
 zrGetCpuTimes(struct ZrCpuTimes *pTimes)
 {
@@ -643,11 +1836,12 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
 
         time.LowPart = userTime.dwLowDateTime;
         time.HighPart = userTime.dwHighDateTime;
-        *pTimes->user = time.QuadPart * 100ull;
+        pTimes->user = time.QuadPart * 100ull;
 
         time.LowPart = kernelTime.dwLowDateTime;
         time.HighPart = kernelTime.dwHighDateTime;
-        *pTimes->system = time.QuadPart * 100ull;
+        pTimes->system = time.QuadPart * 100ull;
+        return ZR_SUCCESS;
     }
 #elif defined(ZRP_PLATFORM_UNIX)
     {
@@ -658,10 +1852,7 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
             return ZR_ERROR;
         }
 
-        pTimes->user = (ZrUint64)usage.ru_utime.tv_sec * 1000000000ull
-                       + (ZrUint64)usage.ru_utime.tv_usec * 1000ull;
-        pTimes->system = (ZrUint64)usage.ru_stime.tv_sec * 1000000000ull
-                         + (ZrUint64)usage.ru_stime.tv_usec * 1000ull;
+        zrpTimerGetUsageCpuTimes(pTimes, &usage);
         return ZR_SUCCESS;
     }
 #endif
@@ -670,5 +1861,182 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
     return ZR_ERROR;
 }
 
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadCpuTimes(struct ZrCpuTimes *pTimes)
+{
+    ZR_ASSERT(pTimes != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    {
+        FILETIME creationTime;
+        FILETIME exitTime;
+        FILETIME kernelTime;
+        FILETIME userTime;
+        ULARGE_INTEGER time;
+
+        if (!GetThreadTimes(GetCurrentThread(),
+                            &creationTime,
+                            &exitTime,
+                            &kernelTime,
+                            &userTime)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        time.LowPart = userTime.dwLowDateTime;
+        time.HighPart = userTime.dwHighDateTime;
+        pTimes->user = time.QuadPart * 100ull;
+
+        time.LowPart = kernelTime.dwLowDateTime;
+        time.HighPart = kernelTime.dwHighDateTime;
+        pTimes->system = time.QuadPart * 100ull;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_DARWIN)
+    {
+        mach_port_t thread;
+        thread_basic_info_data_t info;
+        mach_msg_type_number_t count;
+        kern_return_t result;
+
+        thread = mach_thread_self();
+        count = THREAD_BASIC_INFO_COUNT;
+        result = thread_info(
+            thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+        mach_port_deallocate(mach_task_self(), thread);
+        if (result != KERN_SUCCESS) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        pTimes->user = (ZrUint64)info.user_time.seconds * 1000000000ull
+                       + (ZrUint64)info.user_time.microseconds * 1000ull;
+        pTimes->system = (ZrUint64)info.system_time.seconds * 1000000000ull
+                         + (ZrUint64)info.system_time.microseconds * 1000ull;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_UNIX) && defined(ZRP_TIMER_RUSAGE_THREAD)
+    {
+        struct rusage usage;
+
+        if (getrusage(ZRP_TIMER_RUSAGE_THREAD, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsageCpuTimes(pTimes, &usage);
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_CLOCK_USE_CLOCK_GETTIME)                                     \
+    && defined(CLOCK_THREAD_CPUTIME_ID)
+    {
+        struct timespec time;
+
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        pTimes->user = (ZrUint64)time.tv_sec * 1000000000ull
+                       + (ZrUint64)time.tv_nsec;
+        pTimes->system = 0;
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pTimes;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetResourceUsage(struct ZrResourceUsage *pUsage)
+{
+    ZR_ASSERT(pUsage != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX)
+    {
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current resource usage\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsage(pUsage, &usage);
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pUsage;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadResourceUsage(struct ZrResourceUsage *pUsage)
+{
+    ZR_ASSERT(pUsage != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX) && defined(ZRP_TIMER_RUSAGE_THREAD)
+    {
+        struct rusage usage;
+
+        if (getrusage(ZRP_TIMER_RUSAGE_THREAD, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread resource "
+                          "usage\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsage(pUsage, &usage);
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pUsage;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE ZrUint64
+zrGetTicks(void)
+{
+    ZrUint64 time;
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerTicksState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeTicks();
+    }
+
+    if (zrpTimerUseCounter) {
+        return zrpTimerReadCounter();
+    }
+
+    if (zrGetRealTime(&time) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    return time;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE ZrUint64
+zrTicksToNanoseconds(ZrUint64 ticks)
+{
+    ZrUint64 frequency;
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerTicksState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeTicks();
+    }
+
+    /* Split the conversion to avoid overflowing, with rates up to 18 GHz. */
+    frequency = zrpTimerTicksPerSecond;
+    return ticks / frequency * 1000000000ull
+           + ticks % frequency * 1000000000ull / frequency;
+}
+
 #endif /* ZRP_TIMER_IMPLEMENTATION_DEFINED */
 #endif /* ZR_DEFINE_IMPLEMENTATION */
@@ -22,24 +22,54 @@
 #define ZRP_DYNAMICARRAY_LINKAGE extern
 #endif
 
+struct ZrConcurrentArray;
+struct ZrSlotMap;
+struct ZrBitSet;
+
 #define ZRP_DYNAMICARRAY_DECLARE_CREATE_FUNCTION(name, type)                   \
     ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(type **ppArray,      \
                                                           ZrSize size)
 
+#define ZRP_DYNAMICARRAY_DECLARE_CREATE_MAPPED_FUNCTION(name, type)            \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(                     \
+        type **ppArray, const char *pPath, ZrSize size)
+
+#define ZRP_DYNAMICARRAY_DECLARE_OPEN_MAPPED_FUNCTION(name, type)              \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrOpen##name(type **ppArray,        \
+                                                        const char *pPath)
+
+#define ZRP_DYNAMICARRAY_DECLARE_CLOSE_MAPPED_FUNCTION(name, type)             \
+    ZRP_DYNAMICARRAY_LINKAGE void zrClose##name(type *pArray)
+
+#define ZRP_DYNAMICARRAY_DECLARE_SYNC_MAPPED_FUNCTION(name, type)              \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrSync##name(const type *pArray)
+
 #define ZRP_DYNAMICARRAY_DECLARE_DESTROY_FUNCTION(name, type)                  \
     ZRP_DYNAMICARRAY_LINKAGE void zrDestroy##name(type *pArray)
 
+#define ZRP_DYNAMICARRAY_DECLARE_SAVE_FUNCTION(name, type)                     \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrSave##name(const type *pArray,    \
+                                                        const char *pPath)
+
+#define ZRP_DYNAMICARRAY_DECLARE_LOAD_FUNCTION(name, type)                     \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrLoad##name(type **ppArray,        \
+                                                        const char *pPath)
+
+#define ZRP_DYNAMICARRAY_DECLARE_VIEW_FUNCTION(name, type)                     \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrView##name(                       \
+        const type **ppArray, const void *pBuffer, ZrSize bufferSize)
+
 #define ZRP_DYNAMICARRAY_DECLARE_GET_SIZE_FUNCTION(name, type)                 \
-    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(const type *pArray,        \
-                                                    ZrSize *pSize)
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(ZrSize *pSize,             \
+                                                    const type *pArray)
 
 #define ZRP_DYNAMICARRAY_DECLARE_GET_CAPACITY_FUNCTION(name, type)             \
-    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Capacity(const type *pArray,    \
-                                                        ZrSize *pCapacity)
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Capacity(ZrSize *pCapacity,     \
+                                                        const type *pArray)
 
 #define ZRP_DYNAMICARRAY_DECLARE_GET_MAX_CAPACITY_FUNCTION(name, type)         \
-    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##MaxCapacity(const type *pArray, \
-                                                           ZrSize *pCapacity)
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##MaxCapacity(                    \
+        ZrSize *pMaxCapacity)
 
 #define ZRP_DYNAMICARRAY_DECLARE_RESIZE_FUNCTION(name, type)                   \
     ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrResize##name(type **ppArray,      \
@@ -95,27 +125,265 @@
 #define ZRP_DYNAMICARRAY_DECLARE_TRIM_BACK_FUNCTION(name, type)                \
     ZRP_DYNAMICARRAY_LINKAGE void zrTrim##name##Back(type *pArray, ZrSize size)
 
+#define ZRP_DYNAMICARRAY_DECLARE_CREATE_CONCURRENT_FUNCTION(name, type)        \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(                     \
+        struct ZrConcurrentArray **ppArray)
+
+#define ZRP_DYNAMICARRAY_DECLARE_DESTROY_CONCURRENT_FUNCTION(name, type)       \
+    ZRP_DYNAMICARRAY_LINKAGE void zrDestroy##name(                             \
+        struct ZrConcurrentArray *pArray)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_CONCURRENT_SIZE_FUNCTION(name, type)      \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(                           \
+        ZrSize *pSize, const struct ZrConcurrentArray *pArray)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_CONCURRENT_ELEMENT_FUNCTION(name, type)   \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Element(                        \
+        type **ppElement, const struct ZrConcurrentArray *pArray, ZrSize index)
+
+#define ZRP_DYNAMICARRAY_DECLARE_INSERT_CONCURRENT_BACK_FUNCTION(name, type)   \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrInsert##name##Back(               \
+        struct ZrConcurrentArray *pArray, ZrSize size, const type *pValues)
+
+#define ZRP_DYNAMICARRAY_DECLARE_PUSH_CONCURRENT_BACK_FUNCTION(name, type)     \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrPush##name##Back(                 \
+        struct ZrConcurrentArray *pArray, type value)
+
+#define ZRP_DYNAMICARRAY_DECLARE_COMMON_FUNCTIONS(name, type)                  \
+    ZRP_DYNAMICARRAY_DECLARE_SAVE_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_VIEW_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_GET_SIZE_FUNCTION(name, type);                    \
+    ZRP_DYNAMICARRAY_DECLARE_GET_CAPACITY_FUNCTION(name, type);                \
+    ZRP_DYNAMICARRAY_DECLARE_GET_MAX_CAPACITY_FUNCTION(name, type);            \
+    ZRP_DYNAMICARRAY_DECLARE_RESIZE_FUNCTION(name, type);                      \
+    ZRP_DYNAMICARRAY_DECLARE_RESERVE_FUNCTION(name, type);                     \
+    ZRP_DYNAMICARRAY_DECLARE_EXTEND_FUNCTION(name, type);                      \
+    ZRP_DYNAMICARRAY_DECLARE_EXTEND_FRONT_FUNCTION(name, type);                \
+    ZRP_DYNAMICARRAY_DECLARE_EXTEND_BACK_FUNCTION(name, type);                 \
+    ZRP_DYNAMICARRAY_DECLARE_INSERT_FUNCTION(name, type);                      \
+    ZRP_DYNAMICARRAY_DECLARE_INSERT_FRONT_FUNCTION(name, type);                \
+    ZRP_DYNAMICARRAY_DECLARE_INSERT_BACK_FUNCTION(name, type);                 \
+    ZRP_DYNAMICARRAY_DECLARE_PUSH_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_PUSH_FRONT_FUNCTION(name, type);                  \
+    ZRP_DYNAMICARRAY_DECLARE_PUSH_BACK_FUNCTION(name, type);                   \
+    ZRP_DYNAMICARRAY_DECLARE_TRIM_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_TRIM_FRONT_FUNCTION(name, type);                  \
+    ZRP_DYNAMICARRAY_DECLARE_TRIM_BACK_FUNCTION(name, type);
+
 #define ZR_MAKE_DYNAMIC_ARRAY(name, type)                                      \
-    ZRP_DYNAMICARRAY_DECLARE_MAX_CAPACITY(name, type)                          \
-    ZRP_DYNAMICARRAY_DECLARE_CREATE_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DECLARE_DESTROY_FUNCTION(name, type)                      \
-    ZRP_DYNAMICARRAY_DECLARE_GET_SIZE_FUNCTION(name, type)                     \
-    ZRP_DYNAMICARRAY_DECLARE_GET_CAPACITY_FUNCTION(name, type)                 \
-    ZRP_DYNAMICARRAY_DECLARE_GET_MAX_CAPACITY_FUNCTION(name, type)             \
-    ZRP_DYNAMICARRAY_DECLARE_RESIZE_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DECLARE_RESERVE_FUNCTION(name, type)                      \
-    ZRP_DYNAMICARRAY_DECLARE_EXTEND_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DECLARE_EXTEND_FRONT_FUNCTION(name, type)                 \
-    ZRP_DYNAMICARRAY_DECLARE_EXTEND_BACK_FUNCTION(name, type)                  \
-    ZRP_DYNAMICARRAY_DECLARE_INSERT_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DECLARE_INSERT_FRONT_FUNCTION(name, type)                 \
-    ZRP_DYNAMICARRAY_DECLARE_INSERT_BACK_FUNCTION(name, type)                  \
-    ZRP_DYNAMICARRAY_DECLARE_PUSH_FUNCTION(name, type)                         \
-    ZRP_DYNAMICARRAY_DECLARE_PUSH_FRONT_FUNCTION(name, type)                   \
-    ZRP_DYNAMICARRAY_DECLARE_PUSH_BACK_FUNCTION(name, type)                    \
-    ZRP_DYNAMICARRAY_DECLARE_TRIM_FUNCTION(name, type)                         \
-    ZRP_DYNAMICARRAY_DECLARE_TRIM_FRONT_FUNCTION(name, type)                   \
-    ZRP_DYNAMICARRAY_DECLARE_TRIM_BACK_FUNCTION(name, type)
+    ZRP_DYNAMICARRAY_DECLARE_CREATE_FUNCTION(name, type);                      \
+    ZRP_DYNAMICARRAY_DECLARE_DESTROY_FUNCTION(name, type);                     \
+    ZRP_DYNAMICARRAY_DECLARE_LOAD_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_COMMON_FUNCTIONS(name, type)
+
+/*
+   The mapped variant stores the array into a file that is memory-mapped, and
+   is meant to be reopened later on without having to copy the elements.
+   Files are only compatible across platforms sharing the same data model and
+   endianness.
+
+   Both variants can be saved into snapshot files that are either loaded as
+   regular arrays, or viewed in place from a buffer, such as a memory-mapped
+   snapshot file, without copying. Views are read-only arrays that can be
+   passed to any function that doesn't modify the array.
+*/
+#define ZR_MAKE_MAPPED_DYNAMIC_ARRAY(name, type)                               \
+    ZRP_DYNAMICARRAY_DECLARE_CREATE_MAPPED_FUNCTION(name, type);               \
+    ZRP_DYNAMICARRAY_DECLARE_OPEN_MAPPED_FUNCTION(name, type);                 \
+    ZRP_DYNAMICARRAY_DECLARE_CLOSE_MAPPED_FUNCTION(name, type);                \
+    ZRP_DYNAMICARRAY_DECLARE_SYNC_MAPPED_FUNCTION(name, type);                 \
+    ZRP_DYNAMICARRAY_DECLARE_COMMON_FUNCTIONS(name, type)
+
+/*
+   The concurrent variant is an append-only array that can be pushed to from
+   multiple threads without locking. Elements are stored in segments of
+   growing sizes that are never moved, so pointers to elements remain valid
+   until the array is destroyed, and the size returned always corresponds to
+   a prefix of elements that are fully written.
+*/
+#define ZR_MAKE_CONCURRENT_DYNAMIC_ARRAY(name, type)                           \
+    ZRP_DYNAMICARRAY_DECLARE_CREATE_CONCURRENT_FUNCTION(name, type);           \
+    ZRP_DYNAMICARRAY_DECLARE_DESTROY_CONCURRENT_FUNCTION(name, type);          \
+    ZRP_DYNAMICARRAY_DECLARE_GET_CONCURRENT_SIZE_FUNCTION(name, type);         \
+    ZRP_DYNAMICARRAY_DECLARE_GET_CONCURRENT_ELEMENT_FUNCTION(name, type);      \
+    ZRP_DYNAMICARRAY_DECLARE_INSERT_CONCURRENT_BACK_FUNCTION(name, type);      \
+    ZRP_DYNAMICARRAY_DECLARE_PUSH_CONCURRENT_BACK_FUNCTION(name, type);
+
+#define ZRP_DYNAMICARRAY_DECLARE_CREATE_SLOT_MAP_FUNCTION(name, type, handle)  \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(                     \
+        struct ZrSlotMap **ppMap, ZrSize capacity)
+
+#define ZRP_DYNAMICARRAY_DECLARE_DESTROY_SLOT_MAP_FUNCTION(name, type, handle) \
+    ZRP_DYNAMICARRAY_LINKAGE void zrDestroy##name(struct ZrSlotMap *pMap)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_SIZE_FUNCTION(                   \
+    name, type, handle)                                                        \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(                           \
+        ZrSize *pSize, const struct ZrSlotMap *pMap)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_ELEMENTS_FUNCTION(               \
+    name, type, handle)                                                        \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Elements(                       \
+        type **ppElements, const struct ZrSlotMap *pMap)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_ELEMENT_FUNCTION(                \
+    name, type, handle)                                                        \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Element(                        \
+        type **ppElement, const struct ZrSlotMap *pMap, handle h)
+
+#define ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_HANDLE_FUNCTION(                 \
+    name, type, handle)                                                        \
+    ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Handle(                         \
+        handle *pHandle, const struct ZrSlotMap *pMap, ZrSize index)
+
+#define ZRP_DYNAMICARRAY_DECLARE_RESERVE_SLOT_MAP_FUNCTION(name, type, handle) \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrReserve##name(                    \
+        struct ZrSlotMap *pMap, ZrSize capacity)
+
+#define ZRP_DYNAMICARRAY_DECLARE_INSERT_SLOT_MAP_FUNCTION(name, type, handle)  \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrInsert##name(                     \
+        handle *pHandle, struct ZrSlotMap *pMap, type value)
+
+#define ZRP_DYNAMICARRAY_DECLARE_ERASE_SLOT_MAP_FUNCTION(name, type, handle)   \
+    ZRP_DYNAMICARRAY_LINKAGE void zrErase##name(struct ZrSlotMap *pMap,        \
+                                                handle h)
+
+#define ZRP_DYNAMICARRAY_DECLARE_SLOT_MAP_FUNCTIONS(name, type, handle)        \
+    ZRP_DYNAMICARRAY_DECLARE_CREATE_SLOT_MAP_FUNCTION(name, type, handle);     \
+    ZRP_DYNAMICARRAY_DECLARE_DESTROY_SLOT_MAP_FUNCTION(name, type, handle);    \
+    ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_SIZE_FUNCTION(name, type, handle);   \
+    ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_ELEMENTS_FUNCTION(                   \
+        name, type, handle);                                                   \
+    ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_ELEMENT_FUNCTION(                    \
+        name, type, handle);                                                   \
+    ZRP_DYNAMICARRAY_DECLARE_GET_SLOT_MAP_HANDLE_FUNCTION(name, type, handle); \
+    ZRP_DYNAMICARRAY_DECLARE_RESERVE_SLOT_MAP_FUNCTION(name, type, handle);    \
+    ZRP_DYNAMICARRAY_DECLARE_INSERT_SLOT_MAP_FUNCTION(name, type, handle);     \
+    ZRP_DYNAMICARRAY_DECLARE_ERASE_SLOT_MAP_FUNCTION(name, type, handle);
+
+/*
+   Slot maps hand out generational handles to their elements that remain
+   valid until the element is erased, no matter how the storage is moved
+   around, while the elements themselves are kept packed for iteration.
+   Handles are 64-bit integers, or 32-bit ones for the compact variant, which
+   is limited to about a million elements. A handle of 0 is never valid.
+
+   Pointers to the elements are invalidated by any insertion or erasure.
+*/
+#define ZR_MAKE_SLOT_MAP(name, type)                                           \
+    ZRP_DYNAMICARRAY_DECLARE_SLOT_MAP_FUNCTIONS(name, type, ZrUint64)
+
+#define ZR_MAKE_COMPACT_SLOT_MAP(name, type)                                   \
+    ZRP_DYNAMICARRAY_DECLARE_SLOT_MAP_FUNCTIONS(name, type, ZrUint32)
+
+#define ZRP_DYNAMICARRAY_DECLARE_ENQUEUE_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrEnqueue##name(type **ppQueue,     \
+                                                           type value)
+
+#define ZRP_DYNAMICARRAY_DECLARE_DEQUEUE_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_LINKAGE int zrDequeue##name(type *pValue, type *pQueue)
+
+#define ZRP_DYNAMICARRAY_DECLARE_PEEK_FUNCTION(name, type)                     \
+    ZRP_DYNAMICARRAY_LINKAGE int zrPeek##name(type *pValue,                    \
+                                              const type *pQueue)
+
+#define ZRP_DYNAMICARRAY_DECLARE_HEAPIFY_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_LINKAGE void zrHeapify##name(type *pQueue)
+
+#define ZRP_DYNAMICARRAY_DECLARE_UPDATE_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_LINKAGE void zrUpdate##name(type *pQueue, ZrSize index)
+
+#define ZRP_DYNAMICARRAY_DECLARE_REMOVE_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_LINKAGE void zrRemove##name(                              \
+        type *pValue, type *pQueue, ZrSize index)
+
+#define ZRP_DYNAMICARRAY_DECLARE_PRIORITY_QUEUE_FUNCTIONS(name, type)          \
+    ZRP_DYNAMICARRAY_DECLARE_ENQUEUE_FUNCTION(name, type);                     \
+    ZRP_DYNAMICARRAY_DECLARE_DEQUEUE_FUNCTION(name, type);                     \
+    ZRP_DYNAMICARRAY_DECLARE_PEEK_FUNCTION(name, type);                        \
+    ZRP_DYNAMICARRAY_DECLARE_HEAPIFY_FUNCTION(name, type);                     \
+    ZRP_DYNAMICARRAY_DECLARE_UPDATE_FUNCTION(name, type);                      \
+    ZRP_DYNAMICARRAY_DECLARE_REMOVE_FUNCTION(name, type);
+
+/*
+   Priority queues are regular dynamic arrays kept ordered as 4-ary min-heaps,
+   where `lessFn(const type *pA, const type *pB)` returns whether `pA` comes
+   out first. All the dynamic array functions remain available but any
+   modification done through them requires calling `zrHeapify*()` before
+   using the queue again, which is also how an existing array gets turned into
+   a queue.
+
+   The indexed variant calls `setIndexFn(type *pElement, ZrSize index)` each
+   time an element is moved within the queue, allowing for the element to
+   track its index, which can then be passed to `zrUpdate*()` after changing
+   its priority, such as when decreasing a key, or to `zrRemove*()`.
+*/
+#define ZR_MAKE_PRIORITY_QUEUE(name, type, lessFn)                             \
+    ZR_MAKE_DYNAMIC_ARRAY(name, type)                                          \
+    ZRP_DYNAMICARRAY_DECLARE_PRIORITY_QUEUE_FUNCTIONS(name, type)
+
+#define ZR_MAKE_INDEXED_PRIORITY_QUEUE(name, type, lessFn, setIndexFn)         \
+    ZR_MAKE_DYNAMIC_ARRAY(name, type)                                          \
+    ZRP_DYNAMICARRAY_DECLARE_PRIORITY_QUEUE_FUNCTIONS(name, type)
+
+/*
+   Bit sets are dynamic arrays of bits stored in 64-bit words. Ranking and
+   selecting require the bit set to be indexed beforehand, with any
+   modification invalidating the index until it is rebuilt.
+*/
+
+ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrCreateBitSet(struct ZrBitSet **ppBitSet, ZrSize size);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrDestroyBitSet(struct ZrBitSet *pBitSet);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrGetBitSetSize(ZrSize *pSize, const struct ZrBitSet *pBitSet);
+
+ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrResizeBitSet(struct ZrBitSet *pBitSet, ZrSize size);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrSetBit(struct ZrBitSet *pBitSet, ZrSize position);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrClearBit(struct ZrBitSet *pBitSet, ZrSize position);
+
+ZRP_DYNAMICARRAY_LINKAGE int
+zrTestBit(const struct ZrBitSet *pBitSet, ZrSize position);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrSetBits(struct ZrBitSet *pBitSet, ZrSize position, ZrSize size);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrClearBits(struct ZrBitSet *pBitSet, ZrSize position, ZrSize size);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrCountBits(ZrSize *pCount, const struct ZrBitSet *pBitSet);
+
+ZRP_DYNAMICARRAY_LINKAGE int
+zrFindNextBit(ZrSize *pPosition,
+              const struct ZrBitSet *pBitSet,
+              ZrSize position);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrAndBitSets(struct ZrBitSet *pBitSet, const struct ZrBitSet *pOther);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrOrBitSets(struct ZrBitSet *pBitSet, const struct ZrBitSet *pOther);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrXorBitSets(struct ZrBitSet *pBitSet, const struct ZrBitSet *pOther);
+
+ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrIndexBitSet(struct ZrBitSet *pBitSet);
+
+ZRP_DYNAMICARRAY_LINKAGE void
+zrRankBit(ZrSize *pRank, const struct ZrBitSet *pBitSet, ZrSize position);
+
+ZRP_DYNAMICARRAY_LINKAGE int
+zrSelectBit(ZrSize *pPosition, const struct ZrBitSet *pBitSet, ZrSize rank);
 
 #endif /* ZERO_DYNAMICARRAY_H */
 
@@ -127,6 +395,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #ifndef ZR_ASSERT
 #include <assert.h>
@@ -143,10 +412,29 @@
 #define ZR_FREE free
 #endif /* ZR_FREE */
 
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
 /* @include "partials/unused.h" */
 /* @include "partials/logging.h" */
 /* @include "partials/loglevel.h" */
 /* @include "partials/logger.h" */
+/* @include "partials/atomics.h" */
+/* @include "partials/threads.h" */
+/* @include "partials/bits.h" */
+
+#if defined(ZRP_PLATFORM_UNIX) && defined(_POSIX_C_SOURCE)                     \
+    && _POSIX_C_SOURCE >= 200112L
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define ZRP_DYNAMICARRAY_POSIX 1
+#else
+#define ZRP_DYNAMICARRAY_POSIX 0
+#endif
 
 #define ZRP_DYNAMICARRAY_GET_BLOCK(pBuffer)                                    \
     ((void *)&((struct ZrpDynamicArrayHeader *)(pBuffer))[-1])
@@ -158,12 +446,42 @@
     ((const void *)&((const struct ZrpDynamicArrayHeader *)pBuffer)[-1])
 #define ZRP_DYNAMICARRAY_GET_CONST_HEADER(pBlock)                              \
     ((const struct ZrpDynamicArrayHeader *)(pBlock))
+#define ZRP_DYNAMICARRAY_GET_CONST_BUFFER(pBlock)                              \
+    ((const void *)&((const struct ZrpDynamicArrayHeader *)(pBlock))[1])
 
 #define ZRP_DYNAMICARRAY_DEFINE_MAX_CAPACITY(name, type)                       \
     static const size_t zrpMax##name##Capacity                                 \
         = (((size_t)-1 - sizeof(struct ZrpDynamicArrayHeader))                 \
            / sizeof(type));
 
+#define ZRP_DYNAMICARRAY_DEFINE_MAPPED_MAX_CAPACITY(name, type)                \
+    static const size_t zrpMax##name##Capacity                                 \
+        = (((size_t)-1 - sizeof(struct ZrpDynamicArrayMappedHeader)            \
+            - sizeof(struct ZrpDynamicArrayHeader))                            \
+           / sizeof(type));
+
+#define ZRP_DYNAMICARRAY_DEFINE_ENSURE_CAPACITY_FUNCTION(name, type)           \
+    ZRP_MAYBE_UNUSED static enum ZrStatus zrpEnsure##name##HasEnoughCapacity(  \
+        void **ppBlock, size_t requestedCapacity)                              \
+    {                                                                          \
+        return zrpDynamicArrayEnsureHasEnoughCapacity(                         \
+            ppBlock,                                                           \
+            *ppBlock == NULL                                                   \
+                ? 0                                                            \
+                : ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity,             \
+            requestedCapacity,                                                 \
+            zrpMax##name##Capacity,                                            \
+            sizeof(type));                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_ENSURE_MAPPED_CAPACITY_FUNCTION(name, type)    \
+    ZRP_MAYBE_UNUSED static enum ZrStatus zrpEnsure##name##HasEnoughCapacity(  \
+        void **ppBlock, size_t requestedCapacity)                              \
+    {                                                                          \
+        return zrpDynamicArrayEnsureMappedHasEnoughCapacity(                   \
+            ppBlock, requestedCapacity, zrpMax##name##Capacity, sizeof(type)); \
+    }
+
 #define ZRP_DYNAMICARRAY_DEFINE_CREATE_FUNCTION(name, type)                    \
     ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(    \
         type **ppArray, ZrSize size)                                           \
@@ -175,8 +493,7 @@
                                                                                \
         pBlock = NULL;                                                         \
                                                                                \
-        status = zrpDynamicArrayEnsureHasEnoughCapacity(                       \
-            &pBlock, 0, (size_t)size, zrpMax##name##Capacity, sizeof(type));   \
+        status = zrpEnsure##name##HasEnoughCapacity(&pBlock, (size_t)size);    \
         if (status != ZR_SUCCESS) {                                            \
             ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
                           "type ‘" #type "’ (requested capacity: %zu)\n",      \
@@ -203,6 +520,148 @@
         ZR_FREE(ZRP_DYNAMICARRAY_GET_BLOCK(pArray));                           \
     }
 
+#define ZRP_DYNAMICARRAY_DEFINE_CREATE_MAPPED_FUNCTION(name, type)             \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(    \
+        type **ppArray, const char *pPath, ZrSize size)                        \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        void *pBlock;                                                          \
+                                                                               \
+        ZR_ASSERT(ppArray != NULL);                                            \
+        ZR_ASSERT(pPath != NULL);                                              \
+                                                                               \
+        status = zrpDynamicArrayCreateMapped(&pBlock,                          \
+                                             pPath,                            \
+                                             (size_t)size,                     \
+                                             zrpMax##name##Capacity,           \
+                                             sizeof(type));                    \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create the file ‘%s’ mapping an array "   \
+                          "of type ‘" #type "’ (requested capacity: %zu)\n",   \
+                          pPath,                                               \
+                          (size_t)size);                                       \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pBlock != NULL);                                             \
+                                                                               \
+        ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size = (size_t)size;              \
+        *ppArray = (type *)ZRP_DYNAMICARRAY_GET_BUFFER(pBlock);                \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_OPEN_MAPPED_FUNCTION(name, type)               \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrOpen##name(      \
+        type **ppArray, const char *pPath)                                     \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        void *pBlock;                                                          \
+                                                                               \
+        ZR_ASSERT(ppArray != NULL);                                            \
+        ZR_ASSERT(pPath != NULL);                                              \
+                                                                               \
+        status = zrpDynamicArrayOpenMapped(                                    \
+            &pBlock, pPath, zrpMax##name##Capacity, sizeof(type));             \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to open the file ‘%s’ mapping an array of "  \
+                          "type ‘" #type "’\n",                                \
+                          pPath);                                              \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pBlock != NULL);                                             \
+                                                                               \
+        *ppArray = (type *)ZRP_DYNAMICARRAY_GET_BUFFER(pBlock);                \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_CLOSE_MAPPED_FUNCTION(name, type)              \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrClose##name(type *pArray) \
+    {                                                                          \
+        if (pArray == NULL) {                                                  \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        zrpDynamicArrayCloseMapped(ZRP_DYNAMICARRAY_GET_BLOCK(pArray));        \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_SYNC_MAPPED_FUNCTION(name, type)               \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrSync##name(      \
+        const type *pArray)                                                    \
+    {                                                                          \
+        ZR_ASSERT(pArray != NULL);                                             \
+                                                                               \
+        return zrpDynamicArraySyncMapped(                                      \
+            ZRP_DYNAMICARRAY_GET_CONST_BLOCK(pArray));                         \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_SAVE_FUNCTION(name, type)                      \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrSave##name(      \
+        const type *pArray, const char *pPath)                                 \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(pArray != NULL);                                             \
+        ZR_ASSERT(pPath != NULL);                                              \
+                                                                               \
+        status = zrpDynamicArraySave(                                          \
+            ZRP_DYNAMICARRAY_GET_CONST_BLOCK(pArray), pPath, sizeof(type));    \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to save the array of type ‘" #type "’ into " \
+                          "the file ‘%s’\n",                                   \
+                          pPath);                                              \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_LOAD_FUNCTION(name, type)                      \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrLoad##name(      \
+        type **ppArray, const char *pPath)                                     \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        void *pBlock;                                                          \
+                                                                               \
+        ZR_ASSERT(ppArray != NULL);                                            \
+        ZR_ASSERT(pPath != NULL);                                              \
+                                                                               \
+        status = zrpDynamicArrayLoad(                                          \
+            &pBlock, pPath, zrpMax##name##Capacity, sizeof(type));             \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to load an array of type ‘" #type "’ from "  \
+                          "the file ‘%s’\n",                                   \
+                          pPath);                                              \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pBlock != NULL);                                             \
+                                                                               \
+        *ppArray = (type *)ZRP_DYNAMICARRAY_GET_BUFFER(pBlock);                \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_VIEW_FUNCTION(name, type)                      \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrView##name(      \
+        const type **ppArray, const void *pBuffer, ZrSize bufferSize)          \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        const void *pBlock;                                                    \
+                                                                               \
+        ZR_ASSERT(ppArray != NULL);                                            \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+                                                                               \
+        status = zrpDynamicArrayView(                                          \
+            &pBlock, pBuffer, (size_t)bufferSize, sizeof(type));               \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to view an array of type ‘" #type "’\n");    \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        *ppArray = (const type *)ZRP_DYNAMICARRAY_GET_CONST_BUFFER(pBlock);    \
+        return ZR_SUCCESS;                                                     \
+    }
+
 #define ZRP_DYNAMICARRAY_DEFINE_GET_SIZE_FUNCTION(name, type)                  \
     ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(          \
         ZrSize *pSize, const type *pArray)                                     \
@@ -244,12 +703,7 @@
                                                                                \
         pBlock = ZRP_DYNAMICARRAY_GET_BLOCK(*ppArray);                         \
                                                                                \
-        status = zrpDynamicArrayEnsureHasEnoughCapacity(                       \
-            &pBlock,                                                           \
-            ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->capacity,                     \
-            (size_t)size,                                                      \
-            zrpMax##name##Capacity,                                            \
-            sizeof(type));                                                     \
+        status = zrpEnsure##name##HasEnoughCapacity(&pBlock, (size_t)size);    \
         if (status != ZR_SUCCESS) {                                            \
             ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
                           "type ‘" #type "’ (requested capacity: %zu)\n",      \
@@ -276,12 +730,8 @@
                                                                                \
         pBlock = ZRP_DYNAMICARRAY_GET_BLOCK(*ppArray);                         \
                                                                                \
-        status = zrpDynamicArrayEnsureHasEnoughCapacity(                       \
-            &pBlock,                                                           \
-            ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->capacity,                     \
-            (size_t)capacity,                                                  \
-            zrpMax##name##Capacity,                                            \
-            sizeof(type));                                                     \
+        status = zrpEnsure##name##HasEnoughCapacity(                           \
+            &pBlock, (size_t)capacity);                                        \
         if (status != ZR_SUCCESS) {                                            \
             ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
                           "type ‘" #type "’ (requested capacity: %zu)\n",      \
@@ -311,12 +761,9 @@
             position = (ZrSize)ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size;      \
         }                                                                      \
                                                                                \
-        status = zrpDynamicArrayEnsureHasEnoughCapacity(                       \
+        status = zrpEnsure##name##HasEnoughCapacity(                           \
             &pBlock,                                                           \
-            ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->capacity,                     \
-            ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size + (size_t)size,          \
-            zrpMax##name##Capacity,                                            \
-            sizeof(type));                                                     \
+            ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size + (size_t)size);         \
         if (status != ZR_SUCCESS) {                                            \
             ZRP_LOG_ERROR(                                                     \
                 "failed to reserve a large enough capacity for the "           \
@@ -452,7 +899,9 @@
                                                                                \
         memmove(&pArray[position],                                             \
                 &pArray[position + size],                                      \
-                sizeof(type) * (size_t)size);                                  \
+                sizeof(type)                                                   \
+                    * (ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size               \
+                       - (size_t)position - (size_t)size));                    \
         ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size -= (size_t)size;             \
     }
 
@@ -467,80 +916,589 @@
     ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrTrim##name##Back(         \
         type *pArray, ZrSize size)                                             \
     {                                                                          \
-        zrTrim##name(pArray, (ZrSize)-1, size);                                \
+        size_t currentSize;                                                    \
+                                                                               \
+        ZR_ASSERT(pArray != NULL);                                             \
+                                                                               \
+        currentSize                                                            \
+            = ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pArray))  \
+                  ->size;                                                      \
+        if (size > currentSize) {                                              \
+            size = (ZrSize)currentSize;                                        \
+        }                                                                      \
+                                                                               \
+        zrTrim##name(pArray, (ZrSize)(currentSize - (size_t)size), size);      \
     }
 
-#undef ZR_MAKE_DYNAMIC_ARRAY
-#define ZR_MAKE_DYNAMIC_ARRAY(name, type)                                      \
-    ZRP_DYNAMICARRAY_DEFINE_MAX_CAPACITY(name, type)                           \
-    ZRP_DYNAMICARRAY_DEFINE_CREATE_FUNCTION(name, type)                        \
-    ZRP_DYNAMICARRAY_DEFINE_DESTROY_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DEFINE_GET_SIZE_FUNCTION(name, type)                      \
-    ZRP_DYNAMICARRAY_DEFINE_GET_CAPACITY_FUNCTION(name, type)                  \
-    ZRP_DYNAMICARRAY_DEFINE_GET_MAX_CAPACITY_FUNCTION(name, type)              \
-    ZRP_DYNAMICARRAY_DEFINE_RESIZE_FUNCTION(name, type)                        \
-    ZRP_DYNAMICARRAY_DEFINE_RESERVE_FUNCTION(name, type)                       \
-    ZRP_DYNAMICARRAY_DEFINE_EXTEND_FUNCTION(name, type)                        \
-    ZRP_DYNAMICARRAY_DEFINE_EXTEND_FRONT_FUNCTION(name, type)                  \
-    ZRP_DYNAMICARRAY_DEFINE_EXTEND_BACK_FUNCTION(name, type)                   \
-    ZRP_DYNAMICARRAY_DEFINE_INSERT_FUNCTION(name, type)                        \
-    ZRP_DYNAMICARRAY_DEFINE_INSERT_FRONT_FUNCTION(name, type)                  \
-    ZRP_DYNAMICARRAY_DEFINE_INSERT_BACK_FUNCTION(name, type)                   \
-    ZRP_DYNAMICARRAY_DEFINE_PUSH_FUNCTION(name, type)                          \
-    ZRP_DYNAMICARRAY_DEFINE_PUSH_FRONT_FUNCTION(name, type)                    \
-    ZRP_DYNAMICARRAY_DEFINE_PUSH_BACK_FUNCTION(name, type)                     \
-    ZRP_DYNAMICARRAY_DEFINE_TRIM_FUNCTION(name, type)                          \
-    ZRP_DYNAMICARRAY_DEFINE_TRIM_FRONT_FUNCTION(name, type)                    \
-    ZRP_DYNAMICARRAY_DEFINE_TRIM_BACK_FUNCTION(name, type)
+#define ZRP_DYNAMICARRAY_DEFINE_CREATE_CONCURRENT_FUNCTION(name, type)         \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(    \
+        struct ZrConcurrentArray **ppArray)                                    \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(ppArray != NULL);                                            \
+                                                                               \
+        status = zrpConcurrentArrayCreate(ppArray, sizeof(type));              \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create a concurrent array of type "       \
+                          "‘" #type "’\n");                                    \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
 
-struct ZrpDynamicArrayHeader {
-    size_t size;
-    size_t capacity;
-};
+#define ZRP_DYNAMICARRAY_DEFINE_DESTROY_CONCURRENT_FUNCTION(name, type)        \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrDestroy##name(            \
+        struct ZrConcurrentArray *pArray)                                      \
+    {                                                                          \
+        if (pArray == NULL) {                                                  \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pArray->elementSize == sizeof(type));                        \
+        zrpConcurrentArrayDestroy(pArray);                                     \
+    }
 
-ZRP_MAYBE_UNUSED static void
-zrpDynamicArrayGetNewCapacity(size_t *pNewCapacity,
-                              size_t current,
-                              size_t requested,
-                              size_t max)
-{
-    *pNewCapacity = current + current / 2 + 1;
-    if (*pNewCapacity < current) {
-        *pNewCapacity = max;
-        return;
+#define ZRP_DYNAMICARRAY_DEFINE_GET_CONCURRENT_SIZE_FUNCTION(name, type)       \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(          \
+        ZrSize *pSize, const struct ZrConcurrentArray *pArray)                 \
+    {                                                                          \
+        ZR_ASSERT(pSize != NULL);                                              \
+        ZR_ASSERT(pArray != NULL);                                             \
+        ZR_ASSERT(pArray->elementSize == sizeof(type));                        \
+                                                                               \
+        *pSize = (ZrSize)zrpAtomicLoadSizeAcquire(&pArray->committedSize);     \
     }
 
-    if (*pNewCapacity < requested) {
-        *pNewCapacity = requested;
+#define ZRP_DYNAMICARRAY_DEFINE_GET_CONCURRENT_ELEMENT_FUNCTION(name, type)    \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Element(       \
+        type **ppElement,                                                      \
+        const struct ZrConcurrentArray *pArray,                                \
+        ZrSize index)                                                          \
+    {                                                                          \
+        ZR_ASSERT(ppElement != NULL);                                          \
+        ZR_ASSERT(pArray != NULL);                                             \
+        ZR_ASSERT(pArray->elementSize == sizeof(type));                        \
+                                                                               \
+        *ppElement = (type *)zrpConcurrentArrayGetElement(pArray,              \
+                                                          (size_t)index);      \
     }
-}
 
-ZRP_MAYBE_UNUSED static enum ZrStatus
-zrpDynamicArrayEnsureHasEnoughCapacity(void **ppBlock,
-                                       size_t currentCapacity,
-                                       size_t requestedCapacity,
-                                       size_t maxCapacity,
-                                       size_t elementSize)
-{
-    void *pBlock;
-    size_t newCapacity;
+#define ZRP_DYNAMICARRAY_DEFINE_INSERT_CONCURRENT_BACK_FUNCTION(name, type)    \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus                    \
+        zrInsert##name##Back(struct ZrConcurrentArray *pArray,                 \
+                             ZrSize size,                                      \
+                             const type *pValues)                              \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(pArray != NULL);                                             \
+        ZR_ASSERT(pArray->elementSize == sizeof(type));                        \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+                                                                               \
+        status = zrpConcurrentArrayAppend(pArray, (size_t)size, pValues);      \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to append to the concurrent array of type "  \
+                          "‘" #type "’ (requested size: %zu)\n",               \
+                          (size_t)size);                                       \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
 
-    ZR_ASSERT(ppBlock != NULL);
-    ZR_ASSERT(elementSize > 0);
+#define ZRP_DYNAMICARRAY_DEFINE_PUSH_CONCURRENT_BACK_FUNCTION(name, type)      \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus                    \
+        zrPush##name##Back(struct ZrConcurrentArray *pArray, type value)       \
+    {                                                                          \
+        return zrInsert##name##Back(pArray, 1, &value);                        \
+    }
 
-    if (requestedCapacity > maxCapacity) {
-        ZRP_LOG_TRACE("the requested capacity is too large\n");
-        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+#define ZRP_DYNAMICARRAY_DEFINE_CREATE_SLOT_MAP_FUNCTION(                      \
+    name, type, handle, indexBitCount)                                         \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrCreate##name(    \
+        struct ZrSlotMap **ppMap, ZrSize capacity)                             \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(ppMap != NULL);                                              \
+                                                                               \
+        status = zrpSlotMapCreate(ppMap,                                       \
+                                  (size_t)capacity,                            \
+                                  sizeof(type),                                \
+                                  sizeof(handle) * 8,                          \
+                                  indexBitCount);                              \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create a slot map of type ‘" #type "’ "   \
+                          "(requested capacity: %zu)\n",                       \
+                          (size_t)capacity);                                   \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
     }
 
-    if (*ppBlock != NULL && currentCapacity >= requestedCapacity) {
-        return ZR_SUCCESS;
+#define ZRP_DYNAMICARRAY_DEFINE_DESTROY_SLOT_MAP_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrDestroy##name(            \
+        struct ZrSlotMap *pMap)                                                \
+    {                                                                          \
+        if (pMap == NULL) {                                                    \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+        zrpSlotMapDestroy(pMap);                                               \
     }
 
-    zrpDynamicArrayGetNewCapacity(
-        &newCapacity, currentCapacity, requestedCapacity, maxCapacity);
-    ZR_ASSERT(newCapacity >= requestedCapacity);
-    ZR_ASSERT(newCapacity <= maxCapacity);
+#define ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_SIZE_FUNCTION(name, type)         \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Size(          \
+        ZrSize *pSize, const struct ZrSlotMap *pMap)                           \
+    {                                                                          \
+        ZR_ASSERT(pSize != NULL);                                              \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        *pSize = (ZrSize)ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size;   \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_ELEMENTS_FUNCTION(name, type)     \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Elements(      \
+        type **ppElements, const struct ZrSlotMap *pMap)                       \
+    {                                                                          \
+        ZR_ASSERT(ppElements != NULL);                                         \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        *ppElements = (type *)ZRP_DYNAMICARRAY_GET_BUFFER(pMap->pElements);    \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_ELEMENT_FUNCTION(                 \
+    name, type, handle)                                                        \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Element(       \
+        type **ppElement, const struct ZrSlotMap *pMap, handle h)              \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(ppElement != NULL);                                          \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        if (!zrpSlotMapResolve(&index, pMap, (ZrUint64)h)) {                   \
+            *ppElement = NULL;                                                 \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        *ppElement                                                             \
+            = &((type *)ZRP_DYNAMICARRAY_GET_BUFFER(pMap->pElements))[index];  \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_HANDLE_FUNCTION(                  \
+    name, type, handle)                                                        \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrGet##name##Handle(        \
+        handle *pHandle, const struct ZrSlotMap *pMap, ZrSize index)           \
+    {                                                                          \
+        ZR_ASSERT(pHandle != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+        ZR_ASSERT(index < ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size); \
+                                                                               \
+        *pHandle = (handle)zrpSlotMapGetHandle(pMap, (size_t)index);           \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_RESERVE_SLOT_MAP_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrReserve##name(   \
+        struct ZrSlotMap *pMap, ZrSize capacity)                               \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        status = zrpSlotMapReserve(pMap, (size_t)capacity);                    \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
+                          "type ‘" #type "’ (requested capacity: %zu)\n",      \
+                          (size_t)capacity);                                   \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_INSERT_SLOT_MAP_FUNCTION(name, type, handle)   \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrInsert##name(    \
+        handle *pHandle, struct ZrSlotMap *pMap, type value)                   \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        ZrUint64 fullHandle;                                                   \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pHandle != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        status = zrpSlotMapInsert(&fullHandle, &index, pMap);                  \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to insert into the slot map of type "        \
+                          "‘" #type "’\n");                                    \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        ((type *)ZRP_DYNAMICARRAY_GET_BUFFER(pMap->pElements))[index] = value; \
+        *pHandle = (handle)fullHandle;                                         \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_ERASE_SLOT_MAP_FUNCTION(name, type, handle)    \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrErase##name(              \
+        struct ZrSlotMap *pMap, handle h)                                      \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->elementSize == sizeof(type));                          \
+                                                                               \
+        if (zrpSlotMapResolve(&index, pMap, (ZrUint64)h)) {                    \
+            zrpSlotMapErase(pMap, index);                                      \
+        }                                                                      \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_SLOT_MAP_FUNCTIONS(                            \
+    name, type, handle, indexBitCount)                                         \
+    ZRP_DYNAMICARRAY_DEFINE_CREATE_SLOT_MAP_FUNCTION(                          \
+        name, type, handle, indexBitCount)                                     \
+    ZRP_DYNAMICARRAY_DEFINE_DESTROY_SLOT_MAP_FUNCTION(name, type)              \
+    ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_SIZE_FUNCTION(name, type)             \
+    ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_ELEMENTS_FUNCTION(name, type)         \
+    ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_ELEMENT_FUNCTION(name, type, handle)  \
+    ZRP_DYNAMICARRAY_DEFINE_GET_SLOT_MAP_HANDLE_FUNCTION(name, type, handle)   \
+    ZRP_DYNAMICARRAY_DEFINE_RESERVE_SLOT_MAP_FUNCTION(name, type)              \
+    ZRP_DYNAMICARRAY_DEFINE_INSERT_SLOT_MAP_FUNCTION(name, type, handle)       \
+    ZRP_DYNAMICARRAY_DEFINE_ERASE_SLOT_MAP_FUNCTION(name, type, handle)
+
+#define ZRP_DYNAMICARRAY_SET_NO_INDEX(pElement, index)                         \
+    ((void)(pElement), (void)(index))
+
+#define ZRP_DYNAMICARRAY_GET_PARENT(index) (((index)-1) / 4)
+#define ZRP_DYNAMICARRAY_GET_FIRST_CHILD(index) ((index)*4 + 1)
+
+#define ZRP_DYNAMICARRAY_DEFINE_SIFT_UP_FUNCTION(                              \
+    name, type, lessFn, setIndexFn)                                            \
+    ZRP_MAYBE_UNUSED static size_t zrpSift##name##Up(type *pQueue,             \
+                                                     size_t index)             \
+    {                                                                          \
+        type value;                                                            \
+        size_t parent;                                                         \
+                                                                               \
+        value = pQueue[index];                                                 \
+        while (index > 0) {                                                    \
+            parent = ZRP_DYNAMICARRAY_GET_PARENT(index);                       \
+            if (!lessFn(&value, &pQueue[parent])) {                            \
+                break;                                                         \
+            }                                                                  \
+                                                                               \
+            pQueue[index] = pQueue[parent];                                    \
+            setIndexFn(&pQueue[index], (ZrSize)index);                         \
+            index = parent;                                                    \
+        }                                                                      \
+                                                                               \
+        pQueue[index] = value;                                                 \
+        setIndexFn(&pQueue[index], (ZrSize)index);                             \
+        return index;                                                          \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_SIFT_DOWN_FUNCTION(                            \
+    name, type, lessFn, setIndexFn)                                            \
+    ZRP_MAYBE_UNUSED static void zrpSift##name##Down(                          \
+        type *pQueue, size_t size, size_t index)                               \
+    {                                                                          \
+        type value;                                                            \
+        size_t child;                                                          \
+        size_t last;                                                           \
+        size_t i;                                                              \
+                                                                               \
+        value = pQueue[index];                                                 \
+        for (;;) {                                                             \
+            child = ZRP_DYNAMICARRAY_GET_FIRST_CHILD(index);                   \
+            if (child >= size) {                                               \
+                break;                                                         \
+            }                                                                  \
+                                                                               \
+            last = size - child > 4 ? child + 4 : size;                        \
+            for (i = child + 1; i < last; ++i) {                               \
+                if (lessFn(&pQueue[i], &pQueue[child])) {                      \
+                    child = i;                                                 \
+                }                                                              \
+            }                                                                  \
+                                                                               \
+            if (!lessFn(&pQueue[child], &value)) {                             \
+                break;                                                         \
+            }                                                                  \
+                                                                               \
+            pQueue[index] = pQueue[child];                                     \
+            setIndexFn(&pQueue[index], (ZrSize)index);                         \
+            index = child;                                                     \
+        }                                                                      \
+                                                                               \
+        pQueue[index] = value;                                                 \
+        setIndexFn(&pQueue[index], (ZrSize)index);                             \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_ENQUEUE_FUNCTION(name, type)                   \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus zrEnqueue##name(   \
+        type **ppQueue, type value)                                            \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        size_t size;                                                           \
+                                                                               \
+        ZR_ASSERT(ppQueue != NULL);                                            \
+        ZR_ASSERT(*ppQueue != NULL);                                           \
+                                                                               \
+        status = zrPush##name##Back(ppQueue, value);                           \
+        if (status != ZR_SUCCESS) {                                            \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        size = ZRP_DYNAMICARRAY_GET_HEADER(                                    \
+                   ZRP_DYNAMICARRAY_GET_BLOCK(*ppQueue))                       \
+                   ->size;                                                     \
+        zrpSift##name##Up(*ppQueue, size - 1);                                 \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_DEQUEUE_FUNCTION(name, type)                   \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE int zrDequeue##name(             \
+        type *pValue, type *pQueue)                                            \
+    {                                                                          \
+        size_t size;                                                           \
+                                                                               \
+        ZR_ASSERT(pValue != NULL);                                             \
+        ZR_ASSERT(pQueue != NULL);                                             \
+                                                                               \
+        size = ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pQueue)) \
+                   ->size;                                                     \
+        if (size == 0) {                                                       \
+            return 0;                                                          \
+        }                                                                      \
+                                                                               \
+        zrRemove##name(pValue, pQueue, 0);                                     \
+        return 1;                                                              \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_PEEK_FUNCTION(name, type)                      \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE int zrPeek##name(                \
+        type *pValue, const type *pQueue)                                      \
+    {                                                                          \
+        ZR_ASSERT(pValue != NULL);                                             \
+        ZR_ASSERT(pQueue != NULL);                                             \
+                                                                               \
+        if (ZRP_DYNAMICARRAY_GET_CONST_HEADER(                                 \
+                ZRP_DYNAMICARRAY_GET_CONST_BLOCK(pQueue))                      \
+                ->size                                                         \
+            == 0) {                                                            \
+            return 0;                                                          \
+        }                                                                      \
+                                                                               \
+        *pValue = pQueue[0];                                                   \
+        return 1;                                                              \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_HEAPIFY_FUNCTION(name, type, setIndexFn)       \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrHeapify##name(            \
+        type *pQueue)                                                          \
+    {                                                                          \
+        size_t size;                                                           \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pQueue != NULL);                                             \
+                                                                               \
+        size = ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pQueue)) \
+                   ->size;                                                     \
+        for (i = 0; i < size; ++i) {                                           \
+            setIndexFn(&pQueue[i], (ZrSize)i);                                 \
+        }                                                                      \
+                                                                               \
+        if (size < 2) {                                                        \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        i = ZRP_DYNAMICARRAY_GET_PARENT(size - 1) + 1;                         \
+        while (i-- > 0) {                                                      \
+            zrpSift##name##Down(pQueue, size, i);                              \
+        }                                                                      \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_UPDATE_FUNCTION(name, type)                    \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrUpdate##name(             \
+        type *pQueue, ZrSize index)                                            \
+    {                                                                          \
+        size_t size;                                                           \
+                                                                               \
+        ZR_ASSERT(pQueue != NULL);                                             \
+                                                                               \
+        size = ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pQueue)) \
+                   ->size;                                                     \
+        ZR_ASSERT((size_t)index < size);                                       \
+                                                                               \
+        if (zrpSift##name##Up(pQueue, (size_t)index) == (size_t)index) {       \
+            zrpSift##name##Down(pQueue, size, (size_t)index);                  \
+        }                                                                      \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_REMOVE_FUNCTION(name, type)                    \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zrRemove##name(             \
+        type *pValue, type *pQueue, ZrSize index)                              \
+    {                                                                          \
+        size_t size;                                                           \
+                                                                               \
+        ZR_ASSERT(pValue != NULL);                                             \
+        ZR_ASSERT(pQueue != NULL);                                             \
+                                                                               \
+        size = ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pQueue)) \
+                   ->size;                                                     \
+        ZR_ASSERT((size_t)index < size);                                       \
+                                                                               \
+        *pValue = pQueue[index];                                               \
+        --size;                                                                \
+        ZRP_DYNAMICARRAY_GET_HEADER(ZRP_DYNAMICARRAY_GET_BLOCK(pQueue))->size  \
+            = size;                                                            \
+        if ((size_t)index == size) {                                           \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        pQueue[index] = pQueue[size];                                          \
+        zrUpdate##name(pQueue, index);                                         \
+    }
+
+#define ZRP_DYNAMICARRAY_DEFINE_PRIORITY_QUEUE_FUNCTIONS(                      \
+    name, type, lessFn, setIndexFn)                                            \
+    ZRP_DYNAMICARRAY_DEFINE_SIFT_UP_FUNCTION(name, type, lessFn, setIndexFn)   \
+    ZRP_DYNAMICARRAY_DEFINE_SIFT_DOWN_FUNCTION(name, type, lessFn, setIndexFn) \
+    ZRP_DYNAMICARRAY_DEFINE_ENQUEUE_FUNCTION(name, type)                       \
+    ZRP_DYNAMICARRAY_DEFINE_PEEK_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_HEAPIFY_FUNCTION(name, type, setIndexFn)           \
+    ZRP_DYNAMICARRAY_DEFINE_UPDATE_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_REMOVE_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_DEQUEUE_FUNCTION(name, type)
+
+#define ZRP_DYNAMICARRAY_DEFINE_COMMON_FUNCTIONS(name, type)                   \
+    ZRP_DYNAMICARRAY_DEFINE_SAVE_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_VIEW_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_GET_SIZE_FUNCTION(name, type)                      \
+    ZRP_DYNAMICARRAY_DEFINE_GET_CAPACITY_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_DEFINE_GET_MAX_CAPACITY_FUNCTION(name, type)              \
+    ZRP_DYNAMICARRAY_DEFINE_RESIZE_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_RESERVE_FUNCTION(name, type)                       \
+    ZRP_DYNAMICARRAY_DEFINE_EXTEND_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_EXTEND_FRONT_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_DEFINE_EXTEND_BACK_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_DEFINE_INSERT_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_INSERT_FRONT_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_DEFINE_INSERT_BACK_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_DEFINE_PUSH_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_PUSH_FRONT_FUNCTION(name, type)                    \
+    ZRP_DYNAMICARRAY_DEFINE_PUSH_BACK_FUNCTION(name, type)                     \
+    ZRP_DYNAMICARRAY_DEFINE_TRIM_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_TRIM_FRONT_FUNCTION(name, type)                    \
+    ZRP_DYNAMICARRAY_DEFINE_TRIM_BACK_FUNCTION(name, type)
+
+#undef ZR_MAKE_DYNAMIC_ARRAY
+#define ZR_MAKE_DYNAMIC_ARRAY(name, type)                                      \
+    ZRP_DYNAMICARRAY_DEFINE_MAX_CAPACITY(name, type)                           \
+    ZRP_DYNAMICARRAY_DEFINE_ENSURE_CAPACITY_FUNCTION(name, type)               \
+    ZRP_DYNAMICARRAY_DEFINE_CREATE_FUNCTION(name, type)                        \
+    ZRP_DYNAMICARRAY_DEFINE_DESTROY_FUNCTION(name, type)                       \
+    ZRP_DYNAMICARRAY_DEFINE_LOAD_FUNCTION(name, type)                          \
+    ZRP_DYNAMICARRAY_DEFINE_COMMON_FUNCTIONS(name, type)
+
+#undef ZR_MAKE_MAPPED_DYNAMIC_ARRAY
+#define ZR_MAKE_MAPPED_DYNAMIC_ARRAY(name, type)                               \
+    ZRP_DYNAMICARRAY_DEFINE_MAPPED_MAX_CAPACITY(name, type)                    \
+    ZRP_DYNAMICARRAY_DEFINE_ENSURE_MAPPED_CAPACITY_FUNCTION(name, type)        \
+    ZRP_DYNAMICARRAY_DEFINE_CREATE_MAPPED_FUNCTION(name, type)                 \
+    ZRP_DYNAMICARRAY_DEFINE_OPEN_MAPPED_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_DEFINE_CLOSE_MAPPED_FUNCTION(name, type)                  \
+    ZRP_DYNAMICARRAY_DEFINE_SYNC_MAPPED_FUNCTION(name, type)                   \
+    ZRP_DYNAMICARRAY_DEFINE_COMMON_FUNCTIONS(name, type)
+
+#undef ZR_MAKE_CONCURRENT_DYNAMIC_ARRAY
+#define ZR_MAKE_CONCURRENT_DYNAMIC_ARRAY(name, type)                           \
+    ZRP_DYNAMICARRAY_DEFINE_CREATE_CONCURRENT_FUNCTION(name, type)             \
+    ZRP_DYNAMICARRAY_DEFINE_DESTROY_CONCURRENT_FUNCTION(name, type)            \
+    ZRP_DYNAMICARRAY_DEFINE_GET_CONCURRENT_SIZE_FUNCTION(name, type)           \
+    ZRP_DYNAMICARRAY_DEFINE_GET_CONCURRENT_ELEMENT_FUNCTION(name, type)        \
+    ZRP_DYNAMICARRAY_DEFINE_INSERT_CONCURRENT_BACK_FUNCTION(name, type)        \
+    ZRP_DYNAMICARRAY_DEFINE_PUSH_CONCURRENT_BACK_FUNCTION(name, type)
+
+#undef ZR_MAKE_SLOT_MAP
+#define ZR_MAKE_SLOT_MAP(name, type)                                           \
+    ZRP_DYNAMICARRAY_DEFINE_SLOT_MAP_FUNCTIONS(name, type, ZrUint64, 32)
+
+#undef ZR_MAKE_COMPACT_SLOT_MAP
+#define ZR_MAKE_COMPACT_SLOT_MAP(name, type)                                   \
+    ZRP_DYNAMICARRAY_DEFINE_SLOT_MAP_FUNCTIONS(name, type, ZrUint32, 20)
+
+#undef ZR_MAKE_PRIORITY_QUEUE
+#define ZR_MAKE_PRIORITY_QUEUE(name, type, lessFn)                             \
+    ZR_MAKE_DYNAMIC_ARRAY(name, type)                                          \
+    ZRP_DYNAMICARRAY_DEFINE_PRIORITY_QUEUE_FUNCTIONS(                          \
+        name, type, lessFn, ZRP_DYNAMICARRAY_SET_NO_INDEX)
+
+#undef ZR_MAKE_INDEXED_PRIORITY_QUEUE
+#define ZR_MAKE_INDEXED_PRIORITY_QUEUE(name, type, lessFn, setIndexFn)         \
+    ZR_MAKE_DYNAMIC_ARRAY(name, type)                                          \
+    ZRP_DYNAMICARRAY_DEFINE_PRIORITY_QUEUE_FUNCTIONS(                          \
+        name, type, lessFn, setIndexFn)
+
+struct ZrpDynamicArrayHeader {
+    size_t size;
+    size_t capacity;
+};
+
+ZRP_MAYBE_UNUSED static void
+zrpDynamicArrayGetNewCapacity(size_t *pNewCapacity,
+                              size_t current,
+                              size_t requested,
+                              size_t max)
+{
+    *pNewCapacity = current + current / 2 + 1;
+    if (*pNewCapacity < current || *pNewCapacity > max) {
+        *pNewCapacity = max;
+        return;
+    }
+
+    if (*pNewCapacity < requested) {
+        *pNewCapacity = requested;
+    }
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayEnsureHasEnoughCapacity(void **ppBlock,
+                                       size_t currentCapacity,
+                                       size_t requestedCapacity,
+                                       size_t maxCapacity,
+                                       size_t elementSize)
+{
+    void *pBlock;
+    size_t newCapacity;
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (requestedCapacity > maxCapacity) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    if (*ppBlock != NULL && currentCapacity >= requestedCapacity) {
+        return ZR_SUCCESS;
+    }
+
+    zrpDynamicArrayGetNewCapacity(
+        &newCapacity, currentCapacity, requestedCapacity, maxCapacity);
+    ZR_ASSERT(newCapacity >= requestedCapacity);
+    ZR_ASSERT(newCapacity <= maxCapacity);
 
     pBlock = ZR_REALLOC(
         *ppBlock,
@@ -555,5 +1513,2020 @@ zrpDynamicArrayEnsureHasEnoughCapacity(void **ppBlock,
     return ZR_SUCCESS;
 }
 
+/*
+   Mapped arrays prefix the regular block with an extra header describing the
+   file. The array pointer returned to the user is thus still preceded by the
+   regular header, allowing all the functions that don't need to reallocate
+   the block to be shared with the regular arrays.
+
+     reservation         mapping         block    user pointer
+      /                   /               /        /
+     +-----------+-------+---------------+--------+--------------------
+     | (unused)  | state | mapped header | header | elements...
+     +-----------+-------+---------------+--------+--------------------
+     \__ private page __/\__ file _____________________________________
+
+   The state, such as the file descriptor, is only meaningful for the running
+   process. It is kept in a page reserved right before the mapping of the file
+   but mapped privately, so that opening a file never modifies it.
+
+   Growing the file relies on `mremap()` when available, which glibc only
+   declares if `_GNU_SOURCE` is defined, otherwise the file is mapped anew.
+*/
+
+#define ZRP_DYNAMICARRAY_MAPPED_MAGIC "ZRDYNARR"
+#define ZRP_DYNAMICARRAY_MAPPED_VERSION 1
+
+#define ZRP_DYNAMICARRAY_GET_MAPPED_HEADER(pBlock)                             \
+    (&((struct ZrpDynamicArrayMappedHeader *)(pBlock))[-1])
+#define ZRP_DYNAMICARRAY_GET_CONST_MAPPED_HEADER(pBlock)                       \
+    (&((const struct ZrpDynamicArrayMappedHeader *)(pBlock))[-1])
+#define ZRP_DYNAMICARRAY_GET_MAPPED_BLOCK(pMapping)                            \
+    ((void *)&((struct ZrpDynamicArrayMappedHeader *)(pMapping))[1])
+#define ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)                            \
+    (&((struct ZrpDynamicArrayMappedState *)(pMapping))[-1])
+
+#if defined(MREMAP_MAYMOVE) && defined(MREMAP_FIXED)
+#define ZRP_DYNAMICARRAY_USE_MREMAP
+#endif
+
+struct ZrpDynamicArrayMappedHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t elementSize;
+    uint64_t mappingSize;
+    unsigned char padding[64 - 32 - sizeof(struct ZrpDynamicArrayHeader)];
+};
+
+struct ZrpDynamicArrayMappedState {
+    size_t pageSize;
+    int fileDescriptor;
+};
+
+typedef char zrp_dynamicarray_invalid_mapped_header_size
+    [sizeof(struct ZrpDynamicArrayMappedHeader)
+                 + sizeof(struct ZrpDynamicArrayHeader)
+             == 64
+         ? 1
+         : -1];
+
+#if ZRP_DYNAMICARRAY_POSIX
+static enum ZrStatus
+zrpDynamicArrayGetPageSize(size_t *pPageSize)
+{
+    long pageSize;
+
+    pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) {
+        ZRP_LOG_TRACE("failed to retrieve the page size\n");
+        return ZR_ERROR;
+    }
+
+    *pPageSize = (size_t)pageSize;
+    return ZR_SUCCESS;
+}
+
+static enum ZrStatus
+zrpDynamicArrayGetMappingSize(size_t *pMappingSize,
+                              size_t *pCapacity,
+                              size_t requestedCapacity,
+                              size_t maxCapacity,
+                              size_t elementSize,
+                              size_t pageSize)
+{
+
+    *pMappingSize = sizeof(struct ZrpDynamicArrayMappedHeader)
+                    + sizeof(struct ZrpDynamicArrayHeader)
+                    + elementSize * requestedCapacity;
+
+    /*
+       Round up to the page size and make use of the extra space, if any,
+       while leaving room for the page reserved before the mapping.
+    */
+    if (*pMappingSize > (size_t)-1 - pageSize * 2) {
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    *pMappingSize = (*pMappingSize + pageSize - 1) / pageSize * pageSize;
+    *pCapacity = (*pMappingSize - sizeof(struct ZrpDynamicArrayMappedHeader)
+                  - sizeof(struct ZrpDynamicArrayHeader))
+                 / elementSize;
+    if (*pCapacity > maxCapacity) {
+        *pCapacity = maxCapacity;
+    }
+
+    return ZR_SUCCESS;
+}
+
+/*
+   Reserve the address range for a mapping preceded by a page for its state.
+   The reservation maps the file privately and without any access, which
+   doesn't count towards the memory committed by the process, and it is then
+   mostly covered by the shared mapping of the file.
+*/
+static enum ZrStatus
+zrpDynamicArrayReserveMapping(void **ppReservation,
+                              int fileDescriptor,
+                              size_t mappingSize,
+                              size_t pageSize)
+{
+    void *pReservation;
+
+    pReservation = mmap(NULL,
+                        pageSize + mappingSize,
+                        PROT_NONE,
+                        MAP_PRIVATE,
+                        fileDescriptor,
+                        0);
+    if (pReservation == MAP_FAILED) {
+        ZRP_LOG_TRACE("failed to reserve the mapping\n");
+        return ZR_ERROR;
+    }
+
+    if (mprotect(pReservation, pageSize, PROT_READ | PROT_WRITE) != 0) {
+        ZRP_LOG_TRACE("failed to make the state page writable\n");
+        munmap(pReservation, pageSize + mappingSize);
+        return ZR_ERROR;
+    }
+
+    *ppReservation = pReservation;
+    return ZR_SUCCESS;
+}
+
+static enum ZrStatus
+zrpDynamicArrayMapFile(void **ppMapping,
+                       int fileDescriptor,
+                       size_t mappingSize,
+                       size_t pageSize)
+{
+    void *pReservation;
+    void *pMapping;
+
+    if (zrpDynamicArrayReserveMapping(
+            &pReservation, fileDescriptor, mappingSize, pageSize)
+        != ZR_SUCCESS) {
+        return ZR_ERROR;
+    }
+
+    pMapping = mmap((char *)pReservation + pageSize,
+                    mappingSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED,
+                    fileDescriptor,
+                    0);
+    if (pMapping == MAP_FAILED) {
+        ZRP_LOG_TRACE("failed to map the file\n");
+        munmap(pReservation, pageSize + mappingSize);
+        return ZR_ERROR;
+    }
+
+    ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)->pageSize = pageSize;
+    ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)->fileDescriptor
+        = fileDescriptor;
+    *ppMapping = pMapping;
+    return ZR_SUCCESS;
+}
+
+static void
+zrpDynamicArrayUnmapFile(void *pMapping, size_t mappingSize)
+{
+    size_t pageSize;
+
+    pageSize = ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)->pageSize;
+    munmap((char *)pMapping - pageSize, pageSize + mappingSize);
+}
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayCreateMapped(void **ppBlock,
+                            const char *pPath,
+                            size_t capacity,
+                            size_t maxCapacity,
+                            size_t elementSize)
+{
+#if ZRP_DYNAMICARRAY_POSIX
+    enum ZrStatus status;
+    int fileDescriptor;
+    void *pMapping;
+    size_t pageSize;
+    size_t mappingSize;
+    struct ZrpDynamicArrayMappedHeader *pMappedHeader;
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(pPath != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (capacity > maxCapacity) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    if (zrpDynamicArrayGetPageSize(&pageSize) != ZR_SUCCESS) {
+        return ZR_ERROR;
+    }
+
+    status = zrpDynamicArrayGetMappingSize(&mappingSize,
+                                           &capacity,
+                                           capacity,
+                                           maxCapacity,
+                                           elementSize,
+                                           pageSize);
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_TRACE("failed to compute the size of the mapping\n");
+        return status;
+    }
+
+    fileDescriptor = open(pPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor == -1) {
+        ZRP_LOG_TRACE("failed to open the file\n");
+        return ZR_ERROR;
+    }
+
+    if (ftruncate(fileDescriptor, (off_t)mappingSize) != 0) {
+        ZRP_LOG_TRACE("failed to resize the file\n");
+        close(fileDescriptor);
+        return ZR_ERROR;
+    }
+
+    if (zrpDynamicArrayMapFile(&pMapping, fileDescriptor, mappingSize, pageSize)
+        != ZR_SUCCESS) {
+        close(fileDescriptor);
+        return ZR_ERROR;
+    }
+
+    pMappedHeader = (struct ZrpDynamicArrayMappedHeader *)pMapping;
+    memcpy(pMappedHeader->magic,
+           ZRP_DYNAMICARRAY_MAPPED_MAGIC,
+           sizeof pMappedHeader->magic);
+    pMappedHeader->version = ZRP_DYNAMICARRAY_MAPPED_VERSION;
+    pMappedHeader->headerSize = (uint32_t)sizeof(struct ZrpDynamicArrayHeader);
+    pMappedHeader->elementSize = (uint64_t)elementSize;
+    pMappedHeader->mappingSize = (uint64_t)mappingSize;
+
+    *ppBlock = ZRP_DYNAMICARRAY_GET_MAPPED_BLOCK(pMapping);
+    ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->size = 0;
+    ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity = capacity;
+    return ZR_SUCCESS;
+#else
+    (void)ppBlock;
+    (void)pPath;
+    (void)capacity;
+    (void)maxCapacity;
+    (void)elementSize;
+    ZRP_LOG_TRACE("platform not supported\n");
+    return ZR_ERROR;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayOpenMapped(void **ppBlock,
+                          const char *pPath,
+                          size_t maxCapacity,
+                          size_t elementSize)
+{
+#if ZRP_DYNAMICARRAY_POSIX
+    int fileDescriptor;
+    struct stat info;
+    struct ZrpDynamicArrayMappedHeader mappedHeader;
+    size_t pageSize;
+    size_t mappingSize;
+    void *pMapping;
+    struct ZrpDynamicArrayMappedHeader *pMappedHeader;
+    struct ZrpDynamicArrayHeader *pHeader;
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(pPath != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (zrpDynamicArrayGetPageSize(&pageSize) != ZR_SUCCESS) {
+        return ZR_ERROR;
+    }
+
+    fileDescriptor = open(pPath, O_RDWR);
+    if (fileDescriptor == -1) {
+        ZRP_LOG_TRACE("failed to open the file\n");
+        return ZR_ERROR;
+    }
+
+    if (fstat(fileDescriptor, &info) != 0) {
+        ZRP_LOG_TRACE("failed to retrieve the size of the file\n");
+        goto error;
+    }
+
+    if (read(fileDescriptor, &mappedHeader, sizeof mappedHeader)
+        != (ssize_t)sizeof mappedHeader) {
+        ZRP_LOG_TRACE("failed to read the header of the file\n");
+        goto error;
+    }
+
+    /*
+       Only the size recorded in the header is mapped, the file may be larger
+       if it was being grown when the process stopped.
+    */
+    mappingSize = (size_t)mappedHeader.mappingSize;
+    if ((uint64_t)mappingSize != mappedHeader.mappingSize
+        || mappingSize < sizeof(struct ZrpDynamicArrayMappedHeader)
+                             + sizeof(struct ZrpDynamicArrayHeader)
+        || mappingSize > (size_t)-1 - pageSize || info.st_size < 0
+        || (uint64_t)info.st_size < mappedHeader.mappingSize) {
+        ZRP_LOG_TRACE("the file has an invalid size\n");
+        goto error;
+    }
+
+    if (zrpDynamicArrayMapFile(&pMapping, fileDescriptor, mappingSize, pageSize)
+        != ZR_SUCCESS) {
+        goto error;
+    }
+
+    pMappedHeader = (struct ZrpDynamicArrayMappedHeader *)pMapping;
+    pHeader = ZRP_DYNAMICARRAY_GET_HEADER(
+        ZRP_DYNAMICARRAY_GET_MAPPED_BLOCK(pMapping));
+    if (memcmp(pMappedHeader->magic,
+               ZRP_DYNAMICARRAY_MAPPED_MAGIC,
+               sizeof pMappedHeader->magic)
+            != 0
+        || pMappedHeader->version != ZRP_DYNAMICARRAY_MAPPED_VERSION
+        || pMappedHeader->headerSize != sizeof(struct ZrpDynamicArrayHeader)
+        || pMappedHeader->elementSize != (uint64_t)elementSize
+        || pHeader->capacity > maxCapacity || pHeader->size > pHeader->capacity
+        || pHeader->capacity
+               > (mappingSize - sizeof(struct ZrpDynamicArrayMappedHeader)
+                  - sizeof(struct ZrpDynamicArrayHeader))
+                     / elementSize) {
+        ZRP_LOG_TRACE("the file doesn't contain a compatible array\n");
+        zrpDynamicArrayUnmapFile(pMapping, mappingSize);
+        goto error;
+    }
+
+    *ppBlock = ZRP_DYNAMICARRAY_GET_MAPPED_BLOCK(pMapping);
+    return ZR_SUCCESS;
+
+error:
+    close(fileDescriptor);
+    return ZR_ERROR;
+#else
+    (void)ppBlock;
+    (void)pPath;
+    (void)maxCapacity;
+    (void)elementSize;
+    ZRP_LOG_TRACE("platform not supported\n");
+    return ZR_ERROR;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpDynamicArrayCloseMapped(void *pBlock)
+{
+#if ZRP_DYNAMICARRAY_POSIX
+    struct ZrpDynamicArrayMappedHeader *pMappedHeader;
+    int fileDescriptor;
+
+    ZR_ASSERT(pBlock != NULL);
+
+    pMappedHeader = ZRP_DYNAMICARRAY_GET_MAPPED_HEADER(pBlock);
+    fileDescriptor
+        = ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMappedHeader)->fileDescriptor;
+    zrpDynamicArrayUnmapFile(pMappedHeader,
+                             (size_t)pMappedHeader->mappingSize);
+    close(fileDescriptor);
+#else
+    (void)pBlock;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArraySyncMapped(const void *pBlock)
+{
+#if ZRP_DYNAMICARRAY_POSIX
+    const struct ZrpDynamicArrayMappedHeader *pMappedHeader;
+
+    ZR_ASSERT(pBlock != NULL);
+
+    pMappedHeader = ZRP_DYNAMICARRAY_GET_CONST_MAPPED_HEADER(pBlock);
+    if (msync((void *)(uintptr_t)pMappedHeader,
+              (size_t)pMappedHeader->mappingSize,
+              MS_SYNC)
+        != 0) {
+        ZRP_LOG_ERROR("failed to synchronize the mapped file\n");
+        return ZR_ERROR;
+    }
+
+    return ZR_SUCCESS;
+#else
+    (void)pBlock;
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayEnsureMappedHasEnoughCapacity(void **ppBlock,
+                                             size_t requestedCapacity,
+                                             size_t maxCapacity,
+                                             size_t elementSize)
+{
+#if ZRP_DYNAMICARRAY_POSIX
+    enum ZrStatus status;
+    struct ZrpDynamicArrayMappedHeader *pMappedHeader;
+    int fileDescriptor;
+    size_t pageSize;
+    size_t currentMappingSize;
+    size_t mappingSize;
+    size_t newCapacity;
+    void *pReservation;
+    void *pMapping;
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(*ppBlock != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (requestedCapacity > maxCapacity) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    if (ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity >= requestedCapacity) {
+        return ZR_SUCCESS;
+    }
+
+    zrpDynamicArrayGetNewCapacity(
+        &newCapacity,
+        ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity,
+        requestedCapacity,
+        maxCapacity);
+    ZR_ASSERT(newCapacity >= requestedCapacity);
+    ZR_ASSERT(newCapacity <= maxCapacity);
+
+    pMappedHeader = ZRP_DYNAMICARRAY_GET_MAPPED_HEADER(*ppBlock);
+    pageSize = ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMappedHeader)->pageSize;
+    fileDescriptor
+        = ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMappedHeader)->fileDescriptor;
+    currentMappingSize = (size_t)pMappedHeader->mappingSize;
+
+    status = zrpDynamicArrayGetMappingSize(&mappingSize,
+                                           &newCapacity,
+                                           newCapacity,
+                                           maxCapacity,
+                                           elementSize,
+                                           pageSize);
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_TRACE("failed to compute the size of the mapping\n");
+        return status;
+    }
+
+    /*
+       The header keeps the previous mapping size until the new mapping is in
+       place, so a file left larger by a failure or a crash can still be opened.
+    */
+    if (ftruncate(fileDescriptor, (off_t)mappingSize) != 0) {
+        ZRP_LOG_TRACE("failed to resize the file\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    if (zrpDynamicArrayReserveMapping(
+            &pReservation, fileDescriptor, mappingSize, pageSize)
+        != ZR_SUCCESS) {
+        goto error;
+    }
+
+#if defined(ZRP_DYNAMICARRAY_USE_MREMAP)
+    /* Move the pages already mapped instead of faulting them in again. */
+    pMapping = mremap((void *)pMappedHeader,
+                      currentMappingSize,
+                      mappingSize,
+                      MREMAP_MAYMOVE | MREMAP_FIXED,
+                      (char *)pReservation + pageSize);
+    if (pMapping == MAP_FAILED) {
+        ZRP_LOG_TRACE("failed to remap the file\n");
+        munmap(pReservation, pageSize + mappingSize);
+        goto error;
+    }
+
+    munmap((char *)pMappedHeader - pageSize, pageSize);
+#else
+    /* The mapping is shared so its content is already backed by the file. */
+    pMapping = mmap((char *)pReservation + pageSize,
+                    mappingSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED,
+                    fileDescriptor,
+                    0);
+    if (pMapping == MAP_FAILED) {
+        ZRP_LOG_TRACE("failed to map the file\n");
+        munmap(pReservation, pageSize + mappingSize);
+        goto error;
+    }
+
+    zrpDynamicArrayUnmapFile(pMappedHeader, currentMappingSize);
+#endif /* ZRP_DYNAMICARRAY_USE_MREMAP */
+
+    ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)->pageSize = pageSize;
+    ZRP_DYNAMICARRAY_GET_MAPPED_STATE(pMapping)->fileDescriptor
+        = fileDescriptor;
+    ((struct ZrpDynamicArrayMappedHeader *)pMapping)->mappingSize
+        = (uint64_t)mappingSize;
+    *ppBlock = ZRP_DYNAMICARRAY_GET_MAPPED_BLOCK(pMapping);
+    ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity = newCapacity;
+    return ZR_SUCCESS;
+
+error:
+    if (ftruncate(fileDescriptor, (off_t)currentMappingSize) != 0) {
+        ZRP_LOG_TRACE("failed to restore the size of the file\n");
+    }
+
+    return ZR_ERROR_ALLOCATION;
+#else
+    (void)ppBlock;
+    (void)requestedCapacity;
+    (void)maxCapacity;
+    (void)elementSize;
+    ZRP_LOG_TRACE("platform not supported\n");
+    return ZR_ERROR;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+/*
+   Snapshot files start with a header describing the content, followed by
+   a copy of the block where the capacity is set to the size of the array.
+
+     snapshot            block            user pointer
+      /                   /                   /
+     +-----------------+--------+--------------------
+     | snapshot header | header | elements...
+     +-----------------+--------+--------------------
+
+   Elements are stored as-is, so the endianness tag is only used to detect
+   snapshots coming from incompatible platforms rather than to convert them.
+*/
+
+#define ZRP_DYNAMICARRAY_SNAPSHOT_MAGIC "ZRDASNAP"
+#define ZRP_DYNAMICARRAY_SNAPSHOT_VERSION 1
+#define ZRP_DYNAMICARRAY_SNAPSHOT_ENDIANNESS 0x01020304ul
+
+/* Maximum number of bytes transferred by a single `read()` or `write()`. */
+#define ZRP_DYNAMICARRAY_MAX_IO_SIZE ((size_t)1 << 30)
+
+struct ZrpDynamicArraySnapshotHeader {
+    char magic[8];
+    uint32_t endianness;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t reserved;
+    uint64_t elementSize;
+    uint64_t checksum;
+    unsigned char padding[64 - 40 - sizeof(struct ZrpDynamicArrayHeader)];
+};
+
+typedef char zrp_dynamicarray_invalid_snapshot_header_size
+    [sizeof(struct ZrpDynamicArraySnapshotHeader)
+                 + sizeof(struct ZrpDynamicArrayHeader)
+             == 64
+         ? 1
+         : -1];
+
+/*
+   The checksum processes 8 bytes at a time through 4 independent lanes to
+   keep up with the memory bandwidth, and isn't meant to be cryptographically
+   secure.
+*/
+ZRP_MAYBE_UNUSED static uint64_t
+zrpDynamicArrayComputeChecksum(const void *pData, size_t size)
+{
+    const unsigned char *pBytes;
+    uint64_t lanes[4];
+    uint64_t word;
+    uint64_t out;
+    size_t i;
+
+    pBytes = (const unsigned char *)pData;
+    lanes[0] = 0x9e3779b97f4a7c15ull;
+    lanes[1] = 0xc2b2ae3d27d4eb4full;
+    lanes[2] = 0x165667b19e3779f9ull;
+    lanes[3] = 0x85ebca77c2b2ae63ull;
+
+    for (; size >= 32; size -= 32, pBytes += 32) {
+        for (i = 0; i < 4; ++i) {
+            memcpy(&word, &pBytes[i * 8], 8);
+            lanes[i] = (lanes[i] ^ word) * 0x100000001b3ull;
+            lanes[i] ^= lanes[i] >> 29;
+        }
+    }
+
+    out = lanes[0] ^ (lanes[1] << 1) ^ (lanes[2] << 2) ^ (lanes[3] << 3);
+    for (; size > 0; --size, ++pBytes) {
+        out = (out ^ *pBytes) * 0x100000001b3ull;
+    }
+
+    out ^= out >> 33;
+    out *= 0xff51afd7ed558ccdull;
+    out ^= out >> 33;
+    return out;
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpDynamicArrayIsSnapshotCompatible(
+    const struct ZrpDynamicArraySnapshotHeader *pSnapshotHeader,
+    const struct ZrpDynamicArrayHeader *pHeader,
+    size_t elementSize)
+{
+    return memcmp(pSnapshotHeader->magic,
+                  ZRP_DYNAMICARRAY_SNAPSHOT_MAGIC,
+                  sizeof pSnapshotHeader->magic)
+               == 0
+           && pSnapshotHeader->endianness
+                  == ZRP_DYNAMICARRAY_SNAPSHOT_ENDIANNESS
+           && pSnapshotHeader->version == ZRP_DYNAMICARRAY_SNAPSHOT_VERSION
+           && pSnapshotHeader->headerSize
+                  == sizeof(struct ZrpDynamicArrayHeader)
+           && pSnapshotHeader->elementSize == (uint64_t)elementSize
+           && pHeader->capacity == pHeader->size;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayView(const void **ppBlock,
+                    const void *pBuffer,
+                    size_t bufferSize,
+                    size_t elementSize)
+{
+    const void *pBlock;
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(pBuffer != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (bufferSize < sizeof(struct ZrpDynamicArraySnapshotHeader)
+                         + sizeof(struct ZrpDynamicArrayHeader)) {
+        ZRP_LOG_TRACE("the buffer is too small\n");
+        return ZR_ERROR;
+    }
+
+    pBlock = (const void *)&(
+        (const struct ZrpDynamicArraySnapshotHeader *)pBuffer)[1];
+    if (!zrpDynamicArrayIsSnapshotCompatible(
+            (const struct ZrpDynamicArraySnapshotHeader *)pBuffer,
+            ZRP_DYNAMICARRAY_GET_CONST_HEADER(pBlock),
+            elementSize)
+        || ZRP_DYNAMICARRAY_GET_CONST_HEADER(pBlock)->size
+               > (bufferSize - sizeof(struct ZrpDynamicArraySnapshotHeader)
+                  - sizeof(struct ZrpDynamicArrayHeader))
+                     / elementSize) {
+        ZRP_LOG_TRACE("the buffer doesn't contain a compatible array\n");
+        return ZR_ERROR;
+    }
+
+    *ppBlock = pBlock;
+    return ZR_SUCCESS;
+}
+
+#if ZRP_DYNAMICARRAY_POSIX
+/*
+   Read or write the given vectors, resuming after partial transfers. Their
+   total size must not exceed `ZRP_DYNAMICARRAY_MAX_IO_SIZE`.
+*/
+static enum ZrStatus
+zrpDynamicArrayTransfer(int fileDescriptor,
+                        struct iovec *pVectors,
+                        int count,
+                        int write)
+{
+    ssize_t transferred;
+
+    transferred = 0;
+    for (;;) {
+        while (count > 0 && (size_t)transferred >= pVectors->iov_len) {
+            transferred -= (ssize_t)pVectors->iov_len;
+            ++pVectors;
+            --count;
+        }
+
+        if (count == 0) {
+            return ZR_SUCCESS;
+        }
+
+        pVectors->iov_base = (char *)pVectors->iov_base + transferred;
+        pVectors->iov_len -= (size_t)transferred;
+        transferred = write ? writev(fileDescriptor, pVectors, count)
+                            : readv(fileDescriptor, pVectors, count);
+        if (transferred < 0 || (!write && transferred == 0)) {
+            ZRP_LOG_TRACE(write ? "failed to write into the file\n"
+                                : "failed to read the file\n");
+            return ZR_ERROR;
+        }
+    }
+}
+
+/*
+   Transfer the given vectors, the last of which may be larger than
+   `ZRP_DYNAMICARRAY_MAX_IO_SIZE` and is then split across further calls.
+*/
+static enum ZrStatus
+zrpDynamicArrayTransferAll(int fileDescriptor,
+                           struct iovec *pVectors,
+                           int count,
+                           int write)
+{
+    enum ZrStatus status;
+    char *pData;
+    size_t size;
+    size_t chunkSize;
+
+    pData = (char *)pVectors[count - 1].iov_base;
+    size = pVectors[count - 1].iov_len;
+    chunkSize = size < ZRP_DYNAMICARRAY_MAX_IO_SIZE
+                    ? size
+                    : ZRP_DYNAMICARRAY_MAX_IO_SIZE;
+    pVectors[count - 1].iov_len = chunkSize;
+    status = zrpDynamicArrayTransfer(fileDescriptor, pVectors, count, write);
+    while (status == ZR_SUCCESS && size > chunkSize) {
+        pData += chunkSize;
+        size -= chunkSize;
+        chunkSize = size < ZRP_DYNAMICARRAY_MAX_IO_SIZE
+                        ? size
+                        : ZRP_DYNAMICARRAY_MAX_IO_SIZE;
+        pVectors[0].iov_base = pData;
+        pVectors[0].iov_len = chunkSize;
+        status = zrpDynamicArrayTransfer(fileDescriptor, pVectors, 1, write);
+    }
+
+    return status;
+}
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArraySave(const void *pBlock, const char *pPath, size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrpDynamicArraySnapshotHeader snapshotHeader;
+    struct ZrpDynamicArrayHeader header;
+    const void *pElements;
+    size_t elementsSize;
+
+    ZR_ASSERT(pBlock != NULL);
+    ZR_ASSERT(pPath != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    header.size = ZRP_DYNAMICARRAY_GET_CONST_HEADER(pBlock)->size;
+    header.capacity = header.size;
+    pElements = ZRP_DYNAMICARRAY_GET_CONST_BUFFER(pBlock);
+    elementsSize = elementSize * header.size;
+
+    memset(&snapshotHeader, 0, sizeof snapshotHeader);
+    memcpy(snapshotHeader.magic,
+           ZRP_DYNAMICARRAY_SNAPSHOT_MAGIC,
+           sizeof snapshotHeader.magic);
+    snapshotHeader.endianness = ZRP_DYNAMICARRAY_SNAPSHOT_ENDIANNESS;
+    snapshotHeader.version = ZRP_DYNAMICARRAY_SNAPSHOT_VERSION;
+    snapshotHeader.headerSize = (uint32_t)sizeof header;
+    snapshotHeader.elementSize = (uint64_t)elementSize;
+    snapshotHeader.checksum
+        = zrpDynamicArrayComputeChecksum(pElements, elementsSize);
+
+#if ZRP_DYNAMICARRAY_POSIX
+    {
+        int fileDescriptor;
+        struct iovec vectors[3];
+
+        fileDescriptor = open(pPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fileDescriptor == -1) {
+            ZRP_LOG_TRACE("failed to open the file\n");
+            return ZR_ERROR;
+        }
+
+        vectors[0].iov_base = (void *)&snapshotHeader;
+        vectors[0].iov_len = sizeof snapshotHeader;
+        vectors[1].iov_base = (void *)&header;
+        vectors[1].iov_len = sizeof header;
+        vectors[2].iov_base = (void *)(uintptr_t)pElements;
+        vectors[2].iov_len = elementsSize;
+        status = zrpDynamicArrayTransferAll(fileDescriptor, vectors, 3, 1);
+
+        if (close(fileDescriptor) != 0 && status == ZR_SUCCESS) {
+            ZRP_LOG_TRACE("failed to close the file\n");
+            status = ZR_ERROR;
+        }
+
+        return status;
+    }
+#else
+    {
+        FILE *pFile;
+
+        pFile = fopen(pPath, "wb");
+        if (pFile == NULL) {
+            ZRP_LOG_TRACE("failed to open the file\n");
+            return ZR_ERROR;
+        }
+
+        status = ZR_SUCCESS;
+        if (fwrite(&snapshotHeader, sizeof snapshotHeader, 1, pFile) != 1
+            || fwrite(&header, sizeof header, 1, pFile) != 1
+            || fwrite(pElements, 1, elementsSize, pFile) != elementsSize) {
+            ZRP_LOG_TRACE("failed to write into the file\n");
+            status = ZR_ERROR;
+        }
+
+        if (fclose(pFile) != 0 && status == ZR_SUCCESS) {
+            ZRP_LOG_TRACE("failed to close the file\n");
+            status = ZR_ERROR;
+        }
+
+        return status;
+    }
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayLoad(void **ppBlock,
+                    const char *pPath,
+                    size_t maxCapacity,
+                    size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrpDynamicArraySnapshotHeader snapshotHeader;
+    size_t headersSize;
+    size_t fileSize;
+    size_t elementsSize;
+    size_t size;
+    void *pBlock;
+#if ZRP_DYNAMICARRAY_POSIX
+    int fileDescriptor;
+    struct stat info;
+    struct iovec vectors[2];
+#else
+    FILE *pFile;
+    long position;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+
+    ZR_ASSERT(ppBlock != NULL);
+    ZR_ASSERT(pPath != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    /*
+       The size of the file gives the number of elements ahead of reading the
+       headers, so that everything can be read directly into the block.
+    */
+#if ZRP_DYNAMICARRAY_POSIX
+    fileDescriptor = open(pPath, O_RDONLY);
+    if (fileDescriptor == -1) {
+        ZRP_LOG_TRACE("failed to open the file\n");
+        return ZR_ERROR;
+    }
+
+    if (fstat(fileDescriptor, &info) != 0 || info.st_size < 0) {
+        ZRP_LOG_TRACE("failed to retrieve the size of the file\n");
+        status = ZR_ERROR;
+        goto exit;
+    }
+
+    fileSize = (size_t)info.st_size;
+#else
+    pFile = fopen(pPath, "rb");
+    if (pFile == NULL) {
+        ZRP_LOG_TRACE("failed to open the file\n");
+        return ZR_ERROR;
+    }
+
+    if (fseek(pFile, 0, SEEK_END) != 0 || (position = ftell(pFile)) < 0
+        || fseek(pFile, 0, SEEK_SET) != 0) {
+        ZRP_LOG_TRACE("failed to retrieve the size of the file\n");
+        status = ZR_ERROR;
+        goto exit;
+    }
+
+    fileSize = (size_t)position;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+    headersSize = sizeof snapshotHeader + sizeof(struct ZrpDynamicArrayHeader);
+    if (fileSize < headersSize) {
+        ZRP_LOG_TRACE("the file doesn't contain a compatible array\n");
+        status = ZR_ERROR;
+        goto exit;
+    }
+
+    elementsSize = fileSize - headersSize;
+    size = elementsSize / elementSize;
+    if (elementsSize % elementSize != 0 || size > maxCapacity) {
+        ZRP_LOG_TRACE("the file doesn't contain a compatible array\n");
+        status = ZR_ERROR;
+        goto exit;
+    }
+
+    pBlock = ZR_REALLOC(NULL,
+                        sizeof(struct ZrpDynamicArrayHeader) + elementsSize);
+    if (pBlock == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the block\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto exit;
+    }
+
+#if ZRP_DYNAMICARRAY_POSIX
+    vectors[0].iov_base = (void *)&snapshotHeader;
+    vectors[0].iov_len = sizeof snapshotHeader;
+    vectors[1].iov_base = pBlock;
+    vectors[1].iov_len = sizeof(struct ZrpDynamicArrayHeader) + elementsSize;
+    status = zrpDynamicArrayTransferAll(fileDescriptor, vectors, 2, 0);
+#else
+    status = fread(&snapshotHeader, sizeof snapshotHeader, 1, pFile) == 1
+                     && fread(pBlock,
+                              1,
+                              sizeof(struct ZrpDynamicArrayHeader)
+                                  + elementsSize,
+                              pFile)
+                            == sizeof(struct ZrpDynamicArrayHeader)
+                                   + elementsSize
+                 ? ZR_SUCCESS
+                 : ZR_ERROR;
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_TRACE("failed to read the array\n");
+        goto block_undo;
+    }
+
+    if (!zrpDynamicArrayIsSnapshotCompatible(
+            &snapshotHeader, ZRP_DYNAMICARRAY_GET_HEADER(pBlock), elementSize)
+        || ZRP_DYNAMICARRAY_GET_HEADER(pBlock)->size != size) {
+        ZRP_LOG_TRACE("the file doesn't contain a compatible array\n");
+        status = ZR_ERROR;
+        goto block_undo;
+    }
+
+    if (zrpDynamicArrayComputeChecksum(ZRP_DYNAMICARRAY_GET_BUFFER(pBlock),
+                                       elementsSize)
+        != snapshotHeader.checksum) {
+        ZRP_LOG_TRACE("the checksum doesn't match\n");
+        status = ZR_ERROR;
+        goto block_undo;
+    }
+
+    *ppBlock = pBlock;
+    goto exit;
+
+block_undo:
+    ZR_FREE(pBlock);
+
+exit:
+#if ZRP_DYNAMICARRAY_POSIX
+    close(fileDescriptor);
+#else
+    fclose(pFile);
+#endif /* ZRP_DYNAMICARRAY_POSIX */
+    return status;
+}
+
+/*
+   Concurrent arrays reserve slots by atomically incrementing the reserved
+   size, then copy the values into the reserved slots, and finally publish
+   them by advancing the committed size. Publishing happens in the order of
+   the reservations so that the committed size always delimits a prefix of
+   fully written elements, at the cost of writers waiting for the writers
+   having reserved slots before them to be done.
+
+   The slots are stored in a directory of segments where the segment `k` holds
+   `2^(k + shift)` elements, with the directory never being reallocated. If
+   a segment fails to be allocated, the array stops accepting new elements
+   but the elements already committed remain readable. Appends exceeding the
+   maximum size are rejected without reserving any slot.
+*/
+
+#define ZRP_DYNAMICARRAY_CONCURRENT_SHIFT 6
+#define ZRP_DYNAMICARRAY_CONCURRENT_SEGMENT_COUNT                              \
+    (ZR_ENVIRONMENT - ZRP_DYNAMICARRAY_CONCURRENT_SHIFT)
+#define ZRP_DYNAMICARRAY_CONCURRENT_SPIN_COUNT 1024
+
+struct ZrConcurrentArray {
+    volatile size_t reservedSize;
+    unsigned char reservedSizePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+    volatile size_t committedSize;
+    unsigned char committedSizePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+    volatile size_t failed;
+    size_t elementSize;
+    size_t maxSize;
+    void *volatile pSegments[ZRP_DYNAMICARRAY_CONCURRENT_SEGMENT_COUNT];
+};
+
+ZRP_MAYBE_UNUSED static size_t
+zrpDynamicArrayGetFloorLog2(size_t x)
+{
+    ZR_ASSERT(x > 0);
+
+#if defined(__GNUC__)
+    return sizeof(unsigned long long) * 8 - 1
+           - (size_t)__builtin_clzll((unsigned long long)x);
+#else
+    {
+        size_t out;
+
+        out = 0;
+        while (x >>= 1) {
+            ++out;
+        }
+
+        return out;
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConcurrentArrayLocate(size_t *pSegment, size_t *pOffset, size_t index)
+{
+    size_t biased;
+
+    biased = (index >> ZRP_DYNAMICARRAY_CONCURRENT_SHIFT) + 1;
+    *pSegment = zrpDynamicArrayGetFloorLog2(biased);
+    *pOffset = index
+               - (((size_t)1 << *pSegment) - 1)
+                     * ((size_t)1 << ZRP_DYNAMICARRAY_CONCURRENT_SHIFT);
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpConcurrentArrayGetSegmentCapacity(size_t segment)
+{
+    return (size_t)1 << (segment + ZRP_DYNAMICARRAY_CONCURRENT_SHIFT);
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpConcurrentArrayCreate(struct ZrConcurrentArray **ppArray,
+                         size_t elementSize)
+{
+    struct ZrConcurrentArray *pArray;
+    size_t i;
+
+    ZR_ASSERT(ppArray != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    pArray = (struct ZrConcurrentArray *)ZR_REALLOC(NULL, sizeof *pArray);
+    if (pArray == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the array\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pArray->reservedSize = 0;
+    pArray->committedSize = 0;
+    pArray->failed = 0;
+    pArray->elementSize = elementSize;
+    for (i = 0; i < ZRP_DYNAMICARRAY_CONCURRENT_SEGMENT_COUNT; ++i) {
+        pArray->pSegments[i] = NULL;
+    }
+
+    /* Keep the sizes and the byte offsets within a segment representable. */
+    pArray->maxSize
+        = (((size_t)1 << (ZRP_DYNAMICARRAY_CONCURRENT_SEGMENT_COUNT - 1)) - 1)
+          * ((size_t)1 << ZRP_DYNAMICARRAY_CONCURRENT_SHIFT);
+    if (pArray->maxSize / 2 > (size_t)-1 / elementSize) {
+        pArray->maxSize = (size_t)-1 / elementSize * 2;
+    }
+
+    *ppArray = pArray;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConcurrentArrayDestroy(struct ZrConcurrentArray *pArray)
+{
+    size_t i;
+
+    ZR_ASSERT(pArray != NULL);
+
+    for (i = 0; i < ZRP_DYNAMICARRAY_CONCURRENT_SEGMENT_COUNT; ++i) {
+        ZR_FREE(pArray->pSegments[i]);
+    }
+
+    ZR_FREE(pArray);
+}
+
+ZRP_MAYBE_UNUSED static void *
+zrpConcurrentArrayGetElement(const struct ZrConcurrentArray *pArray,
+                             size_t index)
+{
+    size_t segment;
+    size_t offset;
+    unsigned char *pSegment;
+
+    ZR_ASSERT(pArray != NULL);
+    ZR_ASSERT(index < zrpAtomicLoadSizeRelaxed(&pArray->reservedSize));
+
+    zrpConcurrentArrayLocate(&segment, &offset, index);
+    pSegment = (unsigned char *)zrpAtomicLoadPointerAcquire(
+        &pArray->pSegments[segment]);
+    ZR_ASSERT(pSegment != NULL);
+    return (void *)&pSegment[offset * pArray->elementSize];
+}
+
+static enum ZrStatus
+zrpConcurrentArrayEnsureHasSegment(struct ZrConcurrentArray *pArray,
+                                   size_t segment)
+{
+    void *pSegment;
+
+    if (zrpAtomicLoadPointerAcquire(&pArray->pSegments[segment]) != NULL) {
+        return ZR_SUCCESS;
+    }
+
+    pSegment = ZR_REALLOC(NULL,
+                          pArray->elementSize
+                              * zrpConcurrentArrayGetSegmentCapacity(segment));
+    if (pSegment == NULL) {
+        ZRP_LOG_TRACE("failed to allocate a segment\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    if (!zrpAtomicCompareExchangePointer(
+            &pArray->pSegments[segment], NULL, pSegment)) {
+        /* Another thread installed the segment first. */
+        ZR_FREE(pSegment);
+    }
+
+    return ZR_SUCCESS;
+}
+
+static void
+zrpConcurrentArrayCopy(struct ZrConcurrentArray *pArray,
+                       size_t index,
+                       size_t size,
+                       const void *pValues)
+{
+    const unsigned char *pBytes;
+    size_t segment;
+    size_t offset;
+    size_t count;
+
+    pBytes = (const unsigned char *)pValues;
+    zrpConcurrentArrayLocate(&segment, &offset, index);
+    while (size > 0) {
+        count = zrpConcurrentArrayGetSegmentCapacity(segment) - offset;
+        if (count > size) {
+            count = size;
+        }
+
+        memcpy((unsigned char *)pArray->pSegments[segment]
+                   + offset * pArray->elementSize,
+               pBytes,
+               count * pArray->elementSize);
+        pBytes += count * pArray->elementSize;
+        size -= count;
+        offset = 0;
+        ++segment;
+    }
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpConcurrentArrayAppend(struct ZrConcurrentArray *pArray,
+                         size_t size,
+                         const void *pValues)
+{
+    enum ZrStatus status;
+    size_t index;
+    size_t first;
+    size_t last;
+    size_t segment;
+    size_t offset;
+    size_t spinCount;
+
+    ZR_ASSERT(pArray != NULL);
+
+    if (size == 0) {
+        return ZR_SUCCESS;
+    }
+
+    if (zrpAtomicLoadSizeRelaxed(&pArray->failed)) {
+        ZRP_LOG_TRACE("the array is in a failed state\n");
+        return ZR_ERROR;
+    }
+
+    /* Check the size before reserving anything to leave the array usable. */
+    do {
+        index = zrpAtomicLoadSizeRelaxed(&pArray->reservedSize);
+        if (size > pArray->maxSize - index) {
+            ZRP_LOG_TRACE("the requested size is too large\n");
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;
+        }
+    } while (!zrpAtomicCompareExchangeSizeRelaxed(
+        &pArray->reservedSize, index, index + size));
+
+    zrpConcurrentArrayLocate(&first, &offset, index);
+    zrpConcurrentArrayLocate(&last, &offset, index + size - 1);
+    for (segment = first; segment <= last; ++segment) {
+        status = zrpConcurrentArrayEnsureHasSegment(pArray, segment);
+        if (status != ZR_SUCCESS) {
+            goto error;
+        }
+    }
+
+    zrpConcurrentArrayCopy(pArray, index, size, pValues);
+
+    /* Wait for the previous writers to publish their elements. */
+    spinCount = 0;
+    while (zrpAtomicLoadSizeAcquire(&pArray->committedSize) != index) {
+        if (zrpAtomicLoadSizeRelaxed(&pArray->failed)) {
+            ZRP_LOG_TRACE("a previous writer failed\n");
+            return ZR_ERROR;
+        }
+
+        if (++spinCount < ZRP_DYNAMICARRAY_CONCURRENT_SPIN_COUNT) {
+            zrpAtomicPause();
+        } else {
+            zrpThreadYield();
+        }
+    }
+
+    zrpAtomicStoreSizeRelease(&pArray->committedSize, index + size);
+    return ZR_SUCCESS;
+
+error:
+    /* The slots can't be given back, stop accepting new elements. */
+    zrpAtomicStoreSizeRelease(&pArray->failed, 1);
+    return status;
+}
+
+/*
+   Slot maps are made of three regular blocks: the elements, kept packed, the
+   slots that handles refer to, and, for each element, the index of the slot
+   pointing to it. Erasing an element moves the last one in its place and
+   updates the slot of the moved element accordingly.
+
+   Handles pack the index of a slot in their lowest bits and its generation in
+   the remaining ones. The generation of a slot is incremented each time it is
+   either filled or freed, making it odd while the slot is in use, so that
+   handles to erased elements are never resolved. Freed slots are chained into
+   a free list through their index, unless their generation is exhausted, in
+   which case they are retired for good.
+*/
+
+#define ZRP_DYNAMICARRAY_SLOT_MAP_NO_SLOT ((ZrUint32)-1)
+
+struct ZrpDynamicArraySlot {
+    ZrUint32 index;
+    ZrUint32 generation;
+};
+
+struct ZrSlotMap {
+    void *pElements;
+    void *pElementSlots;
+    void *pSlots;
+    size_t elementSize;
+    size_t maxSize;
+    ZrUint32 freeSlot;
+    ZrUint32 maxGeneration;
+    unsigned int indexBitCount;
+};
+
+#define ZRP_DYNAMICARRAY_GET_SLOTS(pMap)                                       \
+    ((struct ZrpDynamicArraySlot *)ZRP_DYNAMICARRAY_GET_BUFFER((pMap)->pSlots))
+#define ZRP_DYNAMICARRAY_GET_ELEMENT_SLOTS(pMap)                               \
+    ((ZrUint32 *)ZRP_DYNAMICARRAY_GET_BUFFER((pMap)->pElementSlots))
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpDynamicArrayEnsureBlockHasEnoughCapacity(void **ppBlock,
+                                            size_t requestedCapacity,
+                                            size_t maxCapacity,
+                                            size_t elementSize)
+{
+    enum ZrStatus status;
+    int isNew;
+
+    isNew = *ppBlock == NULL;
+    status = zrpDynamicArrayEnsureHasEnoughCapacity(
+        ppBlock,
+        isNew ? 0 : ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->capacity,
+        requestedCapacity,
+        maxCapacity,
+        elementSize);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    if (isNew) {
+        ZRP_DYNAMICARRAY_GET_HEADER(*ppBlock)->size = 0;
+    }
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpSlotMapReserve(struct ZrSlotMap *pMap, size_t capacity)
+{
+    enum ZrStatus status;
+
+    ZR_ASSERT(pMap != NULL);
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pMap->pElements, capacity, pMap->maxSize, pMap->elementSize);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pMap->pElementSlots, capacity, pMap->maxSize, sizeof(ZrUint32));
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    return zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pMap->pSlots,
+        capacity,
+        pMap->maxSize,
+        sizeof(struct ZrpDynamicArraySlot));
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpSlotMapDestroy(struct ZrSlotMap *pMap)
+{
+    ZR_ASSERT(pMap != NULL);
+
+    ZR_FREE(pMap->pElements);
+    ZR_FREE(pMap->pElementSlots);
+    ZR_FREE(pMap->pSlots);
+    ZR_FREE(pMap);
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpSlotMapCreate(struct ZrSlotMap **ppMap,
+                 size_t capacity,
+                 size_t elementSize,
+                 unsigned int handleBitCount,
+                 unsigned int indexBitCount)
+{
+    enum ZrStatus status;
+    struct ZrSlotMap *pMap;
+    size_t maxSize;
+
+    ZR_ASSERT(ppMap != NULL);
+    ZR_ASSERT(elementSize > 0);
+    ZR_ASSERT(indexBitCount <= 32);
+    ZR_ASSERT(handleBitCount - indexBitCount <= 32);
+
+    pMap = (struct ZrSlotMap *)ZR_REALLOC(NULL, sizeof *pMap);
+    if (pMap == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the slot map\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    /* The largest slot index is reserved to mark the end of the free list. */
+    maxSize = (size_t)-1 - sizeof(struct ZrpDynamicArrayHeader);
+    maxSize /= elementSize > sizeof(struct ZrpDynamicArraySlot)
+                   ? elementSize
+                   : sizeof(struct ZrpDynamicArraySlot);
+    if ((ZrUint64)maxSize > ((ZrUint64)1 << indexBitCount) - 1) {
+        maxSize = (size_t)(((ZrUint64)1 << indexBitCount) - 1);
+    }
+
+    pMap->pElements = NULL;
+    pMap->pElementSlots = NULL;
+    pMap->pSlots = NULL;
+    pMap->elementSize = elementSize;
+    pMap->maxSize = maxSize;
+    pMap->freeSlot = ZRP_DYNAMICARRAY_SLOT_MAP_NO_SLOT;
+    pMap->maxGeneration = (ZrUint32)(
+        ((ZrUint64)1 << (handleBitCount - indexBitCount)) - 1);
+    pMap->indexBitCount = indexBitCount;
+
+    status = zrpSlotMapReserve(pMap, capacity);
+    if (status != ZR_SUCCESS) {
+        zrpSlotMapDestroy(pMap);
+        return status;
+    }
+
+    *ppMap = pMap;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpSlotMapResolve(size_t *pIndex,
+                  const struct ZrSlotMap *pMap,
+                  ZrUint64 handle)
+{
+    const struct ZrpDynamicArraySlot *pSlot;
+    size_t slot;
+    ZrUint64 generation;
+
+    ZR_ASSERT(pIndex != NULL);
+    ZR_ASSERT(pMap != NULL);
+
+    slot = (size_t)(handle & (((ZrUint64)1 << pMap->indexBitCount) - 1));
+    generation = handle >> pMap->indexBitCount;
+    if (slot >= ZRP_DYNAMICARRAY_GET_HEADER(pMap->pSlots)->size) {
+        return 0;
+    }
+
+    pSlot = &ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[slot];
+    if (!(pSlot->generation & 1) || pSlot->generation != generation) {
+        return 0;
+    }
+
+    *pIndex = (size_t)pSlot->index;
+    return 1;
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpSlotMapGetHandle(const struct ZrSlotMap *pMap, size_t index)
+{
+    ZrUint32 slot;
+
+    ZR_ASSERT(pMap != NULL);
+
+    slot = ZRP_DYNAMICARRAY_GET_ELEMENT_SLOTS(pMap)[index];
+    return ((ZrUint64)ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[slot].generation
+            << pMap->indexBitCount)
+           | slot;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpSlotMapInsert(ZrUint64 *pHandle, size_t *pIndex, struct ZrSlotMap *pMap)
+{
+    enum ZrStatus status;
+    struct ZrpDynamicArraySlot *pSlot;
+    size_t size;
+    size_t slotCount;
+    ZrUint32 slot;
+
+    ZR_ASSERT(pHandle != NULL);
+    ZR_ASSERT(pIndex != NULL);
+    ZR_ASSERT(pMap != NULL);
+
+    size = ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size;
+    if (size >= pMap->maxSize) {
+        ZRP_LOG_TRACE("the slot map is full\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pMap->pElements, size + 1, pMap->maxSize, pMap->elementSize);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pMap->pElementSlots, size + 1, pMap->maxSize, sizeof(ZrUint32));
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    if (pMap->freeSlot == ZRP_DYNAMICARRAY_SLOT_MAP_NO_SLOT) {
+        slotCount = ZRP_DYNAMICARRAY_GET_HEADER(pMap->pSlots)->size;
+        if (slotCount >= pMap->maxSize) {
+            ZRP_LOG_TRACE("all the slots have been retired\n");
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;
+        }
+
+        status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+            &pMap->pSlots,
+            slotCount + 1,
+            pMap->maxSize,
+            sizeof(struct ZrpDynamicArraySlot));
+        if (status != ZR_SUCCESS) {
+            return status;
+        }
+
+        slot = (ZrUint32)slotCount;
+        pSlot = &ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[slot];
+        pSlot->generation = 0;
+        ++ZRP_DYNAMICARRAY_GET_HEADER(pMap->pSlots)->size;
+    } else {
+        slot = pMap->freeSlot;
+        pSlot = &ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[slot];
+        pMap->freeSlot = pSlot->index;
+    }
+
+    ++pSlot->generation;
+    pSlot->index = (ZrUint32)size;
+    ZRP_DYNAMICARRAY_GET_ELEMENT_SLOTS(pMap)[size] = slot;
+    ++ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size;
+    ++ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElementSlots)->size;
+
+    *pHandle = ((ZrUint64)pSlot->generation << pMap->indexBitCount) | slot;
+    *pIndex = size;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpSlotMapErase(struct ZrSlotMap *pMap, size_t index)
+{
+    unsigned char *pElements;
+    ZrUint32 *pElementSlots;
+    struct ZrpDynamicArraySlot *pSlot;
+    size_t last;
+    ZrUint32 slot;
+
+    ZR_ASSERT(pMap != NULL);
+
+    pElements = (unsigned char *)ZRP_DYNAMICARRAY_GET_BUFFER(pMap->pElements);
+    pElementSlots = ZRP_DYNAMICARRAY_GET_ELEMENT_SLOTS(pMap);
+    last = ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size - 1;
+    slot = pElementSlots[index];
+
+    if (index != last) {
+        memcpy(&pElements[index * pMap->elementSize],
+               &pElements[last * pMap->elementSize],
+               pMap->elementSize);
+        pElementSlots[index] = pElementSlots[last];
+        ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[pElementSlots[index]].index
+            = (ZrUint32)index;
+    }
+
+    --ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElements)->size;
+    --ZRP_DYNAMICARRAY_GET_HEADER(pMap->pElementSlots)->size;
+
+    pSlot = &ZRP_DYNAMICARRAY_GET_SLOTS(pMap)[slot];
+    ++pSlot->generation;
+    if (pSlot->generation < pMap->maxGeneration - 1) {
+        pSlot->index = pMap->freeSlot;
+        pMap->freeSlot = slot;
+    }
+}
+
+/*
+   Bit sets store their bits in a regular block of 64-bit words, with the bits
+   past the size in the last word always kept cleared.
+
+   Indexing them builds a block of cumulative counts of the set bits found
+   before each group of 8 words, used for ranking, as well as a block sampling
+   which group holds every 4096th set bit, which narrows down the binary
+   search over the counts when selecting.
+*/
+
+#define ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT 8
+#define ZRP_DYNAMICARRAY_BIT_SET_SELECT_SAMPLE_RATE 4096
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)                  \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZRP_DYNAMICARRAY_USE_SSE2 1
+#else
+#define ZRP_DYNAMICARRAY_USE_SSE2 0
+#endif
+
+#define ZRP_DYNAMICARRAY_GET_WORDS(pBitSet)                                    \
+    ((ZrUint64 *)ZRP_DYNAMICARRAY_GET_BUFFER((pBitSet)->pWords))
+#define ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet)                               \
+    ZRP_DYNAMICARRAY_GET_HEADER((pBitSet)->pWords)->size
+#define ZRP_DYNAMICARRAY_GET_RANKS(pBitSet)                                    \
+    ((size_t *)ZRP_DYNAMICARRAY_GET_BUFFER((pBitSet)->pRanks))
+#define ZRP_DYNAMICARRAY_GET_SELECTS(pBitSet)                                  \
+    ((size_t *)ZRP_DYNAMICARRAY_GET_BUFFER((pBitSet)->pSelects))
+
+struct ZrBitSet {
+    void *pWords;
+    void *pRanks;
+    void *pSelects;
+    size_t size;
+    int indexed;
+};
+
+static const size_t zrpMaxBitSetWordCount
+    = ((size_t)-1 - sizeof(struct ZrpDynamicArrayHeader)) / sizeof(ZrUint64);
+
+ZRP_MAYBE_UNUSED static size_t
+zrpBitSetGetWordCount(size_t size)
+{
+    return size / 64 + (size % 64 != 0);
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrCreateBitSet(struct ZrBitSet **ppBitSet, ZrSize size)
+{
+    enum ZrStatus status;
+    struct ZrBitSet *pBitSet;
+
+    ZR_ASSERT(ppBitSet != NULL);
+
+    pBitSet = (struct ZrBitSet *)ZR_REALLOC(NULL, sizeof *pBitSet);
+    if (pBitSet == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the bit set\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pBitSet->pWords = NULL;
+    pBitSet->pRanks = NULL;
+    pBitSet->pSelects = NULL;
+    pBitSet->size = 0;
+    pBitSet->indexed = 0;
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pBitSet->pWords, 0, zrpMaxBitSetWordCount, sizeof(ZrUint64));
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("failed to allocate the bit set\n");
+        ZR_FREE(pBitSet);
+        return status;
+    }
+
+    status = zrResizeBitSet(pBitSet, size);
+    if (status != ZR_SUCCESS) {
+        zrDestroyBitSet(pBitSet);
+        return status;
+    }
+
+    *ppBitSet = pBitSet;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrDestroyBitSet(struct ZrBitSet *pBitSet)
+{
+    if (pBitSet == NULL) {
+        return;
+    }
+
+    ZR_FREE(pBitSet->pWords);
+    ZR_FREE(pBitSet->pRanks);
+    ZR_FREE(pBitSet->pSelects);
+    ZR_FREE(pBitSet);
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrGetBitSetSize(ZrSize *pSize, const struct ZrBitSet *pBitSet)
+{
+    ZR_ASSERT(pSize != NULL);
+    ZR_ASSERT(pBitSet != NULL);
+
+    *pSize = (ZrSize)pBitSet->size;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrResizeBitSet(struct ZrBitSet *pBitSet, ZrSize size)
+{
+    enum ZrStatus status;
+    ZrUint64 *pWords;
+    size_t previousCount;
+    size_t count;
+
+    ZR_ASSERT(pBitSet != NULL);
+
+    previousCount = ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet);
+    count = zrpBitSetGetWordCount((size_t)size);
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pBitSet->pWords, count, zrpMaxBitSetWordCount, sizeof(ZrUint64));
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("failed to reserve a large enough capacity for the "
+                      "bit set (requested size: %zu)\n",
+                      (size_t)size);
+        return status;
+    }
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    if (count > previousCount) {
+        memset(&pWords[previousCount],
+               0,
+               sizeof *pWords * (count - previousCount));
+    }
+
+    if ((size_t)size % 64 != 0) {
+        pWords[count - 1] &= ((ZrUint64)1 << ((size_t)size % 64)) - 1;
+    }
+
+    ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet) = count;
+    pBitSet->size = (size_t)size;
+    pBitSet->indexed = 0;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrSetBit(struct ZrBitSet *pBitSet, ZrSize position)
+{
+    ZR_ASSERT(pBitSet != NULL);
+    ZR_ASSERT((size_t)position < pBitSet->size);
+
+    ZRP_DYNAMICARRAY_GET_WORDS(pBitSet)[(size_t)position / 64]
+        |= (ZrUint64)1 << ((size_t)position % 64);
+    pBitSet->indexed = 0;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrClearBit(struct ZrBitSet *pBitSet, ZrSize position)
+{
+    ZR_ASSERT(pBitSet != NULL);
+    ZR_ASSERT((size_t)position < pBitSet->size);
+
+    ZRP_DYNAMICARRAY_GET_WORDS(pBitSet)[(size_t)position / 64]
+        &= ~((ZrUint64)1 << ((size_t)position % 64));
+    pBitSet->indexed = 0;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE int
+zrTestBit(const struct ZrBitSet *pBitSet, ZrSize position)
+{
+    ZR_ASSERT(pBitSet != NULL);
+    ZR_ASSERT((size_t)position < pBitSet->size);
+
+    return (int)((ZRP_DYNAMICARRAY_GET_WORDS(pBitSet)[(size_t)position / 64]
+                  >> ((size_t)position % 64))
+                 & 1);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpBitSetFill(struct ZrBitSet *pBitSet,
+              size_t position,
+              size_t size,
+              int value)
+{
+    ZrUint64 *pWords;
+    size_t first;
+    size_t last;
+    ZrUint64 firstMask;
+    ZrUint64 lastMask;
+
+    if (position >= pBitSet->size || size == 0) {
+        return;
+    }
+
+    if (size > pBitSet->size - position) {
+        size = pBitSet->size - position;
+    }
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    first = position / 64;
+    last = (position + size - 1) / 64;
+    firstMask = ~(ZrUint64)0 << (position % 64);
+    lastMask = ~(ZrUint64)0 >> (63 - (position + size - 1) % 64);
+
+    if (first == last) {
+        firstMask &= lastMask;
+    } else {
+        memset(&pWords[first + 1],
+               value ? 0xFF : 0x00,
+               sizeof *pWords * (last - first - 1));
+        pWords[last] = value ? pWords[last] | lastMask
+                             : pWords[last] & ~lastMask;
+    }
+
+    pWords[first] = value ? pWords[first] | firstMask
+                          : pWords[first] & ~firstMask;
+    pBitSet->indexed = 0;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrSetBits(struct ZrBitSet *pBitSet, ZrSize position, ZrSize size)
+{
+    ZR_ASSERT(pBitSet != NULL);
+
+    zrpBitSetFill(pBitSet, (size_t)position, (size_t)size, 1);
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrClearBits(struct ZrBitSet *pBitSet, ZrSize position, ZrSize size)
+{
+    ZR_ASSERT(pBitSet != NULL);
+
+    zrpBitSetFill(pBitSet, (size_t)position, (size_t)size, 0);
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrCountBits(ZrSize *pCount, const struct ZrBitSet *pBitSet)
+{
+    const ZrUint64 *pWords;
+    size_t count;
+    size_t i;
+    size_t out;
+
+    ZR_ASSERT(pCount != NULL);
+    ZR_ASSERT(pBitSet != NULL);
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    count = ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet);
+    out = 0;
+    for (i = 0; i < count; ++i) {
+        out += zrpBitsCountOnes(pWords[i]);
+    }
+
+    *pCount = (ZrSize)out;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE int
+zrFindNextBit(ZrSize *pPosition,
+              const struct ZrBitSet *pBitSet,
+              ZrSize position)
+{
+    const ZrUint64 *pWords;
+    size_t count;
+    size_t i;
+    ZrUint64 word;
+
+    ZR_ASSERT(pPosition != NULL);
+    ZR_ASSERT(pBitSet != NULL);
+
+    if ((size_t)position >= pBitSet->size) {
+        return 0;
+    }
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    count = ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet);
+    i = (size_t)position / 64;
+    word = pWords[i] & (~(ZrUint64)0 << ((size_t)position % 64));
+    while (word == 0) {
+        if (++i == count) {
+            return 0;
+        }
+
+        word = pWords[i];
+    }
+
+    *pPosition = (ZrSize)(i * 64 + zrpBitsCountTrailingZeros(word));
+    return 1;
+}
+
+#if ZRP_DYNAMICARRAY_USE_SSE2
+#define ZRP_DYNAMICARRAY_COMBINE_WIDE(pWords, pOtherWords, i, count, function) \
+    for (; (i) + 2 <= (count); (i) += 2) {                                     \
+        _mm_storeu_si128(                                                      \
+            (__m128i *)(void *)&(pWords)[i],                                   \
+            function(                                                          \
+                _mm_loadu_si128((const __m128i *)(const void *)&(pWords)[i]),  \
+                _mm_loadu_si128(                                               \
+                    (const __m128i *)(const void *)&(pOtherWords)[i])));       \
+    }
+#else
+#define ZRP_DYNAMICARRAY_COMBINE_WIDE(pWords, pOtherWords, i, count, function)
+#endif
+
+#define ZRP_DYNAMICARRAY_DEFINE_COMBINE_FUNCTION(name, wideFunction, operator) \
+    ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void zr##name##BitSets(          \
+        struct ZrBitSet *pBitSet, const struct ZrBitSet *pOther)               \
+    {                                                                          \
+        ZrUint64 *pWords;                                                      \
+        const ZrUint64 *pOtherWords;                                           \
+        size_t count;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pBitSet != NULL);                                            \
+        ZR_ASSERT(pOther != NULL);                                             \
+        ZR_ASSERT(pBitSet->size == pOther->size);                              \
+                                                                               \
+        pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);                          \
+        pOtherWords = ZRP_DYNAMICARRAY_GET_WORDS(pOther);                      \
+        count = ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet);                      \
+        i = 0;                                                                 \
+        ZRP_DYNAMICARRAY_COMBINE_WIDE(                                         \
+            pWords, pOtherWords, i, count, wideFunction)                       \
+        for (; i < count; ++i) {                                               \
+            pWords[i] operator pOtherWords[i];                                 \
+        }                                                                      \
+                                                                               \
+        pBitSet->indexed = 0;                                                  \
+    }
+
+ZRP_DYNAMICARRAY_DEFINE_COMBINE_FUNCTION(And, _mm_and_si128, &=)
+ZRP_DYNAMICARRAY_DEFINE_COMBINE_FUNCTION(Or, _mm_or_si128, |=)
+ZRP_DYNAMICARRAY_DEFINE_COMBINE_FUNCTION(Xor, _mm_xor_si128, ^=)
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE enum ZrStatus
+zrIndexBitSet(struct ZrBitSet *pBitSet)
+{
+    enum ZrStatus status;
+    const ZrUint64 *pWords;
+    size_t *pRanks;
+    size_t *pSelects;
+    size_t wordCount;
+    size_t groupCount;
+    size_t sampleCount;
+    size_t i;
+    size_t sample;
+
+    ZR_ASSERT(pBitSet != NULL);
+
+    if (pBitSet->indexed) {
+        return ZR_SUCCESS;
+    }
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    wordCount = ZRP_DYNAMICARRAY_GET_WORD_COUNT(pBitSet);
+    groupCount = wordCount / ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT + 1;
+
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pBitSet->pRanks, groupCount + 1, (size_t)-1, sizeof(size_t));
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("failed to allocate the rank index of the bit set\n");
+        return status;
+    }
+
+    pRanks = ZRP_DYNAMICARRAY_GET_RANKS(pBitSet);
+    memset(pRanks, 0, sizeof *pRanks * (groupCount + 1));
+
+    for (i = 0; i < wordCount; ++i) {
+        pRanks[i / ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT + 1]
+            += zrpBitsCountOnes(pWords[i]);
+    }
+
+    for (i = 0; i < groupCount; ++i) {
+        pRanks[i + 1] += pRanks[i];
+    }
+
+    ZRP_DYNAMICARRAY_GET_HEADER(pBitSet->pRanks)->size = groupCount + 1;
+
+    sampleCount = pRanks[groupCount]
+                      / ZRP_DYNAMICARRAY_BIT_SET_SELECT_SAMPLE_RATE
+                  + 1;
+    status = zrpDynamicArrayEnsureBlockHasEnoughCapacity(
+        &pBitSet->pSelects, sampleCount, (size_t)-1, sizeof(size_t));
+    if (status != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("failed to allocate the select index of the bit set\n");
+        return status;
+    }
+
+    pSelects = ZRP_DYNAMICARRAY_GET_SELECTS(pBitSet);
+    sample = 0;
+    for (i = 0; i < groupCount && sample < sampleCount; ++i) {
+        while (sample < sampleCount
+               && sample * ZRP_DYNAMICARRAY_BIT_SET_SELECT_SAMPLE_RATE
+                      < pRanks[i + 1]) {
+            pSelects[sample++] = i;
+        }
+    }
+
+    while (sample < sampleCount) {
+        pSelects[sample++] = groupCount - 1;
+    }
+
+    ZRP_DYNAMICARRAY_GET_HEADER(pBitSet->pSelects)->size = sampleCount;
+    pBitSet->indexed = 1;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE void
+zrRankBit(ZrSize *pRank, const struct ZrBitSet *pBitSet, ZrSize position)
+{
+    const ZrUint64 *pWords;
+    size_t word;
+    size_t i;
+    size_t out;
+
+    ZR_ASSERT(pRank != NULL);
+    ZR_ASSERT(pBitSet != NULL);
+    ZR_ASSERT(pBitSet->indexed);
+    ZR_ASSERT((size_t)position <= pBitSet->size);
+
+    /* Number of set bits found before the given position. */
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    word = (size_t)position / 64;
+    i = word / ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT;
+    out = ZRP_DYNAMICARRAY_GET_RANKS(pBitSet)[i];
+    for (i *= ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT; i < word; ++i) {
+        out += zrpBitsCountOnes(pWords[i]);
+    }
+
+    if ((size_t)position % 64 != 0) {
+        out += zrpBitsCountOnes(
+            pWords[word] & (((ZrUint64)1 << ((size_t)position % 64)) - 1));
+    }
+
+    *pRank = (ZrSize)out;
+}
+
+ZRP_MAYBE_UNUSED ZRP_DYNAMICARRAY_LINKAGE int
+zrSelectBit(ZrSize *pPosition, const struct ZrBitSet *pBitSet, ZrSize rank)
+{
+    const ZrUint64 *pWords;
+    const size_t *pRanks;
+    const size_t *pSelects;
+    size_t groupCount;
+    size_t sample;
+    size_t low;
+    size_t high;
+    size_t middle;
+    size_t remaining;
+    size_t count;
+    size_t i;
+
+    ZR_ASSERT(pPosition != NULL);
+    ZR_ASSERT(pBitSet != NULL);
+    ZR_ASSERT(pBitSet->indexed);
+
+    pRanks = ZRP_DYNAMICARRAY_GET_RANKS(pBitSet);
+    groupCount = ZRP_DYNAMICARRAY_GET_HEADER(pBitSet->pRanks)->size - 1;
+    if ((size_t)rank >= pRanks[groupCount]) {
+        return 0;
+    }
+
+    /* Find the last group having at most `rank` set bits before it. */
+    pSelects = ZRP_DYNAMICARRAY_GET_SELECTS(pBitSet);
+    sample = (size_t)rank / ZRP_DYNAMICARRAY_BIT_SET_SELECT_SAMPLE_RATE;
+    low = pSelects[sample];
+    high = sample + 1 < ZRP_DYNAMICARRAY_GET_HEADER(pBitSet->pSelects)->size
+               ? pSelects[sample + 1] + 1
+               : groupCount;
+    while (high - low > 1) {
+        middle = low + (high - low) / 2;
+        if (pRanks[middle] <= (size_t)rank) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    pWords = ZRP_DYNAMICARRAY_GET_WORDS(pBitSet);
+    remaining = (size_t)rank - pRanks[low];
+    for (i = low * ZRP_DYNAMICARRAY_BIT_SET_RANK_WORD_COUNT;; ++i) {
+        count = zrpBitsCountOnes(pWords[i]);
+        if (remaining < count) {
+            break;
+        }
+
+        remaining -= count;
+    }
+
+    *pPosition
+        = (ZrSize)(i * 64 + zrpBitsSelect(pWords[i], (unsigned int)remaining));
+    return 1;
+}
+
 #endif /* ZRP_DYNAMICARRAY_IMPLEMENTATION_DEFINED */
 #endif /* ZR_DEFINE_IMPLEMENTATION */
@@ -0,0 +1,799 @@
+/* @include "partials/license.h" */
+
+#ifndef ZERO_HASHMAP_H
+#define ZERO_HASHMAP_H
+
+#define ZR_HASHMAP_MAJOR_VERSION 0
+#define ZR_HASHMAP_MINOR_VERSION 1
+#define ZR_HASHMAP_PATCH_VERSION 0
+
+/* @include "partials/environment.h" */
+/* @include "partials/platform.h" */
+/* @include "partials/types.h" */
+
+/* @include "partials/status.h" */
+
+#if defined(ZR_HASHMAP_SPECIFY_INTERNAL_LINKAGE)                               \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_HASHMAP_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_HASHMAP_LINKAGE extern "C"
+#else
+#define ZRP_HASHMAP_LINKAGE extern
+#endif
+
+struct ZrHashMap;
+
+#define ZRP_HASHMAP_DECLARE_CREATE_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrCreate##name(struct ZrHashMap **ppMap, \
+                                                     ZrSize size)
+
+#define ZRP_HASHMAP_DECLARE_DESTROY_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE void zrDestroy##name(struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_GET_SIZE_FUNCTION(name, key, value)                \
+    ZRP_HASHMAP_LINKAGE void zrGet##name##Size(ZrSize *pSize,                  \
+                                               const struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_GET_CAPACITY_FUNCTION(name, key, value)            \
+    ZRP_HASHMAP_LINKAGE void zrGet##name##Capacity(                            \
+        ZrSize *pCapacity, const struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_RESERVE_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrReserve##name(struct ZrHashMap *pMap,  \
+                                                      ZrSize size)
+
+#define ZRP_HASHMAP_DECLARE_CLEAR_FUNCTION(name, key, value)                   \
+    ZRP_HASHMAP_LINKAGE void zrClear##name(struct ZrHashMap *pMap)
+
+#define ZRP_HASHMAP_DECLARE_INSERT_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE enum ZrStatus zrInsert##name(                          \
+        struct ZrHashMap *pMap, key k, value v)
+
+#define ZRP_HASHMAP_DECLARE_FIND_FUNCTION(name, key, value)                    \
+    ZRP_HASHMAP_LINKAGE void zrFind##name(                                     \
+        value **ppValue, const struct ZrHashMap *pMap, key k)
+
+#define ZRP_HASHMAP_DECLARE_REMOVE_FUNCTION(name, key, value)                  \
+    ZRP_HASHMAP_LINKAGE void zrRemove##name(struct ZrHashMap *pMap, key k)
+
+#define ZRP_HASHMAP_DECLARE_ITERATE_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_LINKAGE int zrIterate##name(ZrSize *pPosition,                 \
+                                            const key **ppKey,                 \
+                                            value **ppValue,                   \
+                                            const struct ZrHashMap *pMap)
+
+/*
+   Hash maps are open-addressing tables storing one control byte per slot,
+   holding 7 bits of the hash for the occupied slots, that are compared
+   a group at a time, using SSE2 when available, before looking at any key.
+
+   The hash function is called as `hashFn(const key *)` and returns an
+   integer, while the equality function is called as
+   `eqFn(const key *, const key *)` and returns a non-zero value if the keys
+   are equal.
+
+   Iterating starts with a position set to 0 and returns 0 when there are no
+   elements left. Removing elements while iterating is allowed but inserting
+   is not, and pointers to values are invalidated by any insertion.
+*/
+#define ZR_MAKE_HASH_MAP(name, key, value, hashFn, eqFn)                       \
+    ZRP_HASHMAP_DECLARE_CREATE_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_DESTROY_FUNCTION(name, key, value);                    \
+    ZRP_HASHMAP_DECLARE_GET_SIZE_FUNCTION(name, key, value);                   \
+    ZRP_HASHMAP_DECLARE_GET_CAPACITY_FUNCTION(name, key, value);               \
+    ZRP_HASHMAP_DECLARE_RESERVE_FUNCTION(name, key, value);                    \
+    ZRP_HASHMAP_DECLARE_CLEAR_FUNCTION(name, key, value);                      \
+    ZRP_HASHMAP_DECLARE_INSERT_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_FIND_FUNCTION(name, key, value);                       \
+    ZRP_HASHMAP_DECLARE_REMOVE_FUNCTION(name, key, value);                     \
+    ZRP_HASHMAP_DECLARE_ITERATE_FUNCTION(name, key, value);
+
+#endif /* ZERO_HASHMAP_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_HASHMAP_IMPLEMENTATION_DEFINED
+#define ZRP_HASHMAP_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "allocator.h"
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+/* @include "partials/unused.h" */
+/* @include "partials/logging.h" */
+/* @include "partials/loglevel.h" */
+/* @include "partials/logger.h" */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)                  \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZRP_HASHMAP_USE_SSE2 1
+#else
+#define ZRP_HASHMAP_USE_SSE2 0
+#endif
+
+/*
+   The control bytes are laid out at the beginning of a cache line aligned
+   block, followed by the slots.
+
+     block
+      /
+     +----------+--------+---------+-------+
+     | controls | clones | padding | slots |
+     +----------+--------+---------+-------+
+      \                             \
+       0                           offset
+
+   The first `group width - 1` control bytes are cloned past the end so that
+   a group can be loaded starting from any slot without wrapping around.
+
+   An empty control byte has only its sign bit set, a deleted one has all of
+   its bits set except the lowest one, and a full one has its sign bit
+   cleared with the 7 remaining bits taken from the hash.
+*/
+
+/*
+   Matching a group returns a mask with one bit per slot, found at the
+   position `(slot << shift) + offset`.
+*/
+
+#if ZRP_HASHMAP_USE_SSE2
+#define ZRP_HASHMAP_GROUP_WIDTH 16
+#define ZRP_HASHMAP_MASK_SHIFT 0
+#define ZRP_HASHMAP_MASK_OFFSET 0
+#else
+#define ZRP_HASHMAP_GROUP_WIDTH 8
+#define ZRP_HASHMAP_MASK_SHIFT 3
+#define ZRP_HASHMAP_MASK_OFFSET 7
+#endif
+
+#define ZRP_HASHMAP_CONTROL_EMPTY 0x80
+#define ZRP_HASHMAP_CONTROL_DELETED 0xFE
+#define ZRP_HASHMAP_MIN_CAPACITY 16
+
+#define ZRP_HASHMAP_GET_H1(hash) ((size_t)((hash) >> 7))
+#define ZRP_HASHMAP_GET_H2(hash) ((unsigned char)((hash)&0x7F))
+#define ZRP_HASHMAP_IS_FULL(control) ((control) < 0x80)
+
+#define ZRP_HASHMAP_GET_SLOT(pMap, index)                                      \
+    ((void *)&(pMap)->pSlots[(index) * (pMap)->slotSize])
+
+struct ZrHashMap {
+    unsigned char *pControls;
+    unsigned char *pSlots;
+    size_t capacity;
+    size_t size;
+    size_t growthLeft;
+    size_t slotSize;
+};
+
+#if ZRP_HASHMAP_USE_SSE2
+typedef __m128i ZrpHashMapGroup;
+#else
+typedef ZrUint64 ZrpHashMapGroup;
+#endif
+
+typedef ZrUint64 (*ZrpHashMapHashSlotFunction)(const void *pSlot);
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMix(ZrUint64 hash)
+{
+    /* Spread weak hashes, such as the identity, across all bits. */
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetTrailingZeroCount(ZrUint64 mask)
+{
+    ZR_ASSERT(mask != 0);
+
+#if defined(__GNUC__)
+    return (size_t)__builtin_ctzll(mask);
+#else
+    {
+        size_t out;
+
+        out = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++out;
+        }
+
+        return out;
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetLeadingZeroCount(ZrUint64 mask)
+{
+    size_t out;
+
+    /* Count within the group width rather than the full integer. */
+    out = 0;
+    while (out < ZRP_HASHMAP_GROUP_WIDTH
+           && !(mask
+                & ((ZrUint64)1 << (((ZRP_HASHMAP_GROUP_WIDTH - 1 - out)
+                                    << ZRP_HASHMAP_MASK_SHIFT)
+                                   + ZRP_HASHMAP_MASK_OFFSET)))) {
+        ++out;
+    }
+
+    return out;
+}
+
+ZRP_MAYBE_UNUSED static ZrpHashMapGroup
+zrpHashMapLoadGroup(const unsigned char *pControls)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return _mm_loadu_si128((const __m128i *)(const void *)pControls);
+#else
+    ZrUint64 out;
+    size_t i;
+
+    /* Assemble in little-endian order so that bytes map to the same bits. */
+    out = 0;
+    for (i = 0; i < ZRP_HASHMAP_GROUP_WIDTH; ++i) {
+        out |= (ZrUint64)pControls[i] << (i * 8);
+    }
+
+    return out;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatch(ZrpHashMapGroup group, unsigned char h2)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char)h2), group));
+#else
+    /* Might report false positives, which the key comparison discards. */
+    ZrUint64 x;
+
+    x = group ^ (0x0101010101010101ull * h2);
+    return (x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatchEmpty(ZrpHashMapGroup group)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(_mm_cmpeq_epi8(
+        _mm_set1_epi8((char)ZRP_HASHMAP_CONTROL_EMPTY), group));
+#else
+    return group & (~group << 6) & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpHashMapMatchEmptyOrDeleted(ZrpHashMapGroup group)
+{
+#if ZRP_HASHMAP_USE_SSE2
+    return (ZrUint64)_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(-1), group));
+#else
+    return group & (~group << 7) & 0x8080808080808080ull;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetMaxSize(size_t capacity)
+{
+    /* Keep the load factor at or below 7/8. */
+    return capacity - capacity / 8;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetCapacityForSize(size_t size)
+{
+    size_t capacity;
+
+    capacity = ZRP_HASHMAP_MIN_CAPACITY;
+    while (zrpHashMapGetMaxSize(capacity) < size) {
+        if (capacity > (size_t)-1 / 2) {
+            return 0;
+        }
+
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapGetSlotsOffset(size_t capacity)
+{
+    return (capacity + ZRP_HASHMAP_GROUP_WIDTH - 1 + ZR_CACHE_LINE_SIZE - 1)
+           / ZR_CACHE_LINE_SIZE * ZR_CACHE_LINE_SIZE;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapResetControls(struct ZrHashMap *pMap)
+{
+    memset(pMap->pControls,
+           ZRP_HASHMAP_CONTROL_EMPTY,
+           pMap->capacity + ZRP_HASHMAP_GROUP_WIDTH - 1);
+    pMap->size = 0;
+    pMap->growthLeft = zrpHashMapGetMaxSize(pMap->capacity);
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapAllocate(struct ZrHashMap *pMap, size_t capacity, size_t slotSize)
+{
+    size_t offset;
+    unsigned char *pBlock;
+
+    ZR_ASSERT(pMap != NULL);
+    ZR_ASSERT(capacity >= ZRP_HASHMAP_MIN_CAPACITY);
+    ZR_ASSERT((capacity & (capacity - 1)) == 0);
+
+    offset = zrpHashMapGetSlotsOffset(capacity);
+    if (capacity > ((size_t)-1 - offset) / slotSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    pBlock = (unsigned char *)zrAllocateAligned(
+        (ZrSize)(offset + capacity * slotSize), ZR_CACHE_LINE_SIZE);
+    if (pBlock == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the table\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pMap->pControls = pBlock;
+    pMap->pSlots = &pBlock[offset];
+    pMap->capacity = capacity;
+    pMap->slotSize = slotSize;
+    zrpHashMapResetControls(pMap);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapSetControl(struct ZrHashMap *pMap,
+                     size_t index,
+                     unsigned char control)
+{
+    pMap->pControls[index] = control;
+    if (index < ZRP_HASHMAP_GROUP_WIDTH - 1) {
+        pMap->pControls[pMap->capacity + index] = control;
+    }
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpHashMapFindFreeSlot(const struct ZrHashMap *pMap, ZrUint64 hash)
+{
+    size_t position;
+    size_t step;
+    ZrUint64 mask;
+
+    position = ZRP_HASHMAP_GET_H1(hash) & (pMap->capacity - 1);
+    step = 0;
+    for (;;) {
+        mask = zrpHashMapMatchEmptyOrDeleted(
+            zrpHashMapLoadGroup(&pMap->pControls[position]));
+        if (mask != 0) {
+            return (position
+                    + (zrpHashMapGetTrailingZeroCount(mask)
+                       >> ZRP_HASHMAP_MASK_SHIFT))
+                   & (pMap->capacity - 1);
+        }
+
+        step += ZRP_HASHMAP_GROUP_WIDTH;
+        position = (position + step) & (pMap->capacity - 1);
+    }
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapResize(struct ZrHashMap *pMap,
+                 size_t capacity,
+                 ZrpHashMapHashSlotFunction pfnHashSlot)
+{
+    enum ZrStatus status;
+    struct ZrHashMap previous;
+    size_t i;
+    size_t index;
+    ZrUint64 hash;
+
+    ZR_ASSERT(pMap != NULL);
+    ZR_ASSERT(zrpHashMapGetMaxSize(capacity) >= pMap->size);
+
+    previous = *pMap;
+    status = zrpHashMapAllocate(pMap, capacity, previous.slotSize);
+    if (status != ZR_SUCCESS) {
+        *pMap = previous;
+        return status;
+    }
+
+    for (i = 0; i < previous.capacity; ++i) {
+        if (!ZRP_HASHMAP_IS_FULL(previous.pControls[i])) {
+            continue;
+        }
+
+        hash = zrpHashMapMix(
+            pfnHashSlot(ZRP_HASHMAP_GET_SLOT(&previous, i)));
+        index = zrpHashMapFindFreeSlot(pMap, hash);
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_GET_H2(hash));
+        memcpy(ZRP_HASHMAP_GET_SLOT(pMap, index),
+               ZRP_HASHMAP_GET_SLOT(&previous, i),
+               pMap->slotSize);
+    }
+
+    pMap->size = previous.size;
+    pMap->growthLeft -= previous.size;
+    zrFreeAligned(previous.pControls);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpHashMapPrepareInsert(size_t *pIndex,
+                        struct ZrHashMap *pMap,
+                        ZrUint64 hash,
+                        ZrpHashMapHashSlotFunction pfnHashSlot)
+{
+    enum ZrStatus status;
+    size_t capacity;
+
+    *pIndex = zrpHashMapFindFreeSlot(pMap, hash);
+    if (pMap->growthLeft == 0
+        && pMap->pControls[*pIndex] == ZRP_HASHMAP_CONTROL_EMPTY) {
+        /*
+           Purge the deleted slots if they account for a large enough share
+           of the table, or grow it otherwise.
+        */
+        capacity = pMap->capacity;
+        if (pMap->size + 1 > zrpHashMapGetMaxSize(capacity) / 2) {
+            if (capacity > (size_t)-1 / 2) {
+                ZRP_LOG_TRACE("the requested capacity is too large\n");
+                return ZR_ERROR_MAX_SIZE_EXCEEDED;
+            }
+
+            capacity *= 2;
+        }
+
+        status = zrpHashMapResize(pMap, capacity, pfnHashSlot);
+        if (status != ZR_SUCCESS) {
+            return status;
+        }
+
+        *pIndex = zrpHashMapFindFreeSlot(pMap, hash);
+    }
+
+    if (pMap->pControls[*pIndex] == ZRP_HASHMAP_CONTROL_EMPTY) {
+        --pMap->growthLeft;
+    }
+
+    zrpHashMapSetControl(pMap, *pIndex, ZRP_HASHMAP_GET_H2(hash));
+    ++pMap->size;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpHashMapRemoveAt(struct ZrHashMap *pMap, size_t index)
+{
+    size_t previous;
+    size_t emptyBefore;
+    size_t emptyAfter;
+
+    ZR_ASSERT(ZRP_HASHMAP_IS_FULL(pMap->pControls[index]));
+
+    /*
+       A slot can be marked as empty again if no group that could have been
+       probed through it was ever full, that is if no window of group width
+       slots containing it is free of empty slots.
+    */
+    previous = (index - ZRP_HASHMAP_GROUP_WIDTH) & (pMap->capacity - 1);
+    emptyBefore = zrpHashMapGetLeadingZeroCount(zrpHashMapMatchEmpty(
+        zrpHashMapLoadGroup(&pMap->pControls[previous])));
+    emptyAfter = zrpHashMapMatchEmpty(
+        zrpHashMapLoadGroup(&pMap->pControls[index]));
+    emptyAfter = emptyAfter == 0
+                     ? ZRP_HASHMAP_GROUP_WIDTH
+                     : zrpHashMapGetTrailingZeroCount(emptyAfter)
+                           >> ZRP_HASHMAP_MASK_SHIFT;
+
+    --pMap->size;
+    if (emptyBefore + emptyAfter < ZRP_HASHMAP_GROUP_WIDTH) {
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_CONTROL_EMPTY);
+        ++pMap->growthLeft;
+    } else {
+        zrpHashMapSetControl(pMap, index, ZRP_HASHMAP_CONTROL_DELETED);
+    }
+}
+
+#define ZRP_HASHMAP_DEFINE_SLOT(name, key, value, hashFn)                      \
+    struct ZrpHashMap##name##Slot {                                            \
+        key k;                                                                 \
+        value v;                                                               \
+    };                                                                         \
+                                                                               \
+    ZRP_MAYBE_UNUSED static ZrUint64 zrpHash##name##Slot(const void *pSlot)    \
+    {                                                                          \
+        return (ZrUint64)hashFn(                                               \
+            &((const struct ZrpHashMap##name##Slot *)pSlot)->k);               \
+    }
+
+#define ZRP_HASHMAP_DEFINE_FIND_INDEX_FUNCTION(name, key, value, eqFn)         \
+    ZRP_MAYBE_UNUSED static int zrpFind##name##Index(                          \
+        size_t *pIndex,                                                        \
+        const struct ZrHashMap *pMap,                                          \
+        const key *pKey,                                                       \
+        ZrUint64 hash)                                                         \
+    {                                                                          \
+        const struct ZrpHashMap##name##Slot *pSlots;                           \
+        ZrpHashMapGroup group;                                                 \
+        ZrUint64 mask;                                                         \
+        size_t position;                                                       \
+        size_t step;                                                           \
+                                                                               \
+        pSlots = (const struct ZrpHashMap##name##Slot *)pMap->pSlots;          \
+        position = ZRP_HASHMAP_GET_H1(hash) & (pMap->capacity - 1);            \
+        step = 0;                                                              \
+        for (;;) {                                                             \
+            group = zrpHashMapLoadGroup(&pMap->pControls[position]);           \
+            mask = zrpHashMapMatch(group, ZRP_HASHMAP_GET_H2(hash));           \
+            while (mask != 0) {                                                \
+                *pIndex = (position                                            \
+                           + (zrpHashMapGetTrailingZeroCount(mask)             \
+                              >> ZRP_HASHMAP_MASK_SHIFT))                      \
+                          & (pMap->capacity - 1);                              \
+                if (eqFn(&pSlots[*pIndex].k, pKey)) {                          \
+                    return 1;                                                  \
+                }                                                              \
+                                                                               \
+                mask &= mask - 1;                                              \
+            }                                                                  \
+                                                                               \
+            if (zrpHashMapMatchEmpty(group) != 0) {                            \
+                return 0;                                                      \
+            }                                                                  \
+                                                                               \
+            step += ZRP_HASHMAP_GROUP_WIDTH;                                   \
+            position = (position + step) & (pMap->capacity - 1);               \
+        }                                                                      \
+    }
+
+#define ZRP_HASHMAP_DEFINE_CREATE_FUNCTION(name, key, value)                   \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrCreate##name(         \
+        struct ZrHashMap **ppMap, ZrSize size)                                 \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrHashMap *pMap;                                                \
+        size_t capacity;                                                       \
+                                                                               \
+        ZR_ASSERT(ppMap != NULL);                                              \
+                                                                               \
+        capacity = zrpHashMapGetCapacityForSize((size_t)size);                 \
+        if (capacity == 0) {                                                   \
+            ZRP_LOG_ERROR("the requested size is too large (requested size: "  \
+                          "%zu)\n",                                            \
+                          (size_t)size);                                       \
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;                                 \
+        }                                                                      \
+                                                                               \
+        pMap = (struct ZrHashMap *)zrAllocate((ZrSize)sizeof *pMap);           \
+        if (pMap == NULL) {                                                    \
+            ZRP_LOG_ERROR("failed to allocate the hash map\n");                \
+            return ZR_ERROR_ALLOCATION;                                        \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapAllocate(                                           \
+            pMap, capacity, sizeof(struct ZrpHashMap##name##Slot));            \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create a hash map with key type "         \
+                          "‘" #key "’ and value type ‘" #value "’ "            \
+                          "(requested size: %zu)\n",                           \
+                          (size_t)size);                                       \
+            zrFree(pMap);                                                      \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        *ppMap = pMap;                                                         \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_DESTROY_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrDestroy##name(                 \
+        struct ZrHashMap *pMap)                                                \
+    {                                                                          \
+        if (pMap == NULL) {                                                    \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+        zrFreeAligned(pMap->pControls);                                        \
+        zrFree(pMap);                                                          \
+    }
+
+#define ZRP_HASHMAP_DEFINE_GET_SIZE_FUNCTION(name, key, value)                 \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrGet##name##Size(               \
+        ZrSize *pSize, const struct ZrHashMap *pMap)                           \
+    {                                                                          \
+        ZR_ASSERT(pSize != NULL);                                              \
+        ZR_ASSERT(pMap != NULL);                                               \
+                                                                               \
+        *pSize = (ZrSize)pMap->size;                                           \
+    }
+
+#define ZRP_HASHMAP_DEFINE_GET_CAPACITY_FUNCTION(name, key, value)             \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrGet##name##Capacity(           \
+        ZrSize *pCapacity, const struct ZrHashMap *pMap)                       \
+    {                                                                          \
+        ZR_ASSERT(pCapacity != NULL);                                          \
+        ZR_ASSERT(pMap != NULL);                                               \
+                                                                               \
+        *pCapacity = (ZrSize)zrpHashMapGetMaxSize(pMap->capacity);             \
+    }
+
+#define ZRP_HASHMAP_DEFINE_RESERVE_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrReserve##name(        \
+        struct ZrHashMap *pMap, ZrSize size)                                   \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        size_t capacity;                                                       \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if ((size_t)size <= pMap->size + pMap->growthLeft) {                   \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        capacity = zrpHashMapGetCapacityForSize((size_t)size);                 \
+        if (capacity == 0) {                                                   \
+            ZRP_LOG_ERROR("the requested size is too large (requested size: "  \
+                          "%zu)\n",                                            \
+                          (size_t)size);                                       \
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;                                 \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapResize(pMap, capacity, zrpHash##name##Slot);        \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to reserve a large enough capacity for the " \
+                          "hash map (requested size: %zu)\n",                  \
+                          (size_t)size);                                       \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_CLEAR_FUNCTION(name, key, value)                    \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrClear##name(                   \
+        struct ZrHashMap *pMap)                                                \
+    {                                                                          \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        zrpHashMapResetControls(pMap);                                         \
+    }
+
+#define ZRP_HASHMAP_DEFINE_INSERT_FUNCTION(name, key, value, hashFn)           \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE enum ZrStatus zrInsert##name(         \
+        struct ZrHashMap *pMap, key k, value v)                                \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrpHashMap##name##Slot *pSlot;                                  \
+        ZrUint64 hash;                                                         \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        hash = zrpHashMapMix((ZrUint64)hashFn(&k));                            \
+        if (zrpFind##name##Index(&index, pMap, &k, hash)) {                    \
+            ((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index].v = v;      \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        status = zrpHashMapPrepareInsert(                                      \
+            &index, pMap, hash, zrpHash##name##Slot);                          \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to insert into the hash map with key type "  \
+                          "‘" #key "’ and value type ‘" #value "’\n");         \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        pSlot = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index];       \
+        pSlot->k = k;                                                          \
+        pSlot->v = v;                                                          \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_HASHMAP_DEFINE_FIND_FUNCTION(name, key, value, hashFn)             \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrFind##name(                    \
+        value **ppValue, const struct ZrHashMap *pMap, key k)                  \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(ppValue != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if (!zrpFind##name##Index(                                             \
+                &index, pMap, &k, zrpHashMapMix((ZrUint64)hashFn(&k)))) {      \
+            *ppValue = NULL;                                                   \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        *ppValue = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[index].v;  \
+    }
+
+#define ZRP_HASHMAP_DEFINE_REMOVE_FUNCTION(name, key, value, hashFn)           \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE void zrRemove##name(                  \
+        struct ZrHashMap *pMap, key k)                                         \
+    {                                                                          \
+        size_t index;                                                          \
+                                                                               \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        if (zrpFind##name##Index(                                              \
+                &index, pMap, &k, zrpHashMapMix((ZrUint64)hashFn(&k)))) {      \
+            zrpHashMapRemoveAt(pMap, index);                                   \
+        }                                                                      \
+    }
+
+#define ZRP_HASHMAP_DEFINE_ITERATE_FUNCTION(name, key, value)                  \
+    ZRP_MAYBE_UNUSED ZRP_HASHMAP_LINKAGE int zrIterate##name(                  \
+        ZrSize *pPosition,                                                     \
+        const key **ppKey,                                                     \
+        value **ppValue,                                                       \
+        const struct ZrHashMap *pMap)                                          \
+    {                                                                          \
+        struct ZrpHashMap##name##Slot *pSlot;                                  \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pPosition != NULL);                                          \
+        ZR_ASSERT(ppKey != NULL);                                              \
+        ZR_ASSERT(ppValue != NULL);                                            \
+        ZR_ASSERT(pMap != NULL);                                               \
+        ZR_ASSERT(pMap->slotSize == sizeof(struct ZrpHashMap##name##Slot));    \
+                                                                               \
+        for (i = (size_t)*pPosition; i < pMap->capacity; ++i) {                \
+            if (ZRP_HASHMAP_IS_FULL(pMap->pControls[i])) {                     \
+                pSlot = &((struct ZrpHashMap##name##Slot *)pMap->pSlots)[i];   \
+                *pPosition = (ZrSize)(i + 1);                                  \
+                *ppKey = &pSlot->k;                                            \
+                *ppValue = &pSlot->v;                                          \
+                return 1;                                                      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        *pPosition = (ZrSize)pMap->capacity;                                   \
+        return 0;                                                              \
+    }
+
+#undef ZR_MAKE_HASH_MAP
+#define ZR_MAKE_HASH_MAP(name, key, value, hashFn, eqFn)                       \
+    ZRP_HASHMAP_DEFINE_SLOT(name, key, value, hashFn)                          \
+    ZRP_HASHMAP_DEFINE_FIND_INDEX_FUNCTION(name, key, value, eqFn)             \
+    ZRP_HASHMAP_DEFINE_CREATE_FUNCTION(name, key, value)                       \
+    ZRP_HASHMAP_DEFINE_DESTROY_FUNCTION(name, key, value)                      \
+    ZRP_HASHMAP_DEFINE_GET_SIZE_FUNCTION(name, key, value)                     \
+    ZRP_HASHMAP_DEFINE_GET_CAPACITY_FUNCTION(name, key, value)                 \
+    ZRP_HASHMAP_DEFINE_RESERVE_FUNCTION(name, key, value)                      \
+    ZRP_HASHMAP_DEFINE_CLEAR_FUNCTION(name, key, value)                        \
+    ZRP_HASHMAP_DEFINE_INSERT_FUNCTION(name, key, value, hashFn)               \
+    ZRP_HASHMAP_DEFINE_FIND_FUNCTION(name, key, value, hashFn)                 \
+    ZRP_HASHMAP_DEFINE_REMOVE_FUNCTION(name, key, value, hashFn)               \
+    ZRP_HASHMAP_DEFINE_ITERATE_FUNCTION(name, key, value)
+
+#endif /* ZRP_HASHMAP_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
@@ -9,7 +9,11 @@
 #define ZR_LOGGER_MINOR_VERSION 1
 #define ZR_LOGGER_PATCH_VERSION 1
 
+/* @include "partials/environment.h" */
 /* @include "partials/platform.h" */
+/* @include "partials/types.h" */
+
+/* @include "partials/status.h" */
 
 #if defined(ZR_LOGGER_SPECIFY_INTERNAL_LINKAGE)                                \
     || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
@@ -22,6 +26,45 @@
 
 /* @include "partials/loglevel.h" */
 
+enum ZrLoggerOverflowPolicy {
+    ZR_LOGGER_OVERFLOW_POLICY_BLOCK = 0,
+    ZR_LOGGER_OVERFLOW_POLICY_DROP = 1,
+    ZR_LOGGER_OVERFLOW_POLICY_SAMPLE = 2
+};
+
+/*
+   Options for the asynchronous mode, where any field left to zero is set to
+   its default value.
+
+   - bufferSize: size in bytes of the buffer allocated for each logging thread
+     (default: 65536).
+   - writeSize: size in bytes of the largest write issued by the background
+     thread (default: 65536).
+   - flushInterval: maximum time in milliseconds between two flushes of the
+     buffers by the background thread (default: 10).
+   - sampleRate: once a buffer is half full, only 1 record out of this many is
+     kept when using the sample overflow policy (default: 16).
+   - overflowPolicy: whether to block, to drop the record, or to start
+     sampling the records when a buffer runs out of space (default: block).
+   - deferFormatting: whether log calls only capture the format, the location,
+     and the raw bytes of the arguments, leaving the formatting to the
+     background thread (default: no).
+
+   When deferring the formatting, the file names and the formats passed to
+   the log calls must remain valid until the asynchronous mode is stopped,
+   which is the case of string literals. String arguments are copied. Records
+   using a conversion that can't be deferred, such as `%n` or `%j`, are
+   formatted by the calling thread instead.
+*/
+struct ZrAsyncLoggerOptions {
+    ZrSize bufferSize;
+    ZrSize writeSize;
+    ZrUint32 flushInterval;
+    ZrUint32 sampleRate;
+    enum ZrLoggerOverflowPolicy overflowPolicy;
+    int deferFormatting;
+};
+
 ZRP_LOGGER_LINKAGE void
 zrLog(enum ZrLogLevel level,
       const char *pFile,
@@ -36,43 +79,3068 @@ zrLogVaList(enum ZrLogLevel level,
             const char *pFormat,
             va_list args);
 
+/*
+   In asynchronous mode, log calls format their record into a buffer owned by
+   the calling thread and a background thread writes the buffers out with as
+   few system calls as possible. Records from a same thread keep their order
+   but records from different threads may not be written in the order they
+   were logged.
+
+   Starting and stopping the asynchronous mode is not thread-safe and must not
+   happen while other threads may be logging.
+*/
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrLoggerStartAsync(const struct ZrAsyncLoggerOptions *pOptions);
+
+ZRP_LOGGER_LINKAGE void
+zrLoggerStopAsync(void);
+
+ZRP_LOGGER_LINKAGE void
+zrLoggerFlush(void);
+
+/*
+   Sinks receive the records, without any styling, in place of the standard
+   error stream as soon as one of them is added. Each sink only receives the
+   records having a level up to its own, which defaults to the debug level.
+
+   File sinks buffer their writes and, when given a maximum file size, rotate
+   the file at `path` to `path.1`, `path.1` to `path.2`, and so on up to the
+   given maximum file count. Memory sinks keep the most recent records in
+   a ring that can be dumped from a signal handler, and function sinks
+   forward the records to a user callback.
+
+   In asynchronous mode, all the sink writes, including the file rotations,
+   happen on the background thread. In synchronous mode, a rotation happens
+   on the thread whose record reaches the maximum file size, which blocks it
+   and the other threads logging to that sink until the files are renamed.
+   Adding and removing sinks is not thread-safe and must not happen while
+   other threads may be logging, and sinks must be removed before being
+   destroyed.
+
+   Only the records logged through this library reach the sinks, other
+   libraries keep logging to the standard error stream unless their `ZR_LOG`
+   macro is overridden to call `zrLog()`.
+*/
+
+struct ZrLogSink;
+
+typedef void (*ZrLogSinkFunction)(void *pData,
+                                  enum ZrLogLevel level,
+                                  const char *pRecord,
+                                  ZrSize size);
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFileLogSink(struct ZrLogSink **ppSink,
+                    const char *pPath,
+                    ZrSize maxFileSize,
+                    ZrUint32 maxFileCount);
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFdLogSink(struct ZrLogSink **ppSink, int fd);
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateMemoryLogSink(struct ZrLogSink **ppSink, ZrSize size);
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFunctionLogSink(struct ZrLogSink **ppSink,
+                        ZrLogSinkFunction pfnFunction,
+                        void *pData);
+
+ZRP_LOGGER_LINKAGE void
+zrDestroyLogSink(struct ZrLogSink *pSink);
+
+ZRP_LOGGER_LINKAGE void
+zrSetLogSinkLevel(struct ZrLogSink *pSink, enum ZrLogLevel level);
+
+ZRP_LOGGER_LINKAGE void
+zrAddLogSink(struct ZrLogSink *pSink);
+
+ZRP_LOGGER_LINKAGE void
+zrRemoveLogSink(struct ZrLogSink *pSink);
+
+/*
+   Write the content of a memory sink to a file descriptor without taking any
+   lock, making it usable from a signal handler. The oldest record may be
+   partially overwritten.
+*/
+ZRP_LOGGER_LINKAGE void
+zrDumpMemoryLogSink(const struct ZrLogSink *pSink, int fd);
+
+/*
+   The logging macros check the level of a record before evaluating any of
+   its arguments, first against the maximum level set at compile time with
+   the `ZR_SET_LOGGING_LEVEL_*` and `ZR_DISABLE_LOGGING` macros, which
+   removes the more verbose call sites from the build altogether, and then
+   against the level set at runtime, either for the given module or globally.
+
+   Modules inherit the global level until they are given their own. Each call
+   site can also be enabled on its own by its file and line, regardless of
+   the levels, once it has been reached at least once.
+
+   The runtime levels can be changed at any time from any thread. They only
+   apply to the logging macros, not to direct calls to `zrLog()`.
+*/
+
+#if defined(ZR_SET_LOGGING_LEVEL_DEBUG)
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_DEBUG
+#elif defined(ZR_SET_LOGGING_LEVEL_TRACE)
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_TRACE
+#elif defined(ZR_SET_LOGGING_LEVEL_INFO)
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_INFO
+#elif defined(ZR_SET_LOGGING_LEVEL_WARNING)
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_WARNING
+#elif defined(ZR_SET_LOGGING_LEVEL_ERROR)
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_ERROR
+#elif defined(ZR_ENABLE_DEBUGGING)                                             \
+    || (!defined(ZR_DISABLE_DEBUGGING)                                         \
+        && (defined(DEBUG) || !defined(NDEBUG)))
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_DEBUG
+#else
+#define ZRP_LOGGER_MAX_LEVEL ZR_LOG_LEVEL_WARNING
+#endif
+
+#ifdef ZR_DISABLE_LOGGING
+#define ZRP_LOGGER_LOGGING 0
+#else
+#define ZRP_LOGGER_LOGGING 1
+#endif /* ZR_DISABLE_LOGGING */
+
+#define ZRP_LOG_MODULE_LEVEL_INHERITED -1
+
+#define ZRP_LOG_SITE_STATE_REGISTERED 0x1
+#define ZRP_LOG_SITE_STATE_ENABLED 0x2
+
+#define ZR_LOG_TARGET_OUTPUT 0x1
+#define ZR_LOG_TARGET_FLIGHT_RECORDER 0x2
+
+struct ZrLogModule {
+    const char *pName;
+    volatile int level;
+};
+
+struct ZrLogSite {
+    const char *pFile;
+    int line;
+    volatile int state;
+    struct ZrLogSite *pNext;
+};
+
+#define ZR_LOG_MODULE_INITIALIZER(name)                                        \
+    {                                                                          \
+        name, ZRP_LOG_MODULE_LEVEL_INHERITED                                   \
+    }
+
+#define ZR_LOG_MODULE_MESSAGE(pModule, level, ...)                             \
+    do {                                                                       \
+        if (ZRP_LOGGER_LOGGING && (level) <= ZRP_LOGGER_MAX_LEVEL) {           \
+            static struct ZrLogSite zrpLogSite                                 \
+                = {__FILE__, __LINE__, 0, 0};                                  \
+                                                                               \
+            int zrpLogTargets;                                                 \
+                                                                               \
+            zrpLogTargets = zrGetLogSiteTargets(&zrpLogSite, pModule, level);  \
+            if (zrpLogTargets) {                                               \
+                ZRP_LOG_TO_TARGETS(zrpLogTargets, level, __VA_ARGS__);         \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+#define ZR_LOG_MESSAGE(level, ...)                                             \
+    ZR_LOG_MODULE_MESSAGE(0, level, __VA_ARGS__)
+
+#define ZR_LOG_DEBUG(...) ZR_LOG_MESSAGE(ZR_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define ZR_LOG_TRACE(...) ZR_LOG_MESSAGE(ZR_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#define ZR_LOG_INFO(...) ZR_LOG_MESSAGE(ZR_LOG_LEVEL_INFO, __VA_ARGS__)
+
+#define ZR_LOG_WARNING(...) ZR_LOG_MESSAGE(ZR_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+#define ZR_LOG_ERROR(...) ZR_LOG_MESSAGE(ZR_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+ZRP_LOGGER_LINKAGE void
+zrSetLogLevel(enum ZrLogLevel level);
+
+ZRP_LOGGER_LINKAGE enum ZrLogLevel
+zrGetLogLevel(void);
+
+ZRP_LOGGER_LINKAGE void
+zrSetLogModuleLevel(struct ZrLogModule *pModule, enum ZrLogLevel level);
+
+ZRP_LOGGER_LINKAGE void
+zrResetLogModuleLevel(struct ZrLogModule *pModule);
+
+/*
+   Force the call sites at the given location to be enabled, or make them
+   follow the levels again. Returns `ZR_ERROR` if no such call site has been
+   reached yet.
+*/
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrSetLogSiteEnabled(const char *pFile, int line, int enabled);
+
+/*
+   Return where a record logged from the given call site is to be written,
+   as a combination of `ZR_LOG_TARGET_*` flags, or 0 if nowhere.
+*/
+ZRP_LOGGER_LINKAGE int
+zrGetLogSiteTargets(struct ZrLogSite *pSite,
+                    const struct ZrLogModule *pModule,
+                    enum ZrLogLevel level);
+
+/* Same as `zrLog()` but only for the given targets. */
+ZRP_LOGGER_LINKAGE void
+zrLogToTargets(int targets,
+               enum ZrLogLevel level,
+               const char *pFile,
+               int line,
+               const char *pFormat,
+               ...);
+
+/*
+   Used by the C++ front-end of the logging macros, which packs the arguments
+   of the records itself when their formatting is deferred. Return whether
+   the packed arguments were handled, or 0 if the record must go through
+   `zrLogToTargets()` instead.
+*/
+ZRP_LOGGER_LINKAGE int
+zrIsLogFormattingDeferred(int targets);
+
+ZRP_LOGGER_LINKAGE int
+zrLogPackedArguments(int targets,
+                     enum ZrLogLevel level,
+                     const char *pFile,
+                     int line,
+                     const char *pFormat,
+                     const void *pArguments,
+                     ZrSize size);
+
+/*
+   In C++11, the logging macros parse their format at compile time and fail
+   to build if the types of their arguments don't match its conversions,
+   which requires the format to be a string literal. The
+   `ZR_DISABLE_LOG_FORMAT_CHECKS` macro restores the plain variadic calls.
+
+   When the asynchronous mode defers the formatting, the arguments are then
+   packed by type into a fixed-size buffer instead of being captured through
+   a `va_list` by parsing the format again on the calling thread.
+*/
+
+#if defined(__cplusplus) && !defined(ZR_DISABLE_LOG_FORMAT_CHECKS)             \
+    && (__cplusplus >= 201103L                                                 \
+        || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+#define ZRP_LOGGER_FORMAT_CHECKS 1
+#else
+#define ZRP_LOGGER_FORMAT_CHECKS 0
+#endif
+
+#if ZRP_LOGGER_FORMAT_CHECKS
+#include <type_traits>
+
+/* Spelled without `<stddef.h>` to keep it out of the public section. */
+typedef decltype(sizeof 0) ZrpLogSizeType;
+typedef decltype(static_cast<char *>(nullptr) - static_cast<char *>(nullptr))
+    ZrpLogPtrdiffType;
+
+#define ZRP_LOG_PACKED_ARGUMENTS_SIZE 256
+
+#define ZRP_LOG_ARGUMENT_INVALID 0
+#define ZRP_LOG_ARGUMENT_INTEGER 0x100
+#define ZRP_LOG_ARGUMENT_FLOAT 0x200
+#define ZRP_LOG_ARGUMENT_STRING 0x300
+#define ZRP_LOG_ARGUMENT_POINTER 0x400
+#define ZRP_LOG_ARGUMENT_CATEGORY_MASK 0xF00
+
+#define ZRP_LOG_FORMAT_PACKABLE 1
+#define ZRP_LOG_FORMAT_VALID 0
+#define ZRP_LOG_FORMAT_TOO_FEW_ARGUMENTS -1
+#define ZRP_LOG_FORMAT_TOO_MANY_ARGUMENTS -2
+#define ZRP_LOG_FORMAT_MISMATCH -3
+#define ZRP_LOG_FORMAT_INVALID_CONVERSION -4
+
+#define ZRP_LOG_MODIFIER_NONE 0
+#define ZRP_LOG_MODIFIER_HH 1
+#define ZRP_LOG_MODIFIER_H 2
+#define ZRP_LOG_MODIFIER_LL 3
+#define ZRP_LOG_MODIFIER_L 4
+#define ZRP_LOG_MODIFIER_Z 5
+#define ZRP_LOG_MODIFIER_T 6
+#define ZRP_LOG_MODIFIER_J 7
+#define ZRP_LOG_MODIFIER_LONG_DOUBLE 8
+
+/*
+   Arguments are identified by their category and by their size once
+   promoted, which is what matters when reading them back from a `va_list`.
+   Character pointers are assumed to be strings.
+*/
+template<typename T>
+struct ZrpLogArgumentKind {
+    static constexpr int value
+        = std::is_pointer<T>::value
+              ? (std::is_same<typename std::remove_cv<
+                                  typename std::remove_pointer<T>::type>::type,
+                              char>::value
+                         || std::is_same<
+                             typename std::remove_cv<
+                                 typename std::remove_pointer<T>::type>::type,
+                             signed char>::value
+                         || std::is_same<
+                             typename std::remove_cv<
+                                 typename std::remove_pointer<T>::type>::type,
+                             unsigned char>::value
+                     ? ZRP_LOG_ARGUMENT_STRING
+                     : ZRP_LOG_ARGUMENT_POINTER)
+          : std::is_same<T, std::nullptr_t>::value ? ZRP_LOG_ARGUMENT_POINTER
+          : std::is_integral<T>::value || std::is_enum<T>::value
+              ? ZRP_LOG_ARGUMENT_INTEGER
+                    | (int)(sizeof(T) < sizeof(int) ? sizeof(int) : sizeof(T))
+          : std::is_floating_point<T>::value
+              ? ZRP_LOG_ARGUMENT_FLOAT
+                    | (int)(sizeof(T) < sizeof(double) ? sizeof(double)
+                                                       : sizeof(T))
+              : ZRP_LOG_ARGUMENT_INVALID;
+};
+
+static constexpr const char *
+zrpLogFindConversion(const char *pFormat)
+{
+    /* Look at a few characters at once to keep the recursion shallow. */
+    return *pFormat == '\0' || *pFormat == '%' ? pFormat
+           : pFormat[1] == '\0' || pFormat[1] == '%' ? pFormat + 1
+           : pFormat[2] == '\0' || pFormat[2] == '%' ? pFormat + 2
+           : pFormat[3] == '\0' || pFormat[3] == '%'
+               ? pFormat + 3
+               : zrpLogFindConversion(pFormat + 4);
+}
+
+static constexpr const char *
+zrpLogSkipFlags(const char *pFormat)
+{
+    return *pFormat == '-' || *pFormat == '+' || *pFormat == ' '
+                   || *pFormat == '#' || *pFormat == '0'
+               ? zrpLogSkipFlags(pFormat + 1)
+               : pFormat;
+}
+
+static constexpr const char *
+zrpLogSkipDigits(const char *pFormat)
+{
+    return *pFormat >= '0' && *pFormat <= '9' ? zrpLogSkipDigits(pFormat + 1)
+                                               : pFormat;
+}
+
+/* Return a pointer to the precision of the conversion at the given '%'. */
+static constexpr const char *
+zrpLogGetPrecision(const char *pStart)
+{
+    return *zrpLogSkipFlags(pStart + 1) == '*'
+               ? zrpLogSkipFlags(pStart + 1) + 1
+               : zrpLogSkipDigits(zrpLogSkipFlags(pStart + 1));
+}
+
+/* Return a pointer to the length modifier of the conversion. */
+static constexpr const char *
+zrpLogGetModifier(const char *pStart)
+{
+    return *zrpLogGetPrecision(pStart) != '.' ? zrpLogGetPrecision(pStart)
+           : zrpLogGetPrecision(pStart)[1] == '*'
+               ? zrpLogGetPrecision(pStart) + 2
+               : zrpLogSkipDigits(zrpLogGetPrecision(pStart) + 1);
+}
+
+static constexpr int
+zrpLogGetModifierType(const char *pModifier)
+{
+    return pModifier[0] == 'h'
+               ? (pModifier[1] == 'h' ? ZRP_LOG_MODIFIER_HH
+                                      : ZRP_LOG_MODIFIER_H)
+           : pModifier[0] == 'l'
+               ? (pModifier[1] == 'l' ? ZRP_LOG_MODIFIER_LL
+                                      : ZRP_LOG_MODIFIER_L)
+           : pModifier[0] == 'z' ? ZRP_LOG_MODIFIER_Z
+           : pModifier[0] == 't' ? ZRP_LOG_MODIFIER_T
+           : pModifier[0] == 'j' ? ZRP_LOG_MODIFIER_J
+           : pModifier[0] == 'L' ? ZRP_LOG_MODIFIER_LONG_DOUBLE
+                                 : ZRP_LOG_MODIFIER_NONE;
+}
+
+/* Return a pointer to the conversion specifier of the conversion. */
+static constexpr const char *
+zrpLogGetSpecifier(const char *pStart)
+{
+    return zrpLogGetModifier(pStart)
+           + (zrpLogGetModifierType(zrpLogGetModifier(pStart))
+                      == ZRP_LOG_MODIFIER_NONE
+                  ? 0
+              : zrpLogGetModifierType(zrpLogGetModifier(pStart))
+                          == ZRP_LOG_MODIFIER_HH
+                      || zrpLogGetModifierType(zrpLogGetModifier(pStart))
+                             == ZRP_LOG_MODIFIER_LL
+                  ? 2
+                  : 1);
+}
+
+static constexpr int
+zrpLogGetStarCount(const char *pStart)
+{
+    return (*zrpLogSkipFlags(pStart + 1) == '*')
+           + (zrpLogGetPrecision(pStart)[0] == '.'
+              && zrpLogGetPrecision(pStart)[1] == '*');
+}
+
+static constexpr int
+zrpLogGetIntegerKind(int modifier)
+{
+    return modifier == ZRP_LOG_MODIFIER_NONE || modifier == ZRP_LOG_MODIFIER_HH
+                   || modifier == ZRP_LOG_MODIFIER_H
+               ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(int)
+           : modifier == ZRP_LOG_MODIFIER_L
+               ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(long)
+           : modifier == ZRP_LOG_MODIFIER_LL || modifier == ZRP_LOG_MODIFIER_J
+               ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(long long)
+           : modifier == ZRP_LOG_MODIFIER_Z
+               ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(ZrpLogSizeType)
+           : modifier == ZRP_LOG_MODIFIER_T
+               ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(ZrpLogPtrdiffType)
+               : ZRP_LOG_ARGUMENT_INVALID;
+}
+
+static constexpr int
+zrpLogGetConversionKind(int modifier, char specifier)
+{
+    return specifier == 'd' || specifier == 'i' || specifier == 'u'
+                   || specifier == 'o' || specifier == 'x' || specifier == 'X'
+               ? zrpLogGetIntegerKind(modifier)
+           : specifier == 'c'
+               ? (modifier == ZRP_LOG_MODIFIER_NONE
+                          || modifier == ZRP_LOG_MODIFIER_L
+                      ? ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(int)
+                      : ZRP_LOG_ARGUMENT_INVALID)
+           : specifier == 'e' || specifier == 'E' || specifier == 'f'
+                   || specifier == 'F' || specifier == 'g' || specifier == 'G'
+                   || specifier == 'a' || specifier == 'A'
+               ? (modifier == ZRP_LOG_MODIFIER_NONE
+                          || modifier == ZRP_LOG_MODIFIER_L
+                      ? ZRP_LOG_ARGUMENT_FLOAT | (int)sizeof(double)
+                  : modifier == ZRP_LOG_MODIFIER_LONG_DOUBLE
+                      ? ZRP_LOG_ARGUMENT_FLOAT | (int)sizeof(long double)
+                      : ZRP_LOG_ARGUMENT_INVALID)
+           : specifier == 's'
+               ? (modifier == ZRP_LOG_MODIFIER_NONE
+                      ? ZRP_LOG_ARGUMENT_STRING
+                  : modifier == ZRP_LOG_MODIFIER_L
+                      ? ZRP_LOG_ARGUMENT_POINTER
+                      : ZRP_LOG_ARGUMENT_INVALID)
+           : specifier == 'p' && modifier == ZRP_LOG_MODIFIER_NONE
+               ? ZRP_LOG_ARGUMENT_POINTER
+               : ZRP_LOG_ARGUMENT_INVALID;
+}
+
+/* Return the kind of the argument that the conversion prints. */
+static constexpr int
+zrpLogGetExpectedKind(const char *pStart)
+{
+    /* Positional arguments aren't supported. */
+    return *zrpLogGetPrecision(pStart) == '$'
+               ? ZRP_LOG_ARGUMENT_INVALID
+               : zrpLogGetConversionKind(
+                   zrpLogGetModifierType(zrpLogGetModifier(pStart)),
+                   *zrpLogGetSpecifier(pStart));
+}
+
+/*
+   Return whether the deferred formatting supports the conversion, in which
+   case the argument can be packed according to its own type.
+
+   This must accept no more than `zrpLoggerParseConversion()` does on the
+   background thread, which rejects conversions longer than
+   `ZRP_LOGGER_MAX_CONVERSION_SIZE`, the `j` modifier, and any modifier on
+   `c` and `s`.
+*/
+static constexpr int
+zrpLogIsPackable(const char *pStart, int kind)
+{
+    return zrpLogGetSpecifier(pStart) - pStart < 32
+           && zrpLogGetModifierType(zrpLogGetModifier(pStart))
+                  != ZRP_LOG_MODIFIER_J
+           && zrpLogGetExpectedKind(pStart) == kind
+           && ((*zrpLogGetSpecifier(pStart) != 'c'
+                && *zrpLogGetSpecifier(pStart) != 's')
+               || zrpLogGetModifierType(zrpLogGetModifier(pStart))
+                      == ZRP_LOG_MODIFIER_NONE)
+           && (kind != ZRP_LOG_ARGUMENT_STRING
+               || *zrpLogGetPrecision(pStart) != '.');
+}
+
+static constexpr int
+zrpLogMatchesKind(int expected, int kind)
+{
+    return expected == kind
+           || (expected == ZRP_LOG_ARGUMENT_POINTER
+               && kind == ZRP_LOG_ARGUMENT_STRING);
+}
+
+template<typename... K>
+static constexpr int
+zrpLogCheckFormat(const char *pFormat, int result, K... kinds);
+
+static constexpr int
+zrpLogCheckArgument(const char *pStart,
+                    int /* starCount */,
+                    int /* result */)
+{
+    return zrpLogGetExpectedKind(pStart) == ZRP_LOG_ARGUMENT_INVALID
+               ? ZRP_LOG_FORMAT_INVALID_CONVERSION
+               : ZRP_LOG_FORMAT_TOO_FEW_ARGUMENTS;
+}
+
+/* Match the next argument against the conversion at the given '%'. */
+template<typename... K>
+static constexpr int
+zrpLogCheckArgument(const char *pStart,
+                    int starCount,
+                    int result,
+                    int kind,
+                    K... kinds)
+{
+    return starCount > 0
+               ? (zrpLogMatchesKind(ZRP_LOG_ARGUMENT_INTEGER | (int)sizeof(int),
+                                    kind)
+                      ? zrpLogCheckArgument(
+                          pStart, starCount - 1, result, kinds...)
+                      : ZRP_LOG_FORMAT_MISMATCH)
+           : zrpLogGetExpectedKind(pStart) == ZRP_LOG_ARGUMENT_INVALID
+               ? ZRP_LOG_FORMAT_INVALID_CONVERSION
+           : zrpLogMatchesKind(zrpLogGetExpectedKind(pStart), kind)
+               ? zrpLogCheckFormat(zrpLogGetSpecifier(pStart) + 1,
+                                   result & zrpLogIsPackable(pStart, kind),
+                                   kinds...)
+               : ZRP_LOG_FORMAT_MISMATCH;
+}
+
+template<typename... K>
+static constexpr int
+zrpLogCheckConversion(const char *pStart, int result, K... kinds)
+{
+    return *pStart == '\0'
+               ? (sizeof...(kinds) == 0 ? result
+                                        : ZRP_LOG_FORMAT_TOO_MANY_ARGUMENTS)
+           : pStart[1] == '%'
+               ? zrpLogCheckFormat(pStart + 2, result, kinds...)
+               : zrpLogCheckArgument(
+                   pStart, zrpLogGetStarCount(pStart), result, kinds...);
+}
+
+template<typename... K>
+static constexpr int
+zrpLogCheckFormat(const char *pFormat, int result, K... kinds)
+{
+    return zrpLogCheckConversion(
+        zrpLogFindConversion(pFormat), result, kinds...);
+}
+
+template<typename... T>
+struct ZrpLogArguments {
+    static constexpr int
+    check(const char *pFormat)
+    {
+        return zrpLogCheckFormat(pFormat,
+                                 ZRP_LOG_FORMAT_PACKABLE,
+                                 ZrpLogArgumentKind<T>::value...);
+    }
+};
+
+/* Only used to deduce the types of the arguments, as decayed by a call. */
+template<typename... T>
+static ZrpLogArguments<T...>
+zrpLogGetArguments(const char *pFormat, T... args);
+
+static inline void
+zrpLogCopyBytes(void *pDestination, const void *pSource, ZrpLogSizeType size)
+{
+#if defined(__GNUC__)
+    __builtin_memcpy(pDestination, pSource, size);
+#else
+    ZrpLogSizeType i;
+
+    for (i = 0; i < size; ++i) {
+        static_cast<char *>(pDestination)[i]
+            = static_cast<const char *>(pSource)[i];
+    }
+#endif
+}
+
+static inline ZrpLogSizeType
+zrpLogGetStringLength(const char *pString)
+{
+#if defined(__GNUC__)
+    return __builtin_strlen(pString);
+#else
+    ZrpLogSizeType length;
+
+    length = 0;
+    while (pString[length] != '\0') {
+        ++length;
+    }
+
+    return length;
+#endif
+}
+
+static inline int
+zrpLogPackBytes(char *pBuffer,
+                ZrpLogSizeType *pSize,
+                const void *pData,
+                ZrpLogSizeType size)
+{
+    if (ZRP_LOG_PACKED_ARGUMENTS_SIZE - *pSize < size) {
+        return 0;
+    }
+
+    zrpLogCopyBytes(&pBuffer[*pSize], pData, size);
+    *pSize += size;
+    return 1;
+}
+
+template<typename T>
+static inline int
+zrpLogPackArgument(
+    char *pBuffer,
+    ZrpLogSizeType *pSize,
+    const T &value,
+    std::integral_constant<int, ZRP_LOG_ARGUMENT_INTEGER> /* category */)
+{
+    typename std::conditional<(sizeof(T) < sizeof(int)), int, T>::type
+        promoted;
+
+    promoted = static_cast<decltype(promoted)>(value);
+    return zrpLogPackBytes(pBuffer, pSize, &promoted, sizeof promoted);
+}
+
+template<typename T>
+static inline int
+zrpLogPackArgument(
+    char *pBuffer,
+    ZrpLogSizeType *pSize,
+    const T &value,
+    std::integral_constant<int, ZRP_LOG_ARGUMENT_FLOAT> /* category */)
+{
+    typename std::conditional<(sizeof(T) < sizeof(double)), double, T>::type
+        promoted;
+
+    promoted = value;
+    return zrpLogPackBytes(pBuffer, pSize, &promoted, sizeof promoted);
+}
+
+template<typename T>
+static inline int
+zrpLogPackArgument(
+    char *pBuffer,
+    ZrpLogSizeType *pSize,
+    const T &value,
+    std::integral_constant<int, ZRP_LOG_ARGUMENT_POINTER> /* category */)
+{
+    const void *pValue;
+
+    static_assert(sizeof value == sizeof pValue, "unsupported pointer size");
+
+    /* Null pointer constants don't have any defined representation. */
+    pValue = nullptr;
+    if (!std::is_same<T, std::nullptr_t>::value) {
+        zrpLogCopyBytes(&pValue, &value, sizeof pValue);
+    }
+
+    return zrpLogPackBytes(pBuffer, pSize, &pValue, sizeof pValue);
+}
+
+/* Strings are copied with their length, as `zrLogToTargets()` would. */
+template<typename T>
+static inline int
+zrpLogPackArgument(
+    char *pBuffer,
+    ZrpLogSizeType *pSize,
+    const T &value,
+    std::integral_constant<int, ZRP_LOG_ARGUMENT_STRING> /* category */)
+{
+    const char *pString;
+    ZrpLogSizeType length;
+
+    pString = value != nullptr ? reinterpret_cast<const char *>(value)
+                            : "(null)";
+    length = zrpLogGetStringLength(pString);
+    return zrpLogPackBytes(pBuffer, pSize, &length, sizeof length)
+           && zrpLogPackBytes(pBuffer, pSize, pString, length + 1);
+}
+
+static inline int
+zrpLogPackArguments(char *pBuffer, ZrpLogSizeType *pSize)
+{
+    (void)pBuffer;
+    (void)pSize;
+    return 1;
+}
+
+template<typename T, typename... U>
+static inline int
+zrpLogPackArguments(char *pBuffer,
+                    ZrpLogSizeType *pSize,
+                    const T &first,
+                    const U &... rest)
+{
+    typedef typename std::decay<const T>::type Type;
+
+    return zrpLogPackArgument<Type>(
+               pBuffer,
+               pSize,
+               first,
+               std::integral_constant<int,
+                                      ZrpLogArgumentKind<Type>::value
+                                          & ZRP_LOG_ARGUMENT_CATEGORY_MASK>())
+           && zrpLogPackArguments(pBuffer, pSize, rest...);
+}
+
+template<typename... T>
+static inline void
+zrpLogToTargets(std::false_type /* packable */,
+                int targets,
+                enum ZrLogLevel level,
+                const char *pFile,
+                int line,
+                const char *pFormat,
+                const T &... args)
+{
+    zrLogToTargets(targets, level, pFile, line, pFormat, args...);
+}
+
+template<typename... T>
+static inline void
+zrpLogToTargets(std::true_type /* packable */,
+                int targets,
+                enum ZrLogLevel level,
+                const char *pFile,
+                int line,
+                const char *pFormat,
+                const T &... args)
+{
+    char buffer[ZRP_LOG_PACKED_ARGUMENTS_SIZE];
+    ZrpLogSizeType size;
+
+    size = 0;
+    if (zrIsLogFormattingDeferred(targets)
+        && zrpLogPackArguments(buffer, &size, args...)
+        && zrLogPackedArguments(
+            targets, level, pFile, line, pFormat, buffer, (ZrSize)size)) {
+        return;
+    }
+
+    zrLogToTargets(targets, level, pFile, line, pFormat, args...);
+}
+
+#define ZRP_LOG_EXPAND(x) x
+
+#define ZRP_LOG_GET_FIRST(first, ...) first
+
+#define ZRP_LOG_GET_FORMAT(...)                                                \
+    ZRP_LOG_EXPAND(ZRP_LOG_GET_FIRST(__VA_ARGS__, 0))
+
+#define ZRP_LOG_TO_TARGETS(targets, level, ...)                                \
+    do {                                                                       \
+        typedef std::integral_constant<                                        \
+            int,                                                               \
+            decltype(zrpLogGetArguments(__VA_ARGS__))::check(                  \
+                ZRP_LOG_GET_FORMAT(__VA_ARGS__))>                              \
+            ZrpLogFormatResult;                                                \
+                                                                               \
+        static_assert(ZrpLogFormatResult::value                                \
+                          != ZRP_LOG_FORMAT_TOO_FEW_ARGUMENTS,                 \
+                      "too few arguments for the log format");                 \
+        static_assert(ZrpLogFormatResult::value                                \
+                          != ZRP_LOG_FORMAT_TOO_MANY_ARGUMENTS,                \
+                      "too many arguments for the log format");                \
+        static_assert(ZrpLogFormatResult::value != ZRP_LOG_FORMAT_MISMATCH,    \
+                      "log argument not matching its conversion");             \
+        static_assert(ZrpLogFormatResult::value                                \
+                          != ZRP_LOG_FORMAT_INVALID_CONVERSION,                \
+                      "unsupported conversion in the log format");             \
+        zrpLogToTargets(                                                       \
+            std::integral_constant<bool,                                       \
+                                   ZrpLogFormatResult::value                   \
+                                       == ZRP_LOG_FORMAT_PACKABLE>(),          \
+            targets,                                                           \
+            level,                                                             \
+            __FILE__,                                                          \
+            __LINE__,                                                          \
+            __VA_ARGS__);                                                      \
+    } while (0)
+#else
+#define ZRP_LOG_TO_TARGETS(targets, level, ...)                                \
+    zrLogToTargets(targets, level, __FILE__, __LINE__, __VA_ARGS__)
+#endif /* ZRP_LOGGER_FORMAT_CHECKS */
+
+/*
+   Rate-limited variants of the logging macros, keeping their state in each
+   call site: `ZR_LOG_EVERY_N()` logs one record out of `n`,
+   `ZR_LOG_FIRST_N()` logs only the first `n` records, and `ZR_LOG_EVERY_MS()`
+   logs at most one record every `ms` milliseconds, as measured with
+   a coarse monotonic clock that may only advance every few milliseconds.
+   Only the records passing the level checks are counted.
+
+   When a call site logs again after having suppressed some records, it first
+   logs the number of records that were suppressed.
+*/
+
+enum ZrLogLimitType {
+    ZR_LOG_LIMIT_TYPE_EVERY_N = 0,
+    ZR_LOG_LIMIT_TYPE_FIRST_N = 1,
+    ZR_LOG_LIMIT_TYPE_EVERY_MS = 2
+};
+
+struct ZrLogLimit {
+    volatile ZrSize count;
+    volatile ZrSize suppressedCount;
+    volatile ZrSize time;
+};
+
+#define ZRP_LOG_LIMITED(level, type, value, ...)                               \
+    do {                                                                       \
+        if (ZRP_LOGGER_LOGGING && (level) <= ZRP_LOGGER_MAX_LEVEL) {           \
+            static struct ZrLogSite zrpLogSite                                 \
+                = {__FILE__, __LINE__, 0, 0};                                  \
+            static struct ZrLogLimit zrpLogLimit;                              \
+            ZrSize zrpLogSuppressedCount;                                      \
+                                                                               \
+            if ((zrGetLogSiteTargets(&zrpLogSite, 0, level)                    \
+                 & ZR_LOG_TARGET_OUTPUT)                                       \
+                && zrCheckLogLimit(                                            \
+                    &zrpLogLimit, type, value, &zrpLogSuppressedCount)) {      \
+                if (zrpLogSuppressedCount > 0) {                               \
+                    zrLog(level,                                               \
+                          __FILE__,                                            \
+                          __LINE__,                                            \
+                          "suppressed %lu records\n",                          \
+                          (unsigned long)zrpLogSuppressedCount);               \
+                }                                                              \
+                                                                               \
+                ZRP_LOG_TO_TARGETS(ZR_LOG_TARGET_OUTPUT                        \
+                                       | ZR_LOG_TARGET_FLIGHT_RECORDER,        \
+                                   level,                                      \
+                                   __VA_ARGS__);                               \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+#define ZR_LOG_EVERY_N(level, n, ...)                                          \
+    ZRP_LOG_LIMITED(level, ZR_LOG_LIMIT_TYPE_EVERY_N, n, __VA_ARGS__)
+
+#define ZR_LOG_FIRST_N(level, n, ...)                                          \
+    ZRP_LOG_LIMITED(level, ZR_LOG_LIMIT_TYPE_FIRST_N, n, __VA_ARGS__)
+
+#define ZR_LOG_EVERY_MS(level, ms, ...)                                        \
+    ZRP_LOG_LIMITED(level, ZR_LOG_LIMIT_TYPE_EVERY_MS, ms, __VA_ARGS__)
+
+/*
+   Count a call against the given limit and return whether the record is to
+   be logged, along with the number of records suppressed since the last one
+   that was logged.
+*/
+ZRP_LOGGER_LINKAGE int
+zrCheckLogLimit(struct ZrLogLimit *pLimit,
+                enum ZrLogLimitType type,
+                ZrSize value,
+                ZrSize *pSuppressedCount);
+
+/*
+   Structured records are made of a message and of typed key/value fields,
+   encoded either as JSON lines or as logfmt lines, which always start with
+   the following keys:
+
+   - ts: UTC time in the ISO 8601 format, with microseconds.
+   - level: name of the level.
+   - thread: identifier of the thread, as known by the system when available,
+     which is the same as in the prefixes of the text records.
+   - file: file of the call site.
+   - line: line of the call site.
+   - msg: message.
+
+   The fields are encoded without going through `printf()`. Floating-point
+   values are written with 15 significant digits, and the values that JSON
+   can't represent are written as `null`.
+*/
+
+enum ZrLogEncoding { ZR_LOG_ENCODING_JSON = 0, ZR_LOG_ENCODING_LOGFMT = 1 };
+
+enum ZrLogFieldType {
+    ZR_LOG_FIELD_TYPE_STRING = 0,
+    ZR_LOG_FIELD_TYPE_INT = 1,
+    ZR_LOG_FIELD_TYPE_UINT = 2,
+    ZR_LOG_FIELD_TYPE_DOUBLE = 3,
+    ZR_LOG_FIELD_TYPE_BOOL = 4
+};
+
+struct ZrLogField {
+    const char *pKey;
+    enum ZrLogFieldType type;
+    const char *pString;
+    ZrInt64 intValue;
+    ZrUint64 uintValue;
+    double doubleValue;
+};
+
+#define ZR_LOG_STRING_FIELD(key, value)                                        \
+    {                                                                          \
+        key, ZR_LOG_FIELD_TYPE_STRING, value, 0, 0, 0.0                        \
+    }
+
+#define ZR_LOG_INT_FIELD(key, value)                                           \
+    {                                                                          \
+        key, ZR_LOG_FIELD_TYPE_INT, 0, (ZrInt64)(value), 0, 0.0                \
+    }
+
+#define ZR_LOG_UINT_FIELD(key, value)                                          \
+    {                                                                          \
+        key, ZR_LOG_FIELD_TYPE_UINT, 0, 0, (ZrUint64)(value), 0.0              \
+    }
+
+#define ZR_LOG_DOUBLE_FIELD(key, value)                                        \
+    {                                                                          \
+        key, ZR_LOG_FIELD_TYPE_DOUBLE, 0, 0, 0, (double)(value)                \
+    }
+
+#define ZR_LOG_BOOL_FIELD(key, value)                                          \
+    {                                                                          \
+        key, ZR_LOG_FIELD_TYPE_BOOL, 0, (value) ? 1 : 0, 0, 0.0                \
+    }
+
+/*
+   Log a structured record with the fields given as `ZR_LOG_*_FIELD()`
+   initializers, which are only evaluated if the record passes the level
+   checks.
+*/
+#define ZR_LOG_FIELDS(level, pMessage, ...)                                    \
+    do {                                                                       \
+        if (ZRP_LOGGER_LOGGING && (level) <= ZRP_LOGGER_MAX_LEVEL) {           \
+            static struct ZrLogSite zrpLogSite                                 \
+                = {__FILE__, __LINE__, 0, 0};                                  \
+                                                                               \
+            if (zrGetLogSiteTargets(&zrpLogSite, 0, level)                     \
+                & ZR_LOG_TARGET_OUTPUT) {                                      \
+                const struct ZrLogField zrpLogFields[] = {__VA_ARGS__};        \
+                                                                               \
+                zrLogFields(level,                                             \
+                            __FILE__,                                          \
+                            __LINE__,                                          \
+                            pMessage,                                          \
+                            zrpLogFields,                                      \
+                            sizeof zrpLogFields / sizeof zrpLogFields[0]);     \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+ZRP_LOGGER_LINKAGE void
+zrSetLogEncoding(enum ZrLogEncoding encoding);
+
+ZRP_LOGGER_LINKAGE void
+zrLogFields(enum ZrLogLevel level,
+            const char *pFile,
+            int line,
+            const char *pMessage,
+            const struct ZrLogField *pFields,
+            ZrSize fieldCount);
+
+/*
+   The flight recorder keeps the most recent records of each thread in a ring
+   of its own, at all levels, without writing them anywhere. While it runs,
+   the logging macros also format the records that the runtime levels filter
+   out, for the recorder only. Records above the maximum level set at compile
+   time remain compiled out.
+
+   Each thread allocates its ring on its first record, and the rings are only
+   released when stopping the recorder. Starting and stopping the recorder is
+   not thread-safe and must not happen while other threads may be logging.
+
+   `zrDumpFlightRecorder()` takes no lock and only calls `write()`, making it
+   usable from a signal handler, such as the one that
+   `zrInstallFlightRecorderCrashHandler()` installs for `SIGSEGV` and
+   `SIGABRT`, which dumps the rings before letting the signal terminate the
+   process. The oldest record of each ring may be partially overwritten.
+*/
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrLoggerStartFlightRecorder(ZrSize ringSize);
+
+ZRP_LOGGER_LINKAGE void
+zrLoggerStopFlightRecorder(void);
+
+ZRP_LOGGER_LINKAGE void
+zrDumpFlightRecorder(int fd);
+
+ZRP_LOGGER_LINKAGE enum ZrStatus
+zrInstallFlightRecorderCrashHandler(int fd);
+
 #endif /* ZERO_LOGGER_H */
 
 #ifdef ZR_DEFINE_IMPLEMENTATION
 #ifndef ZRP_LOGGER_IMPLEMENTATION_DEFINED
 #define ZRP_LOGGER_IMPLEMENTATION_DEFINED
 
+#include <errno.h>
+#include <float.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#include <io.h>
+#endif
+
+#include "allocator.h"
 
 #ifndef ZR_ASSERT
 #include <assert.h>
 #define ZR_ASSERT assert
 #endif /* ZR_ASSERT */
 
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
 /* @include "partials/unused.h" */
+/* @include "partials/logging.h" */
 /* @include "partials/logger.h" */
+/* @include "partials/atomics.h" */
+/* @include "partials/threads.h" */
+/* @include "partials/clock.h" */
 
-ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
-zrLog(enum ZrLogLevel level,
-      const char *pFile,
-      int line,
-      const char *pFormat,
-      ...)
+#if defined(ZRP_PLATFORM_UNIX) && !defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+#include <sys/time.h>
+#endif
+
+#if !defined(ZRP_LOGGER_THREAD_LOCAL)
+typedef char zrp_logger_unsupported_compiler[-1];
+#endif
+
+#if !defined(ZRP_LOGGER_USE_VSNPRINTF)
+typedef char zrp_logger_missing_vsnprintf[-1];
+#endif
+
+#if defined(ZRP_PLATFORM_UNIX) && defined(_POSIX_C_SOURCE)                     \
+    && _POSIX_C_SOURCE >= 1
+#define ZRP_LOGGER_USE_SIGACTION
+#endif
+
+#define ZRP_LOGGER_DEFAULT_BUFFER_SIZE 65536
+#define ZRP_LOGGER_DEFAULT_WRITE_SIZE 65536
+#define ZRP_LOGGER_DEFAULT_FLUSH_INTERVAL 10
+#define ZRP_LOGGER_DEFAULT_SAMPLE_RATE 16
+
+/* Records fitting into this size are formatted without any allocation. */
+#define ZRP_LOGGER_STACK_BUFFER_SIZE 512
+
+/* Large enough to always fit a record formatted on the stack. */
+#define ZRP_LOGGER_MIN_BUFFER_SIZE 1024
+
+#define ZRP_LOGGER_RECORD_ALIGNMENT 8
+/* Also hardcoded in `zrpLogIsPackable()`, which must stay in sync. */
+#define ZRP_LOGGER_MAX_CONVERSION_SIZE 32
+#define ZRP_LOGGER_SCRATCH_SIZE 256
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWriteFd(int fd, const char *pData, size_t size)
 {
-    va_list args;
+#if defined(ZRP_PLATFORM_WINDOWS)
+    int written;
 
-    ZR_ASSERT(pFile != NULL);
-    ZR_ASSERT(pFormat != NULL);
+    while (size > 0) {
+        written = _write(
+            fd, pData, size > 0x40000000 ? 0x40000000 : (unsigned int)size);
+        if (written < 0) {
+            return;
+        }
 
-    va_start(args, pFormat);
-    zrpLoggerLogVaList(level, pFile, line, pFormat, args);
-    va_end(args);
+        pData += written;
+        size -= (size_t)written;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+    ssize_t written;
+
+    while (size > 0) {
+        written = write(fd, pData, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return;
+        }
+
+        pData += written;
+        size -= (size_t)written;
+    }
+#endif
 }
 
-ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
-zrLogVaList(enum ZrLogLevel level,
+ZRP_MAYBE_UNUSED static void
+zrpLoggerWrite(const char *pData, size_t size)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    HANDLE handle;
+    DWORD written;
+
+    handle = GetStdHandle(STD_ERROR_HANDLE);
+    while (size > 0) {
+        if (!WriteFile(handle,
+                       pData,
+                       size > 0x40000000 ? 0x40000000 : (DWORD)size,
+                       &written,
+                       NULL)) {
+            return;
+        }
+
+        pData += written;
+        size -= (size_t)written;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+    zrpLoggerWriteFd(STDERR_FILENO, pData, size);
+#endif
+}
+
+/*
+   Sinks receive complete records, without any styling, for the levels that
+   they accept. Each sink serializes its writes with its own mutex but, in
+   asynchronous mode, all the writes happen on the background thread.
+*/
+
+enum ZrpLogSinkType {
+    ZRP_LOG_SINK_TYPE_FILE = 0,
+    ZRP_LOG_SINK_TYPE_FD = 1,
+    ZRP_LOG_SINK_TYPE_MEMORY = 2,
+    ZRP_LOG_SINK_TYPE_FUNCTION = 3
+};
+
+struct ZrLogSink {
+    enum ZrpLogSinkType type;
+    volatile int level;
+    ZrpMutex mutex;
+    struct ZrLogSink *pNext;
+
+    /* File sinks. */
+    FILE *pFile;
+    char *pPath;
+    char *pSourcePath;
+    char *pDestinationPath;
+    size_t fileSize;
+    size_t maxFileSize;
+    ZrUint32 maxFileCount;
+
+    /* File descriptor sinks. */
+    int fd;
+
+    /* Memory sinks. */
+    char *pRing;
+    size_t ringSize;
+    volatile size_t ringPosition;
+
+    /* Function sinks. */
+    ZrLogSinkFunction pfnFunction;
+    void *pData;
+};
+
+static void *volatile zrpLogSinks;
+
+static volatile int zrpLoggerLevel = ZR_LOG_LEVEL_DEBUG;
+
+/* Call sites reached at least once, to look them up by their location. */
+static void *volatile zrpLogSites;
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpLogSinkCreate(struct ZrLogSink **ppSink,
+                 enum ZrpLogSinkType type,
+                 size_t extraSize)
+{
+    enum ZrStatus status;
+    struct ZrLogSink *pSink;
+
+    ZR_ASSERT(ppSink != NULL);
+
+    pSink = (struct ZrLogSink *)zrAllocate(
+        (ZrSize)(sizeof *pSink + extraSize));
+    if (pSink == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the log sink\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    memset(pSink, 0, sizeof *pSink);
+    pSink->type = type;
+    pSink->level = (int)ZR_LOG_LEVEL_DEBUG;
+    pSink->fd = -1;
+
+    status = zrpMutexCreate(&pSink->mutex);
+    if (status != ZR_SUCCESS) {
+        zrFree(pSink);
+        return status;
+    }
+
+    *ppSink = pSink;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogSinkRotate(struct ZrLogSink *pSink)
+{
+    ZrUint32 i;
+
+    fclose(pSink->pFile);
+
+    /* Shift `path.1` to `path.2` and so on, then `path` to `path.1`. */
+    for (i = pSink->maxFileCount; i > 0; --i) {
+        sprintf(pSink->pDestinationPath,
+                "%s.%lu",
+                pSink->pPath,
+                (unsigned long)i);
+        if (i > 1) {
+            sprintf(pSink->pSourcePath,
+                    "%s.%lu",
+                    pSink->pPath,
+                    (unsigned long)(i - 1));
+        } else {
+            strcpy(pSink->pSourcePath, pSink->pPath);
+        }
+
+        remove(pSink->pDestinationPath);
+        rename(pSink->pSourcePath, pSink->pDestinationPath);
+    }
+
+    pSink->pFile = fopen(pSink->pPath, "wb");
+    pSink->fileSize = 0;
+    if (pSink->pFile == NULL) {
+        ZRP_LOG_ERROR("failed to reopen the log file '%s'\n", pSink->pPath);
+    }
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogSinkWrite(struct ZrLogSink *pSink,
+                enum ZrLogLevel level,
+                const char *pData,
+                size_t size)
+{
+    size_t position;
+    size_t offset;
+    size_t chunkSize;
+
+    if ((int)level > zrpAtomicLoadIntRelaxed(&pSink->level)) {
+        return;
+    }
+
+    zrpMutexLock(&pSink->mutex);
+    switch (pSink->type) {
+        case ZRP_LOG_SINK_TYPE_FILE:
+            if (pSink->pFile == NULL) {
+                break;
+            }
+
+            pSink->fileSize += fwrite(pData, 1, size, pSink->pFile);
+            if (level == ZR_LOG_LEVEL_ERROR) {
+                fflush(pSink->pFile);
+            }
+
+            if (pSink->maxFileSize > 0
+                && pSink->fileSize >= pSink->maxFileSize) {
+                zrpLogSinkRotate(pSink);
+            }
+
+            break;
+        case ZRP_LOG_SINK_TYPE_FD:
+            zrpLoggerWriteFd(pSink->fd, pData, size);
+            break;
+        case ZRP_LOG_SINK_TYPE_MEMORY:
+            position = pSink->ringPosition;
+            if (size > pSink->ringSize) {
+                position += size - pSink->ringSize;
+                pData += size - pSink->ringSize;
+                size = pSink->ringSize;
+            }
+
+            offset = position % pSink->ringSize;
+            chunkSize = pSink->ringSize - offset;
+            if (chunkSize > size) {
+                chunkSize = size;
+            }
+
+            memcpy(&pSink->pRing[offset], pData, chunkSize);
+            memcpy(pSink->pRing, &pData[chunkSize], size - chunkSize);
+            zrpAtomicStoreSizeRelease(&pSink->ringPosition, position + size);
+            break;
+        case ZRP_LOG_SINK_TYPE_FUNCTION:
+            pSink->pfnFunction(pSink->pData, level, pData, (ZrSize)size);
+            break;
+        default:
+            ZR_ASSERT(0);
+    }
+
+    zrpMutexUnlock(&pSink->mutex);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogSinkFlush(struct ZrLogSink *pSink)
+{
+    if (pSink->type == ZRP_LOG_SINK_TYPE_FILE && pSink->pFile != NULL) {
+        zrpMutexLock(&pSink->mutex);
+        fflush(pSink->pFile);
+        zrpMutexUnlock(&pSink->mutex);
+    }
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpLogSinksAcceptLevel(const struct ZrLogSink *pSinks, enum ZrLogLevel level)
+{
+    for (; pSinks != NULL; pSinks = pSinks->pNext) {
+        if ((int)level <= zrpAtomicLoadIntRelaxed(&pSinks->level)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogSinksWrite(struct ZrLogSink *pSinks,
+                 enum ZrLogLevel level,
+                 const char *pData,
+                 size_t size)
+{
+    for (; pSinks != NULL; pSinks = pSinks->pNext) {
+        zrpLogSinkWrite(pSinks, level, pData, size);
+    }
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogSinksFlush(struct ZrLogSink *pSinks)
+{
+    for (; pSinks != NULL; pSinks = pSinks->pNext) {
+        zrpLogSinkFlush(pSinks);
+    }
+}
+
+/*
+   Format a record into the given stack buffer if it fits, or into a buffer
+   to release with `zrFree()` otherwise, and return its size.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerFormatRecord(char **ppRecord,
+                      char *pStackBuffer,
+                      int styled,
+                      enum ZrLogLevel level,
+                      const char *pFile,
+                      int line,
+                      const char *pFormat,
+                      va_list args)
+{
+    struct ZrpLoggerOrigin origin;
+    size_t size;
+    va_list argsCopy;
+
+    zrpLoggerGetOrigin(&origin);
+
+    va_copy(argsCopy, args);
+    *ppRecord = pStackBuffer;
+    size = zrpLoggerFormatVaList(*ppRecord,
+                                 ZRP_LOGGER_STACK_BUFFER_SIZE,
+                                 styled,
+                                 level,
+                                 &origin,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (size >= ZRP_LOGGER_STACK_BUFFER_SIZE) {
+        *ppRecord = (char *)zrAllocate((ZrSize)size + 1);
+        if (*ppRecord == NULL) {
+            *ppRecord = pStackBuffer;
+            size = ZRP_LOGGER_STACK_BUFFER_SIZE - 1;
+        } else {
+            size = zrpLoggerFormatVaList(*ppRecord,
+                                         size + 1,
+                                         styled,
+                                         level,
+                                         &origin,
+                                         pFile,
+                                         line,
+                                         pFormat,
+                                         argsCopy);
+        }
+    }
+
+    va_end(argsCopy);
+    return size;
+}
+
+/*
+   Each logging thread owns a buffer that is a single-producer/single-consumer
+   ring of records, where the producer is the logging thread and the consumer
+   is whichever thread is flushing the buffers while holding the logger's
+   mutex. Records are aligned and never wrap around the end of the ring,
+   a padding record filling the remaining space instead, so the consumer can
+   always read them in place.
+
+   Buffers are never freed before the asynchronous mode is stopped, even if
+   their thread exits.
+*/
+
+enum ZrpLoggerRecordType {
+    ZRP_LOGGER_RECORD_TYPE_PADDING = 0,
+    ZRP_LOGGER_RECORD_TYPE_TEXT = 1,
+    ZRP_LOGGER_RECORD_TYPE_DEFERRED = 2
+};
+
+struct ZrpLoggerRecordHeader {
+    ZrUint32 size;
+    ZrUint16 type;
+    ZrUint16 level;
+};
+
+/*
+   Deferred records start with this structure, followed by the raw bytes of
+   each argument in the order that they are consumed by the format.
+*/
+struct ZrpLoggerDeferredRecord {
+    struct ZrpLoggerOrigin origin;
+    const char *pFile;
+    const char *pFormat;
+    int line;
+    int level;
+};
+
+enum ZrpLoggerArgumentType {
+    ZRP_LOGGER_ARGUMENT_TYPE_NONE = 0,
+    ZRP_LOGGER_ARGUMENT_TYPE_INT = 1,
+    ZRP_LOGGER_ARGUMENT_TYPE_LONG = 2,
+    ZRP_LOGGER_ARGUMENT_TYPE_LONG_LONG = 3,
+    ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_INT = 4,
+    ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG = 5,
+    ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG_LONG = 6,
+    ZRP_LOGGER_ARGUMENT_TYPE_SIZE = 7,
+    ZRP_LOGGER_ARGUMENT_TYPE_PTRDIFF = 8,
+    ZRP_LOGGER_ARGUMENT_TYPE_DOUBLE = 9,
+    ZRP_LOGGER_ARGUMENT_TYPE_LONG_DOUBLE = 10,
+    ZRP_LOGGER_ARGUMENT_TYPE_STRING = 11,
+    ZRP_LOGGER_ARGUMENT_TYPE_POINTER = 12,
+    ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED = 13
+};
+
+struct ZrpLoggerConversion {
+    enum ZrpLoggerArgumentType type;
+    int starCount;
+    int hasPrecision;
+    int precisionIsStar;
+    int precision;
+};
+
+struct ZrpLoggerBuffer {
+    volatile size_t head;
+    unsigned char headPadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+    volatile size_t tail;
+    volatile size_t dropped;
+    size_t sampleCount;
+    unsigned char tailPadding[ZR_CACHE_LINE_SIZE - 3 * sizeof(size_t)];
+    size_t reportedDropped;
+    size_t mask;
+    char *pData;
+    struct ZrpLoggerBuffer *pNext;
+};
+
+struct ZrpAsyncLogger {
+    struct ZrAsyncLoggerOptions options;
+    void *volatile pBuffers;
+    size_t generation;
+    int styled;
+    volatile size_t stopping;
+    char *pWriteBuffer;
+    size_t writeBufferSize;
+    char *pScratch;
+    size_t scratchSize;
+    ZrpMutex mutex;
+    ZrpCondition condition;
+    ZrpThread thread;
+};
+
+static void *volatile zrpAsyncLogger;
+static size_t zrpAsyncLoggerGeneration;
+
+static ZRP_LOGGER_THREAD_LOCAL struct ZrpLoggerBuffer *zrpLoggerThreadBuffer;
+static ZRP_LOGGER_THREAD_LOCAL size_t zrpLoggerThreadGeneration;
+
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerRoundUpToPowerOfTwo(size_t x)
+{
+    size_t out;
+
+    out = 1;
+    while (out < x && out <= (size_t)-1 / 2) {
+        out *= 2;
+    }
+
+    return out;
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerGetRecordSize(size_t payloadSize)
+{
+    return sizeof(struct ZrpLoggerRecordHeader)
+           + ((payloadSize + ZRP_LOGGER_RECORD_ALIGNMENT - 1)
+              & ~(size_t)(ZRP_LOGGER_RECORD_ALIGNMENT - 1));
+}
+
+/*
+   Parse the conversion specification starting at the given '%' character and
+   return a pointer to the character following it.
+
+   Any change to the conversions accepted here must be mirrored in
+   `zrpLogIsPackable()`, otherwise the C++ front-end packs records that the
+   background thread can't format.
+*/
+ZRP_MAYBE_UNUSED static const char *
+zrpLoggerParseConversion(struct ZrpLoggerConversion *pConversion,
+                         const char *pFormat)
+{
+    const char *pStart;
+    int longCount;
+
+    ZR_ASSERT(pConversion != NULL);
+    ZR_ASSERT(pFormat != NULL);
+    ZR_ASSERT(*pFormat == '%');
+
+    pStart = pFormat++;
+    pConversion->type = ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED;
+    pConversion->starCount = 0;
+    pConversion->hasPrecision = 0;
+    pConversion->precisionIsStar = 0;
+    pConversion->precision = 0;
+
+    if (*pFormat == '%') {
+        pConversion->type = ZRP_LOGGER_ARGUMENT_TYPE_NONE;
+        return pFormat + 1;
+    }
+
+    while (*pFormat != '\0' && strchr("-+ #0", *pFormat) != NULL) {
+        ++pFormat;
+    }
+
+    if (*pFormat == '*') {
+        ++pConversion->starCount;
+        ++pFormat;
+    } else {
+        while (*pFormat >= '0' && *pFormat <= '9') {
+            ++pFormat;
+        }
+
+        if (*pFormat == '$') {
+            /* Positional arguments aren't supported. */
+            return pFormat;
+        }
+    }
+
+    if (*pFormat == '.') {
+        pConversion->hasPrecision = 1;
+        ++pFormat;
+        if (*pFormat == '*') {
+            ++pConversion->starCount;
+            pConversion->precisionIsStar = 1;
+            ++pFormat;
+        } else {
+            while (*pFormat >= '0' && *pFormat <= '9') {
+                if (pConversion->precision < 100000) {
+                    pConversion->precision
+                        = pConversion->precision * 10 + (*pFormat - '0');
+                }
+
+                ++pFormat;
+            }
+        }
+    }
+
+    longCount = 0;
+    switch (*pFormat) {
+        case 'h':
+            ++pFormat;
+            pFormat += *pFormat == 'h';
+            break;
+        case 'l':
+            ++pFormat;
+            longCount = 1 + (*pFormat == 'l');
+            pFormat += *pFormat == 'l';
+            break;
+        case 'z':
+            ++pFormat;
+            longCount = -1;
+            break;
+        case 't':
+            ++pFormat;
+            longCount = -2;
+            break;
+        case 'L':
+            ++pFormat;
+            longCount = 3;
+            break;
+        case 'j':
+            /* Avoid depending on `<stdint.h>` for `intmax_t`. */
+            return pFormat;
+        default:
+            break;
+    }
+
+    if (pFormat - pStart >= ZRP_LOGGER_MAX_CONVERSION_SIZE) {
+        return pFormat;
+    }
+
+    switch (*pFormat) {
+        case 'c':
+            pConversion->type = longCount == 0
+                                    ? ZRP_LOGGER_ARGUMENT_TYPE_INT
+                                    : ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED;
+            break;
+        case 'd':
+        case 'i':
+            pConversion->type
+                = longCount == 0   ? ZRP_LOGGER_ARGUMENT_TYPE_INT
+                  : longCount == 1 ? ZRP_LOGGER_ARGUMENT_TYPE_LONG
+                  : longCount == 2 ? ZRP_LOGGER_ARGUMENT_TYPE_LONG_LONG
+                  : longCount == -1 ? ZRP_LOGGER_ARGUMENT_TYPE_SIZE
+                  : longCount == -2 ? ZRP_LOGGER_ARGUMENT_TYPE_PTRDIFF
+                                    : ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED;
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            pConversion->type
+                = longCount == 0   ? ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_INT
+                  : longCount == 1 ? ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG
+                  : longCount == 2
+                      ? ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG_LONG
+                  : longCount == -1 ? ZRP_LOGGER_ARGUMENT_TYPE_SIZE
+                  : longCount == -2 ? ZRP_LOGGER_ARGUMENT_TYPE_PTRDIFF
+                                    : ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED;
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            pConversion->type = longCount == 3
+                                    ? ZRP_LOGGER_ARGUMENT_TYPE_LONG_DOUBLE
+                                    : ZRP_LOGGER_ARGUMENT_TYPE_DOUBLE;
+            break;
+        case 's':
+            pConversion->type = longCount == 0
+                                    ? ZRP_LOGGER_ARGUMENT_TYPE_STRING
+                                    : ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED;
+            break;
+        case 'p':
+            pConversion->type = ZRP_LOGGER_ARGUMENT_TYPE_POINTER;
+            break;
+        default:
+            return pFormat;
+    }
+
+    return pFormat + 1;
+}
+
+#define ZRP_LOGGER_CAPTURE_ARGUMENT(type)                                      \
+    {                                                                          \
+        type value;                                                            \
+                                                                               \
+        value = va_arg(args, type);                                            \
+        if (size - offset < sizeof value) {                                    \
+            return 0;                                                          \
+        }                                                                      \
+                                                                               \
+        memcpy(&pBuffer[offset], &value, sizeof value);                        \
+        offset += sizeof value;                                                \
+    }
+
+/*
+   Capture a deferred record into the given buffer and return its size, or
+   zero if the format uses a conversion that can't be deferred or if the
+   buffer is too small.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpLoggerCaptureVaList(char *pBuffer,
+                       size_t size,
+                       enum ZrLogLevel level,
+                       const char *pFile,
+                       int line,
+                       const char *pFormat,
+                       va_list args)
+{
+    struct ZrpLoggerDeferredRecord record;
+    struct ZrpLoggerConversion conversion;
+    size_t offset;
+    int star;
+    int i;
+
+    ZR_ASSERT(pBuffer != NULL);
+    ZR_ASSERT(size >= sizeof record);
+
+    zrpLoggerGetOrigin(&record.origin);
+    record.pFile = pFile;
+    record.pFormat = pFormat;
+    record.line = line;
+    record.level = (int)level;
+    memcpy(pBuffer, &record, sizeof record);
+    offset = sizeof record;
+
+    while ((pFormat = strchr(pFormat, '%')) != NULL) {
+        pFormat = zrpLoggerParseConversion(&conversion, pFormat);
+
+        star = 0;
+        for (i = 0; i < conversion.starCount; ++i) {
+            star = va_arg(args, int);
+            if (size - offset < sizeof star) {
+                return 0;
+            }
+
+            memcpy(&pBuffer[offset], &star, sizeof star);
+            offset += sizeof star;
+        }
+
+        if (conversion.precisionIsStar) {
+            conversion.hasPrecision = star >= 0;
+            conversion.precision = star;
+        }
+
+        switch (conversion.type) {
+            case ZRP_LOGGER_ARGUMENT_TYPE_NONE:
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_INT:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(int);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG_LONG:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(long long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_INT:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(unsigned int);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(unsigned long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG_LONG:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(unsigned long long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_SIZE:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(size_t);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_PTRDIFF:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(ptrdiff_t);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_DOUBLE:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(double);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG_DOUBLE:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(long double);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_POINTER:
+                ZRP_LOGGER_CAPTURE_ARGUMENT(void *);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_STRING: {
+                const char *pString;
+                size_t length;
+
+                /* Strings are copied since they may not outlive the call. */
+                pString = va_arg(args, const char *);
+                if (pString == NULL) {
+                    pString = "(null)";
+                }
+
+                length = 0;
+                while ((!conversion.hasPrecision
+                        || length < (size_t)conversion.precision)
+                       && pString[length] != '\0') {
+                    ++length;
+                }
+
+                if (size - offset < sizeof length + length + 1) {
+                    return 0;
+                }
+
+                memcpy(&pBuffer[offset], &length, sizeof length);
+                offset += sizeof length;
+                memcpy(&pBuffer[offset], pString, length);
+                offset += length;
+                pBuffer[offset++] = '\0';
+                break;
+            }
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED:
+                return 0;
+            default:
+                ZR_ASSERT(0);
+                return 0;
+        }
+    }
+
+    return offset;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerAppend(struct ZrpAsyncLogger *pLogger,
+                     const char *pData,
+                     size_t size)
+{
+    size_t chunkSize;
+
+    while (size > 0) {
+        if (pLogger->writeBufferSize == pLogger->options.writeSize) {
+            zrpLoggerWrite(pLogger->pWriteBuffer, pLogger->writeBufferSize);
+            pLogger->writeBufferSize = 0;
+        }
+
+        chunkSize = pLogger->options.writeSize - pLogger->writeBufferSize;
+        if (chunkSize > size) {
+            chunkSize = size;
+        }
+
+        memcpy(&pLogger->pWriteBuffer[pLogger->writeBufferSize],
+               pData,
+               chunkSize);
+        pLogger->writeBufferSize += chunkSize;
+        pData += chunkSize;
+        size -= chunkSize;
+    }
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpAsyncLoggerGrowScratch(struct ZrpAsyncLogger *pLogger, size_t size)
+{
+    char *pScratch;
+
+    if (size <= pLogger->scratchSize) {
+        return 1;
+    }
+
+    pScratch = (char *)zrReallocate(pLogger->pScratch, (ZrSize)size);
+    if (pScratch == NULL) {
+        return 0;
+    }
+
+    pLogger->pScratch = pScratch;
+    pLogger->scratchSize = size;
+    return 1;
+}
+
+/* Append formatted data to the scratch buffer, growing it as needed. */
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerPrint(struct ZrpAsyncLogger *pLogger,
+                    size_t *pSize,
+                    const char *pFormat,
+                    ...)
+{
+    va_list args;
+    int size;
+
+    va_start(args, pFormat);
+    size = vsnprintf(&pLogger->pScratch[*pSize],
+                     pLogger->scratchSize - *pSize,
+                     pFormat,
+                     args);
+    va_end(args);
+    if (size < 0) {
+        return;
+    }
+
+    if (*pSize + (size_t)size >= pLogger->scratchSize) {
+        if (zrpAsyncLoggerGrowScratch(pLogger,
+                                      2 * (*pSize + (size_t)size + 1))) {
+            va_start(args, pFormat);
+            vsnprintf(&pLogger->pScratch[*pSize],
+                      pLogger->scratchSize - *pSize,
+                      pFormat,
+                      args);
+            va_end(args);
+        } else {
+            size = (int)(pLogger->scratchSize - *pSize - 1);
+        }
+    }
+
+    *pSize += (size_t)size;
+}
+
+#define ZRP_LOGGER_PRINT_ARGUMENT(type)                                        \
+    {                                                                          \
+        type value;                                                            \
+                                                                               \
+        memcpy(&value, &pData[offset], sizeof value);                          \
+        offset += sizeof value;                                                \
+        zrpAsyncLoggerPrint(pLogger, &size, conversion, value);                \
+    }
+
+/*
+   Format a deferred record into the scratch buffer, mirroring
+   `zrpLoggerCaptureVaList()`, and return its size.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpAsyncLoggerFormatDeferred(struct ZrpAsyncLogger *pLogger,
+                             const char *pData,
+                             int styled)
+{
+    struct ZrpLoggerDeferredRecord record;
+    struct ZrpLoggerConversion parsed;
+    char conversion[ZRP_LOGGER_MAX_CONVERSION_SIZE + 32];
+    const char *pFormat;
+    const char *pConversion;
+    size_t conversionSize;
+    size_t offset;
+    size_t length;
+    size_t size;
+    int star;
+
+    memcpy(&record, pData, sizeof record);
+    offset = sizeof record;
+
+    size = zrpLoggerFormatPrefix(pLogger->pScratch,
+                                 pLogger->scratchSize,
+                                 styled,
+                                 (enum ZrLogLevel)record.level,
+                                 &record.origin,
+                                 record.pFile,
+                                 record.line);
+    if (size >= pLogger->scratchSize) {
+        if (zrpAsyncLoggerGrowScratch(pLogger, 2 * (size + 1))) {
+            zrpLoggerFormatPrefix(pLogger->pScratch,
+                                  pLogger->scratchSize,
+                                  styled,
+                                  (enum ZrLogLevel)record.level,
+                                  &record.origin,
+                                  record.pFile,
+                                  record.line);
+        } else {
+            size = pLogger->scratchSize - 1;
+        }
+    }
+
+    pFormat = record.pFormat;
+    while ((pConversion = strchr(pFormat, '%')) != NULL) {
+        zrpAsyncLoggerPrint(
+            pLogger, &size, "%.*s", (int)(pConversion - pFormat), pFormat);
+        pFormat = zrpLoggerParseConversion(&parsed, pConversion);
+
+        /* Substitute the captured values of the '*' width and precision. */
+        conversionSize = 0;
+        for (; pConversion != pFormat; ++pConversion) {
+            if (*pConversion == '*') {
+                memcpy(&star, &pData[offset], sizeof star);
+                offset += sizeof star;
+                conversionSize += (size_t)sprintf(
+                    &conversion[conversionSize], "%d", star);
+            } else {
+                conversion[conversionSize++] = *pConversion;
+            }
+        }
+
+        conversion[conversionSize] = '\0';
+
+        switch (parsed.type) {
+            case ZRP_LOGGER_ARGUMENT_TYPE_NONE:
+                zrpAsyncLoggerPrint(pLogger, &size, "%%");
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_INT:
+                ZRP_LOGGER_PRINT_ARGUMENT(int);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG:
+                ZRP_LOGGER_PRINT_ARGUMENT(long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG_LONG:
+                ZRP_LOGGER_PRINT_ARGUMENT(long long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_INT:
+                ZRP_LOGGER_PRINT_ARGUMENT(unsigned int);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG:
+                ZRP_LOGGER_PRINT_ARGUMENT(unsigned long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSIGNED_LONG_LONG:
+                ZRP_LOGGER_PRINT_ARGUMENT(unsigned long long);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_SIZE:
+                ZRP_LOGGER_PRINT_ARGUMENT(size_t);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_PTRDIFF:
+                ZRP_LOGGER_PRINT_ARGUMENT(ptrdiff_t);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_DOUBLE:
+                ZRP_LOGGER_PRINT_ARGUMENT(double);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_LONG_DOUBLE:
+                ZRP_LOGGER_PRINT_ARGUMENT(long double);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_POINTER:
+                ZRP_LOGGER_PRINT_ARGUMENT(void *);
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_STRING:
+                memcpy(&length, &pData[offset], sizeof length);
+                offset += sizeof length;
+                zrpAsyncLoggerPrint(
+                    pLogger, &size, conversion, &pData[offset]);
+                offset += length + 1;
+                break;
+            case ZRP_LOGGER_ARGUMENT_TYPE_UNSUPPORTED:
+            default:
+                /* Rejected at capture time. */
+                ZR_ASSERT(0);
+                return size;
+        }
+    }
+
+    zrpAsyncLoggerPrint(pLogger, &size, "%s", pFormat);
+    return size;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerEmit(struct ZrpAsyncLogger *pLogger,
+                   struct ZrLogSink *pSinks,
+                   enum ZrLogLevel level,
+                   const char *pData,
+                   size_t size)
+{
+    if (pSinks != NULL) {
+        zrpLogSinksWrite(pSinks, level, pData, size);
+    } else {
+        zrpAsyncLoggerAppend(pLogger, pData, size);
+    }
+}
+
+/* Must be called while holding the logger's mutex. */
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerDrain(struct ZrpAsyncLogger *pLogger)
+{
+    struct ZrLogSink *pSinks;
+    struct ZrpLoggerBuffer *pBuffer;
+    struct ZrpLoggerRecordHeader header;
+    const char *pPayload;
+    size_t head;
+    size_t tail;
+    size_t offset;
+    size_t size;
+    size_t dropped;
+    int styled;
+
+    pSinks = (struct ZrLogSink *)zrpAtomicLoadPointerAcquire(&zrpLogSinks);
+    styled = pLogger->styled && pSinks == NULL;
+
+    pBuffer = (struct ZrpLoggerBuffer *)zrpAtomicLoadPointerAcquire(
+        &pLogger->pBuffers);
+    for (; pBuffer != NULL; pBuffer = pBuffer->pNext) {
+        head = zrpAtomicLoadSizeRelaxed(&pBuffer->head);
+        tail = zrpAtomicLoadSizeAcquire(&pBuffer->tail);
+        while (head != tail) {
+            offset = head & pBuffer->mask;
+            memcpy(&header, &pBuffer->pData[offset], sizeof header);
+            pPayload = &pBuffer->pData[offset + sizeof header];
+            switch (header.type) {
+                case ZRP_LOGGER_RECORD_TYPE_PADDING:
+                    break;
+                case ZRP_LOGGER_RECORD_TYPE_TEXT:
+                    zrpAsyncLoggerEmit(pLogger,
+                                       pSinks,
+                                       (enum ZrLogLevel)header.level,
+                                       pPayload,
+                                       header.size);
+                    break;
+                case ZRP_LOGGER_RECORD_TYPE_DEFERRED:
+                    size = zrpAsyncLoggerFormatDeferred(
+                        pLogger, pPayload, styled);
+                    zrpAsyncLoggerEmit(pLogger,
+                                       pSinks,
+                                       (enum ZrLogLevel)header.level,
+                                       pLogger->pScratch,
+                                       size);
+                    break;
+                default:
+                    ZR_ASSERT(0);
+            }
+
+            head += zrpLoggerGetRecordSize(header.size);
+        }
+
+        zrpAtomicStoreSizeRelease(&pBuffer->head, head);
+
+        dropped = zrpAtomicLoadSizeRelaxed(&pBuffer->dropped);
+        if (dropped != pBuffer->reportedDropped) {
+            size = 0;
+            zrpAsyncLoggerPrint(
+                pLogger,
+                &size,
+                "logger: dropped %lu record(s)\n",
+                (unsigned long)(dropped - pBuffer->reportedDropped));
+            zrpAsyncLoggerEmit(pLogger,
+                               pSinks,
+                               ZR_LOG_LEVEL_WARNING,
+                               pLogger->pScratch,
+                               size);
+            pBuffer->reportedDropped = dropped;
+        }
+    }
+
+    if (pLogger->writeBufferSize > 0) {
+        zrpLoggerWrite(pLogger->pWriteBuffer, pLogger->writeBufferSize);
+        pLogger->writeBufferSize = 0;
+    }
+
+    zrpLogSinksFlush(pSinks);
+}
+
+ZRP_MAYBE_UNUSED static ZRP_THREAD_RETURN_TYPE ZRP_THREAD_CALL
+zrpAsyncLoggerRun(void *pArg)
+{
+    struct ZrpAsyncLogger *pLogger;
+
+    pLogger = (struct ZrpAsyncLogger *)pArg;
+
+    zrpMutexLock(&pLogger->mutex);
+    while (!zrpAtomicLoadSizeAcquire(&pLogger->stopping)) {
+        zrpAsyncLoggerDrain(pLogger);
+        zrpConditionTimedWait(&pLogger->condition,
+                              &pLogger->mutex,
+                              pLogger->options.flushInterval);
+    }
+
+    zrpAsyncLoggerDrain(pLogger);
+    zrpMutexUnlock(&pLogger->mutex);
+    return ZRP_THREAD_RETURN_VALUE;
+}
+
+ZRP_MAYBE_UNUSED static struct ZrpLoggerBuffer *
+zrpAsyncLoggerGetThreadBuffer(struct ZrpAsyncLogger *pLogger)
+{
+    struct ZrpLoggerBuffer *pBuffer;
+    void *pHead;
+
+    if (zrpLoggerThreadBuffer != NULL
+        && zrpLoggerThreadGeneration == pLogger->generation) {
+        return zrpLoggerThreadBuffer;
+    }
+
+    pBuffer = (struct ZrpLoggerBuffer *)zrAllocateAligned(
+        (ZrSize)(sizeof *pBuffer + pLogger->options.bufferSize),
+        ZR_CACHE_LINE_SIZE);
+    if (pBuffer == NULL) {
+        return NULL;
+    }
+
+    pBuffer->head = 0;
+    pBuffer->tail = 0;
+    pBuffer->dropped = 0;
+    pBuffer->sampleCount = 0;
+    pBuffer->reportedDropped = 0;
+    pBuffer->mask = pLogger->options.bufferSize - 1;
+    pBuffer->pData = (char *)&pBuffer[1];
+
+    do {
+        pHead = zrpAtomicLoadPointerAcquire(&pLogger->pBuffers);
+        pBuffer->pNext = (struct ZrpLoggerBuffer *)pHead;
+    } while (
+        !zrpAtomicCompareExchangePointer(&pLogger->pBuffers, pHead, pBuffer));
+
+    zrpLoggerThreadBuffer = pBuffer;
+    zrpLoggerThreadGeneration = pLogger->generation;
+    return pBuffer;
+}
+
+/*
+   Wait until the buffer has the given amount of space available, or return 0
+   if the record is to be dropped instead.
+*/
+ZRP_MAYBE_UNUSED static int
+zrpAsyncLoggerWaitForSpace(size_t *pHead,
+                           struct ZrpAsyncLogger *pLogger,
+                           struct ZrpLoggerBuffer *pBuffer,
+                           size_t tail,
+                           size_t size)
+{
+    while (pBuffer->mask + 1 - (tail - *pHead) < size) {
+        if (pLogger->options.overflowPolicy
+            != ZR_LOGGER_OVERFLOW_POLICY_BLOCK) {
+            zrpAtomicStoreSizeRelaxed(&pBuffer->dropped, pBuffer->dropped + 1);
+            return 0;
+        }
+
+        zrpConditionSignal(&pLogger->condition);
+        zrpThreadYield();
+        *pHead = zrpAtomicLoadSizeAcquire(&pBuffer->head);
+    }
+
+    return 1;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerPush(struct ZrpAsyncLogger *pLogger,
+                   struct ZrpLoggerBuffer *pBuffer,
+                   enum ZrpLoggerRecordType type,
+                   enum ZrLogLevel level,
+                   const char *pData,
+                   size_t size)
+{
+    struct ZrpLoggerRecordHeader header;
+    size_t capacity;
+    size_t recordSize;
+    size_t head;
+    size_t tail;
+    size_t offset;
+
+    capacity = pBuffer->mask + 1;
+    recordSize = zrpLoggerGetRecordSize(size);
+    ZR_ASSERT(recordSize <= capacity);
+
+    tail = zrpAtomicLoadSizeRelaxed(&pBuffer->tail);
+    head = zrpAtomicLoadSizeAcquire(&pBuffer->head);
+
+    if (pLogger->options.overflowPolicy == ZR_LOGGER_OVERFLOW_POLICY_SAMPLE
+        && tail - head >= capacity / 2
+        && pBuffer->sampleCount++ % pLogger->options.sampleRate != 0) {
+        zrpAtomicStoreSizeRelaxed(&pBuffer->dropped, pBuffer->dropped + 1);
+        return;
+    }
+
+    offset = tail & pBuffer->mask;
+    if (capacity - offset < recordSize) {
+        /* Pad up to the end of the ring to not wrap the record around. */
+        if (!zrpAsyncLoggerWaitForSpace(
+                &head, pLogger, pBuffer, tail, capacity - offset)) {
+            return;
+        }
+
+        header.size = (ZrUint32)(capacity - offset - sizeof header);
+        header.type = ZRP_LOGGER_RECORD_TYPE_PADDING;
+        header.level = 0;
+        memcpy(&pBuffer->pData[offset], &header, sizeof header);
+        tail += capacity - offset;
+        zrpAtomicStoreSizeRelease(&pBuffer->tail, tail);
+        offset = 0;
+    }
+
+    if (!zrpAsyncLoggerWaitForSpace(
+            &head, pLogger, pBuffer, tail, recordSize)) {
+        return;
+    }
+
+    header.size = (ZrUint32)size;
+    header.type = (ZrUint16)type;
+    header.level = (ZrUint16)level;
+    memcpy(&pBuffer->pData[offset], &header, sizeof header);
+    memcpy(&pBuffer->pData[offset + sizeof header], pData, size);
+    zrpAtomicStoreSizeRelease(&pBuffer->tail, tail + recordSize);
+
+    /* Wake up the background thread as the buffer crosses the half mark. */
+    if (tail - head < capacity / 2
+        && tail + recordSize - head >= capacity / 2) {
+        zrpConditionSignal(&pLogger->condition);
+    }
+}
+
+/*
+   Format each record in full before emitting it, so that writing it to the
+   standard error stream is a single system call that doesn't interleave
+   with the records of other threads, nor takes the stdio lock.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerPushText(struct ZrpAsyncLogger *pLogger,
+                       struct ZrpLoggerBuffer *pBuffer,
+                       struct ZrLogSink *pSinks,
+                       enum ZrLogLevel level,
+                       const char *pRecord,
+                       size_t size)
+{
+    if (zrpLoggerGetRecordSize(size) > pBuffer->mask + 1) {
+        /*
+           Too large to ever fit, bypass the buffer after having drained it to
+           preserve the order of the records.
+        */
+        zrpMutexLock(&pLogger->mutex);
+        zrpAsyncLoggerDrain(pLogger);
+        zrpAsyncLoggerEmit(pLogger, pSinks, level, pRecord, size);
+        if (pLogger->writeBufferSize > 0) {
+            zrpLoggerWrite(pLogger->pWriteBuffer, pLogger->writeBufferSize);
+            pLogger->writeBufferSize = 0;
+        }
+
+        zrpMutexUnlock(&pLogger->mutex);
+    } else {
+        zrpAsyncLoggerPush(pLogger,
+                           pBuffer,
+                           ZRP_LOGGER_RECORD_TYPE_TEXT,
+                           level,
+                           pRecord,
+                           size);
+    }
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerLogVaListSync(struct ZrLogSink *pSinks,
+                       enum ZrLogLevel level,
+                       const char *pFile,
+                       int line,
+                       const char *pFormat,
+                       va_list args)
+{
+    char stackBuffer[ZRP_LOGGER_STACK_BUFFER_SIZE];
+    char *pRecord;
+    size_t size;
+
+    size = zrpLoggerFormatRecord(&pRecord,
+                                 stackBuffer,
+                                 pSinks == NULL && zrpLoggerIsStderrStyled(),
+                                 level,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    if (pSinks == NULL) {
+        zrpLoggerWrite(pRecord, size);
+    } else {
+        zrpLogSinksWrite(pSinks, level, pRecord, size);
+    }
+
+    if (pRecord != stackBuffer) {
+        zrFree(pRecord);
+    }
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpAsyncLoggerLogVaList(struct ZrpAsyncLogger *pLogger,
+                        struct ZrLogSink *pSinks,
+                        enum ZrLogLevel level,
+                        const char *pFile,
+                        int line,
+                        const char *pFormat,
+                        va_list args)
+{
+    struct ZrpLoggerBuffer *pBuffer;
+    char stackBuffer[ZRP_LOGGER_STACK_BUFFER_SIZE];
+    char *pRecord;
+    size_t size;
+    va_list argsCopy;
+
+    pBuffer = zrpAsyncLoggerGetThreadBuffer(pLogger);
+    if (pBuffer == NULL) {
+        zrpLoggerLogVaListSync(pSinks, level, pFile, line, pFormat, args);
+        return;
+    }
+
+    if (pLogger->options.deferFormatting) {
+        va_copy(argsCopy, args);
+        size = zrpLoggerCaptureVaList(stackBuffer,
+                                      sizeof stackBuffer,
+                                      level,
+                                      pFile,
+                                      line,
+                                      pFormat,
+                                      argsCopy);
+        va_end(argsCopy);
+        if (size > 0) {
+            zrpAsyncLoggerPush(pLogger,
+                               pBuffer,
+                               ZRP_LOGGER_RECORD_TYPE_DEFERRED,
+                               level,
+                               stackBuffer,
+                               size);
+            return;
+        }
+    }
+
+    size = zrpLoggerFormatRecord(&pRecord,
+                                 stackBuffer,
+                                 pLogger->styled && pSinks == NULL,
+                                 level,
+                                 pFile,
+                                 line,
+                                 pFormat,
+                                 args);
+    zrpAsyncLoggerPushText(pLogger, pBuffer, pSinks, level, pRecord, size);
+    if (pRecord != stackBuffer) {
+        zrFree(pRecord);
+    }
+}
+
+/*
+   Write a record that is already formatted, either through the buffer of the
+   calling thread in asynchronous mode, or directly.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEmitRecord(struct ZrLogSink *pSinks,
+                    enum ZrLogLevel level,
+                    const char *pRecord,
+                    size_t size)
+{
+    struct ZrpAsyncLogger *pLogger;
+    struct ZrpLoggerBuffer *pBuffer;
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+    if (pLogger != NULL) {
+        pBuffer = zrpAsyncLoggerGetThreadBuffer(pLogger);
+        if (pBuffer != NULL) {
+            zrpAsyncLoggerPushText(
+                pLogger, pBuffer, pSinks, level, pRecord, size);
+            return;
+        }
+    }
+
+    if (pSinks == NULL) {
+        zrpLoggerWrite(pRecord, size);
+    } else {
+        zrpLogSinksWrite(pSinks, level, pRecord, size);
+    }
+}
+
+/*
+   Structured records are encoded into a buffer starting on the stack and
+   growing through the allocator. Once an allocation fails, the appends are
+   ignored and the record is dropped.
+*/
+
+/* Size of `YYYY-MM-DDTHH:MM:SS.uuuuuuZ`. */
+#define ZRP_LOGGER_TIMESTAMP_SIZE (ZRP_LOGGER_DATE_TIME_SIZE + 8)
+
+#define ZRP_LOGGER_DOUBLE_DIGIT_COUNT 15
+
+struct ZrpLoggerEncoder {
+    char *pData;
+    size_t size;
+    size_t capacity;
+    char *pStackBuffer;
+    int failed;
+};
+
+static volatile int zrpLoggerEncoding = ZR_LOG_ENCODING_JSON;
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpLoggerGetWallTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    {
+        FILETIME time;
+
+        /* Intervals of 100 nanoseconds since 1601-01-01. */
+        GetSystemTimeAsFileTime(&time);
+        *pTime = ((((ZrUint64)time.dwHighDateTime << 32) | time.dwLowDateTime)
+                  - 116444736000000000ull)
+                 * 100;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    {
+        struct timespec time;
+
+        if (clock_gettime(CLOCK_REALTIME, &time) != 0) {
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+    {
+        struct timeval time;
+
+        if (gettimeofday(&time, NULL) != 0) {
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull
+                 + (ZrUint64)time.tv_usec * 1000ull;
+        return ZR_SUCCESS;
+    }
+#else
+    return ZR_ERROR;
+#endif
+}
+
+/* Format a time in nanoseconds since the epoch, without any allocation. */
+ZRP_MAYBE_UNUSED static void
+zrpLoggerFormatTimestamp(char *pBuffer, ZrUint64 time)
+{
+    zrpLoggerFormatDateTime(pBuffer, time / 1000000000ull);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE] = '.';
+    zrpLoggerWriteDigits(
+        &pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 1], time / 1000 % 1000000, 6);
+    pBuffer[ZRP_LOGGER_DATE_TIME_SIZE + 7] = 'Z';
+}
+
+ZRP_MAYBE_UNUSED static int
+zrpLoggerEncoderReserve(struct ZrpLoggerEncoder *pEncoder, size_t size)
+{
+    char *pData;
+    size_t capacity;
+
+    if (pEncoder->failed) {
+        return 0;
+    }
+
+    if (pEncoder->size + size <= pEncoder->capacity) {
+        return 1;
+    }
+
+    capacity = pEncoder->capacity * 2;
+    if (capacity < pEncoder->size + size) {
+        capacity = pEncoder->size + size;
+    }
+
+    pData = (char *)zrAllocate((ZrSize)capacity);
+    if (pData == NULL) {
+        pEncoder->failed = 1;
+        return 0;
+    }
+
+    memcpy(pData, pEncoder->pData, pEncoder->size);
+    if (pEncoder->pData != pEncoder->pStackBuffer) {
+        zrFree(pEncoder->pData);
+    }
+
+    pEncoder->pData = pData;
+    pEncoder->capacity = capacity;
+    return 1;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppend(struct ZrpLoggerEncoder *pEncoder,
+                       const char *pData,
+                       size_t size)
+{
+    if (!zrpLoggerEncoderReserve(pEncoder, size)) {
+        return;
+    }
+
+    memcpy(&pEncoder->pData[pEncoder->size], pData, size);
+    pEncoder->size += size;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendChar(struct ZrpLoggerEncoder *pEncoder, char c)
+{
+    zrpLoggerEncoderAppend(pEncoder, &c, 1);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendUnsigned(struct ZrpLoggerEncoder *pEncoder,
+                               ZrUint64 value)
+{
+    char digits[20];
+    size_t i;
+
+    i = sizeof digits;
+    do {
+        digits[--i] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    zrpLoggerEncoderAppend(pEncoder, &digits[i], sizeof digits - i);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendSigned(struct ZrpLoggerEncoder *pEncoder, ZrInt64 value)
+{
+    if (value < 0) {
+        zrpLoggerEncoderAppendChar(pEncoder, '-');
+        zrpLoggerEncoderAppendUnsigned(pEncoder, (ZrUint64)0 - (ZrUint64)value);
+        return;
+    }
+
+    zrpLoggerEncoderAppendUnsigned(pEncoder, (ZrUint64)value);
+}
+
+/*
+   Write 15 significant digits, which doubles always preserve, using the
+   scientific notation only for the exponents out of [-5, 15).
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendDouble(struct ZrpLoggerEncoder *pEncoder,
+                             double value,
+                             int json)
+{
+    static const double powers[]
+        = {1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256};
+    char digits[ZRP_LOGGER_DOUBLE_DIGIT_COUNT];
+    ZrUint64 mantissa;
+    int exponent;
+    int digitCount;
+    int i;
+
+    if (!(value >= -DBL_MAX && value <= DBL_MAX)) {
+        if (json) {
+            zrpLoggerEncoderAppend(pEncoder, "null", 4);
+        } else if (value > 0.0) {
+            zrpLoggerEncoderAppend(pEncoder, "+Inf", 4);
+        } else if (value < 0.0) {
+            zrpLoggerEncoderAppend(pEncoder, "-Inf", 4);
+        } else {
+            zrpLoggerEncoderAppend(pEncoder, "NaN", 3);
+        }
+
+        return;
+    }
+
+    if (value < 0.0) {
+        zrpLoggerEncoderAppendChar(pEncoder, '-');
+        value = -value;
+    }
+
+    if (!(value > 0.0)) {
+        zrpLoggerEncoderAppendChar(pEncoder, '0');
+        return;
+    }
+
+    /* Scale the value into [1, 10) with as few operations as possible. */
+    exponent = 0;
+    for (i = (int)(sizeof powers / sizeof powers[0]) - 1; i >= 0; --i) {
+        if (value >= powers[i]) {
+            value /= powers[i];
+            exponent += 1 << i;
+        } else if (value < 1.0 && value * powers[i] < 10.0) {
+            value *= powers[i];
+            exponent -= 1 << i;
+        }
+    }
+
+    if (value < 1.0) {
+        value *= 10.0;
+        --exponent;
+    }
+
+    /* Truncate near the largest doubles to not round them up to infinity. */
+    mantissa = (ZrUint64)(value * 1e14
+                          + (exponent < DBL_MAX_10_EXP ? 0.5 : 0.0));
+    if (mantissa >= 1000000000000000ull) {
+        mantissa /= 10;
+        ++exponent;
+    }
+
+    zrpLoggerWriteDigits(digits, mantissa, ZRP_LOGGER_DOUBLE_DIGIT_COUNT);
+    digitCount = ZRP_LOGGER_DOUBLE_DIGIT_COUNT;
+    while (digitCount > 1 && digits[digitCount - 1] == '0') {
+        --digitCount;
+    }
+
+    if (exponent >= ZRP_LOGGER_DOUBLE_DIGIT_COUNT || exponent < -5) {
+        zrpLoggerEncoderAppendChar(pEncoder, digits[0]);
+        if (digitCount > 1) {
+            zrpLoggerEncoderAppendChar(pEncoder, '.');
+            zrpLoggerEncoderAppend(
+                pEncoder, &digits[1], (size_t)digitCount - 1);
+        }
+
+        zrpLoggerEncoderAppendChar(pEncoder, 'e');
+        zrpLoggerEncoderAppendChar(pEncoder, exponent < 0 ? '-' : '+');
+        zrpLoggerEncoderAppendUnsigned(
+            pEncoder, (ZrUint64)(exponent < 0 ? -exponent : exponent));
+    } else if (exponent >= 0) {
+        for (i = 0; i <= exponent; ++i) {
+            zrpLoggerEncoderAppendChar(pEncoder,
+                                       i < digitCount ? digits[i] : '0');
+        }
+
+        if (exponent < digitCount - 1) {
+            zrpLoggerEncoderAppendChar(pEncoder, '.');
+            zrpLoggerEncoderAppend(pEncoder,
+                                   &digits[exponent + 1],
+                                   (size_t)(digitCount - exponent - 1));
+        }
+    } else {
+        zrpLoggerEncoderAppend(pEncoder, "0.", 2);
+        for (i = exponent; i < -1; ++i) {
+            zrpLoggerEncoderAppendChar(pEncoder, '0');
+        }
+
+        zrpLoggerEncoderAppend(pEncoder, digits, (size_t)digitCount);
+    }
+}
+
+/*
+   Write a string quoted and escaped as in JSON, which is also how logfmt
+   quotes its values, or as is for logfmt values not needing any quote.
+*/
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendString(struct ZrpLoggerEncoder *pEncoder,
+                             const char *pString,
+                             int json)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    const char *pRun;
+    char escape[6];
+    unsigned char c;
+
+    if (pString == NULL) {
+        pString = "";
+    }
+
+    if (!json && *pString != '\0') {
+        for (pRun = pString; *pRun != '\0'; ++pRun) {
+            c = (unsigned char)*pRun;
+            if (c <= ' ' || c == '=' || c == '"' || c == '\\' || c == 0x7F) {
+                break;
+            }
+        }
+
+        if (*pRun == '\0') {
+            zrpLoggerEncoderAppend(pEncoder, pString, (size_t)(pRun - pString));
+            return;
+        }
+    }
+
+    zrpLoggerEncoderAppendChar(pEncoder, '"');
+    for (pRun = pString;; ++pString) {
+        c = (unsigned char)*pString;
+        if (c >= ' ' && c != '"' && c != '\\') {
+            continue;
+        }
+
+        zrpLoggerEncoderAppend(pEncoder, pRun, (size_t)(pString - pRun));
+        if (c == '\0') {
+            break;
+        }
+
+        escape[0] = '\\';
+        switch (c) {
+            case '"':
+            case '\\':
+                escape[1] = (char)c;
+                zrpLoggerEncoderAppend(pEncoder, escape, 2);
+                break;
+            case '\n':
+                escape[1] = 'n';
+                zrpLoggerEncoderAppend(pEncoder, escape, 2);
+                break;
+            case '\r':
+                escape[1] = 'r';
+                zrpLoggerEncoderAppend(pEncoder, escape, 2);
+                break;
+            case '\t':
+                escape[1] = 't';
+                zrpLoggerEncoderAppend(pEncoder, escape, 2);
+                break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = hexDigits[c >> 4];
+                escape[5] = hexDigits[c & 0xF];
+                zrpLoggerEncoderAppend(pEncoder, escape, 6);
+        }
+
+        pRun = pString + 1;
+    }
+
+    zrpLoggerEncoderAppendChar(pEncoder, '"');
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncoderAppendKey(struct ZrpLoggerEncoder *pEncoder,
+                          const char *pKey,
+                          int json)
+{
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, pEncoder->size > 0 ? ',' : '{');
+        zrpLoggerEncoderAppendString(pEncoder, pKey, 1);
+        zrpLoggerEncoderAppendChar(pEncoder, ':');
+    } else {
+        if (pEncoder->size > 0) {
+            zrpLoggerEncoderAppendChar(pEncoder, ' ');
+        }
+
+        zrpLoggerEncoderAppendString(pEncoder, pKey, 0);
+        zrpLoggerEncoderAppendChar(pEncoder, '=');
+    }
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLoggerEncodeFields(struct ZrpLoggerEncoder *pEncoder,
+                      enum ZrLogEncoding encoding,
+                      enum ZrLogLevel level,
+                      const char *pFile,
+                      int line,
+                      const char *pMessage,
+                      const struct ZrLogField *pFields,
+                      size_t fieldCount)
+{
+    const struct ZrpLoggerLabel *pLabel;
+    char timestamp[ZRP_LOGGER_TIMESTAMP_SIZE];
+    ZrUint64 time;
+    size_t i;
+    int json;
+
+    json = encoding == ZR_LOG_ENCODING_JSON;
+
+    if (zrpLoggerGetWallTime(&time) != ZR_SUCCESS) {
+        time = 0;
+    }
+
+    zrpLoggerFormatTimestamp(timestamp, time);
+    zrpLoggerEncoderAppendKey(pEncoder, "ts", json);
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, '"');
+    }
+
+    zrpLoggerEncoderAppend(pEncoder, timestamp, sizeof timestamp);
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, '"');
+    }
+
+    /* The labels are in the form `error: `. */
+    pLabel = &zrpLoggerLevelLabels[level];
+    zrpLoggerEncoderAppendKey(pEncoder, "level", json);
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, '"');
+    }
+
+    zrpLoggerEncoderAppend(pEncoder, pLabel->pString, pLabel->size - 2);
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, '"');
+    }
+
+    zrpLoggerEncoderAppendKey(pEncoder, "thread", json);
+    zrpLoggerEncoderAppendUnsigned(pEncoder,
+                                   (ZrUint64)zrpLoggerGetThreadId());
+    zrpLoggerEncoderAppendKey(pEncoder, "file", json);
+    zrpLoggerEncoderAppendString(pEncoder, pFile, json);
+    zrpLoggerEncoderAppendKey(pEncoder, "line", json);
+    zrpLoggerEncoderAppendSigned(pEncoder, (ZrInt64)line);
+    zrpLoggerEncoderAppendKey(pEncoder, "msg", json);
+    zrpLoggerEncoderAppendString(pEncoder, pMessage, json);
+
+    for (i = 0; i < fieldCount; ++i) {
+        zrpLoggerEncoderAppendKey(pEncoder, pFields[i].pKey, json);
+        switch (pFields[i].type) {
+            case ZR_LOG_FIELD_TYPE_STRING:
+                zrpLoggerEncoderAppendString(
+                    pEncoder, pFields[i].pString, json);
+                break;
+            case ZR_LOG_FIELD_TYPE_INT:
+                zrpLoggerEncoderAppendSigned(pEncoder, pFields[i].intValue);
+                break;
+            case ZR_LOG_FIELD_TYPE_UINT:
+                zrpLoggerEncoderAppendUnsigned(pEncoder, pFields[i].uintValue);
+                break;
+            case ZR_LOG_FIELD_TYPE_DOUBLE:
+                zrpLoggerEncoderAppendDouble(
+                    pEncoder, pFields[i].doubleValue, json);
+                break;
+            case ZR_LOG_FIELD_TYPE_BOOL:
+                if (pFields[i].intValue) {
+                    zrpLoggerEncoderAppend(pEncoder, "true", 4);
+                } else {
+                    zrpLoggerEncoderAppend(pEncoder, "false", 5);
+                }
+
+                break;
+            default:
+                ZR_ASSERT(0);
+        }
+    }
+
+    if (json) {
+        zrpLoggerEncoderAppendChar(pEncoder, '}');
+    }
+
+    zrpLoggerEncoderAppendChar(pEncoder, '\n');
+}
+
+/*
+   The flight recorder gives each logging thread a ring that only the thread
+   writes to, publishing its position with a release store so that a dump can
+   read the rings at any time without any lock.
+*/
+
+#define ZRP_LOGGER_DEFAULT_FLIGHT_RING_SIZE 65536
+
+struct ZrpFlightRing {
+    struct ZrpFlightRing *pNext;
+    unsigned long threadId;
+    char *pData;
+    size_t size;
+    volatile size_t position;
+};
+
+struct ZrpFlightRecorder {
+    void *volatile pRings;
+    size_t ringSize;
+    size_t generation;
+};
+
+static void *volatile zrpFlightRecorder;
+static size_t zrpFlightRecorderGeneration;
+static volatile int zrpFlightRecorderFd = -1;
+static ZRP_LOGGER_THREAD_LOCAL struct ZrpFlightRing *zrpLoggerThreadRing;
+static ZRP_LOGGER_THREAD_LOCAL size_t zrpLoggerThreadRingGeneration;
+
+ZRP_MAYBE_UNUSED static struct ZrpFlightRing *
+zrpFlightRecorderGetThreadRing(struct ZrpFlightRecorder *pRecorder)
+{
+    struct ZrpFlightRing *pRing;
+    void *pHead;
+
+    if (zrpLoggerThreadRing != NULL
+        && zrpLoggerThreadRingGeneration == pRecorder->generation) {
+        return zrpLoggerThreadRing;
+    }
+
+    pRing = (struct ZrpFlightRing *)zrAllocate(
+        (ZrSize)(sizeof *pRing + pRecorder->ringSize));
+    if (pRing == NULL) {
+        return NULL;
+    }
+
+    pRing->threadId = zrpLoggerGetThreadId();
+    pRing->pData = (char *)&pRing[1];
+    pRing->size = pRecorder->ringSize;
+    pRing->position = 0;
+
+    do {
+        pHead = zrpAtomicLoadPointerAcquire(&pRecorder->pRings);
+        pRing->pNext = (struct ZrpFlightRing *)pHead;
+    } while (
+        !zrpAtomicCompareExchangePointer(&pRecorder->pRings, pHead, pRing));
+
+    zrpLoggerThreadRing = pRing;
+    zrpLoggerThreadRingGeneration = pRecorder->generation;
+    return pRing;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpFlightRecorderWrite(struct ZrpFlightRecorder *pRecorder,
+                       const char *pData,
+                       size_t size)
+{
+    struct ZrpFlightRing *pRing;
+    size_t position;
+    size_t offset;
+    size_t chunkSize;
+
+    pRing = zrpFlightRecorderGetThreadRing(pRecorder);
+    if (pRing == NULL) {
+        return;
+    }
+
+    position = pRing->position;
+    if (size > pRing->size) {
+        position += size - pRing->size;
+        pData += size - pRing->size;
+        size = pRing->size;
+    }
+
+    offset = position % pRing->size;
+    chunkSize = pRing->size - offset;
+    if (chunkSize > size) {
+        chunkSize = size;
+    }
+
+    memcpy(&pRing->pData[offset], pData, chunkSize);
+    memcpy(pRing->pData, &pData[chunkSize], size - chunkSize);
+    zrpAtomicStoreSizeRelease(&pRing->position, position + size);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpFlightRecorderHandleSignal(int signalNumber)
+{
+    zrDumpFlightRecorder(zrpAtomicLoadIntRelaxed(&zrpFlightRecorderFd));
+
+    /* The default action was restored before calling this handler. */
+    raise(signalNumber);
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpLogVaList(int targets,
+             enum ZrLogLevel level,
+             const char *pFile,
+             int line,
+             const char *pFormat,
+             va_list args)
+{
+    struct ZrLogSink *pSinks;
+    struct ZrpAsyncLogger *pLogger;
+    struct ZrpFlightRecorder *pRecorder;
+    char stackBuffer[ZRP_LOGGER_STACK_BUFFER_SIZE];
+    char *pRecord;
+    size_t size;
+    int styled;
+    va_list argsCopy;
+
+    pSinks = (struct ZrLogSink *)zrpAtomicLoadPointerAcquire(&zrpLogSinks);
+    if (pSinks != NULL && !zrpLogSinksAcceptLevel(pSinks, level)) {
+        targets &= ~ZR_LOG_TARGET_OUTPUT;
+    }
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+
+    pRecorder = NULL;
+    if (targets & ZR_LOG_TARGET_FLIGHT_RECORDER) {
+        pRecorder = (struct ZrpFlightRecorder *)zrpAtomicLoadPointerAcquire(
+            &zrpFlightRecorder);
+    }
+
+    if (pRecorder != NULL) {
+        va_copy(argsCopy, args);
+        size = zrpLoggerFormatRecord(
+            &pRecord, stackBuffer, 0, level, pFile, line, pFormat, argsCopy);
+        va_end(argsCopy);
+        zrpFlightRecorderWrite(pRecorder, pRecord, size);
+
+        /* Output the same record unless it needs to be styled. */
+        if (pSinks == NULL) {
+            styled = pLogger != NULL ? pLogger->styled
+                                     : zrpLoggerIsStderrStyled();
+        } else {
+            styled = 0;
+        }
+
+        if ((targets & ZR_LOG_TARGET_OUTPUT) && !styled) {
+            zrpLoggerEmitRecord(pSinks, level, pRecord, size);
+            targets &= ~ZR_LOG_TARGET_OUTPUT;
+        }
+
+        if (pRecord != stackBuffer) {
+            zrFree(pRecord);
+        }
+    }
+
+    if (!(targets & ZR_LOG_TARGET_OUTPUT)) {
+        return;
+    }
+
+    if (pLogger != NULL) {
+        zrpAsyncLoggerLogVaList(
+            pLogger, pSinks, level, pFile, line, pFormat, args);
+        return;
+    }
+
+    zrpLoggerLogVaListSync(pSinks, level, pFile, line, pFormat, args);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLog(enum ZrLogLevel level,
+      const char *pFile,
+      int line,
+      const char *pFormat,
+      ...)
+{
+    va_list args;
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    va_start(args, pFormat);
+    zrLogVaList(level, pFile, line, pFormat, args);
+    va_end(args);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLogVaList(enum ZrLogLevel level,
             const char *pFile,
             int line,
             const char *pFormat,
@@ -81,7 +3149,861 @@ zrLogVaList(enum ZrLogLevel level,
     ZR_ASSERT(pFile != NULL);
     ZR_ASSERT(pFormat != NULL);
 
-    zrpLoggerLogVaList(level, pFile, line, pFormat, args);
+    zrpLogVaList(ZR_LOG_TARGET_OUTPUT | ZR_LOG_TARGET_FLIGHT_RECORDER,
+                 level,
+                 pFile,
+                 line,
+                 pFormat,
+                 args);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLogToTargets(int targets,
+               enum ZrLogLevel level,
+               const char *pFile,
+               int line,
+               const char *pFormat,
+               ...)
+{
+    va_list args;
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+
+    va_start(args, pFormat);
+    zrpLogVaList(targets, level, pFile, line, pFormat, args);
+    va_end(args);
+}
+
+/*
+   Return the asynchronous logger if it defers the formatting of the records
+   logged to the given targets, or NULL otherwise.
+*/
+ZRP_MAYBE_UNUSED static struct ZrpAsyncLogger *
+zrpLoggerGetDeferringLogger(int targets)
+{
+    struct ZrpAsyncLogger *pLogger;
+
+    /* The flight recorder only keeps formatted records. */
+    if ((targets & ZR_LOG_TARGET_FLIGHT_RECORDER)
+        && zrpAtomicLoadPointerAcquire(&zrpFlightRecorder) != NULL) {
+        return NULL;
+    }
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+    if (pLogger == NULL || !pLogger->options.deferFormatting) {
+        return NULL;
+    }
+
+    return pLogger;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE int
+zrIsLogFormattingDeferred(int targets)
+{
+    return zrpLoggerGetDeferringLogger(targets) != NULL;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE int
+zrLogPackedArguments(int targets,
+                     enum ZrLogLevel level,
+                     const char *pFile,
+                     int line,
+                     const char *pFormat,
+                     const void *pArguments,
+                     ZrSize size)
+{
+    struct ZrpLoggerDeferredRecord record;
+    struct ZrpAsyncLogger *pLogger;
+    struct ZrpLoggerBuffer *pBuffer;
+    struct ZrLogSink *pSinks;
+    char stackBuffer[ZRP_LOGGER_STACK_BUFFER_SIZE];
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pFormat != NULL);
+    ZR_ASSERT(pArguments != NULL || size == 0);
+
+    pLogger = zrpLoggerGetDeferringLogger(targets);
+    if (pLogger == NULL || (size_t)size > sizeof stackBuffer - sizeof record) {
+        return 0;
+    }
+
+    pSinks = (struct ZrLogSink *)zrpAtomicLoadPointerAcquire(&zrpLogSinks);
+    if (!(targets & ZR_LOG_TARGET_OUTPUT)
+        || (pSinks != NULL && !zrpLogSinksAcceptLevel(pSinks, level))) {
+        return 1;
+    }
+
+    pBuffer = zrpAsyncLoggerGetThreadBuffer(pLogger);
+    if (pBuffer == NULL) {
+        return 0;
+    }
+
+    zrpLoggerGetOrigin(&record.origin);
+    record.pFile = pFile;
+    record.pFormat = pFormat;
+    record.line = line;
+    record.level = (int)level;
+    memcpy(stackBuffer, &record, sizeof record);
+    memcpy(&stackBuffer[sizeof record], pArguments, (size_t)size);
+    zrpAsyncLoggerPush(pLogger,
+                       pBuffer,
+                       ZRP_LOGGER_RECORD_TYPE_DEFERRED,
+                       level,
+                       stackBuffer,
+                       sizeof record + (size_t)size);
+    return 1;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrLoggerStartAsync(const struct ZrAsyncLoggerOptions *pOptions)
+{
+    enum ZrStatus status;
+    struct ZrpAsyncLogger *pLogger;
+
+    ZR_ASSERT(zrpAsyncLogger == NULL);
+
+    pLogger = (struct ZrpAsyncLogger *)zrAllocate(sizeof *pLogger);
+    if (pLogger == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the asynchronous logger\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    memset(&pLogger->options, 0, sizeof pLogger->options);
+    if (pOptions != NULL) {
+        pLogger->options = *pOptions;
+    }
+
+    if (pLogger->options.bufferSize == 0) {
+        pLogger->options.bufferSize = ZRP_LOGGER_DEFAULT_BUFFER_SIZE;
+    }
+
+    if (pLogger->options.writeSize == 0) {
+        pLogger->options.writeSize = ZRP_LOGGER_DEFAULT_WRITE_SIZE;
+    }
+
+    if (pLogger->options.flushInterval == 0) {
+        pLogger->options.flushInterval = ZRP_LOGGER_DEFAULT_FLUSH_INTERVAL;
+    }
+
+    if (pLogger->options.sampleRate == 0) {
+        pLogger->options.sampleRate = ZRP_LOGGER_DEFAULT_SAMPLE_RATE;
+    }
+
+    if (pLogger->options.bufferSize < ZRP_LOGGER_MIN_BUFFER_SIZE) {
+        pLogger->options.bufferSize = ZRP_LOGGER_MIN_BUFFER_SIZE;
+    }
+
+    pLogger->options.bufferSize = (ZrSize)zrpLoggerRoundUpToPowerOfTwo(
+        (size_t)pLogger->options.bufferSize);
+    pLogger->pBuffers = NULL;
+    pLogger->generation = ++zrpAsyncLoggerGeneration;
+    pLogger->stopping = 0;
+    pLogger->writeBufferSize = 0;
+
+    pLogger->styled = zrpLoggerIsStderrStyled();
+
+    pLogger->pWriteBuffer
+        = (char *)zrAllocate((ZrSize)pLogger->options.writeSize);
+    if (pLogger->pWriteBuffer == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the asynchronous logger\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto logger_undo;
+    }
+
+    pLogger->scratchSize = ZRP_LOGGER_SCRATCH_SIZE;
+    pLogger->pScratch = (char *)zrAllocate((ZrSize)pLogger->scratchSize);
+    if (pLogger->pScratch == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the asynchronous logger\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto write_buffer_undo;
+    }
+
+    status = zrpMutexCreate(&pLogger->mutex);
+    if (status != ZR_SUCCESS) {
+        goto scratch_undo;
+    }
+
+    status = zrpConditionCreate(&pLogger->condition);
+    if (status != ZR_SUCCESS) {
+        goto mutex_undo;
+    }
+
+    status = zrpThreadCreate(&pLogger->thread, zrpAsyncLoggerRun, pLogger);
+    if (status != ZR_SUCCESS) {
+        goto condition_undo;
+    }
+
+    /* Flush any record previously written through the standard streams. */
+    fflush(stderr);
+
+    zrpAtomicStorePointerRelease(&zrpAsyncLogger, pLogger);
+    return ZR_SUCCESS;
+
+condition_undo:
+    zrpConditionDestroy(&pLogger->condition);
+
+mutex_undo:
+    zrpMutexDestroy(&pLogger->mutex);
+
+scratch_undo:
+    zrFree(pLogger->pScratch);
+
+write_buffer_undo:
+    zrFree(pLogger->pWriteBuffer);
+
+logger_undo:
+    zrFree(pLogger);
+    return status;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLoggerStopAsync(void)
+{
+    struct ZrpAsyncLogger *pLogger;
+    struct ZrpLoggerBuffer *pBuffer;
+    struct ZrpLoggerBuffer *pNext;
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAsyncLogger;
+    if (pLogger == NULL) {
+        return;
+    }
+
+    zrpAtomicStorePointerRelease(&zrpAsyncLogger, NULL);
+
+    zrpMutexLock(&pLogger->mutex);
+    zrpAtomicStoreSizeRelease(&pLogger->stopping, 1);
+    zrpConditionSignal(&pLogger->condition);
+    zrpMutexUnlock(&pLogger->mutex);
+    zrpThreadJoin(pLogger->thread);
+
+    pBuffer = (struct ZrpLoggerBuffer *)pLogger->pBuffers;
+    while (pBuffer != NULL) {
+        pNext = pBuffer->pNext;
+        zrFreeAligned(pBuffer);
+        pBuffer = pNext;
+    }
+
+    zrpConditionDestroy(&pLogger->condition);
+    zrpMutexDestroy(&pLogger->mutex);
+    zrFree(pLogger->pScratch);
+    zrFree(pLogger->pWriteBuffer);
+    zrFree(pLogger);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLoggerFlush(void)
+{
+    struct ZrpAsyncLogger *pLogger;
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+    if (pLogger == NULL) {
+        fflush(stderr);
+        zrpLogSinksFlush(
+            (struct ZrLogSink *)zrpAtomicLoadPointerAcquire(&zrpLogSinks));
+        return;
+    }
+
+    zrpMutexLock(&pLogger->mutex);
+    zrpAsyncLoggerDrain(pLogger);
+    zrpMutexUnlock(&pLogger->mutex);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFileLogSink(struct ZrLogSink **ppSink,
+                    const char *pPath,
+                    ZrSize maxFileSize,
+                    ZrUint32 maxFileCount)
+{
+    enum ZrStatus status;
+    struct ZrLogSink *pSink;
+    size_t pathSize;
+
+    ZR_ASSERT(ppSink != NULL);
+    ZR_ASSERT(pPath != NULL);
+
+    /* Room for the path and for two rotated paths with their suffix. */
+    pathSize = strlen(pPath) + 1;
+    status = zrpLogSinkCreate(
+        &pSink, ZRP_LOG_SINK_TYPE_FILE, pathSize + 2 * (pathSize + 16));
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    pSink->pPath = (char *)&pSink[1];
+    pSink->pSourcePath = &pSink->pPath[pathSize];
+    pSink->pDestinationPath = &pSink->pSourcePath[pathSize + 16];
+    pSink->maxFileSize = (size_t)maxFileSize;
+    pSink->maxFileCount = maxFileCount;
+    memcpy(pSink->pPath, pPath, pathSize);
+
+    pSink->pFile = fopen(pPath, "ab");
+    if (pSink->pFile == NULL) {
+        ZRP_LOG_ERROR("failed to open the log file '%s'\n", pPath);
+        zrpMutexDestroy(&pSink->mutex);
+        zrFree(pSink);
+        return ZR_ERROR;
+    }
+
+    if (fseek(pSink->pFile, 0, SEEK_END) == 0) {
+        long position;
+
+        position = ftell(pSink->pFile);
+        pSink->fileSize = position > 0 ? (size_t)position : 0;
+    }
+
+    *ppSink = pSink;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFdLogSink(struct ZrLogSink **ppSink, int fd)
+{
+    enum ZrStatus status;
+
+    ZR_ASSERT(ppSink != NULL);
+    ZR_ASSERT(fd >= 0);
+
+    status = zrpLogSinkCreate(ppSink, ZRP_LOG_SINK_TYPE_FD, 0);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    (*ppSink)->fd = fd;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateMemoryLogSink(struct ZrLogSink **ppSink, ZrSize size)
+{
+    enum ZrStatus status;
+
+    ZR_ASSERT(ppSink != NULL);
+    ZR_ASSERT(size > 0);
+
+    status = zrpLogSinkCreate(ppSink, ZRP_LOG_SINK_TYPE_MEMORY, (size_t)size);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    (*ppSink)->pRing = (char *)&(*ppSink)[1];
+    (*ppSink)->ringSize = (size_t)size;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrCreateFunctionLogSink(struct ZrLogSink **ppSink,
+                        ZrLogSinkFunction pfnFunction,
+                        void *pData)
+{
+    enum ZrStatus status;
+
+    ZR_ASSERT(ppSink != NULL);
+    ZR_ASSERT(pfnFunction != NULL);
+
+    status = zrpLogSinkCreate(ppSink, ZRP_LOG_SINK_TYPE_FUNCTION, 0);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    (*ppSink)->pfnFunction = pfnFunction;
+    (*ppSink)->pData = pData;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrDestroyLogSink(struct ZrLogSink *pSink)
+{
+    if (pSink == NULL) {
+        return;
+    }
+
+    if (pSink->type == ZRP_LOG_SINK_TYPE_FILE && pSink->pFile != NULL) {
+        fclose(pSink->pFile);
+    }
+
+    zrpMutexDestroy(&pSink->mutex);
+    zrFree(pSink);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrSetLogSinkLevel(struct ZrLogSink *pSink, enum ZrLogLevel level)
+{
+    ZR_ASSERT(pSink != NULL);
+
+    zrpAtomicStoreIntRelaxed(&pSink->level, (int)level);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrAddLogSink(struct ZrLogSink *pSink)
+{
+    struct ZrpAsyncLogger *pLogger;
+
+    ZR_ASSERT(pSink != NULL);
+
+    /* Prevent the background thread from draining into the sinks. */
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+    if (pLogger != NULL) {
+        zrpMutexLock(&pLogger->mutex);
+    }
+
+    pSink->pNext = (struct ZrLogSink *)zrpLogSinks;
+    zrpAtomicStorePointerRelease(&zrpLogSinks, pSink);
+
+    if (pLogger != NULL) {
+        zrpMutexUnlock(&pLogger->mutex);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrRemoveLogSink(struct ZrLogSink *pSink)
+{
+    struct ZrpAsyncLogger *pLogger;
+    struct ZrLogSink *pSinks;
+    struct ZrLogSink *pPrevious;
+
+    ZR_ASSERT(pSink != NULL);
+
+    pLogger = (struct ZrpAsyncLogger *)zrpAtomicLoadPointerAcquire(
+        &zrpAsyncLogger);
+    if (pLogger != NULL) {
+        /* Records that went through this sink's level are written out. */
+        zrpMutexLock(&pLogger->mutex);
+        zrpAsyncLoggerDrain(pLogger);
+    }
+
+    pSinks = (struct ZrLogSink *)zrpLogSinks;
+    if (pSinks == pSink) {
+        zrpAtomicStorePointerRelease(&zrpLogSinks, pSink->pNext);
+    } else {
+        for (pPrevious = pSinks; pPrevious != NULL;
+             pPrevious = pPrevious->pNext) {
+            if (pPrevious->pNext == pSink) {
+                pPrevious->pNext = pSink->pNext;
+                break;
+            }
+        }
+    }
+
+    zrpLogSinkFlush(pSink);
+    pSink->pNext = NULL;
+
+    if (pLogger != NULL) {
+        zrpMutexUnlock(&pLogger->mutex);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrDumpMemoryLogSink(const struct ZrLogSink *pSink, int fd)
+{
+    size_t position;
+    size_t offset;
+
+    ZR_ASSERT(pSink != NULL);
+    ZR_ASSERT(pSink->type == ZRP_LOG_SINK_TYPE_MEMORY);
+
+    position = zrpAtomicLoadSizeAcquire(&pSink->ringPosition);
+    if (position <= pSink->ringSize) {
+        zrpLoggerWriteFd(fd, pSink->pRing, position);
+        return;
+    }
+
+    offset = position % pSink->ringSize;
+    zrpLoggerWriteFd(fd, &pSink->pRing[offset], pSink->ringSize - offset);
+    zrpLoggerWriteFd(fd, pSink->pRing, offset);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrSetLogLevel(enum ZrLogLevel level)
+{
+    zrpAtomicStoreIntRelaxed(&zrpLoggerLevel, (int)level);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrLogLevel
+zrGetLogLevel(void)
+{
+    return (enum ZrLogLevel)zrpAtomicLoadIntRelaxed(&zrpLoggerLevel);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrSetLogModuleLevel(struct ZrLogModule *pModule, enum ZrLogLevel level)
+{
+    ZR_ASSERT(pModule != NULL);
+
+    zrpAtomicStoreIntRelaxed(&pModule->level, (int)level);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrResetLogModuleLevel(struct ZrLogModule *pModule)
+{
+    ZR_ASSERT(pModule != NULL);
+
+    zrpAtomicStoreIntRelaxed(&pModule->level, ZRP_LOG_MODULE_LEVEL_INHERITED);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrSetLogSiteEnabled(const char *pFile, int line, int enabled)
+{
+    struct ZrLogSite *pSite;
+    enum ZrStatus status;
+
+    ZR_ASSERT(pFile != NULL);
+
+    status = ZR_ERROR;
+    for (pSite = (struct ZrLogSite *)zrpAtomicLoadPointerAcquire(&zrpLogSites);
+         pSite != NULL;
+         pSite = pSite->pNext) {
+        if (pSite->line != line || strcmp(pSite->pFile, pFile) != 0) {
+            continue;
+        }
+
+        if (enabled) {
+            zrpAtomicFetchOrInt(&pSite->state, ZRP_LOG_SITE_STATE_ENABLED);
+        } else {
+            zrpAtomicFetchAndInt(&pSite->state, ~ZRP_LOG_SITE_STATE_ENABLED);
+        }
+
+        status = ZR_SUCCESS;
+    }
+
+    return status;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE int
+zrGetLogSiteTargets(struct ZrLogSite *pSite,
+                    const struct ZrLogModule *pModule,
+                    enum ZrLogLevel level)
+{
+    int state;
+    int maxLevel;
+    int targets;
+    void *pSites;
+
+    ZR_ASSERT(pSite != NULL);
+
+    state = zrpAtomicLoadIntRelaxed(&pSite->state);
+    if (!(state & ZRP_LOG_SITE_STATE_REGISTERED)) {
+        state = zrpAtomicFetchOrInt(&pSite->state,
+                                    ZRP_LOG_SITE_STATE_REGISTERED);
+        if (!(state & ZRP_LOG_SITE_STATE_REGISTERED)) {
+            do {
+                pSites = zrpAtomicLoadPointerAcquire(&zrpLogSites);
+                pSite->pNext = (struct ZrLogSite *)pSites;
+            } while (!zrpAtomicCompareExchangePointer(
+                &zrpLogSites, pSites, pSite));
+        }
+    }
+
+    targets = 0;
+    if (zrpAtomicLoadPointerAcquire(&zrpFlightRecorder) != NULL) {
+        targets |= ZR_LOG_TARGET_FLIGHT_RECORDER;
+    }
+
+    if (state & ZRP_LOG_SITE_STATE_ENABLED) {
+        return targets | ZR_LOG_TARGET_OUTPUT;
+    }
+
+    maxLevel = ZRP_LOG_MODULE_LEVEL_INHERITED;
+    if (pModule != NULL) {
+        maxLevel = zrpAtomicLoadIntRelaxed(&pModule->level);
+    }
+
+    if (maxLevel == ZRP_LOG_MODULE_LEVEL_INHERITED) {
+        maxLevel = zrpAtomicLoadIntRelaxed(&zrpLoggerLevel);
+    }
+
+    if ((int)level <= maxLevel) {
+        targets |= ZR_LOG_TARGET_OUTPUT;
+    }
+
+    return targets;
+}
+
+/*
+   Monotonic time in milliseconds for the rate limits, read from a coarse
+   clock when there is one since suppressed calls also need to read it.
+*/
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpLoggerGetLimitTime(ZrUint64 *pTime)
+{
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec time;
+
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &time) != 0) {
+        return ZR_ERROR;
+    }
+
+    *pTime = (ZrUint64)time.tv_sec * 1000 + (ZrUint64)time.tv_nsec / 1000000;
+    return ZR_SUCCESS;
+#else
+    if (zrpClockGetRealTime(pTime) != ZR_SUCCESS) {
+        return ZR_ERROR;
+    }
+
+    *pTime /= 1000000;
+    return ZR_SUCCESS;
+#endif
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE int
+zrCheckLogLimit(struct ZrLogLimit *pLimit,
+                enum ZrLogLimitType type,
+                ZrSize value,
+                ZrSize *pSuppressedCount)
+{
+    volatile size_t *pCount;
+    volatile size_t *pSuppressed;
+    volatile size_t *pTime;
+    size_t count;
+    size_t suppressedCount;
+    size_t interval;
+    size_t now;
+    size_t last;
+    ZrUint64 time;
+
+    ZR_ASSERT(pLimit != NULL);
+    ZR_ASSERT(pSuppressedCount != NULL);
+
+    /* `ZrSize` has the size of `size_t` but may be a distinct type. */
+    pCount = (volatile size_t *)(volatile void *)&pLimit->count;
+    pSuppressed = (volatile size_t *)(volatile void *)&pLimit->suppressedCount;
+    pTime = (volatile size_t *)(volatile void *)&pLimit->time;
+
+    *pSuppressedCount = 0;
+    switch (type) {
+        case ZR_LOG_LIMIT_TYPE_EVERY_N:
+            ZR_ASSERT(value > 0);
+            count = zrpAtomicFetchAddSize(pCount, 1);
+            if (count % (size_t)value != 0) {
+                return 0;
+            }
+
+            *pSuppressedCount = count > 0 ? value - 1 : 0;
+            return 1;
+        case ZR_LOG_LIMIT_TYPE_FIRST_N:
+            /* Stop counting once the limit is reached to never wrap around. */
+            if (zrpAtomicLoadSizeRelaxed(pCount) >= (size_t)value) {
+                return 0;
+            }
+
+            return zrpAtomicFetchAddSize(pCount, 1) < (size_t)value;
+        case ZR_LOG_LIMIT_TYPE_EVERY_MS:
+            if (zrpLoggerGetLimitTime(&time) != ZR_SUCCESS) {
+                return 1;
+            }
+
+            /* Wrapping around is fine as long as the interval fits. */
+            now = (size_t)time;
+            interval = (size_t)value;
+            if (zrpAtomicFetchAddSize(pCount, 1) > 0) {
+                do {
+                    last = zrpAtomicLoadSizeRelaxed(pTime);
+                    if (now - last < interval) {
+                        zrpAtomicFetchAddSize(pSuppressed, 1);
+                        return 0;
+                    }
+                } while (!zrpAtomicCompareExchangeSizeRelaxed(
+                    pTime, last, now));
+            } else {
+                zrpAtomicStoreSizeRelaxed(pTime, now);
+            }
+
+            suppressedCount = zrpAtomicLoadSizeRelaxed(pSuppressed);
+            zrpAtomicFetchAddSize(pSuppressed, (size_t)0 - suppressedCount);
+            *pSuppressedCount = (ZrSize)suppressedCount;
+            return 1;
+        default:
+            ZR_ASSERT(0);
+    }
+
+    return 1;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrSetLogEncoding(enum ZrLogEncoding encoding)
+{
+    zrpAtomicStoreIntRelaxed(&zrpLoggerEncoding, (int)encoding);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLogFields(enum ZrLogLevel level,
+            const char *pFile,
+            int line,
+            const char *pMessage,
+            const struct ZrLogField *pFields,
+            ZrSize fieldCount)
+{
+    struct ZrLogSink *pSinks;
+    struct ZrpFlightRecorder *pRecorder;
+    struct ZrpLoggerEncoder encoder;
+    char stackBuffer[ZRP_LOGGER_STACK_BUFFER_SIZE];
+
+    ZR_ASSERT(pFile != NULL);
+    ZR_ASSERT(pMessage != NULL);
+    ZR_ASSERT(pFields != NULL || fieldCount == 0);
+
+    pSinks = (struct ZrLogSink *)zrpAtomicLoadPointerAcquire(&zrpLogSinks);
+    if (pSinks != NULL && !zrpLogSinksAcceptLevel(pSinks, level)
+        && zrpAtomicLoadPointerAcquire(&zrpFlightRecorder) == NULL) {
+        return;
+    }
+
+    encoder.pData = stackBuffer;
+    encoder.size = 0;
+    encoder.capacity = sizeof stackBuffer;
+    encoder.pStackBuffer = stackBuffer;
+    encoder.failed = 0;
+    zrpLoggerEncodeFields(
+        &encoder,
+        (enum ZrLogEncoding)zrpAtomicLoadIntRelaxed(&zrpLoggerEncoding),
+        level,
+        pFile,
+        line,
+        pMessage,
+        pFields,
+        (size_t)fieldCount);
+    if (encoder.failed) {
+        ZRP_LOG_ERROR("failed to allocate the structured record\n");
+    } else {
+        pRecorder = (struct ZrpFlightRecorder *)zrpAtomicLoadPointerAcquire(
+            &zrpFlightRecorder);
+        if (pRecorder != NULL) {
+            zrpFlightRecorderWrite(pRecorder, encoder.pData, encoder.size);
+        }
+
+        if (pSinks == NULL || zrpLogSinksAcceptLevel(pSinks, level)) {
+            zrpLoggerEmitRecord(pSinks, level, encoder.pData, encoder.size);
+        }
+    }
+
+    if (encoder.pData != stackBuffer) {
+        zrFree(encoder.pData);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrLoggerStartFlightRecorder(ZrSize ringSize)
+{
+    struct ZrpFlightRecorder *pRecorder;
+
+    ZR_ASSERT(zrpFlightRecorder == NULL);
+
+    pRecorder = (struct ZrpFlightRecorder *)zrAllocate(sizeof *pRecorder);
+    if (pRecorder == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the flight recorder\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pRecorder->pRings = NULL;
+    pRecorder->ringSize
+        = ringSize > 0 ? (size_t)ringSize : ZRP_LOGGER_DEFAULT_FLIGHT_RING_SIZE;
+    pRecorder->generation = ++zrpFlightRecorderGeneration;
+
+    zrpAtomicStorePointerRelease(&zrpFlightRecorder, pRecorder);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrLoggerStopFlightRecorder(void)
+{
+    struct ZrpFlightRecorder *pRecorder;
+    struct ZrpFlightRing *pRing;
+    struct ZrpFlightRing *pNext;
+
+    pRecorder = (struct ZrpFlightRecorder *)zrpFlightRecorder;
+    if (pRecorder == NULL) {
+        return;
+    }
+
+    zrpAtomicStorePointerRelease(&zrpFlightRecorder, NULL);
+
+    pRing = (struct ZrpFlightRing *)pRecorder->pRings;
+    while (pRing != NULL) {
+        pNext = pRing->pNext;
+        zrFree(pRing);
+        pRing = pNext;
+    }
+
+    zrFree(pRecorder);
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE void
+zrDumpFlightRecorder(int fd)
+{
+    static const char header[] = "flight recorder: thread ";
+    struct ZrpFlightRecorder *pRecorder;
+    struct ZrpFlightRing *pRing;
+    char digits[24];
+    size_t digitCount;
+    size_t position;
+    size_t offset;
+    unsigned long threadId;
+
+    pRecorder = (struct ZrpFlightRecorder *)zrpAtomicLoadPointerAcquire(
+        &zrpFlightRecorder);
+    if (pRecorder == NULL) {
+        return;
+    }
+
+    for (pRing = (struct ZrpFlightRing *)zrpAtomicLoadPointerAcquire(
+             &pRecorder->pRings);
+         pRing != NULL;
+         pRing = pRing->pNext) {
+        threadId = pRing->threadId;
+        digitCount = sizeof digits;
+        digits[--digitCount] = '\n';
+        do {
+            digits[--digitCount] = (char)('0' + threadId % 10);
+            threadId /= 10;
+        } while (threadId > 0);
+
+        zrpLoggerWriteFd(fd, header, sizeof header - 1);
+        zrpLoggerWriteFd(fd, &digits[digitCount], sizeof digits - digitCount);
+
+        position = zrpAtomicLoadSizeAcquire(&pRing->position);
+        if (position <= pRing->size) {
+            zrpLoggerWriteFd(fd, pRing->pData, position);
+            continue;
+        }
+
+        offset = position % pRing->size;
+        zrpLoggerWriteFd(fd, &pRing->pData[offset], pRing->size - offset);
+        zrpLoggerWriteFd(fd, pRing->pData, offset);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_LOGGER_LINKAGE enum ZrStatus
+zrInstallFlightRecorderCrashHandler(int fd)
+{
+    static const int signals[] = {SIGSEGV, SIGABRT};
+    size_t i;
+
+    zrpAtomicStoreIntRelaxed(&zrpFlightRecorderFd, fd);
+
+    for (i = 0; i < sizeof signals / sizeof signals[0]; ++i) {
+#if defined(ZRP_LOGGER_USE_SIGACTION)
+        struct sigaction action;
+
+        memset(&action, 0, sizeof action);
+        action.sa_handler = zrpFlightRecorderHandleSignal;
+        action.sa_flags = (int)SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(signals[i], &action, NULL) != 0) {
+            ZRP_LOG_ERROR("failed to install the crash handler\n");
+            return ZR_ERROR;
+        }
+#else
+        if (signal(signals[i], zrpFlightRecorderHandleSignal) == SIG_ERR) {
+            ZRP_LOG_ERROR("failed to install the crash handler\n");
+            return ZR_ERROR;
+        }
+#endif
+    }
+
+    return ZR_SUCCESS;
 }
 
 #endif /* ZRP_LOGGER_IMPLEMENTATION_DEFINED */
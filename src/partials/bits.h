@@ -0,0 +1,60 @@
+#ifndef ZRP_BITS_DEFINED
+#define ZRP_BITS_DEFINED
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+ZRP_MAYBE_UNUSED static unsigned int
+zrpBitsCountOnes(ZrUint64 x)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (unsigned int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static unsigned int
+zrpBitsCountTrailingZeros(ZrUint64 x)
+{
+    ZR_ASSERT(x != 0);
+
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctzll(x);
+#else
+    {
+        unsigned int out;
+
+        out = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            ++out;
+        }
+
+        return out;
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static unsigned int
+zrpBitsSelect(ZrUint64 x, unsigned int rank)
+{
+    /* Position of the set bit having `rank` set bits below it. */
+    ZR_ASSERT(rank < zrpBitsCountOnes(x));
+
+#if defined(__BMI2__) && defined(__x86_64__)
+    return zrpBitsCountTrailingZeros(_pdep_u64((ZrUint64)1 << rank, x));
+#else
+    while (rank-- > 0) {
+        x &= x - 1;
+    }
+
+    return zrpBitsCountTrailingZeros(x);
+#endif
+}
+
+#endif /* ZRP_BITS_DEFINED */
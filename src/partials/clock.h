@@ -0,0 +1,120 @@
+#ifndef ZRP_CLOCK_DEFINED
+#define ZRP_CLOCK_DEFINED
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(ZRP_PLATFORM_DARWIN)
+#include <mach/mach_time.h>
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
+#include <time.h>
+#define ZRP_CLOCK_USE_CLOCK_GETTIME
+#if defined(CLOCK_MONOTONIC_RAW)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC_RAW
+#elif defined(CLOCK_MONOTONIC)
+#define ZRP_CLOCK_ID CLOCK_MONOTONIC
+#else
+#define ZRP_CLOCK_ID CLOCK_REALTIME
+#endif
+#else
+#include <sys/time.h>
+#endif
+#else
+typedef char zrp_clock_unsupported_platform[-1];
+#endif
+
+/*
+    In some cases, tick values are casted to 64-bit floating-points in order
+    to prevent (unlikely) integer overflows during some arithmetic operations.
+    This effectively reducse the precision of the ticks having a value greater
+    than 2^53, which corresponds to approximatively 104 days.
+*/
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpClockGetRealTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    {
+        static double timeToNano;
+        LARGE_INTEGER time;
+
+        if (timeToNano == 0.0) {
+            LARGE_INTEGER frequency;
+
+            if (!QueryPerformanceFrequency(&frequency)) {
+                ZRP_LOG_ERROR("failed to retrieve the time's frequency\n");
+                return ZR_ERROR;
+            }
+
+            timeToNano = 1000000000.0 / frequency.QuadPart;
+        }
+
+        if (!QueryPerformanceCounter(&time)) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = time.QuadPart * timeToNano;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_DARWIN)
+    /*
+       Since Darwin 5.2, `clock_gettime()` can return high resolution times
+       with the `CLOCK_UPTIME_RAW` clock but it internally only calls
+       `mach_absolute_time()` with the overhead of converting the result into
+       the `timespec` format.
+    */
+    {
+        static double timeToNano;
+
+        if (timeToNano == 0.0) {
+            mach_timebase_info_data_t info;
+
+            if (mach_timebase_info(&info) != KERN_SUCCESS) {
+                ZRP_LOG_ERROR("failed to retrieve the current time\n");
+                return ZR_ERROR;
+            }
+
+            timeToNano = (double)info.numer / info.denom;
+        }
+
+        *pTime = mach_absolute_time() * timeToNano;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    {
+        struct timespec time;
+
+        if (clock_gettime(ZRP_CLOCK_ID, &time) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
+        return ZR_SUCCESS;
+    }
+#else
+    {
+        struct timeval time;
+
+        if (gettimeofday(&time, NULL) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current time\n");
+            return ZR_ERROR;
+        }
+
+        *pTime = (ZrUint64)time.tv_sec * 1000000000ull
+                 + (ZrUint64)time.tv_usec * 1000ull;
+        return ZR_SUCCESS;
+    }
+#endif
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+#endif /* ZRP_CLOCK_DEFINED */
@@ -0,0 +1,236 @@
+#ifndef ZRP_THREADS_DEFINED
+#define ZRP_THREADS_DEFINED
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define ZRP_THREAD_RETURN_TYPE DWORD
+#define ZRP_THREAD_CALL WINAPI
+#define ZRP_THREAD_RETURN_VALUE 0
+typedef HANDLE ZrpThread;
+typedef CRITICAL_SECTION ZrpMutex;
+typedef CONDITION_VARIABLE ZrpCondition;
+#elif defined(ZRP_PLATFORM_UNIX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define ZRP_THREAD_RETURN_TYPE void *
+#define ZRP_THREAD_CALL
+#define ZRP_THREAD_RETURN_VALUE NULL
+typedef pthread_t ZrpThread;
+typedef pthread_mutex_t ZrpMutex;
+typedef pthread_cond_t ZrpCondition;
+#else
+typedef char zrp_threads_unsupported_platform[-1];
+#endif
+
+typedef ZRP_THREAD_RETURN_TYPE(ZRP_THREAD_CALL *ZrpThreadFunction)(void *);
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpThreadCreate(ZrpThread *pThread, ZrpThreadFunction pfnFunction, void *pArg)
+{
+    ZR_ASSERT(pThread != NULL);
+    ZR_ASSERT(pfnFunction != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    *pThread = CreateThread(NULL, 0, pfnFunction, pArg, 0, NULL);
+    if (*pThread == NULL) {
+        ZRP_LOG_ERROR("failed to create a thread\n");
+        return ZR_ERROR;
+    }
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_create(pThread, NULL, pfnFunction, pArg) != 0) {
+        ZRP_LOG_ERROR("failed to create a thread\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpThreadJoin(ZrpThread thread)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_join(thread, NULL);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpThreadYield(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SwitchToThread();
+#elif defined(ZRP_PLATFORM_UNIX)
+    sched_yield();
+#endif
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpMutexCreate(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    InitializeCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_mutex_init(pMutex, NULL) != 0) {
+        ZRP_LOG_ERROR("failed to create a mutex\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexDestroy(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    DeleteCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_destroy(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexLock(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    EnterCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_lock(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpMutexUnlock(ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    LeaveCriticalSection(pMutex);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_mutex_unlock(pMutex);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpConditionCreate(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    InitializeConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    if (pthread_cond_init(pCondition, NULL) != 0) {
+        ZRP_LOG_ERROR("failed to create a condition variable\n");
+        return ZR_ERROR;
+    }
+#endif
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionDestroy(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_destroy(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionWait(ZrpCondition *pCondition, ZrpMutex *pMutex)
+{
+    ZR_ASSERT(pCondition != NULL);
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SleepConditionVariableCS(pCondition, pMutex, INFINITE);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_wait(pCondition, pMutex);
+#endif
+}
+
+/* Spurious wake-ups are possible, as with `zrpConditionWait()`. */
+ZRP_MAYBE_UNUSED static void
+zrpConditionTimedWait(ZrpCondition *pCondition,
+                      ZrpMutex *pMutex,
+                      ZrUint32 milliseconds)
+{
+    ZR_ASSERT(pCondition != NULL);
+    ZR_ASSERT(pMutex != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SleepConditionVariableCS(pCondition, pMutex, (DWORD)milliseconds);
+#elif defined(ZRP_PLATFORM_UNIX)
+    {
+        struct timeval now;
+        struct timespec deadline;
+        long nanoseconds;
+
+        gettimeofday(&now, NULL);
+        nanoseconds = (long)now.tv_usec * 1000L
+                      + (long)(milliseconds % 1000) * 1000000L;
+        deadline.tv_sec = now.tv_sec + (time_t)(milliseconds / 1000)
+                          + (time_t)(nanoseconds / 1000000000L);
+        deadline.tv_nsec = nanoseconds % 1000000000L;
+        pthread_cond_timedwait(pCondition, pMutex, &deadline);
+    }
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionSignal(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WakeConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_signal(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpConditionBroadcast(ZrpCondition *pCondition)
+{
+    ZR_ASSERT(pCondition != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    WakeAllConditionVariable(pCondition);
+#elif defined(ZRP_PLATFORM_UNIX)
+    pthread_cond_broadcast(pCondition);
+#endif
+}
+
+ZRP_MAYBE_UNUSED static size_t
+zrpGetProcessorCount(void)
+{
+#if defined(ZRP_PLATFORM_WINDOWS)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (size_t)info.dwNumberOfProcessors;
+#elif defined(ZRP_PLATFORM_UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    long count;
+
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#else
+    return 1;
+#endif
+}
+
+#endif /* ZRP_THREADS_DEFINED */
@@ -0,0 +1,581 @@
+/* @include "partials/license.h" */
+
+#ifndef ZERO_RINGBUFFER_H
+#define ZERO_RINGBUFFER_H
+
+#define ZR_RINGBUFFER_MAJOR_VERSION 0
+#define ZR_RINGBUFFER_MINOR_VERSION 1
+#define ZR_RINGBUFFER_PATCH_VERSION 0
+
+/* @include "partials/environment.h" */
+/* @include "partials/platform.h" */
+/* @include "partials/types.h" */
+
+/* @include "partials/status.h" */
+
+#if defined(ZR_RINGBUFFER_SPECIFY_INTERNAL_LINKAGE)                            \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_RINGBUFFER_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_RINGBUFFER_LINKAGE extern "C"
+#else
+#define ZRP_RINGBUFFER_LINKAGE extern
+#endif
+
+struct ZrSpscRingBuffer;
+struct ZrMpmcRingBuffer;
+
+#define ZRP_RINGBUFFER_DECLARE_CREATE_FUNCTION(name, type, buffer)             \
+    ZRP_RINGBUFFER_LINKAGE enum ZrStatus zrCreate##name(                       \
+        struct buffer **ppBuffer, ZrSize capacity)
+
+#define ZRP_RINGBUFFER_DECLARE_DESTROY_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE void zrDestroy##name(struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_GET_CAPACITY_FUNCTION(name, type, buffer)       \
+    ZRP_RINGBUFFER_LINKAGE void zrGet##name##Capacity(                         \
+        ZrSize *pCapacity, const struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_ENQUEUE_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE int zrEnqueue##name(struct buffer *pBuffer,         \
+                                               type value)
+
+#define ZRP_RINGBUFFER_DECLARE_DEQUEUE_FUNCTION(name, type, buffer)            \
+    ZRP_RINGBUFFER_LINKAGE int zrDequeue##name(type *pValue,                   \
+                                               struct buffer *pBuffer)
+
+#define ZRP_RINGBUFFER_DECLARE_ENQUEUE_BATCH_FUNCTION(name, type, buffer)      \
+    ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(                        \
+        ZrSize *pCount,                                                        \
+        struct buffer *pBuffer,                                                \
+        ZrSize size,                                                           \
+        const type *pValues)
+
+#define ZRP_RINGBUFFER_DECLARE_DEQUEUE_BATCH_FUNCTION(name, type, buffer)      \
+    ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(                        \
+        ZrSize *pCount, type *pValues, struct buffer *pBuffer, ZrSize size)
+
+#define ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, buffer)                   \
+    ZRP_RINGBUFFER_DECLARE_CREATE_FUNCTION(name, type, buffer);                \
+    ZRP_RINGBUFFER_DECLARE_DESTROY_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_GET_CAPACITY_FUNCTION(name, type, buffer);          \
+    ZRP_RINGBUFFER_DECLARE_ENQUEUE_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_DEQUEUE_FUNCTION(name, type, buffer);               \
+    ZRP_RINGBUFFER_DECLARE_ENQUEUE_BATCH_FUNCTION(name, type, buffer);         \
+    ZRP_RINGBUFFER_DECLARE_DEQUEUE_BATCH_FUNCTION(name, type, buffer);
+
+/*
+   Ring buffers are bounded lock-free queues, with their capacity rounded up
+   to the next power of two. The SPSC variant supports a single producer
+   thread and a single consumer thread, while the MPMC variant supports any
+   number of both.
+
+   Enqueuing returns 0 when the buffer is full, and dequeuing returns 0 when
+   it is empty. The batch variants transfer as many elements as possible, up
+   to the given size, using a single atomic operation to publish or claim all
+   of them, and return the number of elements transferred.
+*/
+#define ZR_MAKE_SPSC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, ZrSpscRingBuffer)
+
+#define ZR_MAKE_MPMC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DECLARE_FUNCTIONS(name, type, ZrMpmcRingBuffer)
+
+#endif /* ZERO_RINGBUFFER_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED
+#define ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "allocator.h"
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+/* @include "partials/unused.h" */
+/* @include "partials/logging.h" */
+/* @include "partials/loglevel.h" */
+/* @include "partials/logger.h" */
+/* @include "partials/atomics.h" */
+
+#define ZRP_RINGBUFFER_ALIGN(size)                                             \
+    (((size) + ZR_CACHE_LINE_SIZE - 1) / ZR_CACHE_LINE_SIZE                    \
+     * ZR_CACHE_LINE_SIZE)
+
+#define ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(name, type, buffer, prefix)      \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE enum ZrStatus zrCreate##name(      \
+        struct buffer **ppBuffer, ZrSize capacity)                             \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+                                                                               \
+        ZR_ASSERT(ppBuffer != NULL);                                           \
+                                                                               \
+        status = prefix##Create(ppBuffer, (size_t)capacity, sizeof(type));     \
+        if (status != ZR_SUCCESS) {                                            \
+            ZRP_LOG_ERROR("failed to create the ring buffer of type "          \
+                          "‘" #type "’ (requested capacity: %zu)\n",           \
+                          (size_t)capacity);                                   \
+            return status;                                                     \
+        }                                                                      \
+                                                                               \
+        return ZR_SUCCESS;                                                     \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDestroy##name(              \
+        struct buffer *pBuffer)                                                \
+    {                                                                          \
+        if (pBuffer == NULL) {                                                 \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        zrFreeAligned(pBuffer);                                                \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, buffer)        \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrGet##name##Capacity(        \
+        ZrSize *pCapacity, const struct buffer *pBuffer)                       \
+    {                                                                          \
+        ZR_ASSERT(pCapacity != NULL);                                          \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+                                                                               \
+        *pCapacity = (ZrSize)(pBuffer->mask + 1);                              \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE int zrEnqueue##name(               \
+        struct buffer *pBuffer, type value)                                    \
+    {                                                                          \
+        ZrSize count;                                                          \
+                                                                               \
+        zrEnqueue##name##Batch(&count, pBuffer, 1, &value);                    \
+        return count != 0;                                                     \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, buffer)             \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE int zrDequeue##name(               \
+        type *pValue, struct buffer *pBuffer)                                  \
+    {                                                                          \
+        ZrSize count;                                                          \
+                                                                               \
+        zrDequeue##name##Batch(&count, pValue, pBuffer, 1);                    \
+        return count != 0;                                                     \
+    }
+
+/*
+   The SPSC variant keeps the positions of the consumer and of the producer
+   on separate cache lines, each next to a cached copy of the other position
+   so that the shared one only needs to be loaded again when the cached copy
+   says that the buffer looks full, or empty. Positions increase forever and
+   wrap around the range of `size_t`.
+*/
+
+struct ZrSpscRingBuffer {
+    unsigned char *pElements;
+    size_t mask;
+    size_t elementSize;
+    unsigned char sharedPadding[ZR_CACHE_LINE_SIZE - 3 * sizeof(size_t)];
+    volatile size_t head;
+    size_t cachedTail;
+    unsigned char headPadding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+    volatile size_t tail;
+    size_t cachedHead;
+    unsigned char tailPadding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpRingBufferGetCapacity(size_t *pCapacity,
+                         size_t capacity,
+                         size_t elementSize,
+                         size_t offset)
+{
+    size_t out;
+
+    ZR_ASSERT(pCapacity != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    out = 2;
+    while (out < capacity) {
+        if (out > (size_t)-1 / 2) {
+            ZRP_LOG_TRACE("the requested capacity is too large\n");
+            return ZR_ERROR_MAX_SIZE_EXCEEDED;
+        }
+
+        out *= 2;
+    }
+
+    if (out > ((size_t)-1 - offset) / elementSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    *pCapacity = out;
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpSpscRingBufferCreate(struct ZrSpscRingBuffer **ppBuffer,
+                        size_t capacity,
+                        size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrSpscRingBuffer *pBuffer;
+    size_t offset;
+
+    ZR_ASSERT(ppBuffer != NULL);
+
+    offset = ZRP_RINGBUFFER_ALIGN(sizeof *pBuffer);
+    status = zrpRingBufferGetCapacity(&capacity, capacity, elementSize, offset);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    pBuffer = (struct ZrSpscRingBuffer *)zrAllocateAligned(
+        (ZrSize)(offset + capacity * elementSize), ZR_CACHE_LINE_SIZE);
+    if (pBuffer == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the ring buffer\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pBuffer->pElements = (unsigned char *)pBuffer + offset;
+    pBuffer->mask = capacity - 1;
+    pBuffer->elementSize = elementSize;
+    pBuffer->head = 0;
+    pBuffer->cachedTail = 0;
+    pBuffer->tail = 0;
+    pBuffer->cachedHead = 0;
+
+    *ppBuffer = pBuffer;
+    return ZR_SUCCESS;
+}
+
+/* Number of elements, up to `size`, that the producer can write. */
+ZRP_MAYBE_UNUSED static size_t
+zrpSpscRingBufferAcquireWrite(size_t *pPosition,
+                              struct ZrSpscRingBuffer *pBuffer,
+                              size_t size)
+{
+    size_t available;
+
+    *pPosition = zrpAtomicLoadSizeRelaxed(&pBuffer->tail);
+    available = pBuffer->mask + 1 - (*pPosition - pBuffer->cachedHead);
+    if (available < size) {
+        pBuffer->cachedHead = zrpAtomicLoadSizeAcquire(&pBuffer->head);
+        available = pBuffer->mask + 1 - (*pPosition - pBuffer->cachedHead);
+    }
+
+    return available < size ? available : size;
+}
+
+/* Number of elements, up to `size`, that the consumer can read. */
+ZRP_MAYBE_UNUSED static size_t
+zrpSpscRingBufferAcquireRead(size_t *pPosition,
+                             struct ZrSpscRingBuffer *pBuffer,
+                             size_t size)
+{
+    size_t available;
+
+    *pPosition = zrpAtomicLoadSizeRelaxed(&pBuffer->head);
+    available = pBuffer->cachedTail - *pPosition;
+    if (available < size) {
+        pBuffer->cachedTail = zrpAtomicLoadSizeAcquire(&pBuffer->tail);
+        available = pBuffer->cachedTail - *pPosition;
+    }
+
+    return available < size ? available : size;
+}
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_SPSC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        struct ZrSpscRingBuffer *pBuffer,                                      \
+        ZrSize size,                                                           \
+        const type *pValues)                                                   \
+    {                                                                          \
+        type *pElements;                                                       \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+                                                                               \
+        count = zrpSpscRingBufferAcquireWrite(                                 \
+            &position, pBuffer, (size_t)size);                                 \
+        pElements = (type *)(void *)pBuffer->pElements;                        \
+        for (i = 0; i < count; ++i) {                                          \
+            pElements[(position + i) & pBuffer->mask] = pValues[i];            \
+        }                                                                      \
+                                                                               \
+        if (count > 0) {                                                       \
+            zrpAtomicStoreSizeRelease(&pBuffer->tail, position + count);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_SPSC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        type *pValues,                                                         \
+        struct ZrSpscRingBuffer *pBuffer,                                      \
+        ZrSize size)                                                           \
+    {                                                                          \
+        const type *pElements;                                                 \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+                                                                               \
+        count = zrpSpscRingBufferAcquireRead(                                  \
+            &position, pBuffer, (size_t)size);                                 \
+        pElements = (const type *)(const void *)pBuffer->pElements;            \
+        for (i = 0; i < count; ++i) {                                          \
+            pValues[i] = pElements[(position + i) & pBuffer->mask];            \
+        }                                                                      \
+                                                                               \
+        if (count > 0) {                                                       \
+            zrpAtomicStoreSizeRelease(&pBuffer->head, position + count);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+/*
+   The MPMC variant follows Dmitry Vyukov's bounded queue, where each element
+   is paired with a sequence number telling whether it is ready to be written
+   for a given position, when equal to that position, or ready to be read,
+   when equal to that position plus one. Producers and consumers claim their
+   positions by moving their respective counter forward with a single
+   compare-and-swap, covering as many consecutive elements as are found ready.
+
+   The sequence numbers are stored apart from the elements to allow for any
+   element type without having to worry about alignment.
+*/
+
+struct ZrMpmcRingBuffer {
+    volatile size_t *pSequences;
+    unsigned char *pElements;
+    size_t mask;
+    size_t elementSize;
+    unsigned char sharedPadding[ZR_CACHE_LINE_SIZE - 4 * sizeof(size_t)];
+    volatile size_t enqueuePosition;
+    unsigned char enqueuePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+    volatile size_t dequeuePosition;
+    unsigned char dequeuePadding[ZR_CACHE_LINE_SIZE - sizeof(size_t)];
+};
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpMpmcRingBufferCreate(struct ZrMpmcRingBuffer **ppBuffer,
+                        size_t capacity,
+                        size_t elementSize)
+{
+    enum ZrStatus status;
+    struct ZrMpmcRingBuffer *pBuffer;
+    size_t sequencesOffset;
+    size_t elementsOffset;
+    size_t i;
+
+    ZR_ASSERT(ppBuffer != NULL);
+
+    sequencesOffset = ZRP_RINGBUFFER_ALIGN(sizeof *pBuffer);
+    status = zrpRingBufferGetCapacity(
+        &capacity, capacity, elementSize + sizeof(size_t), sequencesOffset);
+    if (status != ZR_SUCCESS) {
+        return status;
+    }
+
+    elementsOffset = ZRP_RINGBUFFER_ALIGN(sequencesOffset
+                                          + capacity * sizeof(size_t));
+    if (elementsOffset < sequencesOffset
+        || capacity > ((size_t)-1 - elementsOffset) / elementSize) {
+        ZRP_LOG_TRACE("the requested capacity is too large\n");
+        return ZR_ERROR_MAX_SIZE_EXCEEDED;
+    }
+
+    pBuffer = (struct ZrMpmcRingBuffer *)zrAllocateAligned(
+        (ZrSize)(elementsOffset + capacity * elementSize), ZR_CACHE_LINE_SIZE);
+    if (pBuffer == NULL) {
+        ZRP_LOG_TRACE("failed to allocate the ring buffer\n");
+        return ZR_ERROR_ALLOCATION;
+    }
+
+    pBuffer->pSequences
+        = (volatile size_t *)(void *)((unsigned char *)pBuffer
+                                      + sequencesOffset);
+    pBuffer->pElements = (unsigned char *)pBuffer + elementsOffset;
+    pBuffer->mask = capacity - 1;
+    pBuffer->elementSize = elementSize;
+    pBuffer->enqueuePosition = 0;
+    pBuffer->dequeuePosition = 0;
+    for (i = 0; i < capacity; ++i) {
+        pBuffer->pSequences[i] = i;
+    }
+
+    *ppBuffer = pBuffer;
+    return ZR_SUCCESS;
+}
+
+/*
+   Claim up to `size` consecutive positions from the given counter, for which
+   the sequence numbers are equal to the position plus the given offset.
+*/
+ZRP_MAYBE_UNUSED static size_t
+zrpMpmcRingBufferClaim(size_t *pPosition,
+                       struct ZrMpmcRingBuffer *pBuffer,
+                       volatile size_t *pCounter,
+                       size_t offset,
+                       size_t size)
+{
+    size_t position;
+    size_t sequence;
+    size_t count;
+
+    ZR_ASSERT(size > 0);
+
+    position = zrpAtomicLoadSizeRelaxed(pCounter);
+    for (;;) {
+        sequence = zrpAtomicLoadSizeAcquire(
+            &pBuffer->pSequences[position & pBuffer->mask]);
+        if (sequence != position + offset) {
+            /*
+               A sequence number lagging behind means that the buffer is full,
+               or empty, otherwise another thread already claimed the
+               position.
+            */
+            if ((ptrdiff_t)(sequence - (position + offset)) < 0) {
+                return 0;
+            }
+
+            position = zrpAtomicLoadSizeRelaxed(pCounter);
+            continue;
+        }
+
+        count = 1;
+        while (count < size
+               && zrpAtomicLoadSizeAcquire(
+                      &pBuffer->pSequences[(position + count) & pBuffer->mask])
+                      == position + count + offset) {
+            ++count;
+        }
+
+        if (zrpAtomicCompareExchangeSizeRelaxed(
+                pCounter, position, position + count)) {
+            *pPosition = position;
+            return count;
+        }
+
+        position = zrpAtomicLoadSizeRelaxed(pCounter);
+    }
+}
+
+#define ZRP_RINGBUFFER_DEFINE_ENQUEUE_MPMC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrEnqueue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        struct ZrMpmcRingBuffer *pBuffer,                                      \
+        ZrSize size,                                                           \
+        const type *pValues)                                                   \
+    {                                                                          \
+        type *pElements;                                                       \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t index;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+                                                                               \
+        count = size == 0 ? 0                                                  \
+                          : zrpMpmcRingBufferClaim(&position,                  \
+                                                   pBuffer,                    \
+                                                   &pBuffer->enqueuePosition,  \
+                                                   0,                          \
+                                                   (size_t)size);              \
+        pElements = (type *)(void *)pBuffer->pElements;                        \
+        for (i = 0; i < count; ++i) {                                          \
+            index = (position + i) & pBuffer->mask;                            \
+            pElements[index] = pValues[i];                                     \
+            zrpAtomicStoreSizeRelease(&pBuffer->pSequences[index],             \
+                                      position + i + 1);                       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#define ZRP_RINGBUFFER_DEFINE_DEQUEUE_MPMC_BATCH_FUNCTION(name, type)          \
+    ZRP_MAYBE_UNUSED ZRP_RINGBUFFER_LINKAGE void zrDequeue##name##Batch(       \
+        ZrSize *pCount,                                                        \
+        type *pValues,                                                         \
+        struct ZrMpmcRingBuffer *pBuffer,                                      \
+        ZrSize size)                                                           \
+    {                                                                          \
+        const type *pElements;                                                 \
+        size_t position;                                                       \
+        size_t count;                                                          \
+        size_t index;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pCount != NULL);                                             \
+        ZR_ASSERT(pValues != NULL || size == 0);                               \
+        ZR_ASSERT(pBuffer != NULL);                                            \
+        ZR_ASSERT(pBuffer->elementSize == sizeof(type));                       \
+                                                                               \
+        count = size == 0 ? 0                                                  \
+                          : zrpMpmcRingBufferClaim(&position,                  \
+                                                   pBuffer,                    \
+                                                   &pBuffer->dequeuePosition,  \
+                                                   1,                          \
+                                                   (size_t)size);              \
+        pElements = (const type *)(const void *)pBuffer->pElements;            \
+        for (i = 0; i < count; ++i) {                                          \
+            index = (position + i) & pBuffer->mask;                            \
+            pValues[i] = pElements[index];                                     \
+            zrpAtomicStoreSizeRelease(&pBuffer->pSequences[index],             \
+                                      position + i + pBuffer->mask + 1);       \
+        }                                                                      \
+                                                                               \
+        *pCount = (ZrSize)count;                                               \
+    }
+
+#undef ZR_MAKE_SPSC_RING_BUFFER
+#define ZR_MAKE_SPSC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(                                     \
+        name, type, ZrSpscRingBuffer, zrpSpscRingBuffer)                       \
+    ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, ZrSpscRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, ZrSpscRingBuffer)  \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_SPSC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_SPSC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, ZrSpscRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, ZrSpscRingBuffer)
+
+#undef ZR_MAKE_MPMC_RING_BUFFER
+#define ZR_MAKE_MPMC_RING_BUFFER(name, type)                                   \
+    ZRP_RINGBUFFER_DEFINE_CREATE_FUNCTION(                                     \
+        name, type, ZrMpmcRingBuffer, zrpMpmcRingBuffer)                       \
+    ZRP_RINGBUFFER_DEFINE_DESTROY_FUNCTION(name, type, ZrMpmcRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_GET_CAPACITY_FUNCTION(name, type, ZrMpmcRingBuffer)  \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_MPMC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_MPMC_BATCH_FUNCTION(name, type)              \
+    ZRP_RINGBUFFER_DEFINE_ENQUEUE_FUNCTION(name, type, ZrMpmcRingBuffer)       \
+    ZRP_RINGBUFFER_DEFINE_DEQUEUE_FUNCTION(name, type, ZrMpmcRingBuffer)
+
+#endif /* ZRP_RINGBUFFER_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
@@ -0,0 +1,805 @@
+/* @include "partials/license.h" */
+
+#ifndef ZERO_THREADPOOL_H
+#define ZERO_THREADPOOL_H
+
+#define ZR_THREADPOOL_MAJOR_VERSION 0
+#define ZR_THREADPOOL_MINOR_VERSION 1
+#define ZR_THREADPOOL_PATCH_VERSION 0
+
+/* @include "partials/environment.h" */
+/* @include "partials/platform.h" */
+/* @include "partials/types.h" */
+
+/* @include "partials/status.h" */
+
+#if defined(ZR_THREADPOOL_SPECIFY_INTERNAL_LINKAGE)                            \
+    || defined(ZR_SPECIFY_INTERNAL_LINKAGE)
+#define ZRP_THREADPOOL_LINKAGE static
+#elif defined(__cplusplus)
+#define ZRP_THREADPOOL_LINKAGE extern "C"
+#else
+#define ZRP_THREADPOOL_LINKAGE extern
+#endif
+
+struct ZrThreadPool;
+
+struct ZrParallelChunkTiming {
+    ZrSize begin;
+    ZrSize end;
+    ZrSize thread;
+    ZrUint64 start;
+    ZrUint64 duration;
+};
+
+typedef void (*ZrParallelForFunction)(void *pData,
+                                      ZrSize chunk,
+                                      ZrSize begin,
+                                      ZrSize end);
+
+ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrCreateThreadPool(struct ZrThreadPool **ppPool, ZrSize threadCount);
+
+ZRP_THREADPOOL_LINKAGE void
+zrDestroyThreadPool(struct ZrThreadPool *pPool);
+
+ZRP_THREADPOOL_LINKAGE void
+zrGetThreadPoolThreadCount(ZrSize *pThreadCount,
+                           const struct ZrThreadPool *pPool);
+
+/*
+   The chunks split the elements of the array at the given address, which may
+   be NULL if unknown, so that the threads writing to different chunks don't
+   share cache lines.
+*/
+ZRP_THREADPOOL_LINKAGE void
+zrGetParallelChunkCount(ZrSize *pChunkCount,
+                        const struct ZrThreadPool *pPool,
+                        const void *pArray,
+                        ZrSize size,
+                        ZrSize elementSize);
+
+/*
+   A pool runs a single job at a time, which the calling thread takes part in
+   until all the chunks are processed. The parallel functions must thus not be
+   called concurrently on the same pool, nor from within their callbacks.
+*/
+ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrParallelFor(struct ZrThreadPool *pPool,
+              const void *pArray,
+              ZrSize size,
+              ZrSize elementSize,
+              ZrParallelForFunction pfnFunction,
+              void *pData,
+              struct ZrParallelChunkTiming *pTimings);
+
+#define ZRP_THREADPOOL_DECLARE_FOR_EACH_FUNCTION(name, type)                   \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelForEach##name(              \
+        struct ZrThreadPool *pPool,                                            \
+        type *pArray,                                                          \
+        ZrSize size,                                                           \
+        void (*pfnFunction)(type * pElement, void *pData),                     \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZRP_THREADPOOL_DECLARE_TRANSFORM_FUNCTION(name, type)                  \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelTransform##name(            \
+        struct ZrThreadPool *pPool,                                            \
+        type *pOutput,                                                         \
+        const type *pInput,                                                    \
+        ZrSize size,                                                           \
+        void (*pfnFunction)(type * pOutput, const type *pInput, void *pData),  \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZRP_THREADPOOL_DECLARE_REDUCE_FUNCTION(name, type)                     \
+    ZRP_THREADPOOL_LINKAGE enum ZrStatus zrParallelReduce##name(               \
+        struct ZrThreadPool *pPool,                                            \
+        type *pResult,                                                         \
+        const type *pArray,                                                    \
+        ZrSize size,                                                           \
+        type initialValue,                                                     \
+        type (*pfnFunction)(type accumulator, type value, void *pData),        \
+        void *pData,                                                           \
+        struct ZrParallelChunkTiming *pTimings)
+
+#define ZR_MAKE_PARALLEL_ALGORITHMS(name, type)                                \
+    ZRP_THREADPOOL_DECLARE_FOR_EACH_FUNCTION(name, type);                      \
+    ZRP_THREADPOOL_DECLARE_TRANSFORM_FUNCTION(name, type);                     \
+    ZRP_THREADPOOL_DECLARE_REDUCE_FUNCTION(name, type);
+
+#endif /* ZERO_THREADPOOL_H */
+
+#ifdef ZR_DEFINE_IMPLEMENTATION
+#ifndef ZRP_THREADPOOL_IMPLEMENTATION_DEFINED
+#define ZRP_THREADPOOL_IMPLEMENTATION_DEFINED
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef ZR_ASSERT
+#include <assert.h>
+#define ZR_ASSERT assert
+#endif /* ZR_ASSERT */
+
+#ifndef ZR_MALLOC
+#include <stdlib.h>
+#define ZR_MALLOC malloc
+#endif /* ZR_MALLOC */
+
+#ifndef ZR_FREE
+#include <stdlib.h>
+#define ZR_FREE free
+#endif /* ZR_FREE */
+
+#ifndef ZR_CACHE_LINE_SIZE
+#define ZR_CACHE_LINE_SIZE 64
+#endif /* ZR_CACHE_LINE_SIZE */
+
+/* @include "partials/unused.h" */
+/* @include "partials/logging.h" */
+/* @include "partials/loglevel.h" */
+/* @include "partials/logger.h" */
+/* @include "partials/atomics.h" */
+/* @include "partials/threads.h" */
+/* @include "partials/clock.h" */
+
+/*
+   Each participating thread is assigned an even range of chunks to start
+   with. Enough chunks are created for every thread to get several of them so
+   that, once a thread runs out of chunks in its own range, it can steal the
+   remaining ones from the ranges of the other threads. Chunks are sized to
+   a multiple of the cache line size and the first one is extended up to the
+   first line boundary of the array to prevent threads from sharing lines
+   when writing to contiguous elements.
+*/
+
+#define ZRP_THREADPOOL_CHUNKS_PER_THREAD 4
+#define ZRP_THREADPOOL_MIN_CHUNK_BYTE_SIZE 4096
+
+typedef char zrp_threadpool_invalid_cache_line_size
+    [ZR_CACHE_LINE_SIZE >= 2 * sizeof(size_t) ? 1 : -1];
+
+struct ZrpThreadPoolRange {
+    volatile size_t next;
+    size_t end;
+    unsigned char padding[ZR_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
+
+struct ZrpThreadPoolJob {
+    ZrParallelForFunction pfnFunction;
+    void *pData;
+    size_t size;
+    size_t chunkSize;
+    size_t offset;
+    struct ZrParallelChunkTiming *pTimings;
+};
+
+struct ZrpThreadPoolWorker {
+    struct ZrThreadPool *pPool;
+    size_t index;
+    ZrpThread thread;
+};
+
+struct ZrThreadPool {
+    ZrpMutex mutex;
+    ZrpCondition startCondition;
+    ZrpCondition endCondition;
+    size_t generation;
+    size_t pendingWorkerCount;
+    int quit;
+    struct ZrpThreadPoolJob job;
+    struct ZrpThreadPoolRange *pRanges;
+    struct ZrpThreadPoolWorker *pWorkers;
+    size_t workerCount;
+};
+
+static size_t
+zrpThreadPoolGetGreatestCommonDivisor(size_t a, size_t b)
+{
+    size_t remainder;
+
+    while (b != 0) {
+        remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+/*
+   Retrieve the number of elements per chunk, the number of elements that
+   the first chunk has in excess to end on a cache line boundary, and the
+   resulting number of chunks.
+*/
+static void
+zrpThreadPoolGetChunks(size_t *pChunkSize,
+                       size_t *pOffset,
+                       size_t *pChunkCount,
+                       size_t participantCount,
+                       const void *pArray,
+                       size_t size,
+                       size_t elementSize)
+{
+    size_t granularity;
+    size_t chunkCount;
+    size_t minChunkSize;
+    size_t misalignment;
+    size_t i;
+
+    ZR_ASSERT(pChunkSize != NULL);
+    ZR_ASSERT(pOffset != NULL);
+    ZR_ASSERT(pChunkCount != NULL);
+    ZR_ASSERT(participantCount > 0);
+    ZR_ASSERT(elementSize > 0);
+
+    /* Smallest number of elements spanning a whole number of cache lines. */
+    granularity = ZR_CACHE_LINE_SIZE
+                  / zrpThreadPoolGetGreatestCommonDivisor(ZR_CACHE_LINE_SIZE,
+                                                          elementSize);
+
+    chunkCount = participantCount * ZRP_THREADPOOL_CHUNKS_PER_THREAD;
+    *pChunkSize = size / chunkCount + (size % chunkCount != 0);
+
+    minChunkSize = ZRP_THREADPOOL_MIN_CHUNK_BYTE_SIZE / elementSize;
+    if (*pChunkSize < minChunkSize) {
+        *pChunkSize = minChunkSize;
+    }
+
+    *pChunkSize = (*pChunkSize + granularity - 1) / granularity * granularity;
+
+    /*
+       Find the first element starting a cache line, if any does since the
+       elements might be less aligned than the cache line size requires.
+    */
+    *pOffset = 0;
+    misalignment = (size_t)((uintptr_t)pArray % ZR_CACHE_LINE_SIZE);
+    if (misalignment != 0) {
+        for (i = 1; i < granularity; ++i) {
+            if ((misalignment + i * elementSize) % ZR_CACHE_LINE_SIZE == 0) {
+                *pOffset = i;
+                break;
+            }
+        }
+    }
+
+    if (size <= *pChunkSize + *pOffset) {
+        *pChunkCount = 1;
+    } else {
+        size -= *pChunkSize + *pOffset;
+        *pChunkCount = 1 + size / *pChunkSize + (size % *pChunkSize != 0);
+    }
+}
+
+static void
+zrpThreadPoolRunChunk(struct ZrThreadPool *pPool,
+                      size_t participant,
+                      size_t chunk)
+{
+    const struct ZrpThreadPoolJob *pJob;
+    size_t begin;
+    size_t end;
+
+    pJob = &pPool->job;
+
+    begin = chunk == 0 ? 0 : chunk * pJob->chunkSize + pJob->offset;
+    end = (chunk + 1) * pJob->chunkSize + pJob->offset;
+    if (end > pJob->size) {
+        end = pJob->size;
+    }
+
+    if (pJob->pTimings == NULL) {
+        pJob->pfnFunction(
+            pJob->pData, (ZrSize)chunk, (ZrSize)begin, (ZrSize)end);
+    } else {
+        struct ZrParallelChunkTiming *pTiming;
+        ZrUint64 start;
+        ZrUint64 stop;
+
+        if (zrpClockGetRealTime(&start) != ZR_SUCCESS) {
+            start = 0;
+        }
+
+        pJob->pfnFunction(
+            pJob->pData, (ZrSize)chunk, (ZrSize)begin, (ZrSize)end);
+
+        if (zrpClockGetRealTime(&stop) != ZR_SUCCESS || stop < start) {
+            stop = start;
+        }
+
+        pTiming = &pJob->pTimings[chunk];
+        pTiming->begin = (ZrSize)begin;
+        pTiming->end = (ZrSize)end;
+        pTiming->thread = (ZrSize)participant;
+        pTiming->start = start;
+        pTiming->duration = stop - start;
+    }
+}
+
+static void
+zrpThreadPoolRunJob(struct ZrThreadPool *pPool, size_t participant)
+{
+    size_t participantCount;
+    size_t i;
+
+    participantCount = pPool->workerCount + 1;
+
+    /* Start with the own range and then steal from the others. */
+    for (i = 0; i < participantCount; ++i) {
+        struct ZrpThreadPoolRange *pRange;
+        size_t chunk;
+
+        pRange = &pPool->pRanges[(participant + i) % participantCount];
+        while (zrpAtomicLoadSizeRelaxed(&pRange->next) < pRange->end) {
+            chunk = zrpAtomicFetchAddSize(&pRange->next, 1);
+            if (chunk >= pRange->end) {
+                break;
+            }
+
+            zrpThreadPoolRunChunk(pPool, participant, chunk);
+        }
+    }
+}
+
+static ZRP_THREAD_RETURN_TYPE ZRP_THREAD_CALL
+zrpThreadPoolRunWorker(void *pArg)
+{
+    struct ZrpThreadPoolWorker *pWorker;
+    struct ZrThreadPool *pPool;
+    size_t generation;
+
+    pWorker = (struct ZrpThreadPoolWorker *)pArg;
+    pPool = pWorker->pPool;
+    generation = 0;
+
+    for (;;) {
+        zrpMutexLock(&pPool->mutex);
+        while (pPool->generation == generation && !pPool->quit) {
+            zrpConditionWait(&pPool->startCondition, &pPool->mutex);
+        }
+
+        if (pPool->quit) {
+            zrpMutexUnlock(&pPool->mutex);
+            break;
+        }
+
+        generation = pPool->generation;
+        zrpMutexUnlock(&pPool->mutex);
+
+        zrpThreadPoolRunJob(pPool, pWorker->index);
+
+        zrpMutexLock(&pPool->mutex);
+        if (--pPool->pendingWorkerCount == 0) {
+            zrpConditionSignal(&pPool->endCondition);
+        }
+
+        zrpMutexUnlock(&pPool->mutex);
+    }
+
+    return ZRP_THREAD_RETURN_VALUE;
+}
+
+static void
+zrpThreadPoolStopWorkers(struct ZrThreadPool *pPool, size_t workerCount)
+{
+    size_t i;
+
+    zrpMutexLock(&pPool->mutex);
+    pPool->quit = 1;
+    zrpConditionBroadcast(&pPool->startCondition);
+    zrpMutexUnlock(&pPool->mutex);
+
+    for (i = 0; i < workerCount; ++i) {
+        zrpThreadJoin(pPool->pWorkers[i].thread);
+    }
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrCreateThreadPool(struct ZrThreadPool **ppPool, ZrSize threadCount)
+{
+    enum ZrStatus status;
+    struct ZrThreadPool *pPool;
+    size_t i;
+
+    ZR_ASSERT(ppPool != NULL);
+
+    if (threadCount == 0) {
+        /* The calling thread also takes part in the work. */
+        threadCount = (ZrSize)zrpGetProcessorCount() - 1;
+    }
+
+    pPool = (struct ZrThreadPool *)ZR_MALLOC(sizeof *pPool);
+    if (pPool == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the thread pool\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto exit;
+    }
+
+    pPool->generation = 0;
+    pPool->pendingWorkerCount = 0;
+    pPool->quit = 0;
+    pPool->workerCount = 0;
+
+    pPool->pRanges = (struct ZrpThreadPoolRange *)ZR_MALLOC(
+        sizeof *pPool->pRanges * ((size_t)threadCount + 1));
+    if (pPool->pRanges == NULL) {
+        ZRP_LOG_ERROR("failed to allocate the chunk ranges\n");
+        status = ZR_ERROR_ALLOCATION;
+        goto pool_undo;
+    }
+
+    if (threadCount == 0) {
+        pPool->pWorkers = NULL;
+    } else {
+        pPool->pWorkers = (struct ZrpThreadPoolWorker *)ZR_MALLOC(
+            sizeof *pPool->pWorkers * (size_t)threadCount);
+        if (pPool->pWorkers == NULL) {
+            ZRP_LOG_ERROR("failed to allocate the workers\n");
+            status = ZR_ERROR_ALLOCATION;
+            goto ranges_undo;
+        }
+    }
+
+    status = zrpMutexCreate(&pPool->mutex);
+    if (status != ZR_SUCCESS) {
+        goto workers_undo;
+    }
+
+    status = zrpConditionCreate(&pPool->startCondition);
+    if (status != ZR_SUCCESS) {
+        goto mutex_undo;
+    }
+
+    status = zrpConditionCreate(&pPool->endCondition);
+    if (status != ZR_SUCCESS) {
+        goto start_condition_undo;
+    }
+
+    for (i = 0; i < (size_t)threadCount; ++i) {
+        pPool->pWorkers[i].pPool = pPool;
+        pPool->pWorkers[i].index = i + 1;
+        status = zrpThreadCreate(&pPool->pWorkers[i].thread,
+                                 zrpThreadPoolRunWorker,
+                                 &pPool->pWorkers[i]);
+        if (status != ZR_SUCCESS) {
+            ZRP_LOG_ERROR("failed to create the worker threads\n");
+            goto threads_undo;
+        }
+
+        ++pPool->workerCount;
+    }
+
+    *ppPool = pPool;
+    return ZR_SUCCESS;
+
+threads_undo:
+    zrpThreadPoolStopWorkers(pPool, pPool->workerCount);
+    zrpConditionDestroy(&pPool->endCondition);
+
+start_condition_undo:
+    zrpConditionDestroy(&pPool->startCondition);
+
+mutex_undo:
+    zrpMutexDestroy(&pPool->mutex);
+
+workers_undo:
+    ZR_FREE(pPool->pWorkers);
+
+ranges_undo:
+    ZR_FREE(pPool->pRanges);
+
+pool_undo:
+    ZR_FREE(pPool);
+
+exit:
+    return status;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrDestroyThreadPool(struct ZrThreadPool *pPool)
+{
+    if (pPool == NULL) {
+        return;
+    }
+
+    zrpThreadPoolStopWorkers(pPool, pPool->workerCount);
+    zrpConditionDestroy(&pPool->endCondition);
+    zrpConditionDestroy(&pPool->startCondition);
+    zrpMutexDestroy(&pPool->mutex);
+    ZR_FREE(pPool->pWorkers);
+    ZR_FREE(pPool->pRanges);
+    ZR_FREE(pPool);
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrGetThreadPoolThreadCount(ZrSize *pThreadCount,
+                           const struct ZrThreadPool *pPool)
+{
+    ZR_ASSERT(pThreadCount != NULL);
+    ZR_ASSERT(pPool != NULL);
+
+    *pThreadCount = (ZrSize)pPool->workerCount;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE void
+zrGetParallelChunkCount(ZrSize *pChunkCount,
+                        const struct ZrThreadPool *pPool,
+                        const void *pArray,
+                        ZrSize size,
+                        ZrSize elementSize)
+{
+    size_t chunkSize;
+    size_t offset;
+    size_t chunkCount;
+
+    ZR_ASSERT(pChunkCount != NULL);
+    ZR_ASSERT(pPool != NULL);
+
+    zrpThreadPoolGetChunks(&chunkSize,
+                           &offset,
+                           &chunkCount,
+                           pPool->workerCount + 1,
+                           pArray,
+                           (size_t)size,
+                           (size_t)elementSize);
+    *pChunkCount = (ZrSize)chunkCount;
+}
+
+ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus
+zrParallelFor(struct ZrThreadPool *pPool,
+              const void *pArray,
+              ZrSize size,
+              ZrSize elementSize,
+              ZrParallelForFunction pfnFunction,
+              void *pData,
+              struct ZrParallelChunkTiming *pTimings)
+{
+    size_t participantCount;
+    size_t chunkCount;
+    size_t i;
+
+    ZR_ASSERT(pPool != NULL);
+    ZR_ASSERT(pfnFunction != NULL);
+    ZR_ASSERT(elementSize > 0);
+
+    if (size == 0) {
+        return ZR_SUCCESS;
+    }
+
+    participantCount = pPool->workerCount + 1;
+
+    pPool->job.pfnFunction = pfnFunction;
+    pPool->job.pData = pData;
+    pPool->job.size = (size_t)size;
+    pPool->job.pTimings = pTimings;
+    zrpThreadPoolGetChunks(&pPool->job.chunkSize,
+                           &pPool->job.offset,
+                           &chunkCount,
+                           participantCount,
+                           pArray,
+                           (size_t)size,
+                           (size_t)elementSize);
+
+    for (i = 0; i < participantCount; ++i) {
+        zrpAtomicStoreSizeRelaxed(&pPool->pRanges[i].next,
+                                  chunkCount * i / participantCount);
+        pPool->pRanges[i].end = chunkCount * (i + 1) / participantCount;
+    }
+
+    if (pPool->workerCount == 0 || chunkCount == 1) {
+        for (i = 0; i < chunkCount; ++i) {
+            zrpThreadPoolRunChunk(pPool, 0, i);
+        }
+
+        return ZR_SUCCESS;
+    }
+
+    zrpMutexLock(&pPool->mutex);
+    ZR_ASSERT(pPool->pendingWorkerCount == 0);
+    pPool->pendingWorkerCount = pPool->workerCount;
+    ++pPool->generation;
+    zrpConditionBroadcast(&pPool->startCondition);
+    zrpMutexUnlock(&pPool->mutex);
+
+    zrpThreadPoolRunJob(pPool, 0);
+
+    zrpMutexLock(&pPool->mutex);
+    while (pPool->pendingWorkerCount != 0) {
+        zrpConditionWait(&pPool->endCondition, &pPool->mutex);
+    }
+
+    zrpMutexUnlock(&pPool->mutex);
+    return ZR_SUCCESS;
+}
+
+#define ZRP_THREADPOOL_DEFINE_FOR_EACH_FUNCTION(name, type)                    \
+    struct ZrpParallelForEach##name##Context {                                 \
+        type *pArray;                                                          \
+        void (*pfnFunction)(type *, void *);                                   \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelForEach##name##Chunk(                               \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelForEach##name##Context *pContext;              \
+        size_t i;                                                              \
+                                                                               \
+        (void)chunk;                                                           \
+        pContext = (const struct ZrpParallelForEach##name##Context *)pData;    \
+        for (i = (size_t)begin; i < (size_t)end; ++i) {                        \
+            pContext->pfnFunction(&pContext->pArray[i], pContext->pData);      \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelForEach##name(                                               \
+            struct ZrThreadPool *pPool,                                        \
+            type *pArray,                                                      \
+            ZrSize size,                                                       \
+            void (*pfnFunction)(type * pElement, void *pData),                 \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        struct ZrpParallelForEach##name##Context context;                      \
+                                                                               \
+        ZR_ASSERT(pArray != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        context.pArray = pArray;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        return zrParallelFor(pPool,                                            \
+                             pArray,                                           \
+                             size,                                             \
+                             (ZrSize)sizeof(type),                             \
+                             zrpParallelForEach##name##Chunk,                  \
+                             &context,                                         \
+                             pTimings);                                        \
+    }
+
+#define ZRP_THREADPOOL_DEFINE_TRANSFORM_FUNCTION(name, type)                   \
+    struct ZrpParallelTransform##name##Context {                               \
+        type *pOutput;                                                         \
+        const type *pInput;                                                    \
+        void (*pfnFunction)(type *, const type *, void *);                     \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelTransform##name##Chunk(                             \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelTransform##name##Context *pContext;            \
+        size_t i;                                                              \
+                                                                               \
+        (void)chunk;                                                           \
+        pContext = (const struct ZrpParallelTransform##name##Context *)pData;  \
+        for (i = (size_t)begin; i < (size_t)end; ++i) {                        \
+            pContext->pfnFunction(&pContext->pOutput[i],                       \
+                                  &pContext->pInput[i],                        \
+                                  pContext->pData);                            \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelTransform##name(                                             \
+            struct ZrThreadPool *pPool,                                        \
+            type *pOutput,                                                     \
+            const type *pInput,                                                \
+            ZrSize size,                                                       \
+            void (*pfnFunction)(                                               \
+                type * pOutput, const type *pInput, void *pData),              \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        struct ZrpParallelTransform##name##Context context;                    \
+                                                                               \
+        ZR_ASSERT(pOutput != NULL || size == 0);                               \
+        ZR_ASSERT(pInput != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        context.pOutput = pOutput;                                             \
+        context.pInput = pInput;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        return zrParallelFor(pPool,                                            \
+                             pOutput,                                          \
+                             size,                                             \
+                             (ZrSize)sizeof(type),                             \
+                             zrpParallelTransform##name##Chunk,                \
+                             &context,                                         \
+                             pTimings);                                        \
+    }
+
+#define ZRP_THREADPOOL_DEFINE_REDUCE_FUNCTION(name, type)                      \
+    struct ZrpParallelReduce##name##Context {                                  \
+        const type *pArray;                                                    \
+        type *pPartials;                                                       \
+        type (*pfnFunction)(type, type, void *);                               \
+        void *pData;                                                           \
+    };                                                                         \
+                                                                               \
+    static void zrpParallelReduce##name##Chunk(                                \
+        void *pData, ZrSize chunk, ZrSize begin, ZrSize end)                   \
+    {                                                                          \
+        const struct ZrpParallelReduce##name##Context *pContext;               \
+        type accumulator;                                                      \
+        size_t i;                                                              \
+                                                                               \
+        pContext = (const struct ZrpParallelReduce##name##Context *)pData;     \
+        accumulator = pContext->pArray[begin];                                 \
+        for (i = (size_t)begin + 1; i < (size_t)end; ++i) {                    \
+            accumulator = pContext->pfnFunction(                               \
+                accumulator, pContext->pArray[i], pContext->pData);            \
+        }                                                                      \
+                                                                               \
+        pContext->pPartials[chunk] = accumulator;                              \
+    }                                                                          \
+                                                                               \
+    ZRP_MAYBE_UNUSED ZRP_THREADPOOL_LINKAGE enum ZrStatus                      \
+        zrParallelReduce##name(                                                \
+            struct ZrThreadPool *pPool,                                        \
+            type *pResult,                                                     \
+            const type *pArray,                                                \
+            ZrSize size,                                                       \
+            type initialValue,                                                 \
+            type (*pfnFunction)(type accumulator, type value, void *pData),    \
+            void *pData,                                                       \
+            struct ZrParallelChunkTiming *pTimings)                            \
+    {                                                                          \
+        enum ZrStatus status;                                                  \
+        struct ZrpParallelReduce##name##Context context;                       \
+        ZrSize chunkCount;                                                     \
+        size_t i;                                                              \
+                                                                               \
+        ZR_ASSERT(pResult != NULL);                                            \
+        ZR_ASSERT(pArray != NULL || size == 0);                                \
+        ZR_ASSERT(pfnFunction != NULL);                                        \
+                                                                               \
+        *pResult = initialValue;                                               \
+        if (size == 0) {                                                       \
+            return ZR_SUCCESS;                                                 \
+        }                                                                      \
+                                                                               \
+        zrGetParallelChunkCount(                                               \
+            &chunkCount, pPool, pArray, size, (ZrSize)sizeof(type));           \
+                                                                               \
+        context.pArray = pArray;                                               \
+        context.pfnFunction = pfnFunction;                                     \
+        context.pData = pData;                                                 \
+        context.pPartials                                                      \
+            = (type *)ZR_MALLOC(sizeof(type) * (size_t)chunkCount);            \
+        if (context.pPartials == NULL) {                                       \
+            ZRP_LOG_ERROR("failed to allocate the partial results\n");         \
+            return ZR_ERROR_ALLOCATION;                                        \
+        }                                                                      \
+                                                                               \
+        status = zrParallelFor(pPool,                                          \
+                               pArray,                                         \
+                               size,                                           \
+                               (ZrSize)sizeof(type),                           \
+                               zrpParallelReduce##name##Chunk,                 \
+                               &context,                                       \
+                               pTimings);                                      \
+        if (status == ZR_SUCCESS) {                                            \
+            for (i = 0; i < (size_t)chunkCount; ++i) {                         \
+                *pResult                                                       \
+                    = pfnFunction(*pResult, context.pPartials[i], pData);      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        ZR_FREE(context.pPartials);                                            \
+        return status;                                                         \
+    }
+
+#undef ZR_MAKE_PARALLEL_ALGORITHMS
+#define ZR_MAKE_PARALLEL_ALGORITHMS(name, type)                                \
+    ZRP_THREADPOOL_DEFINE_FOR_EACH_FUNCTION(name, type)                        \
+    ZRP_THREADPOOL_DEFINE_TRANSFORM_FUNCTION(name, type)                       \
+    ZRP_THREADPOOL_DEFINE_REDUCE_FUNCTION(name, type)
+
+#endif /* ZRP_THREADPOOL_IMPLEMENTATION_DEFINED */
+#endif /* ZR_DEFINE_IMPLEMENTATION */
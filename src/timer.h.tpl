@@ -29,12 +29,118 @@ struct ZrCpuTimes {
     ZrUint64 system;
 };
 
+/*
+   - times: CPU times spent in user and kernel modes.
+   - voluntaryContextSwitches: count of times that the CPU was yielded, for
+     example to wait for a resource.
+   - involuntaryContextSwitches: count of times that the scheduler preempted
+     the CPU, for example to run a thread with a higher priority.
+   - minorPageFaults: count of page faults serviced without any I/O.
+   - majorPageFaults: count of page faults requiring an I/O.
+   - maxResidentSetSize: peak resident memory in bytes. On Linux, it always
+     refers to the whole process.
+*/
+struct ZrResourceUsage {
+    struct ZrCpuTimes times;
+    ZrUint64 voluntaryContextSwitches;
+    ZrUint64 involuntaryContextSwitches;
+    ZrUint64 minorPageFaults;
+    ZrUint64 majorPageFaults;
+    ZrUint64 maxResidentSetSize;
+};
+
+/*
+   Clocks that `zrGetRealTime()` can read from. The raw monotonic clock isn't
+   adjusted by NTP, the monotonic clock is, the coarse monotonic clock is
+   cheaper but only advances at each scheduler tick, and the boot time clock
+   also counts the time spent suspended.
+
+   Without `clock_gettime()`, only `ZR_CLOCK_MONOTONIC_RAW` is available and
+   it refers to the high-resolution clock of the platform. When the raw
+   clock doesn't exist, it falls back to the monotonic clock.
+*/
+enum ZrClock {
+    ZR_CLOCK_MONOTONIC_RAW = 0,
+    ZR_CLOCK_MONOTONIC = 1,
+    ZR_CLOCK_MONOTONIC_COARSE = 2,
+    ZR_CLOCK_BOOTTIME = 3
+};
+
+/*
+   - clock: clock being used.
+   - resolution: measured resolution in nanoseconds, that is the largest of
+     the resolution reported by the system and of the smallest step observed
+     between two consecutive reads.
+   - cost: measured cost in nanoseconds of reading the clock.
+*/
+struct ZrClockInfo {
+    enum ZrClock clock;
+    ZrUint64 resolution;
+    ZrUint64 cost;
+};
+
 ZRP_TIMER_LINKAGE enum ZrStatus
 zrGetRealTime(ZrUint64 *pTime);
 
+/*
+   Unless set at compile time with one of the `ZR_SET_TIMER_CLOCK_*` macros,
+   the first call to any of the clock functions probes the available clocks
+   and selects the cheapest one having a resolution of at most
+   `ZR_TIMER_MAX_CLOCK_RESOLUTION` nanoseconds (default: 1000).
+
+   Each clock is only probed once. Setting or selecting the clock can happen
+   while other threads call `zrGetRealTime()` or `zrGetClockInfo()`, but then
+   times read from different clocks must not be compared with each other.
+   Setting the clock returns `ZR_ERROR` if it isn't available, and selecting
+   it does so if no clock is fine enough, in which case the clock in use
+   doesn't change.
+*/
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrSetClock(enum ZrClock clock);
+
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrSelectClock(ZrUint64 maxResolution);
+
+ZRP_TIMER_LINKAGE void
+zrGetClockInfo(struct ZrClockInfo *pInfo);
+
 ZRP_TIMER_LINKAGE enum ZrStatus
 zrGetCpuTimes(struct ZrCpuTimes *pTimes);
 
+/*
+   Outside of Linux and without `RUSAGE_THREAD`, the CPU times of the calling
+   thread can still be retrieved from `CLOCK_THREAD_CPUTIME_ID`, which doesn't
+   distinguish between the user and kernel modes, so the total is then
+   reported as user time.
+*/
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadCpuTimes(struct ZrCpuTimes *pTimes);
+
+/* Resource usages are only available on Unix platforms. */
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetResourceUsage(struct ZrResourceUsage *pUsage);
+
+/* Only available on Linux and on the platforms defining `RUSAGE_THREAD`. */
+ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadResourceUsage(struct ZrResourceUsage *pUsage);
+
+/*
+   Ticks are read directly from the counter of the CPU when it runs at
+   a constant rate, that is the invariant timestamp counter on x86 and the
+   virtual counter on ARM64, and from the same clock as `zrGetRealTime()`
+   otherwise. They are only meaningful relative to each other and need to be
+   converted to get a duration.
+
+   The first call to either function checks for the counter and, on x86,
+   calibrates its rate against `zrGetRealTime()`, which takes about 10
+   milliseconds.
+*/
+ZRP_TIMER_LINKAGE ZrUint64
+zrGetTicks(void);
+
+ZRP_TIMER_LINKAGE ZrUint64
+zrTicksToNanoseconds(ZrUint64 ticks);
+
 #endif /* ZERO_TIMER_H */
 
 #ifdef ZR_DEFINE_IMPLEMENTATION
@@ -55,122 +161,491 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes);
 /* @include "partials/loglevel.h" */
 /* @include "partials/logger.h" */
 
-#if defined(ZRP_PLATFORM_WINDOWS)
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#elif defined(ZRP_PLATFORM_DARWIN)
-#include <mach/mach_time.h>
-#include <sys/resource.h>
-#elif defined(ZRP_PLATFORM_UNIX)
+/* @include "partials/atomics.h" */
+/* @include "partials/clock.h" */
+
+#if defined(ZRP_PLATFORM_DARWIN)
+#include <mach/mach.h>
+#endif
+
+#if defined(ZRP_PLATFORM_UNIX)
 #include <sys/resource.h>
-#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 199309L
-#include <time.h>
-#define ZRP_TIMER_USE_CLOCK_GETTIME
-#if defined(CLOCK_MONOTONIC_RAW)
-#define ZRP_TIMER_CLOCK_ID CLOCK_MONOTONIC_RAW
-#elif defined(CLOCK_MONOTONIC)
-#define ZRP_TIMER_CLOCK_ID CLOCK_MONOTONIC
-#else
-#define ZRP_TIMER_CLOCK_ID CLOCK_REALTIME
 #endif
-#else
-#include <sys/time.h>
+
+/*
+   Linux only exposes `RUSAGE_THREAD` with `_GNU_SOURCE`, but its value is
+   part of the system call ABI.
+*/
+#if defined(RUSAGE_THREAD)
+#define ZRP_TIMER_RUSAGE_THREAD RUSAGE_THREAD
+#elif defined(ZRP_PLATFORM_LINUX)
+#define ZRP_TIMER_RUSAGE_THREAD 1
 #endif
-#else
-typedef char zrp_timer_unsupported_platform[-1];
+
+#if defined(__GNUC__)                                                          \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+#include <cpuid.h>
+#define ZRP_TIMER_USE_TSC
+#elif defined(_MSC_VER)                                                        \
+    && (defined(ZRP_ARCH_X86_64) || defined(ZRP_ARCH_X86_32))
+#include <intrin.h>
+#define ZRP_TIMER_USE_TSC
+#elif defined(__GNUC__) && defined(ZRP_ARCH_ARM_64)
+#define ZRP_TIMER_USE_CNTVCT
 #endif
 
+#ifndef ZR_TIMER_MAX_CLOCK_RESOLUTION
+#define ZR_TIMER_MAX_CLOCK_RESOLUTION 1000
+#endif /* ZR_TIMER_MAX_CLOCK_RESOLUTION */
+
+#if defined(ZR_SET_TIMER_CLOCK_MONOTONIC_RAW)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC_RAW
+#elif defined(ZR_SET_TIMER_CLOCK_MONOTONIC)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC
+#elif defined(ZR_SET_TIMER_CLOCK_MONOTONIC_COARSE)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_MONOTONIC_COARSE
+#elif defined(ZR_SET_TIMER_CLOCK_BOOTTIME)
+#define ZRP_TIMER_CLOCK ZR_CLOCK_BOOTTIME
+#endif
+
+#define ZRP_TIMER_STATE_UNINITIALIZED 0
+#define ZRP_TIMER_STATE_INITIALIZING 1
+#define ZRP_TIMER_STATE_INITIALIZED 2
+
+#define ZRP_TIMER_CLOCK_COUNT 4
+#define ZRP_TIMER_PROBE_SAMPLE_COUNT 256
+
+#define ZRP_TIMER_CALIBRATION_DURATION 10000000ull
+
+static volatile size_t zrpTimerClockState;
+static volatile size_t zrpTimerClock;
+
+static volatile size_t zrpTimerClockInfoStates[ZRP_TIMER_CLOCK_COUNT];
+static struct ZrClockInfo zrpTimerClockInfos[ZRP_TIMER_CLOCK_COUNT];
+static int zrpTimerClockAvailabilities[ZRP_TIMER_CLOCK_COUNT];
+
+static volatile size_t zrpTimerTicksState;
+static int zrpTimerUseCounter;
+static ZrUint64 zrpTimerTicksPerSecond;
+
 /*
-    In some cases, tick values are casted to 64-bit floating-points in order
-    to prevent (unlikely) integer overflows during some arithmetic operations.
-    This effectively reducse the precision of the ticks having a value greater
-    than 2^53, which corresponds to approximatively 104 days.
+   Return whether the calling thread is the one to initialize the given
+   state, after waiting for another thread to be done with it otherwise.
 */
+ZRP_MAYBE_UNUSED static int
+zrpTimerBeginInitialization(volatile size_t *pState)
+{
+    /* The exchange may fail spuriously, so retry until someone claims it. */
+    while (zrpAtomicLoadSizeRelaxed(pState) == ZRP_TIMER_STATE_UNINITIALIZED) {
+        if (zrpAtomicCompareExchangeSizeRelaxed(pState,
+                                                ZRP_TIMER_STATE_UNINITIALIZED,
+                                                ZRP_TIMER_STATE_INITIALIZING)) {
+            return 1;
+        }
+    }
 
-ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
-zrGetRealTime(ZrUint64 *pTime)
+    while (zrpAtomicLoadSizeAcquire(pState) != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpAtomicPause();
+    }
+
+    return 0;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerEndInitialization(volatile size_t *pState)
 {
-    ZR_ASSERT(pTime != NULL);
+    zrpAtomicStoreSizeRelease(pState, ZRP_TIMER_STATE_INITIALIZED);
+}
 
-#if defined(ZRP_PLATFORM_WINDOWS)
-    {
-        static double timeToNano;
-        LARGE_INTEGER time;
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+ZRP_MAYBE_UNUSED static int
+zrpTimerGetClockId(clockid_t *pId, enum ZrClock clock)
+{
+    switch (clock) {
+        case ZR_CLOCK_MONOTONIC_RAW:
+            *pId = ZRP_CLOCK_ID;
+            return 1;
+#if defined(CLOCK_MONOTONIC)
+        case ZR_CLOCK_MONOTONIC:
+            *pId = CLOCK_MONOTONIC;
+            return 1;
+#endif
+#if defined(CLOCK_MONOTONIC_COARSE)
+        case ZR_CLOCK_MONOTONIC_COARSE:
+            *pId = CLOCK_MONOTONIC_COARSE;
+            return 1;
+#endif
+#if defined(CLOCK_BOOTTIME)
+        case ZR_CLOCK_BOOTTIME:
+            *pId = CLOCK_BOOTTIME;
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+#endif
 
-        if (timeToNano == 0.0) {
-            LARGE_INTEGER frequency;
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpTimerReadClock(ZrUint64 *pTime, enum ZrClock clock)
+{
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    clockid_t id;
+    struct timespec time;
 
-            if (!QueryPerformanceFrequency(&frequency)) {
-                ZRP_LOG_ERROR("failed to retrieve the time's frequency\n");
-                return ZR_ERROR;
-            }
+    if (!zrpTimerGetClockId(&id, clock) || clock_gettime(id, &time) != 0) {
+        ZRP_LOG_ERROR("failed to retrieve the current time\n");
+        return ZR_ERROR;
+    }
 
-            timeToNano = (double)ZR_TIMER_TICKS_PER_SECOND / frequency.QuadPart;
+    *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
+    return ZR_SUCCESS;
+#else
+    (void)clock;
+
+    return zrpClockGetRealTime(pTime);
+#endif
+}
+
+/* Measure the resolution and the cost of a clock, if available. */
+ZRP_MAYBE_UNUSED static int
+zrpTimerProbeClock(struct ZrClockInfo *pInfo, enum ZrClock clock)
+{
+    ZrUint64 start;
+    ZrUint64 end;
+    ZrUint64 previous;
+    ZrUint64 time;
+    ZrUint64 step;
+    size_t i;
+
+#if defined(ZRP_CLOCK_USE_CLOCK_GETTIME)
+    clockid_t id;
+    struct timespec resolution;
+    struct timespec now;
+
+    /* Some clocks are known to the headers but not to the running kernel. */
+    if (!zrpTimerGetClockId(&id, clock) || clock_getres(id, &resolution) != 0
+        || clock_gettime(id, &now) != 0) {
+        return 0;
+    }
+
+    pInfo->resolution = (ZrUint64)resolution.tv_sec * 1000000000ull
+                        + (ZrUint64)resolution.tv_nsec;
+#else
+    if (clock != ZR_CLOCK_MONOTONIC_RAW) {
+        return 0;
+    }
+
+    pInfo->resolution = 1;
+#endif
+
+    pInfo->clock = clock;
+    if (zrpClockGetRealTime(&start) != ZR_SUCCESS
+        || zrpTimerReadClock(&previous, clock) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    step = 0;
+    for (i = 0; i < ZRP_TIMER_PROBE_SAMPLE_COUNT; ++i) {
+        if (zrpTimerReadClock(&time, clock) != ZR_SUCCESS) {
+            return 0;
         }
 
-        if (!QueryPerformanceCounter(&time)) {
-            ZRP_LOG_ERROR("failed to retrieve the current time\n");
-            return ZR_ERROR;
+        if (time > previous && (step == 0 || time - previous < step)) {
+            step = time - previous;
         }
 
-        *pTime = time.QuadPart * timeToNano;
-        return ZR_SUCCESS;
+        previous = time;
     }
-#elif defined(ZRP_PLATFORM_DARWIN)
-    /*
-       Since Darwin 5.2, `clock_gettime()` can return high resolution times
-       with the `CLOCK_UPTIME_RAW` clock but it internally only calls
-       `mach_absolute_time()` with the overhead of converting the result into
-       the `timespec` format.
-    */
-    {
-        static double timeToNano;
 
-        if (timeToNano == 0.0) {
-            mach_timebase_info_data_t info;
+    if (zrpClockGetRealTime(&end) != ZR_SUCCESS) {
+        return 0;
+    }
 
-            if (mach_timebase_info(&info) != KERN_SUCCESS) {
-                ZRP_LOG_ERROR("failed to retrieve the current time\n");
-                return ZR_ERROR;
-            }
+    if (step > pInfo->resolution) {
+        pInfo->resolution = step;
+    }
 
-            timeToNano = (double)info.numer / info.denom;
+    pInfo->cost = (end - start) / ZRP_TIMER_PROBE_SAMPLE_COUNT;
+    return 1;
+}
+
+/*
+   Retrieve the info of a clock and return whether it is available. Each clock
+   is only probed once so that its info never changes after being published,
+   allowing it to be read while other threads set or select the clock.
+*/
+ZRP_MAYBE_UNUSED static int
+zrpTimerGetClockInfo(const struct ZrClockInfo **ppInfo, enum ZrClock clock)
+{
+    size_t i;
+
+    ZR_ASSERT((int)clock >= 0 && (int)clock < ZRP_TIMER_CLOCK_COUNT);
+
+    i = (size_t)clock;
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerClockInfoStates[i])
+            != ZRP_TIMER_STATE_INITIALIZED
+        && zrpTimerBeginInitialization(&zrpTimerClockInfoStates[i])) {
+        zrpTimerClockAvailabilities[i]
+            = zrpTimerProbeClock(&zrpTimerClockInfos[i], clock);
+        if (!zrpTimerClockAvailabilities[i]) {
+            zrpTimerClockInfos[i].clock = clock;
+            zrpTimerClockInfos[i].resolution = 0;
+            zrpTimerClockInfos[i].cost = 0;
         }
 
-        *pTime = mach_absolute_time() * timeToNano;
-        return ZR_SUCCESS;
+        zrpTimerEndInitialization(&zrpTimerClockInfoStates[i]);
     }
-#elif defined(ZRP_PLATFORM_UNIX)
-#if defined(ZRP_TIMER_USE_CLOCK_GETTIME)
-    {
-        struct timespec time;
 
-        if (clock_gettime(ZRP_TIMER_CLOCK_ID, &time) != 0) {
-            ZRP_LOG_ERROR("failed to retrieve the current time\n");
-            return ZR_ERROR;
+    *ppInfo = &zrpTimerClockInfos[i];
+    return zrpTimerClockAvailabilities[i];
+}
+
+ZRP_MAYBE_UNUSED static enum ZrStatus
+zrpTimerSelectClock(ZrUint64 maxResolution)
+{
+    const struct ZrClockInfo *pInfo;
+    const struct ZrClockInfo *pBestInfo;
+    int i;
+
+    pBestInfo = NULL;
+    for (i = 0; i < ZRP_TIMER_CLOCK_COUNT; ++i) {
+        if (zrpTimerGetClockInfo(&pInfo, (enum ZrClock)i)
+            && pInfo->resolution <= maxResolution
+            && (pBestInfo == NULL || pInfo->cost < pBestInfo->cost)) {
+            pBestInfo = pInfo;
         }
+    }
 
-        *pTime = (ZrUint64)time.tv_sec * 1000000000ull + (ZrUint64)time.tv_nsec;
-        return ZR_SUCCESS;
+    if (pBestInfo == NULL) {
+        return ZR_ERROR;
+    }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)pBestInfo->clock);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerInitializeClock(void)
+{
+#if defined(ZRP_TIMER_CLOCK)
+    const struct ZrClockInfo *pInfo;
+#endif
+
+    if (!zrpTimerBeginInitialization(&zrpTimerClockState)) {
+        return;
+    }
+
+#if defined(ZRP_TIMER_CLOCK)
+    if (!zrpTimerGetClockInfo(&pInfo, ZRP_TIMER_CLOCK)) {
+        ZRP_LOG_ERROR("the clock set at compile time isn't available\n");
     }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)ZRP_TIMER_CLOCK);
 #else
+    if (zrpTimerSelectClock(ZR_TIMER_MAX_CLOCK_RESOLUTION) != ZR_SUCCESS) {
+        zrpAtomicStoreSizeRelaxed(&zrpTimerClock,
+                                  (size_t)ZR_CLOCK_MONOTONIC_RAW);
+    }
+#endif
+
+    zrpTimerEndInitialization(&zrpTimerClockState);
+}
+
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpTimerReadCounter(void)
+{
+#if defined(ZRP_TIMER_USE_TSC) && defined(__GNUC__)
+    return (ZrUint64)__builtin_ia32_rdtsc();
+#elif defined(ZRP_TIMER_USE_TSC)
+    return (ZrUint64)__rdtsc();
+#elif defined(ZRP_TIMER_USE_CNTVCT)
+    ZrUint64 counter;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(counter));
+    return counter;
+#else
+    return 0;
+#endif
+}
+
+/* Return the rate of the counter, or 0 if it can't be relied upon. */
+ZRP_MAYBE_UNUSED static ZrUint64
+zrpTimerGetCounterFrequency(void)
+{
+#if defined(ZRP_TIMER_USE_TSC)
+    ZrUint64 startTime;
+    ZrUint64 time;
+    ZrUint64 startTicks;
+    ZrUint64 ticks;
+
+    /* Without an invariant TSC, its rate follows the frequency scaling. */
     {
-        struct timeval time;
+#if defined(__GNUC__)
+        unsigned int registers[4];
+
+        if (!__get_cpuid(0x80000000u,
+                         &registers[0],
+                         &registers[1],
+                         &registers[2],
+                         &registers[3])
+            || registers[0] < 0x80000007u
+            || !__get_cpuid(0x80000007u,
+                            &registers[0],
+                            &registers[1],
+                            &registers[2],
+                            &registers[3])
+            || !(registers[3] & 0x100u)) {
+            return 0;
+        }
+#else
+        int registers[4];
 
-        if (gettimeofday(&time, NULL) != 0) {
-            ZRP_LOG_ERROR("failed to retrieve the current time\n");
-            return ZR_ERROR;
+        __cpuid(registers, (int)0x80000000u);
+        if ((unsigned int)registers[0] < 0x80000007u) {
+            return 0;
         }
 
-        *pTime = (ZrUint64)time.tv_sec * 1000000000ull
-                 + (ZrUint64)time.tv_usec * 1000ull;
-        return ZR_SUCCESS;
+        __cpuid(registers, (int)0x80000007u);
+        if (!((unsigned int)registers[3] & 0x100u)) {
+            return 0;
+        }
+#endif
+    }
+
+    if (zrpClockGetRealTime(&startTime) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    startTicks = zrpTimerReadCounter();
+    do {
+        if (zrpClockGetRealTime(&time) != ZR_SUCCESS) {
+            return 0;
+        }
+    } while (time - startTime < ZRP_TIMER_CALIBRATION_DURATION);
+
+    ticks = zrpTimerReadCounter();
+    if (ticks <= startTicks) {
+        return 0;
+    }
+
+    return (ZrUint64)((double)(ticks - startTicks) * 1000000000.0
+                          / (double)(time - startTime)
+                      + 0.5);
+#elif defined(ZRP_TIMER_USE_CNTVCT)
+    ZrUint64 frequency;
+
+    /* The generic timer reports its own frequency. */
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency;
+#else
+    return 0;
+#endif
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerInitializeTicks(void)
+{
+    ZrUint64 frequency;
+
+    if (!zrpTimerBeginInitialization(&zrpTimerTicksState)) {
+        return;
     }
+
+    frequency = zrpTimerGetCounterFrequency();
+    if (frequency > 0) {
+        zrpTimerUseCounter = 1;
+        zrpTimerTicksPerSecond = frequency;
+    } else {
+        zrpTimerUseCounter = 0;
+        zrpTimerTicksPerSecond = ZR_TIMER_TICKS_PER_SECOND;
+    }
+
+    zrpTimerEndInitialization(&zrpTimerTicksState);
+}
+
+#if defined(ZRP_PLATFORM_UNIX)
+ZRP_MAYBE_UNUSED static void
+zrpTimerGetUsageCpuTimes(struct ZrCpuTimes *pTimes, const struct rusage *pUsage)
+{
+    pTimes->user = (ZrUint64)pUsage->ru_utime.tv_sec * 1000000000ull
+                   + (ZrUint64)pUsage->ru_utime.tv_usec * 1000ull;
+    pTimes->system = (ZrUint64)pUsage->ru_stime.tv_sec * 1000000000ull
+                     + (ZrUint64)pUsage->ru_stime.tv_usec * 1000ull;
+}
+
+ZRP_MAYBE_UNUSED static void
+zrpTimerGetUsage(struct ZrResourceUsage *pUsage, const struct rusage *pSource)
+{
+    zrpTimerGetUsageCpuTimes(&pUsage->times, pSource);
+    pUsage->voluntaryContextSwitches = (ZrUint64)pSource->ru_nvcsw;
+    pUsage->involuntaryContextSwitches = (ZrUint64)pSource->ru_nivcsw;
+    pUsage->minorPageFaults = (ZrUint64)pSource->ru_minflt;
+    pUsage->majorPageFaults = (ZrUint64)pSource->ru_majflt;
+
+    /* Darwin reports the peak resident set size in bytes, others in KiB. */
+#if defined(ZRP_PLATFORM_DARWIN)
+    pUsage->maxResidentSetSize = (ZrUint64)pSource->ru_maxrss;
+#else
+    pUsage->maxResidentSetSize = (ZrUint64)pSource->ru_maxrss * 1024ull;
 #endif
+}
 #endif
 
-    ZRP_LOG_ERROR("platform not supported\n");
-    return ZR_ERROR;
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetRealTime(ZrUint64 *pTime)
+{
+    ZR_ASSERT(pTime != NULL);
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerClockState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeClock();
+    }
+
+    return zrpTimerReadClock(
+        pTime, (enum ZrClock)zrpAtomicLoadSizeRelaxed(&zrpTimerClock));
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrSetClock(enum ZrClock clock)
+{
+    const struct ZrClockInfo *pInfo;
+
+    zrpTimerInitializeClock();
+    if ((int)clock < 0 || (int)clock >= ZRP_TIMER_CLOCK_COUNT
+        || !zrpTimerGetClockInfo(&pInfo, clock)) {
+        ZRP_LOG_ERROR("the clock %d isn't available\n", (int)clock);
+        return ZR_ERROR;
+    }
+
+    zrpAtomicStoreSizeRelaxed(&zrpTimerClock, (size_t)clock);
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrSelectClock(ZrUint64 maxResolution)
+{
+    zrpTimerInitializeClock();
+    if (zrpTimerSelectClock(maxResolution) != ZR_SUCCESS) {
+        ZRP_LOG_ERROR("no clock has a resolution of %lu nanoseconds\n",
+                      (unsigned long)maxResolution);
+        return ZR_ERROR;
+    }
+
+    return ZR_SUCCESS;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE void
+zrGetClockInfo(struct ZrClockInfo *pInfo)
+{
+    const struct ZrClockInfo *pClockInfo;
+
+    ZR_ASSERT(pInfo != NULL);
+
+    zrpTimerInitializeClock();
+    zrpTimerGetClockInfo(
+        &pClockInfo, (enum ZrClock)zrpAtomicLoadSizeRelaxed(&zrpTimerClock));
+    *pInfo = *pClockInfo;
 }
 
 ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
@@ -197,11 +672,12 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
 
         time.LowPart = userTime.dwLowDateTime;
         time.HighPart = userTime.dwHighDateTime;
-        *pTimes->user = time.QuadPart * 100ull;
+        pTimes->user = time.QuadPart * 100ull;
 
         time.LowPart = kernelTime.dwLowDateTime;
         time.HighPart = kernelTime.dwHighDateTime;
-        *pTimes->system = time.QuadPart * 100ull;
+        pTimes->system = time.QuadPart * 100ull;
+        return ZR_SUCCESS;
     }
 #elif defined(ZRP_PLATFORM_UNIX)
     {
@@ -212,10 +688,7 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
             return ZR_ERROR;
         }
 
-        pTimes->user = (ZrUint64)usage.ru_utime.tv_sec * 1000000000ull
-                       + (ZrUint64)usage.ru_utime.tv_usec * 1000ull;
-        pTimes->system = (ZrUint64)usage.ru_stime.tv_sec * 1000000000ull
-                         + (ZrUint64)usage.ru_stime.tv_usec * 1000ull;
+        zrpTimerGetUsageCpuTimes(pTimes, &usage);
         return ZR_SUCCESS;
     }
 #endif
@@ -224,5 +697,182 @@ zrGetCpuTimes(struct ZrCpuTimes *pTimes)
     return ZR_ERROR;
 }
 
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadCpuTimes(struct ZrCpuTimes *pTimes)
+{
+    ZR_ASSERT(pTimes != NULL);
+
+#if defined(ZRP_PLATFORM_WINDOWS)
+    {
+        FILETIME creationTime;
+        FILETIME exitTime;
+        FILETIME kernelTime;
+        FILETIME userTime;
+        ULARGE_INTEGER time;
+
+        if (!GetThreadTimes(GetCurrentThread(),
+                            &creationTime,
+                            &exitTime,
+                            &kernelTime,
+                            &userTime)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        time.LowPart = userTime.dwLowDateTime;
+        time.HighPart = userTime.dwHighDateTime;
+        pTimes->user = time.QuadPart * 100ull;
+
+        time.LowPart = kernelTime.dwLowDateTime;
+        time.HighPart = kernelTime.dwHighDateTime;
+        pTimes->system = time.QuadPart * 100ull;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_DARWIN)
+    {
+        mach_port_t thread;
+        thread_basic_info_data_t info;
+        mach_msg_type_number_t count;
+        kern_return_t result;
+
+        thread = mach_thread_self();
+        count = THREAD_BASIC_INFO_COUNT;
+        result = thread_info(
+            thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+        mach_port_deallocate(mach_task_self(), thread);
+        if (result != KERN_SUCCESS) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        pTimes->user = (ZrUint64)info.user_time.seconds * 1000000000ull
+                       + (ZrUint64)info.user_time.microseconds * 1000ull;
+        pTimes->system = (ZrUint64)info.system_time.seconds * 1000000000ull
+                         + (ZrUint64)info.system_time.microseconds * 1000ull;
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_PLATFORM_UNIX) && defined(ZRP_TIMER_RUSAGE_THREAD)
+    {
+        struct rusage usage;
+
+        if (getrusage(ZRP_TIMER_RUSAGE_THREAD, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsageCpuTimes(pTimes, &usage);
+        return ZR_SUCCESS;
+    }
+#elif defined(ZRP_CLOCK_USE_CLOCK_GETTIME)                                     \
+    && defined(CLOCK_THREAD_CPUTIME_ID)
+    {
+        struct timespec time;
+
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread CPU times\n");
+            return ZR_ERROR;
+        }
+
+        pTimes->user = (ZrUint64)time.tv_sec * 1000000000ull
+                       + (ZrUint64)time.tv_nsec;
+        pTimes->system = 0;
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pTimes;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetResourceUsage(struct ZrResourceUsage *pUsage)
+{
+    ZR_ASSERT(pUsage != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX)
+    {
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current resource usage\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsage(pUsage, &usage);
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pUsage;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE enum ZrStatus
+zrGetThreadResourceUsage(struct ZrResourceUsage *pUsage)
+{
+    ZR_ASSERT(pUsage != NULL);
+
+#if defined(ZRP_PLATFORM_UNIX) && defined(ZRP_TIMER_RUSAGE_THREAD)
+    {
+        struct rusage usage;
+
+        if (getrusage(ZRP_TIMER_RUSAGE_THREAD, &usage)) {
+            ZRP_LOG_ERROR("failed to retrieve the current thread resource "
+                          "usage\n");
+            return ZR_ERROR;
+        }
+
+        zrpTimerGetUsage(pUsage, &usage);
+        return ZR_SUCCESS;
+    }
+#else
+    (void)pUsage;
+#endif
+
+    ZRP_LOG_ERROR("platform not supported\n");
+    return ZR_ERROR;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE ZrUint64
+zrGetTicks(void)
+{
+    ZrUint64 time;
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerTicksState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeTicks();
+    }
+
+    if (zrpTimerUseCounter) {
+        return zrpTimerReadCounter();
+    }
+
+    if (zrGetRealTime(&time) != ZR_SUCCESS) {
+        return 0;
+    }
+
+    return time;
+}
+
+ZRP_MAYBE_UNUSED ZRP_TIMER_LINKAGE ZrUint64
+zrTicksToNanoseconds(ZrUint64 ticks)
+{
+    ZrUint64 frequency;
+
+    if (zrpAtomicLoadSizeAcquire(&zrpTimerTicksState)
+        != ZRP_TIMER_STATE_INITIALIZED) {
+        zrpTimerInitializeTicks();
+    }
+
+    /* Split the conversion to avoid overflowing, with rates up to 18 GHz. */
+    frequency = zrpTimerTicksPerSecond;
+    return ticks / frequency * 1000000000ull
+           + ticks % frequency * 1000000000ull / frequency;
+}
+
 #endif /* ZRP_TIMER_IMPLEMENTATION_DEFINED */
 #endif /* ZR_DEFINE_IMPLEMENTATION */